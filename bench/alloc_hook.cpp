@@ -0,0 +1,67 @@
+#include "bench_harness.h"
+#include <cstdlib>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace fps_monitor {
+namespace bench {
+
+namespace {
+thread_local uint64_t t_allocationCount = 0;
+} // namespace
+
+uint64_t allocationCount() {
+    return t_allocationCount;
+}
+
+} // namespace bench
+} // namespace fps_monitor
+
+// Replacement global allocation functions. The array, nothrow and sized
+// forms forward to these by default, so only these are replaced (the
+// sized deletes are spelled out for compilers that warn otherwise).
+void* operator new(std::size_t size) {
+    ++fps_monitor::bench::t_allocationCount;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++fps_monitor::bench::t_allocationCount;
+    std::size_t align = static_cast<std::size_t>(alignment);
+#if defined(_MSC_VER)
+    void* ptr = _aligned_malloc(size ? size : 1, align);
+#else
+    // aligned_alloc needs a size that is a multiple of the alignment
+    void* ptr = std::aligned_alloc(align, ((size ? size : 1) + align - 1) / align * align);
+#endif
+    if (ptr) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+#if defined(_MSC_VER)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept {
+    ::operator delete(ptr, alignment);
+}
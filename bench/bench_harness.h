@@ -0,0 +1,188 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace fps_monitor {
+namespace bench {
+
+/**
+ * @brief Keep a value alive so the optimizer cannot drop the benchmarked work
+ *
+ * @param value Result of the benchmarked expression
+ */
+template<typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+    static const volatile T* sink;
+    sink = &value;
+    _ReadWriteBarrier();
+#else
+    asm volatile("" : : "g"(&value) : "memory");
+#endif
+}
+
+/**
+ * @brief Heap allocations made by the calling thread so far
+ *
+ * Counted by the replacement operator new in alloc_hook.cpp (in every
+ * build type, unlike the debug-only AllocationCounter of the overlay).
+ *
+ * @return uint64_t Allocation count
+ */
+uint64_t allocationCount();
+
+/**
+ * @brief Per-run state handed to a benchmark function
+ *
+ * The function performs setup, then loops on keepRunning() around the code
+ * being measured. Only the loop is timed.
+ */
+class State {
+public:
+    /**
+     * @brief Construct a new State
+     *
+     * @param arg Benchmark argument (typically a sample count)
+     * @param iterations Number of timed loop iterations
+     */
+    State(size_t arg, uint64_t iterations)
+        : m_arg(arg)
+        , m_iterations(iterations)
+        , m_remaining(iterations)
+        , m_itemsPerIteration(1)
+        , m_started(false)
+        , m_startAllocations(0)
+        , m_allocations(0)
+    {
+    }
+
+    /**
+     * @brief Advance the timed loop
+     *
+     * The first call starts the clock and the last one stops it; heap
+     * allocations in between are counted.
+     *
+     * @return true if another iteration should run
+     * @return false once all iterations are done
+     */
+    bool keepRunning() {
+        if (!m_started) {
+            m_started = true;
+            m_startAllocations = allocationCount();
+            m_start = std::chrono::steady_clock::now();
+        }
+
+        if (m_remaining == 0) {
+            m_stop = std::chrono::steady_clock::now();
+            m_allocations = allocationCount() - m_startAllocations;
+            return false;
+        }
+
+        --m_remaining;
+        return true;
+    }
+
+    /**
+     * @brief Set how many items one iteration processes (for ns/item)
+     *
+     * @param items Items per iteration
+     */
+    void setItemsPerIteration(uint64_t items) { m_itemsPerIteration = items; }
+
+    /**
+     * @brief Attach a note to the result line (e.g. the kernel actually used)
+     *
+     * @param label Free-form label
+     */
+    void setLabel(const std::string& label) { m_label = label; }
+
+    size_t arg() const { return m_arg; }                                     ///< Benchmark argument
+    uint64_t iterations() const { return m_iterations; }                     ///< Timed iterations
+    uint64_t itemsPerIteration() const { return m_itemsPerIteration; }       ///< Items per iteration
+    const std::string& label() const { return m_label; }                     ///< Result note
+    uint64_t allocations() const { return m_allocations; }                   ///< Allocations in the timed loop
+
+    /**
+     * @brief Get the time spent in the timed loop
+     *
+     * @return double Elapsed seconds
+     */
+    double elapsedSeconds() const {
+        return std::chrono::duration<double>(m_stop - m_start).count();
+    }
+
+private:
+    size_t m_arg;                                        ///< Benchmark argument
+    uint64_t m_iterations;                               ///< Requested iterations
+    uint64_t m_remaining;                                ///< Iterations left
+    uint64_t m_itemsPerIteration;                        ///< Items per iteration
+    bool m_started;                                      ///< Clock started
+    uint64_t m_startAllocations;                         ///< allocationCount() at loop start
+    uint64_t m_allocations;                              ///< Allocations during the loop
+    std::chrono::steady_clock::time_point m_start;       ///< Loop start
+    std::chrono::steady_clock::time_point m_stop;        ///< Loop end
+    std::string m_label;                                 ///< Result note
+};
+
+/// Benchmark entry point
+using BenchmarkFunc = void (*)(State&);
+
+/**
+ * @brief A registered benchmark and the arguments it runs with
+ */
+struct Benchmark {
+    std::string name;           ///< Display name
+    BenchmarkFunc func;         ///< Benchmark body
+    std::vector<size_t> args;   ///< One run per argument
+};
+
+/**
+ * @brief Global benchmark list (filled by static registrars)
+ *
+ * @return std::vector<Benchmark>& Registered benchmarks
+ */
+inline std::vector<Benchmark>& registry() {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+}
+
+/**
+ * @brief Registers a benchmark at static-initialization time
+ */
+struct Registrar {
+    Registrar(const char* name, BenchmarkFunc func, std::initializer_list<size_t> args) {
+        registry().push_back({name, func, args.size() > 0 ? std::vector<size_t>(args) : std::vector<size_t>{0}});
+    }
+};
+
+/**
+ * @brief Run the registered benchmarks and print a results table
+ *
+ * Options: --filter=<substring>, --min-time=<seconds>
+ *
+ * @param argc Argument count
+ * @param argv Arguments
+ * @return int Process exit code
+ */
+int runBenchmarks(int argc, char** argv);
+
+} // namespace bench
+} // namespace fps_monitor
+
+#define FPS_BENCH_CONCAT_INNER(a, b) a##b
+#define FPS_BENCH_CONCAT(a, b) FPS_BENCH_CONCAT_INNER(a, b)
+
+/**
+ * @brief Register a benchmark: FPS_BENCHMARK("name", func, arg1, arg2, ...)
+ */
+#define FPS_BENCHMARK(name, func, ...) \
+    static ::fps_monitor::bench::Registrar FPS_BENCH_CONCAT(s_benchRegistrar, __LINE__)(name, func, {__VA_ARGS__})
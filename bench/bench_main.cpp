@@ -0,0 +1,83 @@
+#include "bench_harness.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace fps_monitor {
+namespace bench {
+
+namespace {
+
+constexpr uint64_t MAX_ITERATIONS = 1000000000ull;
+
+/**
+ * @brief Run one benchmark/argument pair until it has run for minSeconds
+ *
+ * @return State Final (reported) run
+ */
+State runOne(const Benchmark& benchmark, size_t arg, double minSeconds) {
+    uint64_t iterations = 1;
+    for (;;) {
+        State state(arg, iterations);
+        benchmark.func(state);
+
+        double elapsed = state.elapsedSeconds();
+        if (elapsed >= minSeconds || iterations >= MAX_ITERATIONS) {
+            return state;
+        }
+
+        // Aim ~40% past the target so the next run is usually the last
+        double scale = elapsed > 0.0 ? (minSeconds * 1.4) / elapsed : 10.0;
+        scale = scale < 2.0 ? 2.0 : (scale > 100.0 ? 100.0 : scale);
+        iterations = static_cast<uint64_t>(iterations * scale);
+    }
+}
+
+} // namespace
+
+int runBenchmarks(int argc, char** argv) {
+    const char* filter = "";
+    double minSeconds = 0.25;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--filter=", 9) == 0) {
+            filter = argv[i] + 9;
+        } else if (std::strncmp(argv[i], "--min-time=", 11) == 0) {
+            minSeconds = std::atof(argv[i] + 11);
+        } else {
+            std::fprintf(stderr, "usage: %s [--filter=<substring>] [--min-time=<seconds>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::printf("%-36s %10s %14s %12s %14s %12s  %s\n",
+                "benchmark", "arg", "iterations", "ns/iter", "ns/item", "allocs/iter", "note");
+
+    for (const Benchmark& benchmark : registry()) {
+        if (benchmark.name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        for (size_t arg : benchmark.args) {
+            State state = runOne(benchmark, arg, minSeconds);
+            double nsPerIteration = state.elapsedSeconds() * 1e9 / static_cast<double>(state.iterations());
+            double nsPerItem = nsPerIteration / static_cast<double>(state.itemsPerIteration());
+            double allocsPerIteration = static_cast<double>(state.allocations())
+                                      / static_cast<double>(state.iterations());
+
+            std::printf("%-36s %10zu %14llu %12.1f %14.3f %12.3f  %s\n",
+                        benchmark.name.c_str(), arg,
+                        static_cast<unsigned long long>(state.iterations()),
+                        nsPerIteration, nsPerItem, allocsPerIteration, state.label().c_str());
+        }
+    }
+
+    return 0;
+}
+
+} // namespace bench
+} // namespace fps_monitor
+
+int main(int argc, char** argv) {
+    return fps_monitor::bench::runBenchmarks(argc, argv);
+}
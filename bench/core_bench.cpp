@@ -0,0 +1,220 @@
+#include "bench_harness.h"
+#include "frame_generator.h"
+#include "ring_buffer.h"
+#include "stats_tracker.h"
+#include "drop_detector.h"
+#include "stutter_analyzer.h"
+#include "graph_decimator.h"
+#include <chrono>
+#include <vector>
+
+namespace fps_monitor {
+namespace bench {
+
+namespace {
+
+constexpr size_t WINDOW = 8192;             ///< FpsCalculator::MAX_HISTORY
+constexpr size_t SEQUENCE_LENGTH = 65536;   ///< Pre-generated frames, replayed cyclically
+constexpr size_t GRAPH_COLUMNS = 300;       ///< Default overlay graph width
+
+using SampleRing = RingBuffer<uint32_t, WINDOW>;
+
+/**
+ * @brief Pre-generated frame times, so generation stays out of the timed loop
+ */
+class FrameSequence {
+public:
+    FrameSequence(FramePattern pattern, double targetHz)
+        : m_frames(FrameGenerator(pattern, targetHz).generate(SEQUENCE_LENGTH))
+        , m_next(0)
+    {
+    }
+
+    uint32_t next() {
+        uint32_t frame = m_frames[m_next];
+        m_next = (m_next + 1) % m_frames.size();
+        return frame;
+    }
+
+private:
+    std::vector<uint32_t> m_frames;
+    size_t m_next;
+};
+
+/**
+ * @brief Fill a ring with count frames of a steady 144 Hz sequence
+ */
+void fillRing(SampleRing& ring, size_t count) {
+    FrameGenerator generator(FramePattern::Steady, 144.0);
+    for (size_t i = 0; i < count; ++i) {
+        ring.push(generator.next());
+    }
+}
+
+double ticksToFPS(uint32_t ticks) {
+    return static_cast<double>(FrameGenerator::DEFAULT_TICK_FREQUENCY) / static_cast<double>(ticks);
+}
+
+void benchRingPush(State& state) {
+    SampleRing ring;
+    FrameSequence frames(FramePattern::Steady, 144.0);
+
+    while (state.keepRunning()) {
+        ring.push(frames.next());
+    }
+    doNotOptimize(ring.latest());
+}
+
+void benchRingGetAll(State& state) {
+    SampleRing ring;
+    fillRing(ring, state.arg());
+
+    while (state.keepRunning()) {
+        std::vector<uint32_t> samples = ring.getAll();
+        doNotOptimize(samples.data());
+    }
+    state.setItemsPerIteration(state.arg());
+}
+
+void benchRingView(State& state) {
+    SampleRing ring;
+    fillRing(ring, state.arg());
+
+    while (state.keepRunning()) {
+        uint64_t sum = 0;
+        ring.view().forEach([&sum](uint32_t ticks) { sum += ticks; });
+        doNotOptimize(sum);
+    }
+    state.setItemsPerIteration(state.arg());
+}
+
+/**
+ * @brief Full statistics recalculation over a window of arg samples
+ */
+template<PercentileMode Mode>
+void benchStatsCalculate(State& state) {
+    SampleRing ring;
+    fillRing(ring, state.arg());
+    StatsTracker stats(500, WINDOW, Mode, FrameGenerator::DEFAULT_TICK_FREQUENCY);
+    FrameSequence frames(FramePattern::Steady, 144.0);
+    uint64_t total = ring.size();
+
+    while (state.keepRunning()) {
+        // Slide the window by one frame so streaming state stays realistic
+        ring.push(frames.next());
+        SampleView<uint32_t> window = ring.view().last(state.arg());
+        stats.update(window, ++total, true);
+    }
+    doNotOptimize(stats.getStats());
+    state.setItemsPerIteration(state.arg());
+    state.setLabel(Mode == PercentileMode::Exact ? "exact" : "histogram");
+}
+
+/**
+ * @brief Per-frame statistics update (recalculation every 500 ms)
+ */
+template<FramePattern Pattern>
+void benchStatsFrame(State& state) {
+    SampleRing ring;
+    StatsTracker stats(500, WINDOW, PercentileMode::Exact, FrameGenerator::DEFAULT_TICK_FREQUENCY);
+    FrameSequence frames(Pattern, static_cast<double>(state.arg()));
+    uint64_t total = 0;
+
+    while (state.keepRunning()) {
+        ring.push(frames.next());
+        stats.update(ring.view(), ++total);
+    }
+    doNotOptimize(stats.getStats());
+    state.setLabel(FrameGenerator::name(Pattern));
+}
+
+/**
+ * @brief Per-frame drop detection on the synthetic clock
+ */
+template<FramePattern Pattern>
+void benchDropDetector(State& state) {
+    DropDetector detector(15.0);
+    FrameSequence frames(Pattern, static_cast<double>(state.arg()));
+    auto now = std::chrono::steady_clock::now();
+    double average = static_cast<double>(state.arg());
+
+    while (state.keepRunning()) {
+        uint32_t ticks = frames.next();
+        double current = ticksToFPS(ticks);
+        average += (current - average) * 0.01;
+        now += std::chrono::nanoseconds(static_cast<int64_t>(ticks) * (1000000000 / FrameGenerator::DEFAULT_TICK_FREQUENCY));
+        detector.update(current, average, now);
+    }
+    doNotOptimize(detector.getDrops().size());
+    state.setLabel(FrameGenerator::name(Pattern));
+}
+
+/**
+ * @brief Per-frame stutter analysis (rolling median, variance, hitches)
+ */
+template<FramePattern Pattern>
+void benchStutterAnalyzer(State& state) {
+    SampleRing ring;
+    StutterAnalyzer analyzer(FrameGenerator::DEFAULT_TICK_FREQUENCY, 144.0, 2.0);
+    FrameSequence frames(Pattern, static_cast<double>(state.arg()));
+    uint64_t total = 0;
+
+    while (state.keepRunning()) {
+        ring.push(frames.next());
+        analyzer.update(ring.view(), ++total);
+    }
+    doNotOptimize(analyzer.getStats());
+    state.setLabel(FrameGenerator::name(Pattern));
+}
+
+/**
+ * @brief Per-frame graph decimation of a full window to the default graph width
+ */
+template<FramePattern Pattern>
+void benchDecimator(State& state) {
+    SampleRing ring;
+    GraphDecimator decimator;
+    FrameSequence frames(Pattern, static_cast<double>(state.arg()));
+    uint64_t total = 0;
+    for (; total < WINDOW; ++total) {
+        ring.push(frames.next());
+    }
+
+    while (state.keepRunning()) {
+        ring.push(frames.next());
+        doNotOptimize(decimator.update(ring.view(), ++total, GRAPH_COLUMNS, WINDOW));
+    }
+    state.setLabel(FrameGenerator::name(Pattern));
+}
+
+} // namespace
+
+FPS_BENCHMARK("core/ring_buffer/push", benchRingPush, 0);
+FPS_BENCHMARK("core/ring_buffer/get_all", benchRingGetAll, 120, 1200, 8192);
+FPS_BENCHMARK("core/ring_buffer/view", benchRingView, 120, 1200, 8192);
+
+FPS_BENCHMARK("core/stats/calculate/exact", benchStatsCalculate<PercentileMode::Exact>, 120, 1200, 8192);
+FPS_BENCHMARK("core/stats/calculate/histogram", benchStatsCalculate<PercentileMode::Histogram>, 120, 1200, 8192);
+
+FPS_BENCHMARK("core/stats/frame/steady", benchStatsFrame<FramePattern::Steady>, 60, 144, 240, 500);
+FPS_BENCHMARK("core/stats/frame/stutter", benchStatsFrame<FramePattern::Stutter>, 60, 144, 240, 500);
+FPS_BENCHMARK("core/stats/frame/sawtooth", benchStatsFrame<FramePattern::Sawtooth>, 60, 144, 240, 500);
+FPS_BENCHMARK("core/stats/frame/vrr", benchStatsFrame<FramePattern::Vrr>, 60, 144, 240, 500);
+
+FPS_BENCHMARK("core/drop_detector/steady", benchDropDetector<FramePattern::Steady>, 60, 144, 240, 500);
+FPS_BENCHMARK("core/drop_detector/stutter", benchDropDetector<FramePattern::Stutter>, 60, 144, 240, 500);
+FPS_BENCHMARK("core/drop_detector/sawtooth", benchDropDetector<FramePattern::Sawtooth>, 60, 144, 240, 500);
+FPS_BENCHMARK("core/drop_detector/vrr", benchDropDetector<FramePattern::Vrr>, 60, 144, 240, 500);
+
+FPS_BENCHMARK("core/stutter/steady", benchStutterAnalyzer<FramePattern::Steady>, 60, 144, 240, 500);
+FPS_BENCHMARK("core/stutter/stutter", benchStutterAnalyzer<FramePattern::Stutter>, 60, 144, 240, 500);
+FPS_BENCHMARK("core/stutter/sawtooth", benchStutterAnalyzer<FramePattern::Sawtooth>, 60, 144, 240, 500);
+FPS_BENCHMARK("core/stutter/vrr", benchStutterAnalyzer<FramePattern::Vrr>, 60, 144, 240, 500);
+
+FPS_BENCHMARK("overlay/decimator/steady", benchDecimator<FramePattern::Steady>, 60, 144, 240, 500);
+FPS_BENCHMARK("overlay/decimator/stutter", benchDecimator<FramePattern::Stutter>, 60, 144, 240, 500);
+FPS_BENCHMARK("overlay/decimator/sawtooth", benchDecimator<FramePattern::Sawtooth>, 60, 144, 240, 500);
+FPS_BENCHMARK("overlay/decimator/vrr", benchDecimator<FramePattern::Vrr>, 60, 144, 240, 500);
+
+} // namespace bench
+} // namespace fps_monitor
@@ -0,0 +1,82 @@
+#include "frame_generator.h"
+#include <algorithm>
+
+namespace fps_monitor {
+namespace bench {
+
+namespace {
+
+constexpr double JITTER = 0.02;             ///< Frame-time standard deviation (relative)
+constexpr double STUTTER_CHANCE = 0.02;     ///< Probability of a hitch per frame
+constexpr double VRR_MIN_HZ = 48.0;         ///< Bottom of a typical VRR range
+constexpr double VRR_STEP = 0.01;           ///< Largest relative rate change per frame
+
+} // namespace
+
+FrameGenerator::FrameGenerator(FramePattern pattern, double targetHz, int64_t tickFrequency, uint32_t seed)
+    : m_pattern(pattern)
+    , m_targetHz(targetHz)
+    , m_tickFrequency(static_cast<double>(tickFrequency))
+    , m_rng(seed)
+    , m_jitter(0.0, JITTER)
+    , m_unit(0.0, 1.0)
+    , m_frame(0)
+    , m_vrrHz(targetHz)
+{
+}
+
+uint32_t FrameGenerator::next() {
+    double hz = m_targetHz;
+    double scale = 1.0;
+
+    switch (m_pattern) {
+        case FramePattern::Steady:
+            break;
+
+        case FramePattern::Stutter:
+            if (m_unit(m_rng) < STUTTER_CHANCE) {
+                scale = 3.0 + 3.0 * m_unit(m_rng);
+            }
+            break;
+
+        case FramePattern::Sawtooth: {
+            // One ramp per second of nominal frames
+            uint64_t period = std::max<uint64_t>(1, static_cast<uint64_t>(m_targetHz));
+            double phase = static_cast<double>(m_frame % period) / static_cast<double>(period);
+            hz = m_targetHz * (1.0 - 0.5 * phase);
+            break;
+        }
+
+        case FramePattern::Vrr: {
+            double step = (m_unit(m_rng) * 2.0 - 1.0) * VRR_STEP;
+            m_vrrHz = std::clamp(m_vrrHz * (1.0 + step), std::min(VRR_MIN_HZ, m_targetHz), m_targetHz);
+            hz = m_vrrHz;
+            break;
+        }
+    }
+
+    ++m_frame;
+    double seconds = scale * (1.0 + m_jitter(m_rng)) / hz;
+    return static_cast<uint32_t>(std::max(1.0, seconds * m_tickFrequency));
+}
+
+std::vector<uint32_t> FrameGenerator::generate(size_t count) {
+    std::vector<uint32_t> frames(count);
+    for (uint32_t& frame : frames) {
+        frame = next();
+    }
+    return frames;
+}
+
+const char* FrameGenerator::name(FramePattern pattern) {
+    switch (pattern) {
+        case FramePattern::Steady:   return "steady";
+        case FramePattern::Stutter:  return "stutter";
+        case FramePattern::Sawtooth: return "sawtooth";
+        case FramePattern::Vrr:      return "vrr";
+    }
+    return "unknown";
+}
+
+} // namespace bench
+} // namespace fps_monitor
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace fps_monitor {
+namespace bench {
+
+/**
+ * @brief Shape of a synthetic frame-time sequence
+ */
+enum class FramePattern {
+    Steady,     ///< Target rate with small jitter
+    Stutter,    ///< Steady with occasional 3-6x hitches
+    Sawtooth,   ///< Rate ramps down to half over one second, then recovers at once
+    Vrr         ///< Rate wanders between 48 Hz and the target (VRR-like)
+};
+
+/**
+ * @brief Deterministic synthetic frame times for benchmarks
+ *
+ * Produces frame times in ticks of a given frequency, the same form the
+ * capture pipeline feeds FpsCalculator. The same pattern, rate and seed
+ * always give the same sequence so runs are comparable.
+ */
+class FrameGenerator {
+public:
+    static constexpr int64_t DEFAULT_TICK_FREQUENCY = 10000000;  ///< Typical QPC frequency
+
+    /**
+     * @brief Construct a new Frame Generator
+     *
+     * @param pattern Sequence shape
+     * @param targetHz Nominal frame rate (e.g. 60 - 500)
+     * @param tickFrequency Ticks per second of the output
+     * @param seed Random seed
+     */
+    FrameGenerator(FramePattern pattern, double targetHz,
+                   int64_t tickFrequency = DEFAULT_TICK_FREQUENCY, uint32_t seed = 12345);
+
+    /**
+     * @brief Produce the next frame time
+     *
+     * @return uint32_t Frame time in ticks
+     */
+    uint32_t next();
+
+    /**
+     * @brief Produce a sequence of frame times
+     *
+     * @param count Number of frames
+     * @return std::vector<uint32_t> Frame times in ticks
+     */
+    std::vector<uint32_t> generate(size_t count);
+
+    /**
+     * @brief Get the display name of a pattern
+     *
+     * @param pattern Sequence shape
+     * @return const char* Lower-case name
+     */
+    static const char* name(FramePattern pattern);
+
+private:
+    FramePattern m_pattern;                         ///< Sequence shape
+    double m_targetHz;                              ///< Nominal frame rate
+    double m_tickFrequency;                         ///< Output ticks per second
+    std::mt19937 m_rng;                             ///< Deterministic source
+    std::normal_distribution<double> m_jitter;      ///< Relative frame-time jitter
+    std::uniform_real_distribution<double> m_unit;  ///< [0, 1)
+    uint64_t m_frame;                               ///< Frames produced
+    double m_vrrHz;                                 ///< Current VRR rate
+};
+
+} // namespace bench
+} // namespace fps_monitor
@@ -0,0 +1,54 @@
+#include "bench_harness.h"
+#include "frame_generator.h"
+#include "fps_calculator.h"
+#include "stats_tracker.h"
+#include "drop_detector.h"
+#include <chrono>
+#include <vector>
+
+namespace fps_monitor {
+namespace bench {
+
+namespace {
+
+constexpr size_t SEQUENCE_LENGTH = 65536;   ///< Pre-generated frames, replayed cyclically
+
+/**
+ * @brief One analysis-thread frame: calculator, statistics and drop detection
+ *
+ * Same per-sample work AnalysisThread does on a replayed recording, with
+ * drop detection on the synthetic clock.
+ */
+template<FramePattern Pattern>
+void benchAnalysisFrame(State& state) {
+    const int64_t frequency = FrameGenerator::DEFAULT_TICK_FREQUENCY;
+    std::vector<uint32_t> frames = FrameGenerator(Pattern, static_cast<double>(state.arg())).generate(SEQUENCE_LENGTH);
+
+    FpsCalculator calculator(FpsCalculator::MAX_HISTORY, frequency);
+    StatsTracker stats(500, FpsCalculator::MAX_HISTORY, PercentileMode::Exact, frequency);
+    DropDetector detector(15.0);
+    auto now = std::chrono::steady_clock::now();
+    size_t next = 0;
+
+    while (state.keepRunning()) {
+        uint32_t ticks = frames[next];
+        next = (next + 1) % frames.size();
+
+        calculator.addFrameTime(ticks);
+        stats.update(calculator.getSampleView(), calculator.getTotalSamples());
+        now += std::chrono::nanoseconds(static_cast<int64_t>(ticks) * (1000000000 / frequency));
+        detector.update(calculator.getCurrentFPS(), calculator.getAverageFPS(), now);
+    }
+    doNotOptimize(stats.getStats());
+    state.setLabel(FrameGenerator::name(Pattern));
+}
+
+} // namespace
+
+FPS_BENCHMARK("pipeline/frame/steady", benchAnalysisFrame<FramePattern::Steady>, 60, 144, 240, 500);
+FPS_BENCHMARK("pipeline/frame/stutter", benchAnalysisFrame<FramePattern::Stutter>, 60, 144, 240, 500);
+FPS_BENCHMARK("pipeline/frame/sawtooth", benchAnalysisFrame<FramePattern::Sawtooth>, 60, 144, 240, 500);
+FPS_BENCHMARK("pipeline/frame/vrr", benchAnalysisFrame<FramePattern::Vrr>, 60, 144, 240, 500);
+
+} // namespace bench
+} // namespace fps_monitor
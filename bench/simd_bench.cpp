@@ -0,0 +1,105 @@
+#include "bench_harness.h"
+#include "simd_kernels.h"
+#include <random>
+#include <vector>
+
+namespace fps_monitor {
+namespace bench {
+
+namespace {
+
+constexpr int64_t TICKS_PER_SECOND = 10000000;  ///< Typical QPC frequency
+
+/**
+ * @brief Random frame times between 60 and 500 FPS at a 10 MHz tick rate
+ */
+std::vector<uint32_t> makeFrameTimes(size_t count) {
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<uint32_t> ticks(TICKS_PER_SECOND / 500, TICKS_PER_SECOND / 60);
+
+    std::vector<uint32_t> samples(count);
+    for (uint32_t& sample : samples) {
+        sample = ticks(rng);
+    }
+    return samples;
+}
+
+template<SimdLevel Level>
+void benchSum(State& state) {
+    const SimdKernels& kernels = SimdKernels::get(Level);
+    std::vector<uint32_t> samples = makeFrameTimes(state.arg());
+
+    while (state.keepRunning()) {
+        doNotOptimize(kernels.sum(samples.data(), samples.size()));
+    }
+    state.setItemsPerIteration(samples.size());
+    state.setLabel(kernels.name());
+}
+
+template<SimdLevel Level>
+void benchMinMax(State& state) {
+    const SimdKernels& kernels = SimdKernels::get(Level);
+    std::vector<uint32_t> samples = makeFrameTimes(state.arg());
+
+    while (state.keepRunning()) {
+        doNotOptimize(kernels.min(samples.data(), samples.size()));
+        doNotOptimize(kernels.max(samples.data(), samples.size()));
+    }
+    state.setItemsPerIteration(samples.size());
+    state.setLabel(kernels.name());
+}
+
+template<SimdLevel Level>
+void benchCountAbove(State& state) {
+    const SimdKernels& kernels = SimdKernels::get(Level);
+    std::vector<uint32_t> samples = makeFrameTimes(state.arg());
+    uint32_t below100FPS = static_cast<uint32_t>(TICKS_PER_SECOND / 100);
+
+    while (state.keepRunning()) {
+        doNotOptimize(kernels.countAbove(samples.data(), samples.size(), below100FPS));
+    }
+    state.setItemsPerIteration(samples.size());
+    state.setLabel(kernels.name());
+}
+
+template<SimdLevel Level>
+void benchGraphTransform(State& state) {
+    const SimdKernels& kernels = SimdKernels::get(Level);
+    std::vector<uint32_t> samples = makeFrameTimes(state.arg());
+    std::vector<float> pointY(samples.size());
+
+    GraphTransform transform;
+    transform.ticksPerSecond = static_cast<float>(TICKS_PER_SECOND);
+    transform.minFPS = 50.0f;
+    transform.maxFPS = 400.0f;
+    transform.bottom = 130.0f;
+    transform.scale = 80.0f / (transform.maxFPS - transform.minFPS);
+
+    while (state.keepRunning()) {
+        kernels.toGraphY(samples.data(), samples.size(), transform, pointY.data());
+        doNotOptimize(pointY[0]);
+    }
+    state.setItemsPerIteration(samples.size());
+    state.setLabel(kernels.name());
+}
+
+} // namespace
+
+FPS_BENCHMARK("simd/sum/scalar", benchSum<SimdLevel::Scalar>, 10000, 100000, 1000000);
+FPS_BENCHMARK("simd/sum/sse4.1", benchSum<SimdLevel::SSE41>, 10000, 100000, 1000000);
+FPS_BENCHMARK("simd/sum/avx2", benchSum<SimdLevel::AVX2>, 10000, 100000, 1000000);
+
+FPS_BENCHMARK("simd/minmax/scalar", benchMinMax<SimdLevel::Scalar>, 10000, 100000, 1000000);
+FPS_BENCHMARK("simd/minmax/sse4.1", benchMinMax<SimdLevel::SSE41>, 10000, 100000, 1000000);
+FPS_BENCHMARK("simd/minmax/avx2", benchMinMax<SimdLevel::AVX2>, 10000, 100000, 1000000);
+
+FPS_BENCHMARK("simd/count_above/scalar", benchCountAbove<SimdLevel::Scalar>, 10000, 100000, 1000000);
+FPS_BENCHMARK("simd/count_above/sse4.1", benchCountAbove<SimdLevel::SSE41>, 10000, 100000, 1000000);
+FPS_BENCHMARK("simd/count_above/avx2", benchCountAbove<SimdLevel::AVX2>, 10000, 100000, 1000000);
+
+FPS_BENCHMARK("simd/graph_y/scalar", benchGraphTransform<SimdLevel::Scalar>, 10000, 100000, 1000000);
+FPS_BENCHMARK("simd/graph_y/sse4.1", benchGraphTransform<SimdLevel::SSE41>, 10000, 100000, 1000000);
+FPS_BENCHMARK("simd/graph_y/avx2", benchGraphTransform<SimdLevel::AVX2>, 10000, 100000, 1000000);
+
+} // namespace bench
+} // namespace fps_monitor
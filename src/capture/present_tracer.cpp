@@ -0,0 +1,313 @@
+#include "present_tracer.h"
+#include <cstddef>
+#include <cwchar>
+
+#pragma comment(lib, "advapi32.lib")
+
+namespace fps_monitor {
+
+namespace {
+
+// Microsoft-Windows-DXGI
+constexpr GUID DXGI_PROVIDER =
+    { 0xca11c036, 0x0102, 0x4a2d, { 0xa6, 0xad, 0xf0, 0x3c, 0xfe, 0xd5, 0xd3, 0xc9 } };
+
+// Microsoft-Windows-D3D9
+constexpr GUID D3D9_PROVIDER =
+    { 0x783aca0a, 0x790e, 0x4d7f, { 0x84, 0x51, 0xaa, 0x85, 0x05, 0x11, 0xc6, 0xb9 } };
+
+// Microsoft-Windows-DxgKrnl
+constexpr GUID DXGKRNL_PROVIDER =
+    { 0x802ec45a, 0x1e99, 0x4b83, { 0x99, 0x20, 0x87, 0xc9, 0x82, 0x77, 0xba, 0x9d } };
+
+// Event IDs used for frame timing (same events PresentMon keys on)
+constexpr USHORT DXGI_PRESENT_START = 42;
+constexpr USHORT DXGI_PRESENT_MPO_START = 55;
+constexpr USHORT D3D9_PRESENT_START = 1;
+constexpr USHORT DXGKRNL_FLIP_INFO = 168;
+constexpr USHORT DXGKRNL_PRESENT_INFO = 184;
+
+// Held by the instance that owns the trace session
+constexpr const wchar_t* OWNER_LOCK_GLOBAL = L"Global\\FPSMonitorOverlayPresentTrace.Owner";
+constexpr const wchar_t* OWNER_LOCK_LOCAL = L"Local\\FPSMonitorOverlayPresentTrace.Owner";
+
+// DxgKrnl is very chatty; only enable its Base and Present keywords
+constexpr ULONGLONG DXGKRNL_KEYWORDS = 0x1 | 0x8000000;
+
+} // namespace
+
+PresentTracer::PresentTracer()
+    : m_sessionHandle(0)
+    , m_traceHandle(INVALID_PROCESSTRACE_HANDLE)
+    , m_properties{}
+    , m_running(false)
+    , m_stopRequested(false)
+    , m_failed(false)
+    , m_exitStatus(ERROR_SUCCESS)
+    , m_ownerLock(nullptr)
+    , m_ownerInUse(false)
+    , m_droppedCount(0)
+{
+    for (size_t i = 0; i < MAX_TARGETS; ++i) {
+        m_targetPids[i] = 0;
+        m_runtimePresentSeen[i] = false;
+        m_kernelEvent[i] = KernelEvent::None;
+        m_dataEvents[i] = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    }
+}
+
+PresentTracer::~PresentTracer() {
+    stop();
+    for (HANDLE event : m_dataEvents) {
+        if (event) {
+            CloseHandle(event);
+        }
+    }
+}
+
+void PresentTracer::setPresentCallback(PresentCallback callback) {
+    m_callback = std::move(callback);
+}
+
+bool PresentTracer::start() {
+    if (m_running) {
+        return true;
+    }
+
+    // A consumer that ended on its own: join it and close its session
+    stop();
+    m_failed = false;
+
+    // The session name is system-wide: only the instance holding the owner
+    // lock may use it (without the global-namespace privilege, per logon)
+    m_ownerInUse = false;
+    m_ownerLock = CreateMutexW(nullptr, FALSE, OWNER_LOCK_GLOBAL);
+    if (!m_ownerLock) {
+        m_ownerLock = CreateMutexW(nullptr, FALSE, OWNER_LOCK_LOCAL);
+    }
+    if (!m_ownerLock) {
+        return false;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        m_ownerInUse = true;
+        stop();
+        return false;
+    }
+
+    // Nobody owns the session: stop one left behind by an instance that crashed
+    initializeProperties(m_properties);
+    ControlTraceW(0, SESSION_NAME, &m_properties.properties, EVENT_TRACE_CONTROL_STOP);
+
+    initializeProperties(m_properties);
+    ULONG status = StartTraceW(&m_sessionHandle, SESSION_NAME, &m_properties.properties);
+    if (status != ERROR_SUCCESS) {
+        m_sessionHandle = 0;
+        return false;
+    }
+
+    if (!enableProviders()) {
+        stop();
+        return false;
+    }
+
+    EVENT_TRACE_LOGFILEW logFile = {};
+    logFile.LoggerName = const_cast<LPWSTR>(SESSION_NAME);
+    logFile.ProcessTraceMode = PROCESS_TRACE_MODE_REAL_TIME |
+                               PROCESS_TRACE_MODE_EVENT_RECORD |
+                               PROCESS_TRACE_MODE_RAW_TIMESTAMP;
+    logFile.EventRecordCallback = eventRecordCallback;
+    logFile.Context = this;
+
+    m_traceHandle = OpenTraceW(&logFile);
+    if (m_traceHandle == INVALID_PROCESSTRACE_HANDLE) {
+        stop();
+        return false;
+    }
+
+    m_stopRequested = false;
+    m_running = true;
+    m_thread = std::thread(&PresentTracer::consumerThread, this);
+    return true;
+}
+
+void PresentTracer::stop() {
+    // Closing the consumer handle makes ProcessTrace return
+    m_stopRequested = true;
+    if (m_traceHandle != INVALID_PROCESSTRACE_HANDLE) {
+        CloseTrace(m_traceHandle);
+        m_traceHandle = INVALID_PROCESSTRACE_HANDLE;
+    }
+
+    if (m_sessionHandle != 0) {
+        initializeProperties(m_properties);
+        ControlTraceW(m_sessionHandle, nullptr, &m_properties.properties, EVENT_TRACE_CONTROL_STOP);
+        m_sessionHandle = 0;
+    }
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    if (m_ownerLock) {
+        CloseHandle(m_ownerLock);
+        m_ownerLock = nullptr;
+    }
+
+    m_running = false;
+}
+
+bool PresentTracer::isRunning() const {
+    return m_running;
+}
+
+bool PresentTracer::isInUseElsewhere() const {
+    return m_ownerInUse;
+}
+
+bool PresentTracer::hasFailed() const {
+    return m_failed;
+}
+
+ULONG PresentTracer::getExitStatus() const {
+    return m_exitStatus;
+}
+
+void PresentTracer::setTargetProcess(size_t slot, DWORD processId) {
+    if (slot >= MAX_TARGETS || m_targetPids[slot].exchange(processId) == processId) {
+        return;
+    }
+
+    m_runtimePresentSeen[slot] = false;
+    m_kernelEvent[slot] = KernelEvent::None;
+}
+
+DWORD PresentTracer::getTargetProcess(size_t slot) const {
+    return slot < MAX_TARGETS ? m_targetPids[slot].load() : 0;
+}
+
+uint64_t PresentTracer::getDroppedCount() const {
+    return m_droppedCount;
+}
+
+HANDLE PresentTracer::getDataEvent(size_t slot) const {
+    return slot < MAX_TARGETS ? m_dataEvents[slot] : nullptr;
+}
+
+void PresentTracer::initializeProperties(SessionProperties& props) {
+    ZeroMemory(&props, sizeof(props));
+    props.properties.Wnode.BufferSize = sizeof(SessionProperties);
+    props.properties.Wnode.Flags = WNODE_FLAG_TRACED_GUID;
+    props.properties.Wnode.ClientContext = 1; // QueryPerformanceCounter timestamps
+    props.properties.LogFileMode = EVENT_TRACE_REAL_TIME_MODE;
+    props.properties.FlushTimer = 1;          // Deliver buffers at least once per second
+    props.properties.LoggerNameOffset = offsetof(SessionProperties, loggerName);
+    wcsncpy_s(props.loggerName, SESSION_NAME, _TRUNCATE);
+}
+
+bool PresentTracer::enableProviders() {
+    bool anyEnabled = false;
+
+    ULONG status = EnableTraceEx2(m_sessionHandle, &DXGI_PROVIDER, EVENT_CONTROL_CODE_ENABLE_PROVIDER,
+                                  TRACE_LEVEL_INFORMATION, ~0ULL, 0, 0, nullptr);
+    anyEnabled |= (status == ERROR_SUCCESS);
+
+    status = EnableTraceEx2(m_sessionHandle, &D3D9_PROVIDER, EVENT_CONTROL_CODE_ENABLE_PROVIDER,
+                            TRACE_LEVEL_INFORMATION, ~0ULL, 0, 0, nullptr);
+    anyEnabled |= (status == ERROR_SUCCESS);
+
+    status = EnableTraceEx2(m_sessionHandle, &DXGKRNL_PROVIDER, EVENT_CONTROL_CODE_ENABLE_PROVIDER,
+                            TRACE_LEVEL_INFORMATION, DXGKRNL_KEYWORDS, 0, 0, nullptr);
+    anyEnabled |= (status == ERROR_SUCCESS);
+
+    return anyEnabled;
+}
+
+void PresentTracer::setThreadConfig(const ThreadConfig& config) {
+    m_threadConfig = config;
+}
+
+void PresentTracer::consumerThread() {
+    applyThreadConfig(m_threadConfig);
+
+    // Blocks until the trace handle is closed, or the session is stopped
+    // from outside (another tool, or the system on a shortage of buffers)
+    TRACEHANDLE handle = m_traceHandle;
+    ULONG status = ProcessTrace(&handle, 1, nullptr, nullptr);
+    if (!m_stopRequested) {
+        m_exitStatus = status;
+        m_failed = true;
+    }
+    m_running = false;
+}
+
+void WINAPI PresentTracer::eventRecordCallback(PEVENT_RECORD record) {
+    auto* tracer = static_cast<PresentTracer*>(record->UserContext);
+    if (tracer) {
+        tracer->handleEvent(*record);
+    }
+}
+
+void PresentTracer::handleEvent(const EVENT_RECORD& record) {
+    const EVENT_HEADER& header = record.EventHeader;
+
+    // Free slots hold 0, so process 0 would match them
+    if (header.ProcessId == 0) {
+        return;
+    }
+
+    // A handful of slots: a linear scan beats any lookup structure
+    size_t slot = 0;
+    while (slot < MAX_TARGETS && m_targetPids[slot].load(std::memory_order_relaxed) != header.ProcessId) {
+        ++slot;
+    }
+    if (slot == MAX_TARGETS) {
+        return;
+    }
+
+    const USHORT id = header.EventDescriptor.Id;
+
+    if (IsEqualGUID(header.ProviderId, DXGI_PROVIDER)) {
+        if (id == DXGI_PRESENT_START || id == DXGI_PRESENT_MPO_START) {
+            m_runtimePresentSeen[slot].store(true, std::memory_order_relaxed);
+            emitPresent(slot, header.TimeStamp.QuadPart);
+        }
+    } else if (IsEqualGUID(header.ProviderId, D3D9_PROVIDER)) {
+        if (id == D3D9_PRESENT_START) {
+            m_runtimePresentSeen[slot].store(true, std::memory_order_relaxed);
+            emitPresent(slot, header.TimeStamp.QuadPart);
+        }
+    } else if (IsEqualGUID(header.ProviderId, DXGKRNL_PROVIDER)) {
+        // Kernel presents are only used for APIs that bypass DXGI/D3D9
+        // (e.g. OpenGL, some Vulkan drivers); otherwise they'd double count
+        if (m_runtimePresentSeen[slot].load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        // A flip present logs Flip_Info, then Present_Info: count one of them
+        KernelEvent counted = m_kernelEvent[slot].load(std::memory_order_relaxed);
+        if (id == DXGKRNL_FLIP_INFO && counted != KernelEvent::PresentInfo) {
+            m_kernelEvent[slot].store(KernelEvent::Flip, std::memory_order_relaxed);
+            emitPresent(slot, header.TimeStamp.QuadPart);
+        } else if (id == DXGKRNL_PRESENT_INFO) {
+            // The first Present_Info after a flip belongs to the counted flip
+            m_kernelEvent[slot].store(KernelEvent::PresentInfo, std::memory_order_relaxed);
+            if (counted != KernelEvent::Flip) {
+                emitPresent(slot, header.TimeStamp.QuadPart);
+            }
+        }
+    }
+}
+
+void PresentTracer::emitPresent(size_t slot, int64_t qpcTimestamp) {
+    if (!m_callback || !m_callback(slot, qpcTimestamp)) {
+        m_droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Wake the consumer of the slot's queue
+    if (m_dataEvents[slot]) {
+        SetEvent(m_dataEvents[slot]);
+    }
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <windows.h>
+#include <evntrace.h>
+#include <evntcons.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include "thread_config.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Real-time ETW capture of the game's present events
+ *
+ * Runs a private real-time ETW session with the DXGI, D3D9 and DxgKrnl
+ * providers enabled and records the QPC timestamp of every present issued
+ * by the target processes. This measures the games' own frame rates without
+ * injecting into them.
+ *
+ * DXGI and D3D9 presents are timed at their Present start events. Targets
+ * that present through neither (OpenGL, some Vulkan drivers) are timed from
+ * DxgKrnl instead, one event per present: Present_Info, which the kernel
+ * logs for every present. A flip present also logs Flip_Info just before
+ * it, so Flip_Info is only counted while the target has not shown that it
+ * logs Present_Info.
+ *
+ * Up to MAX_TARGETS processes are captured at once by the one session;
+ * each target slot has its own data event, so every tracking session's
+ * consumer only wakes for its own presents.
+ *
+ * Events are consumed on a dedicated thread. The event callback performs no
+ * heap allocation; each timestamp is handed to the present callback on the
+ * consumer thread (typically FpsCalculator::submitPresent(), a wait-free
+ * SPSC queue).
+ *
+ * Starting a real-time session requires administrator rights or membership
+ * in the "Performance Log Users" group. The session name is fixed, so a
+ * named mutex makes sure only one instance runs (or cleans up) the session.
+ */
+class PresentTracer {
+public:
+    static constexpr size_t MAX_TARGETS = 4;    ///< Processes captured at once
+
+    /**
+     * @brief Callback invoked on the consumer thread for every captured present
+     * 
+     * @param slot Target slot of the presenting process
+     * @param qpcTimestamp QPC timestamp of the present
+     * @return true if the present was accepted
+     * @return false if it was dropped (counted by getDroppedCount())
+     */
+    using PresentCallback = std::function<bool(size_t slot, int64_t qpcTimestamp)>;
+
+    /**
+     * @brief Construct a new Present Tracer
+     */
+    PresentTracer();
+
+    /**
+     * @brief Destroy the Present Tracer
+     *
+     * Stops the trace session if still running.
+     */
+    ~PresentTracer();
+
+    // Prevent copying
+    PresentTracer(const PresentTracer&) = delete;
+    PresentTracer& operator=(const PresentTracer&) = delete;
+
+    /**
+     * @brief Set the present callback
+     *
+     * Must be called before start(); the callback runs on the consumer thread.
+     *
+     * @param callback Callback for captured presents
+     */
+    void setPresentCallback(PresentCallback callback);
+
+    /**
+     * @brief Set the consumer thread's priority and affinity
+     *
+     * Must be called before start(); applied when the thread starts.
+     *
+     * @param config Thread settings
+     */
+    void setThreadConfig(const ThreadConfig& config);
+
+    /**
+     * @brief Start the ETW session and the consumer thread
+     *
+     * Restarts a session that ended on its own (see hasFailed()).
+     *
+     * @return true if the session is running
+     * @return false if ETW is unavailable (e.g. insufficient privileges) or
+     *         another instance owns the session (isInUseElsewhere())
+     */
+    bool start();
+
+    /**
+     * @brief Stop the ETW session and join the consumer thread
+     */
+    void stop();
+
+    /**
+     * @brief Check if the session is running
+     *
+     * @return true if running
+     * @return false otherwise
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Check if the last start() found another instance capturing
+     *
+     * @return true if another instance owns the session
+     * @return false otherwise
+     */
+    bool isInUseElsewhere() const;
+
+    /**
+     * @brief Check if the session ended without stop() being called
+     *
+     * @return true if capture stopped unexpectedly (see getExitStatus())
+     * @return false otherwise
+     */
+    bool hasFailed() const;
+
+    /**
+     * @brief Get the ProcessTrace result of a session that ended on its own
+     *
+     * @return ULONG Win32 status (ERROR_SUCCESS unless hasFailed())
+     */
+    ULONG getExitStatus() const;
+
+    /**
+     * @brief Set the process captured in a target slot
+     *
+     * A process should only occupy one slot; presents go to the first match.
+     *
+     * @param slot Target slot (< MAX_TARGETS)
+     * @param processId Target process ID (0 to capture nothing)
+     */
+    void setTargetProcess(size_t slot, DWORD processId);
+
+    /**
+     * @brief Get the process captured in a target slot
+     *
+     * @param slot Target slot (< MAX_TARGETS)
+     * @return DWORD Target process ID (0 if none)
+     */
+    DWORD getTargetProcess(size_t slot) const;
+
+    /**
+     * @brief Get the number of presents rejected by the present callback
+     *
+     * @return uint64_t Dropped present count
+     */
+    uint64_t getDroppedCount() const;
+
+    /**
+     * @brief Get the event signalled after each accepted present of a slot
+     *
+     * Auto-reset; lets the consumer sleep until new presents are queued
+     * instead of polling.
+     *
+     * @param slot Target slot (< MAX_TARGETS)
+     * @return HANDLE Event handle (owned by the tracer)
+     */
+    HANDLE getDataEvent(size_t slot) const;
+
+private:
+    /**
+     * @brief ETW session properties with the session name appended
+     */
+    struct SessionProperties {
+        EVENT_TRACE_PROPERTIES properties;
+        wchar_t loggerName[64];
+    };
+
+    /**
+     * @brief Fill session properties for a real-time QPC-clocked session
+     *
+     * @param props Properties to initialize
+     */
+    static void initializeProperties(SessionProperties& props);
+
+    /**
+     * @brief Enable the present providers on the session
+     *
+     * @return true if at least one provider was enabled
+     * @return false otherwise
+     */
+    bool enableProviders();
+
+    /**
+     * @brief Consumer thread body (blocks in ProcessTrace)
+     */
+    void consumerThread();
+
+    /**
+     * @brief Static ETW event record callback
+     *
+     * @param record Event record (UserContext is the PresentTracer*)
+     */
+    static void WINAPI eventRecordCallback(PEVENT_RECORD record);
+
+    /**
+     * @brief Handle a single event on the consumer thread
+     *
+     * @param record Event record
+     */
+    void handleEvent(const EVENT_RECORD& record);
+
+    /**
+     * @brief Forward a present timestamp to the present callback
+     *
+     * @param slot Target slot of the presenting process
+     * @param qpcTimestamp QPC timestamp of the present
+     */
+    void emitPresent(size_t slot, int64_t qpcTimestamp);
+
+    /**
+     * @brief DxgKrnl event a target's kernel presents are counted from
+     */
+    enum class KernelEvent : uint8_t {
+        None,           ///< No kernel present seen yet
+        Flip,           ///< Flip_Info (no Present_Info seen yet)
+        PresentInfo     ///< Present_Info (Flip_Info is ignored)
+    };
+
+    TRACEHANDLE m_sessionHandle;                      ///< Controller handle
+    TRACEHANDLE m_traceHandle;                        ///< Consumer handle
+    SessionProperties m_properties;                   ///< Session properties
+    std::thread m_thread;                             ///< Consumer thread
+    std::atomic<bool> m_running;                      ///< Session running
+    std::atomic<bool> m_stopRequested;                ///< stop() is closing the session
+    std::atomic<bool> m_failed;                       ///< Session ended without stop()
+    std::atomic<ULONG> m_exitStatus;                  ///< ProcessTrace result when it failed
+    HANDLE m_ownerLock;                               ///< Named mutex held while the session is ours
+    bool m_ownerInUse;                                ///< Another instance held the lock at start()
+    std::atomic<DWORD> m_targetPids[MAX_TARGETS];     ///< Processes being captured (0 = free)
+    std::atomic<bool> m_runtimePresentSeen[MAX_TARGETS];  ///< DXGI/D3D9 presents seen per target
+    std::atomic<KernelEvent> m_kernelEvent[MAX_TARGETS];  ///< Kernel present event per target
+    std::atomic<uint64_t> m_droppedCount;             ///< Presents rejected by the callback
+    HANDLE m_dataEvents[MAX_TARGETS];                 ///< Signalled after each accepted present
+    PresentCallback m_callback;                       ///< Receives captured presents
+    ThreadConfig m_threadConfig;                      ///< Consumer thread scheduling
+
+    static constexpr const wchar_t* SESSION_NAME = L"FPSMonitorOverlayPresentTrace";
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,522 @@
+#include "analysis_thread.h"
+#include "alloc_counter.h"
+#include "frame_scheduler.h"
+#include "network_exporter.h"
+#include "shared_memory_exporter.h"
+#include "timer.h"
+
+namespace fps_monitor {
+
+AnalysisThread::AnalysisThread(const Settings& settings)
+    : m_settings(settings)
+    , m_stopRequested(false)
+    , m_resetRequested(false)
+    , m_overlayTiming(true)
+    , m_wakeEvent(CreateEventW(nullptr, FALSE, FALSE, nullptr))
+    , m_snapshotEvent(CreateEventW(nullptr, FALSE, FALSE, nullptr))
+    , m_dataEvent(nullptr)
+    , m_epoch(0)
+    , m_recorder(nullptr)
+    , m_recordedTotal(0)
+    , m_exporter(nullptr)
+    , m_network(nullptr)
+    , m_networkSession(0)
+    , m_targetProcess(0)
+    , m_dropCount(0)
+    , m_detectedTotal(0)
+    , m_detectionClock(std::chrono::steady_clock::now())
+    , m_replay(nullptr)
+    , m_replaySpeed(1.0)
+    , m_replayClock(0.0)
+    , m_replayFinished(false)
+    , m_profile{}
+    , m_profileElapsed(0.0)
+{
+    m_ingestStage = m_profiler.addStage("ingest");
+    m_statsStage = m_profiler.addStage("stats");
+    m_dropsStage = m_profiler.addStage("drops");
+    m_publishStage = m_profiler.addStage("publish");
+
+    // The window spans historySeconds at any frame rate, up to the CAPACITY
+    // samples the snapshot ring holds
+    m_fpsCalculator = std::make_unique<FpsCalculator>(AnalysisSnapshot::CAPACITY, m_settings.tickFrequency,
+                                                      m_settings.historySeconds);
+    m_statsTracker = std::make_unique<StatsTracker>(m_settings.statsUpdateMs, AnalysisSnapshot::CAPACITY,
+                                                    m_settings.percentileMode,
+                                                    m_fpsCalculator->getTickFrequency());
+    m_stutterAnalyzer = std::make_unique<StutterAnalyzer>(m_fpsCalculator->getTickFrequency(),
+                                                          m_settings.refreshRate, m_settings.stutterFactor);
+    m_dropDetector = std::make_unique<DropDetector>(m_settings.dropThresholdPercent);
+    m_dropDetector->setDropCallback([this](const DropDetector::Drop& drop) {
+        ++m_dropCount;
+        if (m_recorder) {
+            m_recorder->recordDrop(drop.currentFPS, drop.averageFPS);
+        }
+        if (m_exporter) {
+            m_exporter->addDrop(drop, m_detectedTotal, m_epoch);
+        }
+        if (m_network) {
+            m_network->submitDrop(m_networkSession, drop.currentFPS, drop.averageFPS);
+        }
+        if (m_dropCallback) {
+            m_dropCallback(drop);
+        }
+    });
+}
+
+AnalysisThread::~AnalysisThread() {
+    stop();
+
+    if (m_wakeEvent) {
+        CloseHandle(m_wakeEvent);
+    }
+    if (m_snapshotEvent) {
+        CloseHandle(m_snapshotEvent);
+    }
+}
+
+void AnalysisThread::setCaptureSource(HANDLE dataEvent, CaptureQuery isCapturing) {
+    m_dataEvent = dataEvent;
+    m_isCapturing = std::move(isCapturing);
+}
+
+void AnalysisThread::setDropCallback(DropDetector::DropCallback callback) {
+    m_dropCallback = std::move(callback);
+}
+
+void AnalysisThread::setRecorder(SessionRecorder* recorder) {
+    m_recorder = recorder;
+}
+
+void AnalysisThread::setExporter(SharedMemoryExporter* exporter) {
+    m_exporter = exporter;
+}
+
+void AnalysisThread::setNetworkExporter(NetworkExporter* exporter, size_t session) {
+    m_network = exporter;
+    m_networkSession = session;
+}
+
+void AnalysisThread::setReplaySource(ReplaySource* source, double speed, uint64_t startTime) {
+    m_replay = source;
+    m_replaySpeed = std::max(0.0, speed);
+    m_replayClock = static_cast<double>(startTime);
+    m_replayFinished = false;
+    if (m_replay) {
+        m_replay->seek(startTime);
+    }
+}
+
+bool AnalysisThread::start() {
+    if (m_thread.joinable()) {
+        return true;
+    }
+    if (!m_wakeEvent || !m_snapshotEvent) {
+        return false;
+    }
+
+    m_stopRequested = false;
+    m_thread = std::thread(&AnalysisThread::threadMain, this);
+    return true;
+}
+
+void AnalysisThread::stop() {
+    if (!m_thread.joinable()) {
+        return;
+    }
+
+    m_stopRequested = true;
+    SetEvent(m_wakeEvent);
+    m_thread.join();
+}
+
+void AnalysisThread::setOverlayTiming(bool enabled) {
+    if (m_overlayTiming.exchange(enabled) != enabled && m_wakeEvent) {
+        SetEvent(m_wakeEvent);
+    }
+}
+
+bool AnalysisThread::submitPresent(int64_t qpcTimestamp) {
+    return m_fpsCalculator->submitPresent(qpcTimestamp);
+}
+
+void AnalysisThread::requestReset(uint32_t processId, const std::string& targetName) {
+    {
+        std::lock_guard<std::mutex> lock(m_targetMutex);
+        m_targetProcess = processId;
+        m_targetName = targetName;
+    }
+    m_resetRequested = true;
+    if (m_wakeEvent) {
+        SetEvent(m_wakeEvent);
+    }
+}
+
+void AnalysisThread::updateSettings(const LiveSettings& settings) {
+    m_liveSettings.back() = settings;
+    m_liveSettings.publish();
+    if (m_wakeEvent) {
+        SetEvent(m_wakeEvent);
+    }
+}
+
+HANDLE AnalysisThread::getSnapshotEvent() const {
+    return m_snapshotEvent;
+}
+
+bool AnalysisThread::acquireSnapshot() {
+    return m_snapshots.acquire();
+}
+
+const AnalysisSnapshot& AnalysisThread::getSnapshot() const {
+    return m_snapshots.front();
+}
+
+int64_t AnalysisThread::getTickFrequency() const {
+    return m_fpsCalculator->getTickFrequency();
+}
+
+void AnalysisThread::threadMain() {
+    applyThreadConfig(m_settings.thread);
+
+    // Same wait primitive as the UI thread; without a high-resolution timer
+    // the scheduler falls back to wait timeouts
+    FrameScheduler scheduler;
+    scheduler.initialize(m_settings.tickIntervalMs);
+    scheduler.addHandle(m_wakeEvent);
+    size_t dataHandle = FrameScheduler::INVALID_HANDLE_ID;
+    if (m_dataEvent) {
+        dataHandle = scheduler.addHandle(m_dataEvent);
+    }
+
+    Timer timer;
+    timer.start();
+
+    FrameScheduler::WakeReason wake = FrameScheduler::WakeReason::Timeout;
+    double overlayFrameTime = 0.0;
+    uint64_t iterations = 0;
+    bool changed = true; // Publish the empty state so readers see the tick rate
+
+    m_replayOrigin = std::chrono::steady_clock::now();
+
+    while (!m_stopRequested) {
+        double deltaTime = timer.getDeltaTime();
+        bool capturing = !m_replay && m_isCapturing && m_isCapturing();
+        bool overlayTiming = !capturing && !m_replay && m_overlayTiming;
+        bool replaying = m_replay && !m_replayFinished;
+        bool fastReplay = replaying && m_replaySpeed == 0.0;
+
+        // Overlay timing only counts ticking periods (not time spent waiting
+        // for a reset or with timing disabled)
+        overlayFrameTime = overlayTiming ? overlayFrameTime + deltaTime : 0.0;
+        m_profileElapsed += deltaTime;
+
+        // Rare, and copies the target name: outside the checked region
+        if (m_resetRequested.exchange(false)) {
+            applyReset();
+            overlayFrameTime = 0.0;
+            changed = true;
+        }
+
+        // Nothing fresh costs one atomic load
+        if (m_liveSettings.acquire()) {
+            const LiveSettings& live = m_liveSettings.front();
+            m_statsTracker->setUpdateInterval(live.statsUpdateMs);
+            m_dropDetector->setThreshold(live.dropThresholdPercent);
+            m_stutterAnalyzer->setMedianFactor(live.stutterFactor);
+            scheduler.setPeriod(live.tickIntervalMs);
+        }
+
+        // Steady state must not touch the heap (checked in debug builds);
+        // replay is offline and logs its per-frame drops
+        ++iterations;
+        {
+            ScopedAllocationCheck noAllocs(iterations > WARMUP_ITERATIONS && !m_replay);
+
+            if (replaying) {
+                StageProfiler::Scope ingest(m_profiler, m_ingestStage);
+                changed = replayFrames(deltaTime) || changed;
+            } else if (capturing) {
+                // Drain in chunks the calculator retains: each chunk is recorded
+                // and fed to the statistics before the next one pushes it out
+                StageProfiler::Scope ingest(m_profiler, m_ingestStage);
+                size_t drained = 0;
+                size_t count = 0;
+                while (drained < MAX_DRAIN_PER_WAKE
+                       && (count = m_fpsCalculator->processPending(FpsCalculator::MAX_HISTORY)) > 0) {
+                    recordSamples();
+                    updateStatistics(false);
+                    drained += count;
+                    changed = true;
+                }
+            } else if (wake == FrameScheduler::WakeReason::Frame && overlayFrameTime > 0.0) {
+                StageProfiler::Scope ingest(m_profiler, m_ingestStage);
+                m_fpsCalculator->update(overlayFrameTime);
+                recordSamples();
+                overlayFrameTime = 0.0;
+                changed = true;
+            }
+
+            if (changed) {
+                // The final replay statistics must not wait for the interval
+                StageProfiler::Scope stats(m_profiler, m_statsStage);
+                updateStatistics(m_replayFinished);
+            }
+        }
+
+        if (changed) {
+            // The drop callback may log, so it runs outside the checked region
+            if (!m_replay) {
+                StageProfiler::Scope drops(m_profiler, m_dropsStage);
+                detectDrops();
+            }
+
+            if (m_profileElapsed >= PROFILE_INTERVAL) {
+                m_profiler.summarize(m_profile);
+                m_profileElapsed = 0.0;
+            }
+
+            StageProfiler::Scope publish(m_profiler, m_publishStage);
+            publishSnapshot();
+            SetEvent(m_snapshotEvent);
+            changed = false;
+        }
+
+        // As fast as possible: keep going until the recording ends
+        if (fastReplay && !m_replayFinished) {
+            wake = FrameScheduler::WakeReason::Frame;
+            continue;
+        }
+
+        // Capturing: sleep until the tracer queues presents. Otherwise tick
+        // at the configured rate (overlay timing, real-time replay), or only
+        // wake for stop/reset/timing/settings changes
+        scheduler.setFrameEnabled(overlayTiming || (m_replay && !m_replayFinished));
+        scheduler.setHandleEnabled(dataHandle, capturing);
+        wake = scheduler.wait(INFINITE);
+    }
+}
+
+void AnalysisThread::applyReset() {
+    m_fpsCalculator->reset();
+    m_statsTracker->reset();
+    m_stutterAnalyzer->reset();
+    m_recordedTotal = 0;
+    m_detectedTotal = 0;
+    m_detectionClock = std::chrono::steady_clock::now();
+    ++m_epoch;
+
+    if (!m_recorder && !m_exporter && !m_network) {
+        return;
+    }
+
+    uint32_t processId = 0;
+    std::string name;
+    {
+        std::lock_guard<std::mutex> lock(m_targetMutex);
+        processId = m_targetProcess;
+        name = m_targetName;
+    }
+
+    if (m_recorder) {
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        m_recorder->recordTarget(processId, name, now.QuadPart);
+    }
+    if (m_exporter) {
+        m_exporter->setTarget(processId, name);
+    }
+    if (m_network) {
+        m_network->submitTarget(m_networkSession, processId, name);
+    }
+}
+
+void AnalysisThread::updateStatistics(bool force) {
+    // New frames may already have left the time-limited window
+    SampleView<uint32_t> retained = m_fpsCalculator->getRetainedView();
+    uint64_t total = m_fpsCalculator->getTotalSamples();
+    m_statsTracker->addSamples(retained, total);
+    m_statsTracker->update(m_fpsCalculator->getSampleView(), total, force);
+    m_stutterAnalyzer->update(retained, total);
+}
+
+void AnalysisThread::recordSamples() {
+    uint64_t total = m_fpsCalculator->getTotalSamples();
+    if (m_recorder || m_network) {
+        SampleView<uint32_t> samples = m_fpsCalculator->getRetainedView();
+        size_t count = static_cast<size_t>(std::min<uint64_t>(total - m_recordedTotal, samples.size()));
+        for (size_t i = samples.size() - count; i < samples.size(); ++i) {
+            if (m_recorder) {
+                m_recorder->recordFrame(samples[i]);
+            }
+            if (m_network) {
+                m_network->submitFrame(m_networkSession, samples[i]);
+            }
+        }
+    }
+    m_recordedTotal = total;
+}
+
+void AnalysisThread::detectDrops() {
+    SampleView<uint32_t> samples = m_fpsCalculator->getRetainedView();
+    uint64_t total = m_fpsCalculator->getTotalSamples();
+    size_t count = static_cast<size_t>(std::min<uint64_t>(total - m_detectedTotal, samples.size()));
+    double frequency = static_cast<double>(m_fpsCalculator->getTickFrequency());
+    double average = m_fpsCalculator->getAverageFPS();
+
+    // Presents arrive in batches: check every frame, debounced on the
+    // frames' own clock (as replay does), against the window average
+    m_detectedTotal = total - count;
+    for (size_t i = samples.size() - count; i < samples.size(); ++i) {
+        uint32_t ticks = samples[i];
+        m_detectionClock += std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(ticks / frequency));
+        ++m_detectedTotal;
+        m_dropDetector->update(frequency / ticks, average, m_detectionClock);
+    }
+}
+
+bool AnalysisThread::replayFrames(double deltaTime) {
+    double frequency = static_cast<double>(m_fpsCalculator->getTickFrequency());
+
+    // Real time: frames up to the advanced clock; otherwise one window
+    uint64_t until = UINT64_MAX;
+    if (m_replaySpeed > 0.0) {
+        m_replayClock += deltaTime * m_replaySpeed * frequency;
+        until = static_cast<uint64_t>(m_replayClock);
+    }
+
+    // Frames per call stay within the retained samples so StatsTracker sees them all
+    size_t frames = 0;
+    bool consumed = false;
+    while (frames < AnalysisSnapshot::CAPACITY) {
+        const RecordingReader::Record* record = m_replay->peek();
+        if (!record) {
+            m_replayFinished = true;
+            break;
+        }
+        if (record->time > until) {
+            break;
+        }
+
+        if (record->type == RecordingReader::Record::Type::Frame) {
+            m_fpsCalculator->addFrameTime(record->ticks);
+            m_detectedTotal = m_fpsCalculator->getTotalSamples();
+            ++frames;
+
+            // Debounce on the recording's clock, not the replay speed
+            auto frameTime = m_replayOrigin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(static_cast<double>(record->time) / frequency));
+            m_dropDetector->update(m_fpsCalculator->getCurrentFPS(), m_fpsCalculator->getAverageFPS(), frameTime);
+        } else if (record->type == RecordingReader::Record::Type::Target) {
+            // New capture target: start over, as the live session did
+            updateStatistics(false);
+            m_fpsCalculator->reset();
+            m_statsTracker->reset();
+            m_stutterAnalyzer->reset();
+            ++m_epoch;
+            frames = 0;
+        }
+        // Recorded drops are re-detected instead
+
+        m_replayClock = std::max(m_replayClock, static_cast<double>(record->time));
+        m_replay->pop();
+        consumed = true;
+    }
+
+    return consumed || m_replayFinished;
+}
+
+void AnalysisThread::publishSnapshot() {
+    AnalysisSnapshot& snapshot = m_snapshots.back();
+
+    SampleView<uint32_t> samples = m_fpsCalculator->getSampleView();
+    uint64_t total = m_fpsCalculator->getTotalSamples();
+    size_t count = samples.size();
+
+    // The back slot holds an older snapshot; within the same epoch only the
+    // samples added since then are missing (earlier ones sit at the same ring
+    // positions and are still in the window)
+    size_t copyCount = count;
+    if (snapshot.epoch == m_epoch && snapshot.tickFrequency != 0 && total >= snapshot.totalSamples
+        && total - snapshot.totalSamples < count) {
+        copyCount = static_cast<size_t>(total - snapshot.totalSamples);
+    }
+
+    uint64_t firstSample = total - count;
+    for (size_t i = count - copyCount; i < count; ++i) {
+        snapshot.samples[(firstSample + i) % AnalysisSnapshot::CAPACITY] = samples[i];
+    }
+
+    // Same for the history tiers (a few buckets per second)
+    bool sameEpoch = snapshot.epoch == m_epoch && snapshot.tickFrequency != 0;
+    copyBuckets(snapshot, HistoryTiers::Tier::Fine, sameEpoch,
+                snapshot.fineBuckets, AnalysisSnapshot::FINE_CAPACITY);
+    copyBuckets(snapshot, HistoryTiers::Tier::Coarse, sameEpoch,
+                snapshot.coarseBuckets, AnalysisSnapshot::COARSE_CAPACITY);
+    copyStutters(snapshot, sameEpoch);
+
+    snapshot.sampleCount = count;
+    snapshot.totalSamples = total;
+    snapshot.epoch = m_epoch;
+    snapshot.tickFrequency = m_fpsCalculator->getTickFrequency();
+    snapshot.currentFPS = m_fpsCalculator->getCurrentFPS();
+    snapshot.averageFPS = m_fpsCalculator->getAverageFPS();
+    snapshot.minFPS = m_fpsCalculator->getMinFPS();
+    snapshot.maxFPS = m_fpsCalculator->getMaxFPS();
+    snapshot.stats = m_statsTracker->getStats();
+    snapshot.sessionStats = m_statsTracker->getSessionStats();
+    snapshot.stutterStats = m_stutterAnalyzer->getStats();
+    snapshot.dropCount = m_dropCount;
+    snapshot.replayTime = static_cast<uint64_t>(m_replayClock);
+    snapshot.replayFinished = m_replayFinished;
+    snapshot.profile = m_profile;
+
+    if (m_exporter) {
+        m_exporter->publish(snapshot);
+    }
+    m_snapshots.publish();
+}
+
+void AnalysisThread::copyBuckets(AnalysisSnapshot& snapshot, HistoryTiers::Tier tier, bool sameEpoch,
+                                 HistoryTiers::Bucket* ring, size_t capacity) const {
+    const HistoryTiers& history = m_statsTracker->getHistory();
+    SampleView<HistoryTiers::Bucket> buckets = history.getView(tier);
+    uint64_t total = history.getTotalBuckets(tier);
+    size_t count = buckets.size();
+    size_t index = static_cast<size_t>(tier);
+
+    size_t copyCount = count;
+    if (sameEpoch && total >= snapshot.totalBuckets[index] && total - snapshot.totalBuckets[index] < count) {
+        copyCount = static_cast<size_t>(total - snapshot.totalBuckets[index]);
+    }
+
+    uint64_t firstBucket = total - count;
+    for (size_t i = count - copyCount; i < count; ++i) {
+        ring[(firstBucket + i) % capacity] = buckets[i];
+    }
+
+    snapshot.bucketCounts[index] = count;
+    snapshot.totalBuckets[index] = total;
+}
+
+void AnalysisThread::copyStutters(AnalysisSnapshot& snapshot, bool sameEpoch) const {
+    SampleView<StutterAnalyzer::Stutter> stutters = m_stutterAnalyzer->getStutters();
+    uint64_t total = m_stutterAnalyzer->getTotalStutters();
+    size_t count = stutters.size();
+
+    size_t copyCount = count;
+    if (sameEpoch && total >= snapshot.totalStutters && total - snapshot.totalStutters < count) {
+        copyCount = static_cast<size_t>(total - snapshot.totalStutters);
+    }
+
+    uint64_t firstStutter = total - count;
+    for (size_t i = count - copyCount; i < count; ++i) {
+        snapshot.stutters[(firstStutter + i) % AnalysisSnapshot::STUTTER_CAPACITY] = stutters[i];
+    }
+
+    snapshot.stutterCount = count;
+    snapshot.totalStutters = total;
+}
+
+} // namespace fps_monitor
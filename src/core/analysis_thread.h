@@ -0,0 +1,439 @@
+#pragma once
+
+#include <windows.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "fps_calculator.h"
+#include "stats_tracker.h"
+#include "drop_detector.h"
+#include "stutter_analyzer.h"
+#include "triple_buffer.h"
+#include "sample_view.h"
+#include "thread_config.h"
+#include "stage_profiler.h"
+#include "session_recorder.h"
+#include "replay_source.h"
+
+namespace fps_monitor {
+
+class SharedMemoryExporter;
+class NetworkExporter;
+
+/**
+ * @brief Immutable analysis results handed to the render thread
+ * 
+ * Frame times are stored at (absolute sample number % CAPACITY), so the
+ * analysis thread only copies the samples a slot is missing when it
+ * reuses it. History buckets are stored the same way per tier, and
+ * stutters at (absolute stutter number % STUTTER_CAPACITY).
+ */
+struct AnalysisSnapshot {
+    static constexpr size_t CAPACITY = FpsCalculator::MAX_HISTORY;   ///< Largest sample window (caps high frame rates)
+    static constexpr size_t FINE_CAPACITY = HistoryTiers::FINE_CAPACITY;       ///< 100 ms buckets
+    static constexpr size_t COARSE_CAPACITY = HistoryTiers::COARSE_CAPACITY;   ///< 1 s buckets
+    static constexpr size_t STUTTER_CAPACITY = StutterAnalyzer::HISTORY_CAPACITY; ///< Recent stutters
+
+    uint32_t samples[CAPACITY];     ///< Frame times in ticks (ring, see above)
+    HistoryTiers::Bucket fineBuckets[FINE_CAPACITY];        ///< Fine tier (ring)
+    HistoryTiers::Bucket coarseBuckets[COARSE_CAPACITY];    ///< Coarse tier (ring)
+    size_t bucketCounts[HistoryTiers::TIER_COUNT];          ///< Buckets kept per tier
+    uint64_t totalBuckets[HistoryTiers::TIER_COUNT];        ///< HistoryTiers::getTotalBuckets() per tier
+    StutterAnalyzer::Stutter stutters[STUTTER_CAPACITY];    ///< Recent stutters (ring)
+    size_t stutterCount;                                    ///< Stutters kept
+    uint64_t totalStutters;                                 ///< StutterAnalyzer::getTotalStutters()
+    size_t sampleCount;             ///< Samples in the window
+    uint64_t totalSamples;          ///< FpsCalculator::getTotalSamples()
+    uint64_t epoch;                 ///< Incremented by every reset
+    int64_t tickFrequency;          ///< Ticks per second of the samples
+    double currentFPS;              ///< FpsCalculator::getCurrentFPS()
+    double averageFPS;              ///< FpsCalculator::getAverageFPS()
+    double minFPS;                  ///< FpsCalculator::getMinFPS()
+    double maxFPS;                  ///< FpsCalculator::getMaxFPS()
+    StatsTracker::Stats stats;      ///< StatsTracker::getStats()
+    StatsTracker::Stats sessionStats;   ///< StatsTracker::getSessionStats()
+    StutterAnalyzer::Stats stutterStats;    ///< StutterAnalyzer::getStats()
+    uint64_t dropCount;             ///< Drops detected since the thread started
+    uint64_t replayTime;            ///< Replay position in ticks (replay only)
+    bool replayFinished;            ///< Whole recording replayed (replay only)
+    StageProfiler::Summary profile; ///< Analysis stage timings (refreshed once per second)
+
+    /**
+     * @brief Get the sample window (oldest to newest)
+     * 
+     * @return SampleView<uint32_t> View into samples (valid as long as the snapshot)
+     */
+    SampleView<uint32_t> getSampleView() const {
+        size_t start = static_cast<size_t>((totalSamples - sampleCount) % CAPACITY);
+        size_t firstSize = std::min(sampleCount, CAPACITY - start);
+        return SampleView<uint32_t>(samples + start, firstSize, samples, sampleCount - firstSize);
+    }
+
+    /**
+     * @brief Get the buckets of a history tier (oldest to newest)
+     * 
+     * @param tier Aggregation level
+     * @return SampleView<HistoryTiers::Bucket> View into the tier (valid as long as the snapshot)
+     */
+    SampleView<HistoryTiers::Bucket> getBucketView(HistoryTiers::Tier tier) const {
+        size_t index = static_cast<size_t>(tier);
+        const HistoryTiers::Bucket* ring = (tier == HistoryTiers::Tier::Coarse) ? coarseBuckets : fineBuckets;
+        size_t capacity = (tier == HistoryTiers::Tier::Coarse) ? COARSE_CAPACITY : FINE_CAPACITY;
+        size_t count = bucketCounts[index];
+        size_t start = static_cast<size_t>((totalBuckets[index] - count) % capacity);
+        size_t firstSize = std::min(count, capacity - start);
+        return SampleView<HistoryTiers::Bucket>(ring + start, firstSize, ring, count - firstSize);
+    }
+
+    /**
+     * @brief Get the recent stutters (oldest to newest)
+     * 
+     * @return SampleView<StutterAnalyzer::Stutter> View into stutters (valid as long as the snapshot)
+     */
+    SampleView<StutterAnalyzer::Stutter> getStutterView() const {
+        size_t start = static_cast<size_t>((totalStutters - stutterCount) % STUTTER_CAPACITY);
+        size_t firstSize = std::min(stutterCount, STUTTER_CAPACITY - start);
+        return SampleView<StutterAnalyzer::Stutter>(stutters + start, firstSize, stutters, stutterCount - firstSize);
+    }
+};
+
+/**
+ * @brief Analysis stage of the capture -> analysis -> render pipeline
+ * 
+ * Threading model:
+ * - Capture thread (PresentTracer's ETW consumer) calls submitPresent(),
+ *   the producer side of FpsCalculator's SPSC queue.
+ * - The analysis thread owns FpsCalculator, StatsTracker, StutterAnalyzer
+ *   and DropDetector.
+ *   It wakes on the capture data event (or, without capture, on a timer
+ *   measuring its own tick rate), ingests the queued presents, updates the
+ *   statistics and publishes an AnalysisSnapshot through a TripleBuffer.
+ * - The render (UI) thread calls acquireSnapshot()/getSnapshot() and only
+ *   ever reads the snapshot, so a slow EndDraw never delays ingestion.
+ * 
+ * requestReset() may be called from any thread; it also wakes the analysis
+ * thread so a change of capture target is picked up immediately.
+ * updateSettings() hands reloaded settings over through a second
+ * TripleBuffer, so neither side takes a lock for it.
+ * 
+ * With a SessionRecorder attached, every new sample, drop and target
+ * change is also streamed to disk from the analysis thread. With a
+ * SharedMemoryExporter attached, every published snapshot, drop and target
+ * change is also written to its shared-memory section; with a
+ * NetworkExporter, new samples, drops and target changes are queued for
+ * streaming to a collector.
+ * 
+ * With a ReplaySource attached, capture is replaced by a recording played
+ * back at a given speed (or as fast as possible). Drops are re-detected
+ * per frame on the recording's own clock, so a capture can be
+ * re-analysed with different thresholds.
+ */
+class AnalysisThread {
+public:
+    /**
+     * @brief Analysis configuration
+     */
+    struct Settings {
+        double historySeconds;              ///< Time span of the graphing/averaging window
+        int statsUpdateMs;                  ///< StatsTracker update interval
+        PercentileMode percentileMode;      ///< StatsTracker percentile backend
+        double dropThresholdPercent;        ///< DropDetector threshold
+        double stutterFactor;               ///< StutterAnalyzer median factor
+        double refreshRate;                 ///< Display refresh rate for hitch counts (0 = unknown)
+        int tickIntervalMs;                 ///< Frame period when not capturing
+        int64_t tickFrequency;              ///< Sample tick rate (0 = QPC; the recording's for replay)
+        ThreadConfig thread;                ///< Analysis thread scheduling
+    };
+
+    /**
+     * @brief Settings that can change while the thread runs
+     */
+    struct LiveSettings {
+        int statsUpdateMs;                  ///< StatsTracker update interval
+        double dropThresholdPercent;        ///< DropDetector threshold
+        double stutterFactor;               ///< StutterAnalyzer median factor
+        int tickIntervalMs;                 ///< Frame period when not capturing
+    };
+
+    /**
+     * @brief Query run on the analysis thread: are presents being captured?
+     */
+    using CaptureQuery = std::function<bool()>;
+
+    /**
+     * @brief Construct a new Analysis Thread (not started)
+     * 
+     * @param settings Analysis configuration
+     */
+    explicit AnalysisThread(const Settings& settings);
+
+    /**
+     * @brief Destroy the Analysis Thread (stops it)
+     */
+    ~AnalysisThread();
+
+    // Prevent copying
+    AnalysisThread(const AnalysisThread&) = delete;
+    AnalysisThread& operator=(const AnalysisThread&) = delete;
+
+    /**
+     * @brief Set the capture source
+     * 
+     * Must be called before start().
+     * 
+     * @param dataEvent Event signalled when presents are queued
+     *                  (PresentTracer::getDataEvent()), or nullptr
+     * @param isCapturing Whether presents are being captured; otherwise the
+     *                    thread's own tick rate is measured
+     */
+    void setCaptureSource(HANDLE dataEvent, CaptureQuery isCapturing);
+
+    /**
+     * @brief Set the drop callback
+     * 
+     * Must be called before start(); runs on the analysis thread.
+     * 
+     * @param callback Drop callback
+     */
+    void setDropCallback(DropDetector::DropCallback callback);
+
+    /**
+     * @brief Attach a session recorder
+     * 
+     * Must be called before start(); the recorder must outlive the thread.
+     * 
+     * @param recorder Open recorder, or nullptr
+     */
+    void setRecorder(SessionRecorder* recorder);
+
+    /**
+     * @brief Attach a shared-memory exporter
+     * 
+     * Must be called before start(); the exporter must outlive the thread.
+     * 
+     * @param exporter Open exporter, or nullptr
+     */
+    void setExporter(SharedMemoryExporter* exporter);
+
+    /**
+     * @brief Attach a network exporter
+     * 
+     * Must be called before start(); the exporter must outlive the thread.
+     * 
+     * @param exporter Running exporter (shared by every session), or nullptr
+     * @param session Session index the records are tagged with
+     */
+    void setNetworkExporter(NetworkExporter* exporter, size_t session);
+
+    /**
+     * @brief Replay a recording instead of capturing
+     * 
+     * Must be called before start(); the source must outlive the thread and
+     * Settings::tickFrequency must match the recording.
+     * 
+     * @param source Open replay source
+     * @param speed Playback speed (1 = real time, 0 = as fast as possible)
+     * @param startTime First replayed time in ticks
+     */
+    void setReplaySource(ReplaySource* source, double speed, uint64_t startTime);
+
+    /**
+     * @brief Start the analysis thread
+     * 
+     * @return true if the thread is running
+     * @return false otherwise
+     */
+    bool start();
+
+    /**
+     * @brief Stop and join the analysis thread
+     */
+    void stop();
+
+    /**
+     * @brief Enable or disable overlay timing
+     * 
+     * While no presents are captured the thread samples its own tick rate;
+     * disabled (e.g. overlay hidden) it sleeps until woken instead.
+     * 
+     * @param enabled Tick while not capturing
+     */
+    void setOverlayTiming(bool enabled);
+
+    /**
+     * @brief Queue a captured present (capture thread only)
+     * 
+     * @param qpcTimestamp QPC timestamp of the present
+     * @return true if queued
+     * @return false if the queue is full
+     */
+    bool submitPresent(int64_t qpcTimestamp);
+
+    /**
+     * @brief Ask the analysis thread to clear samples and statistics
+     * 
+     * @param processId New capture target (0 for overlay timing)
+     * @param targetName Target name (recorded with the change)
+     */
+    void requestReset(uint32_t processId, const std::string& targetName);
+
+    /**
+     * @brief Apply new settings on the analysis thread
+     * 
+     * Call from one thread only (the UI thread); the latest value wins if
+     * several arrive before the analysis thread wakes.
+     * 
+     * @param settings New settings
+     */
+    void updateSettings(const LiveSettings& settings);
+
+    /**
+     * @brief Get the event signalled after each published snapshot
+     * 
+     * Auto-reset; lets the render thread sleep until there is something new.
+     * 
+     * @return HANDLE Event handle (owned by the analysis thread)
+     */
+    HANDLE getSnapshotEvent() const;
+
+    /**
+     * @brief Take the latest published snapshot (render thread only)
+     * 
+     * @return true if a newer snapshot was acquired
+     * @return false if nothing was published since the last call
+     */
+    bool acquireSnapshot();
+
+    /**
+     * @brief Get the last acquired snapshot (render thread only)
+     * 
+     * @return const AnalysisSnapshot& Snapshot (unchanged until the next acquireSnapshot())
+     */
+    const AnalysisSnapshot& getSnapshot() const;
+
+    /**
+     * @brief Get the tick rate of the samples
+     * 
+     * @return int64_t Ticks per second
+     */
+    int64_t getTickFrequency() const;
+
+private:
+    /**
+     * @brief Analysis thread body
+     */
+    void threadMain();
+
+    /**
+     * @brief Copy the current results into the back snapshot and publish it
+     */
+    void publishSnapshot();
+
+    /**
+     * @brief Copy the buckets of a tier the back snapshot is missing
+     * 
+     * @param snapshot Back snapshot
+     * @param tier Aggregation level
+     * @param sameEpoch The snapshot was published since the last reset
+     * @param ring Snapshot storage of the tier
+     * @param capacity Ring capacity
+     */
+    void copyBuckets(AnalysisSnapshot& snapshot, HistoryTiers::Tier tier, bool sameEpoch,
+                     HistoryTiers::Bucket* ring, size_t capacity) const;
+
+    /**
+     * @brief Copy the stutters the back snapshot is missing
+     * 
+     * @param snapshot Back snapshot
+     * @param sameEpoch The snapshot was published since the last reset
+     */
+    void copyStutters(AnalysisSnapshot& snapshot, bool sameEpoch) const;
+
+    /**
+     * @brief Feed the samples added since the last call to the statistics
+     * 
+     * @param force Recalculate the statistics now (StatsTracker::update())
+     */
+    void updateStatistics(bool force);
+
+    /**
+     * @brief Apply a pending reset and record the new target
+     */
+    void applyReset();
+
+    /**
+     * @brief Record and stream the samples added since the last call
+     */
+    void recordSamples();
+
+    /**
+     * @brief Check every sample added since the last call for a drop (live)
+     */
+    void detectDrops();
+
+    /**
+     * @brief Feed the replay frames that are due
+     * 
+     * Advances the replay clock by deltaTime at the replay speed; as fast as
+     * possible feeds AnalysisSnapshot::CAPACITY frames per call.
+     * 
+     * @param deltaTime Seconds since the previous call
+     * @return true if any record was consumed
+     * @return false otherwise
+     */
+    bool replayFrames(double deltaTime);
+
+    Settings m_settings;                                ///< Analysis configuration
+    std::unique_ptr<FpsCalculator> m_fpsCalculator;     ///< Frame times (analysis thread)
+    std::unique_ptr<StatsTracker> m_statsTracker;       ///< Statistics (analysis thread)
+    std::unique_ptr<StutterAnalyzer> m_stutterAnalyzer; ///< Frame pacing (analysis thread)
+    std::unique_ptr<DropDetector> m_dropDetector;       ///< Drops (analysis thread)
+    TripleBuffer<AnalysisSnapshot> m_snapshots;         ///< Analysis -> render hand-off
+    TripleBuffer<LiveSettings> m_liveSettings;          ///< Render -> analysis settings hand-off
+    std::thread m_thread;                               ///< Analysis thread
+    std::atomic<bool> m_stopRequested;                  ///< Thread should exit
+    std::atomic<bool> m_resetRequested;                 ///< Reset pending
+    std::atomic<bool> m_overlayTiming;                  ///< Tick while not capturing
+    HANDLE m_wakeEvent;                                 ///< Wakes the thread for stop/reset/settings
+    HANDLE m_snapshotEvent;                             ///< Signalled after each publish
+    HANDLE m_dataEvent;                                 ///< Capture data event (not owned)
+    CaptureQuery m_isCapturing;                         ///< Capture state query
+    uint64_t m_epoch;                                   ///< Reset count (analysis thread)
+    DropDetector::DropCallback m_dropCallback;          ///< User drop callback
+    SessionRecorder* m_recorder;                        ///< Optional recorder (not owned)
+    uint64_t m_recordedTotal;                           ///< Samples recorded so far
+    SharedMemoryExporter* m_exporter;                   ///< Optional exporter (not owned)
+    NetworkExporter* m_network;                         ///< Optional network exporter (not owned)
+    size_t m_networkSession;                            ///< Session index sent with every record
+    std::mutex m_targetMutex;                           ///< Guards the pending target
+    uint32_t m_targetProcess;                           ///< Target of the pending reset
+    std::string m_targetName;                           ///< Name of the pending target
+    uint64_t m_dropCount;                               ///< Drops detected (analysis thread)
+    uint64_t m_detectedTotal;                           ///< Samples checked for drops so far
+    std::chrono::steady_clock::time_point m_detectionClock; ///< Time of the newest checked sample
+    ReplaySource* m_replay;                             ///< Optional replay (not owned)
+    double m_replaySpeed;                               ///< Playback speed (0 = unthrottled)
+    double m_replayClock;                               ///< Replay position in ticks
+    bool m_replayFinished;                              ///< End of the recording reached
+    std::chrono::steady_clock::time_point m_replayOrigin;   ///< Clock of replay time 0
+    StageProfiler m_profiler;                           ///< Stage timings (analysis thread)
+    StageProfiler::Summary m_profile;                   ///< Last summary of m_profiler
+    double m_profileElapsed;                            ///< Seconds since the last summary
+    size_t m_ingestStage;                               ///< Profiler stage: presents/frames in
+    size_t m_statsStage;                                ///< Profiler stage: StatsTracker
+    size_t m_dropsStage;                                ///< Profiler stage: DropDetector
+    size_t m_publishStage;                              ///< Profiler stage: snapshot publish
+
+    static constexpr uint64_t WARMUP_ITERATIONS = 120;  ///< Iterations before allocation checks
+    static constexpr size_t MAX_DRAIN_PER_WAKE = 1024;  ///< Presents ingested before publishing
+    static constexpr double PROFILE_INTERVAL = 1.0;     ///< Seconds between profiler summaries
+};
+
+} // namespace fps_monitor
@@ -5,8 +5,11 @@
 
 namespace fps_monitor {
 
-Config::Config() {
+Config::Config()
+    : m_version(0)
+{
     initializeDefaults();
+    publish();
 }
 
 Config::~Config() = default;
@@ -23,13 +26,16 @@ void Config::initializeDefaults() {
 
     // Graph defaults
     m_graphSettings.historySeconds = 2.0;
+    m_graphSettings.viewSeconds = 0.0;
     m_graphSettings.showGrid = false;
+    m_graphSettings.showFill = false;
     m_graphSettings.lineWidth = 2.0;
     m_graphSettings.antiAliasing = true;
     m_graphSettings.colorMode = "solid";
 
     // Detection defaults
     m_detectionSettings.dropThresholdPercent = 15.0;
+    m_detectionSettings.stutterFactor = 2.0;
     m_detectionSettings.showDropMarkers = true;
     m_detectionSettings.flashOnDrop = true;
     m_detectionSettings.flashDurationMs = 200;
@@ -37,6 +43,37 @@ void Config::initializeDefaults() {
     // Performance defaults
     m_performanceSettings.updateRateMs = 16;  // 60 FPS
     m_performanceSettings.statsUpdateMs = 500;
+    m_performanceSettings.percentileMode = "exact";
+    m_performanceSettings.renderBackend = "swapchain";
+    m_performanceSettings.showProfiler = false;
+    m_performanceSettings.profileLogSeconds = 60;
+
+    // Threading defaults
+    m_threadingSettings.capturePriority = "above_normal";
+    m_threadingSettings.analysisPriority = "normal";
+    m_threadingSettings.uiPriority = "normal";
+    m_threadingSettings.captureAffinity = 0;
+    m_threadingSettings.analysisAffinity = 0;
+    m_threadingSettings.uiAffinity = 0;
+
+    // Recording defaults
+    m_recordingSettings.enabled = false;
+    m_recordingSettings.directory = "recordings";
+
+    // Session defaults
+    m_sessionSettings.maxSessions = 1;
+    m_sessionSettings.overlayPerSession = true;
+
+    // Telemetry defaults
+    m_telemetrySettings.enabled = false;
+    m_telemetrySettings.sampleMs = 500;
+
+    // Export defaults
+    m_exportSettings.sharedMemory = false;
+    m_exportSettings.network = "off";
+    m_exportSettings.host = "";
+    m_exportSettings.port = 9300;
+    m_exportSettings.flushMs = 100;
 
     // Control defaults
     m_controlSettings.toggleHotkey = "VK_F12";
@@ -55,7 +92,7 @@ bool Config::load(const std::string& filename) {
     std::map<std::string, std::string> data;
 
     if (!parseIniFile(filename, data)) {
-        // File not found or invalid, use defaults
+        // File not found or invalid, use defaults (or keep the current settings)
         return false;
     }
 
@@ -85,6 +122,9 @@ bool Config::load(const std::string& filename) {
         if (data.count("Graph.history_seconds")) {
             m_graphSettings.historySeconds = std::stod(data["Graph.history_seconds"]);
         }
+        if (data.count("Graph.view_seconds")) {
+            m_graphSettings.viewSeconds = std::stod(data["Graph.view_seconds"]);
+        }
         if (data.count("Graph.line_width")) {
             m_graphSettings.lineWidth = std::stod(data["Graph.line_width"]);
         }
@@ -94,6 +134,9 @@ bool Config::load(const std::string& filename) {
     if (data.count("Graph.show_grid")) {
         m_graphSettings.showGrid = (data["Graph.show_grid"] == "true");
     }
+    if (data.count("Graph.show_fill")) {
+        m_graphSettings.showFill = (data["Graph.show_fill"] == "true");
+    }
     if (data.count("Graph.anti_aliasing")) {
         m_graphSettings.antiAliasing = (data["Graph.anti_aliasing"] == "true");
     }
@@ -106,6 +149,9 @@ bool Config::load(const std::string& filename) {
         if (data.count("Detection.drop_threshold_percent")) {
             m_detectionSettings.dropThresholdPercent = std::stod(data["Detection.drop_threshold_percent"]);
         }
+        if (data.count("Detection.stutter_factor")) {
+            m_detectionSettings.stutterFactor = std::stod(data["Detection.stutter_factor"]);
+        }
         if (data.count("Detection.flash_duration_ms")) {
             m_detectionSettings.flashDurationMs = std::stoi(data["Detection.flash_duration_ms"]);
         }
@@ -127,6 +173,96 @@ bool Config::load(const std::string& filename) {
         if (data.count("Performance.stats_update_ms")) {
             m_performanceSettings.statsUpdateMs = std::stoi(data["Performance.stats_update_ms"]);
         }
+        if (data.count("Performance.profile_log_seconds")) {
+            m_performanceSettings.profileLogSeconds = std::stoi(data["Performance.profile_log_seconds"]);
+        }
+    } catch (const std::exception&) {
+        // Keep defaults on parse error
+    }
+    if (data.count("Performance.percentile_mode")) {
+        m_performanceSettings.percentileMode = data["Performance.percentile_mode"];
+    }
+    if (data.count("Performance.render_backend")) {
+        m_performanceSettings.renderBackend = data["Performance.render_backend"];
+    }
+    if (data.count("Performance.show_profiler")) {
+        m_performanceSettings.showProfiler = (data["Performance.show_profiler"] == "true");
+    }
+
+    // Parse Threading settings
+    if (data.count("Threading.capture_priority")) {
+        m_threadingSettings.capturePriority = data["Threading.capture_priority"];
+    }
+    if (data.count("Threading.analysis_priority")) {
+        m_threadingSettings.analysisPriority = data["Threading.analysis_priority"];
+    }
+    if (data.count("Threading.ui_priority")) {
+        m_threadingSettings.uiPriority = data["Threading.ui_priority"];
+    }
+    try {
+        // Base 0: accepts hex (0x...) as well as decimal masks
+        if (data.count("Threading.capture_affinity")) {
+            m_threadingSettings.captureAffinity = std::stoull(data["Threading.capture_affinity"], nullptr, 0);
+        }
+        if (data.count("Threading.analysis_affinity")) {
+            m_threadingSettings.analysisAffinity = std::stoull(data["Threading.analysis_affinity"], nullptr, 0);
+        }
+        if (data.count("Threading.ui_affinity")) {
+            m_threadingSettings.uiAffinity = std::stoull(data["Threading.ui_affinity"], nullptr, 0);
+        }
+    } catch (const std::exception&) {
+        // Keep defaults on parse error
+    }
+
+    // Parse Recording settings
+    if (data.count("Recording.enabled")) {
+        m_recordingSettings.enabled = (data["Recording.enabled"] == "true");
+    }
+    if (data.count("Recording.directory")) {
+        m_recordingSettings.directory = data["Recording.directory"];
+    }
+
+    // Parse Sessions settings
+    try {
+        if (data.count("Sessions.max_sessions")) {
+            m_sessionSettings.maxSessions = std::stoi(data["Sessions.max_sessions"]);
+        }
+    } catch (const std::exception&) {
+        // Keep defaults on parse error
+    }
+    if (data.count("Sessions.overlay_per_session")) {
+        m_sessionSettings.overlayPerSession = (data["Sessions.overlay_per_session"] == "true");
+    }
+
+    // Parse Telemetry settings
+    try {
+        if (data.count("Telemetry.sample_ms")) {
+            m_telemetrySettings.sampleMs = std::stoi(data["Telemetry.sample_ms"]);
+        }
+    } catch (const std::exception&) {
+        // Keep defaults on parse error
+    }
+    if (data.count("Telemetry.enabled")) {
+        m_telemetrySettings.enabled = (data["Telemetry.enabled"] == "true");
+    }
+
+    // Parse Export settings
+    if (data.count("Export.shared_memory")) {
+        m_exportSettings.sharedMemory = (data["Export.shared_memory"] == "true");
+    }
+    if (data.count("Export.network")) {
+        m_exportSettings.network = data["Export.network"];
+    }
+    if (data.count("Export.host")) {
+        m_exportSettings.host = data["Export.host"];
+    }
+    try {
+        if (data.count("Export.port")) {
+            m_exportSettings.port = std::stoi(data["Export.port"]);
+        }
+        if (data.count("Export.flush_ms")) {
+            m_exportSettings.flushMs = std::stoi(data["Export.flush_ms"]);
+        }
     } catch (const std::exception&) {
         // Keep defaults on parse error
     }
@@ -150,6 +286,7 @@ bool Config::load(const std::string& filename) {
         m_gameDetectionSettings.blacklist = data["GameDetection.blacklist"];
     }
 
+    publish();
     return true;
 }
 
@@ -173,7 +310,9 @@ bool Config::save(const std::string& filename) {
     // Write Graph section
     file << "[Graph]\n";
     file << "history_seconds = " << m_graphSettings.historySeconds << "\n";
+    file << "view_seconds = " << m_graphSettings.viewSeconds << "\n";
     file << "show_grid = " << (m_graphSettings.showGrid ? "true" : "false") << "\n";
+    file << "show_fill = " << (m_graphSettings.showFill ? "true" : "false") << "\n";
     file << "line_width = " << m_graphSettings.lineWidth << "\n";
     file << "anti_aliasing = " << (m_graphSettings.antiAliasing ? "true" : "false") << "\n";
     file << "color_mode = " << m_graphSettings.colorMode << "\n";
@@ -182,6 +321,7 @@ bool Config::save(const std::string& filename) {
     // Write Detection section
     file << "[Detection]\n";
     file << "drop_threshold_percent = " << m_detectionSettings.dropThresholdPercent << "\n";
+    file << "stutter_factor = " << m_detectionSettings.stutterFactor << "\n";
     file << "show_drop_markers = " << (m_detectionSettings.showDropMarkers ? "true" : "false") << "\n";
     file << "flash_on_drop = " << (m_detectionSettings.flashOnDrop ? "true" : "false") << "\n";
     file << "flash_duration_ms = " << m_detectionSettings.flashDurationMs << "\n";
@@ -191,6 +331,49 @@ bool Config::save(const std::string& filename) {
     file << "[Performance]\n";
     file << "update_rate_ms = " << m_performanceSettings.updateRateMs << "\n";
     file << "stats_update_ms = " << m_performanceSettings.statsUpdateMs << "\n";
+    file << "percentile_mode = " << m_performanceSettings.percentileMode << "\n";
+    file << "render_backend = " << m_performanceSettings.renderBackend << "\n";
+    file << "show_profiler = " << (m_performanceSettings.showProfiler ? "true" : "false") << "\n";
+    file << "profile_log_seconds = " << m_performanceSettings.profileLogSeconds << "\n";
+    file << "\n";
+
+    // Write Threading section
+    file << "[Threading]\n";
+    file << "capture_priority = " << m_threadingSettings.capturePriority << "\n";
+    file << "analysis_priority = " << m_threadingSettings.analysisPriority << "\n";
+    file << "ui_priority = " << m_threadingSettings.uiPriority << "\n";
+    file << std::hex << std::showbase;
+    file << "capture_affinity = " << m_threadingSettings.captureAffinity << "\n";
+    file << "analysis_affinity = " << m_threadingSettings.analysisAffinity << "\n";
+    file << "ui_affinity = " << m_threadingSettings.uiAffinity << "\n";
+    file << std::dec << std::noshowbase;
+    file << "\n";
+
+    // Write Recording section
+    file << "[Recording]\n";
+    file << "enabled = " << (m_recordingSettings.enabled ? "true" : "false") << "\n";
+    file << "directory = " << m_recordingSettings.directory << "\n";
+    file << "\n";
+
+    // Write Sessions section
+    file << "[Sessions]\n";
+    file << "max_sessions = " << m_sessionSettings.maxSessions << "\n";
+    file << "overlay_per_session = " << (m_sessionSettings.overlayPerSession ? "true" : "false") << "\n";
+    file << "\n";
+
+    // Write Telemetry section
+    file << "[Telemetry]\n";
+    file << "enabled = " << (m_telemetrySettings.enabled ? "true" : "false") << "\n";
+    file << "sample_ms = " << m_telemetrySettings.sampleMs << "\n";
+    file << "\n";
+
+    // Write Export section
+    file << "[Export]\n";
+    file << "shared_memory = " << (m_exportSettings.sharedMemory ? "true" : "false") << "\n";
+    file << "network = " << m_exportSettings.network << "\n";
+    file << "host = " << m_exportSettings.host << "\n";
+    file << "port = " << m_exportSettings.port << "\n";
+    file << "flush_ms = " << m_exportSettings.flushMs << "\n";
     file << "\n";
 
     // Write Controls section
@@ -209,7 +392,45 @@ bool Config::save(const std::string& filename) {
 }
 
 bool Config::reload() {
-    return load(m_lastFilename);
+    std::string filename;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        filename = m_lastFilename;
+    }
+    return load(filename);
+}
+
+std::string Config::getFilename() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_lastFilename;
+}
+
+uint64_t Config::getVersion() const {
+    return m_version.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<const Config::Settings> Config::getSnapshot() const {
+    return std::atomic_load(&m_snapshot);
+}
+
+void Config::publish() {
+    auto snapshot = std::make_shared<Settings>();
+    snapshot->display = m_displaySettings;
+    snapshot->graph = m_graphSettings;
+    snapshot->detection = m_detectionSettings;
+    snapshot->performance = m_performanceSettings;
+    snapshot->threading = m_threadingSettings;
+    snapshot->recording = m_recordingSettings;
+    snapshot->sessions = m_sessionSettings;
+    snapshot->telemetry = m_telemetrySettings;
+    snapshot->exports = m_exportSettings;
+    snapshot->control = m_controlSettings;
+    snapshot->gameDetection = m_gameDetectionSettings;
+    snapshot->version = m_version.load(std::memory_order_relaxed) + 1;
+
+    // Snapshot first: a reader that sees the new version finds it in place
+    std::atomic_store(&m_snapshot, std::shared_ptr<const Settings>(std::move(snapshot)));
+    m_version.fetch_add(1, std::memory_order_release);
 }
 
 bool Config::parseIniFile(const std::string& filename, std::map<std::string, std::string>& data) {
@@ -280,43 +501,77 @@ std::string Config::positionToString(Position pos) const {
     }
 }
 
-const Config::DisplaySettings& Config::getDisplaySettings() const {
+Config::DisplaySettings Config::getDisplaySettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_displaySettings;
 }
 
-const Config::GraphSettings& Config::getGraphSettings() const {
+Config::GraphSettings Config::getGraphSettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_graphSettings;
 }
 
-const Config::DetectionSettings& Config::getDetectionSettings() const {
+Config::DetectionSettings Config::getDetectionSettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_detectionSettings;
 }
 
-const Config::PerformanceSettings& Config::getPerformanceSettings() const {
+Config::PerformanceSettings Config::getPerformanceSettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_performanceSettings;
 }
 
-const Config::ControlSettings& Config::getControlSettings() const {
+Config::ControlSettings Config::getControlSettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_controlSettings;
 }
 
-const Config::GameDetectionSettings& Config::getGameDetectionSettings() const {
+Config::ThreadingSettings Config::getThreadingSettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_threadingSettings;
+}
+
+Config::RecordingSettings Config::getRecordingSettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_recordingSettings;
+}
+
+Config::SessionSettings Config::getSessionSettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_sessionSettings;
+}
+
+Config::TelemetrySettings Config::getTelemetrySettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_telemetrySettings;
+}
+
+Config::ExportSettings Config::getExportSettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_exportSettings;
+}
+
+Config::GameDetectionSettings Config::getGameDetectionSettings() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
     return m_gameDetectionSettings;
 }
 
 void Config::setDisplaySettings(const DisplaySettings& settings) {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_displaySettings = settings;
+    publish();
 }
 
 void Config::setGraphSettings(const GraphSettings& settings) {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_graphSettings = settings;
+    publish();
 }
 
 void Config::setDetectionSettings(const DetectionSettings& settings) {
     std::lock_guard<std::mutex> lock(m_mutex);
     m_detectionSettings = settings;
+    publish();
 }
 
 } // namespace fps_monitor
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <map>
 #include <mutex>
@@ -11,6 +14,12 @@ namespace fps_monitor {
  * 
  * Parses INI-format configuration files with validation and default values.
  * Supports hot-reload and thread-safe access to settings.
+ * 
+ * Every load, reload and set publishes an immutable Settings snapshot with
+ * a new version number. Readers on other threads compare getVersion() (one
+ * atomic load) with the version of the snapshot they hold and only take a
+ * new one with getSnapshot() when it changed, so the render loop never
+ * waits for a reload in progress.
  */
 class Config {
 public:
@@ -43,7 +52,9 @@ public:
      */
     struct GraphSettings {
         double historySeconds;
+        double viewSeconds;     ///< Span drawn from the history tiers (0: frame-time window)
         bool showGrid;
+        bool showFill;
         double lineWidth;
         bool antiAliasing;
         std::string colorMode;
@@ -54,6 +65,7 @@ public:
      */
     struct DetectionSettings {
         double dropThresholdPercent;
+        double stutterFactor;   ///< Stutter threshold as a multiple of the rolling median
         bool showDropMarkers;
         bool flashOnDrop;
         int flashDurationMs;
@@ -65,6 +77,57 @@ public:
     struct PerformanceSettings {
         int updateRateMs;
         int statsUpdateMs;
+        std::string percentileMode;  ///< "exact" (window) or "histogram" (session)
+        std::string renderBackend;   ///< "swapchain" (D3D11 + DirectComposition) or "hwnd" (legacy)
+        bool showProfiler;           ///< Draw the overlay's own stage timings and CPU/memory
+        int profileLogSeconds;       ///< Interval of the profiler log line (0 = off)
+    };
+
+    /**
+     * @brief Structure containing thread scheduling settings
+     */
+    struct ThreadingSettings {
+        std::string capturePriority;    ///< ETW consumer thread priority name
+        std::string analysisPriority;   ///< Analysis thread priority name
+        std::string uiPriority;         ///< Render/message thread priority name
+        uint64_t captureAffinity;       ///< Logical processor mask (0 = any)
+        uint64_t analysisAffinity;      ///< Logical processor mask (0 = any)
+        uint64_t uiAffinity;            ///< Logical processor mask (0 = any)
+    };
+
+    /**
+     * @brief Structure containing session recording settings
+     */
+    struct RecordingSettings {
+        bool enabled;               ///< Record every frame time and drop to disk
+        std::string directory;      ///< Output directory for .fpsr files
+    };
+
+    /**
+     * @brief Structure containing multi-game tracking settings
+     */
+    struct SessionSettings {
+        int maxSessions;            ///< Games tracked at once (1-4; 1 = foreground game only)
+        bool overlayPerSession;     ///< Show a compact overlay next to every extra game
+    };
+
+    /**
+     * @brief Structure containing system telemetry settings
+     */
+    struct TelemetrySettings {
+        bool enabled;               ///< Sample CPU/GPU load and annotate drops with it
+        int sampleMs;               ///< Milliseconds between samples (100 - 5000)
+    };
+
+    /**
+     * @brief Structure containing export settings
+     */
+    struct ExportSettings {
+        bool sharedMemory;          ///< Publish every session into a named shared-memory section
+        std::string network;        ///< Stream frames to a collector: "off", "udp" or "tcp"
+        std::string host;           ///< Collector host name or address
+        int port;                   ///< Collector port (1 - 65535)
+        int flushMs;                ///< Milliseconds between packets (20 - 1000)
     };
 
     /**
@@ -84,6 +147,24 @@ public:
         std::string blacklist;
     };
 
+    /**
+     * @brief Every section, as published to readers
+     */
+    struct Settings {
+        DisplaySettings display;
+        GraphSettings graph;
+        DetectionSettings detection;
+        PerformanceSettings performance;
+        ThreadingSettings threading;
+        RecordingSettings recording;
+        SessionSettings sessions;
+        TelemetrySettings telemetry;
+        ExportSettings exports;
+        ControlSettings control;
+        GameDetectionSettings gameDetection;
+        uint64_t version;           ///< getVersion() at publication
+    };
+
     /**
      * @brief Construct a new Config object
      * 
@@ -122,47 +203,107 @@ public:
      */
     bool reload();
 
+    /**
+     * @brief Get the path passed to the last load()
+     * 
+     * @return std::string Config file path
+     */
+    std::string getFilename() const;
+
+    /**
+     * @brief Get the version of the latest snapshot
+     * 
+     * Lock-free; cheap enough to check every frame.
+     * 
+     * @return uint64_t Version (incremented by every publication)
+     */
+    uint64_t getVersion() const;
+
+    /**
+     * @brief Get the latest published settings
+     * 
+     * The snapshot never changes; a reload publishes a new one.
+     * 
+     * @return std::shared_ptr<const Settings> Current snapshot
+     */
+    std::shared_ptr<const Settings> getSnapshot() const;
+
     /**
      * @brief Get display settings
      * 
-     * @return const DisplaySettings& Reference to display settings
+     * @return DisplaySettings Copy of the display settings
      */
-    const DisplaySettings& getDisplaySettings() const;
+    DisplaySettings getDisplaySettings() const;
 
     /**
      * @brief Get graph settings
      * 
-     * @return const GraphSettings& Reference to graph settings
+     * @return GraphSettings Copy of the graph settings
      */
-    const GraphSettings& getGraphSettings() const;
+    GraphSettings getGraphSettings() const;
 
     /**
      * @brief Get detection settings
      * 
-     * @return const DetectionSettings& Reference to detection settings
+     * @return DetectionSettings Copy of the detection settings
      */
-    const DetectionSettings& getDetectionSettings() const;
+    DetectionSettings getDetectionSettings() const;
 
     /**
      * @brief Get performance settings
      * 
-     * @return const PerformanceSettings& Reference to performance settings
+     * @return PerformanceSettings Copy of the performance settings
+     */
+    PerformanceSettings getPerformanceSettings() const;
+
+    /**
+     * @brief Get thread scheduling settings
+     * 
+     * @return ThreadingSettings Copy of the threading settings
+     */
+    ThreadingSettings getThreadingSettings() const;
+
+    /**
+     * @brief Get session recording settings
+     * 
+     * @return RecordingSettings Copy of the recording settings
      */
-    const PerformanceSettings& getPerformanceSettings() const;
+    RecordingSettings getRecordingSettings() const;
+
+    /**
+     * @brief Get multi-game tracking settings
+     * 
+     * @return SessionSettings Copy of the session settings
+     */
+    SessionSettings getSessionSettings() const;
+
+    /**
+     * @brief Get system telemetry settings
+     * 
+     * @return TelemetrySettings Copy of the telemetry settings
+     */
+    TelemetrySettings getTelemetrySettings() const;
+
+    /**
+     * @brief Get export settings
+     * 
+     * @return ExportSettings Copy of the export settings
+     */
+    ExportSettings getExportSettings() const;
 
     /**
      * @brief Get control settings
      * 
-     * @return const ControlSettings& Reference to control settings
+     * @return ControlSettings Copy of the control settings
      */
-    const ControlSettings& getControlSettings() const;
+    ControlSettings getControlSettings() const;
 
     /**
      * @brief Get game detection settings
      * 
-     * @return const GameDetectionSettings& Reference to game detection settings
+     * @return GameDetectionSettings Copy of the game detection settings
      */
-    const GameDetectionSettings& getGameDetectionSettings() const;
+    GameDetectionSettings getGameDetectionSettings() const;
 
     /**
      * @brief Set display settings
@@ -225,14 +366,28 @@ private:
      */
     void initializeDefaults();
 
+    /**
+     * @brief Publish the current settings as a new snapshot
+     * 
+     * Caller holds m_mutex.
+     */
+    void publish();
+
     DisplaySettings m_displaySettings;
     GraphSettings m_graphSettings;
     DetectionSettings m_detectionSettings;
     PerformanceSettings m_performanceSettings;
+    ThreadingSettings m_threadingSettings;
+    RecordingSettings m_recordingSettings;
+    SessionSettings m_sessionSettings;
+    TelemetrySettings m_telemetrySettings;
+    ExportSettings m_exportSettings;
     ControlSettings m_controlSettings;
     GameDetectionSettings m_gameDetectionSettings;
     std::string m_lastFilename;
-    mutable std::mutex m_mutex;
+    mutable std::mutex m_mutex;                     ///< Guards the settings above and publication
+    std::shared_ptr<const Settings> m_snapshot;     ///< Latest snapshot (std::atomic_load/store)
+    std::atomic<uint64_t> m_version;                ///< Version of m_snapshot
 };
 
 } // namespace fps_monitor
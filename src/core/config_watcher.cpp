@@ -0,0 +1,82 @@
+#include "config_watcher.h"
+#include "thread_config.h"
+
+namespace fps_monitor {
+
+ConfigWatcher::ConfigWatcher()
+    : m_config(nullptr)
+    , m_stopEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr))
+    , m_changeEvent(CreateEventW(nullptr, FALSE, FALSE, nullptr))
+{
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+
+    if (m_stopEvent) {
+        CloseHandle(m_stopEvent);
+    }
+    if (m_changeEvent) {
+        CloseHandle(m_changeEvent);
+    }
+}
+
+bool ConfigWatcher::start(Config* config) {
+    if (m_thread.joinable()) {
+        return true;
+    }
+    if (!config || !m_stopEvent || !m_changeEvent) {
+        return false;
+    }
+
+    // Watch the directory holding the file ("." for a bare file name)
+    std::string path = config->getFilename();
+    size_t separator = path.find_last_of("\\/");
+    std::string directory = (separator == std::string::npos) ? std::string(".") : path.substr(0, separator + 1);
+    m_fileName = (separator == std::string::npos) ? path : path.substr(separator + 1);
+
+    if (m_fileName.empty() || !m_watcher.start(directory)) {
+        return false;
+    }
+
+    m_config = config;
+    ResetEvent(m_stopEvent);
+    m_thread = std::thread(&ConfigWatcher::threadMain, this);
+    return true;
+}
+
+void ConfigWatcher::stop() {
+    if (m_thread.joinable()) {
+        SetEvent(m_stopEvent);
+        m_thread.join();
+    }
+    m_watcher.stop();
+}
+
+void ConfigWatcher::threadMain() {
+    ThreadConfig watcherThread;
+    watcherThread.priority = THREAD_PRIORITY_BELOW_NORMAL;
+    applyThreadConfig(watcherThread);
+
+    HANDLE handles[2] = { m_stopEvent, m_watcher.getEvent() };
+    for (;;) {
+        if (WaitForMultipleObjects(2, handles, FALSE, INFINITE) != WAIT_OBJECT_0 + 1) {
+            return; // Stop requested (or the wait failed)
+        }
+        if (!m_watcher.poll(m_fileName)) {
+            continue;
+        }
+
+        // Let the editor finish saving; later notifications are part of this change
+        if (WaitForSingleObject(m_stopEvent, DEBOUNCE_MS) == WAIT_OBJECT_0) {
+            return;
+        }
+        m_watcher.poll(m_fileName);
+
+        if (m_config->reload()) {
+            SetEvent(m_changeEvent);
+        }
+    }
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include "config.h"
+#include "directory_watcher.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Reloads the configuration file when it changes on disk
+ *
+ * A below-normal priority thread waits on a DirectoryWatcher for the
+ * config file's directory. When the file is written it waits a short
+ * debounce (editors often save in several writes), calls Config::reload()
+ * and signals the change event, so a sleeping UI thread wakes and picks up
+ * the new Config snapshot. Parsing and file I/O therefore never happen on
+ * the render loop.
+ */
+class ConfigWatcher {
+public:
+    /**
+     * @brief Construct an idle Config Watcher
+     */
+    ConfigWatcher();
+
+    /**
+     * @brief Destroy the Config Watcher (stops it)
+     */
+    ~ConfigWatcher();
+
+    // Prevent copying
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    /**
+     * @brief Start watching the file last loaded by a Config
+     *
+     * @param config Configuration to reload (must outlive the watcher)
+     * @return true if the watcher thread is running
+     * @return false otherwise
+     */
+    bool start(Config* config);
+
+    /**
+     * @brief Stop and join the watcher thread
+     */
+    void stop();
+
+    /**
+     * @brief Get the event signalled after each successful reload
+     *
+     * Auto-reset; can be added to the UI thread's FrameScheduler.
+     *
+     * @return HANDLE Event, or nullptr if it could not be created
+     */
+    HANDLE getChangeEvent() const { return m_changeEvent; }
+
+private:
+    static constexpr DWORD DEBOUNCE_MS = 100;   ///< Quiet time before reloading
+
+    /**
+     * @brief Watcher thread body
+     */
+    void threadMain();
+
+    Config* m_config;                   ///< Configuration to reload (not owned)
+    std::string m_fileName;             ///< Config file name (without directory)
+    DirectoryWatcher m_watcher;         ///< Change notification for its directory
+    std::thread m_thread;               ///< Watcher thread
+    HANDLE m_stopEvent;                 ///< Wakes the thread to exit
+    HANDLE m_changeEvent;               ///< Signalled after each reload
+};
+
+} // namespace fps_monitor
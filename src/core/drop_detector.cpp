@@ -5,6 +5,7 @@ namespace fps_monitor {
 
 DropDetector::DropDetector(double thresholdPercent)
     : m_thresholdPercent(thresholdPercent)
+    , m_drops(std::make_unique<RingBuffer<Drop, MAX_DROP_HISTORY>>())
     , m_lastDrop(std::chrono::steady_clock::now())
 {
 }
@@ -12,8 +13,11 @@ DropDetector::DropDetector(double thresholdPercent)
 DropDetector::~DropDetector() = default;
 
 void DropDetector::update(double currentFPS, double averageFPS) {
+    update(currentFPS, averageFPS, std::chrono::steady_clock::now());
+}
+
+void DropDetector::update(double currentFPS, double averageFPS, std::chrono::steady_clock::time_point now) {
     if (checkForDrop(currentFPS, averageFPS)) {
-        auto now = std::chrono::steady_clock::now();
         auto elapsed = std::chrono::duration<double>(now - m_lastDrop).count();
 
         // Debouncing: only record drop if enough time has passed
@@ -24,14 +28,10 @@ void DropDetector::update(double currentFPS, double averageFPS) {
             drop.currentFPS = currentFPS;
             drop.magnitude = (averageFPS - currentFPS) / averageFPS;
 
-            m_drops.push_back(drop);
+            // Full history overwrites the oldest drop in place
+            m_drops->push(drop);
             m_lastDrop = now;
 
-            // Limit history size
-            if (m_drops.size() > MAX_DROP_HISTORY) {
-                m_drops.erase(m_drops.begin());
-            }
-
             // Invoke callback if registered
             if (m_callback) {
                 m_callback(drop);
@@ -52,20 +52,20 @@ bool DropDetector::checkForDrop(double currentFPS, double averageFPS) const {
     return dropPercent >= m_thresholdPercent;
 }
 
-const std::vector<DropDetector::Drop>& DropDetector::getDrops() const {
-    return m_drops;
+SampleView<DropDetector::Drop> DropDetector::getDrops() const {
+    return m_drops->view();
 }
 
 std::vector<DropDetector::Drop> DropDetector::getRecentDrops(double seconds) const {
     auto now = std::chrono::steady_clock::now();
     std::vector<Drop> recentDrops;
 
-    for (const auto& drop : m_drops) {
+    m_drops->view().forEach([&](const Drop& drop) {
         auto elapsed = std::chrono::duration<double>(now - drop.timestamp).count();
         if (elapsed <= seconds) {
             recentDrops.push_back(drop);
         }
-    }
+    });
 
     return recentDrops;
 }
@@ -84,7 +84,7 @@ void DropDetector::setDropCallback(DropCallback callback) {
 }
 
 void DropDetector::clearHistory() {
-    m_drops.clear();
+    m_drops->clear();
 }
 
 } // namespace fps_monitor
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <functional>
+#include <memory>
 #include <vector>
 #include <chrono>
+#include "ring_buffer.h"
+#include "sample_view.h"
 
 namespace fps_monitor {
 
@@ -11,7 +14,10 @@ namespace fps_monitor {
  * 
  * Detects when FPS drops significantly below the rolling average.
  * Provides debouncing to prevent alert spam and tracks drop history
- * for visualization.
+ * for visualization (a fixed ring: the oldest drop is overwritten once
+ * MAX_DROP_HISTORY are kept).
+ * 
+ * Frame-level pacing problems are StutterAnalyzer's job.
  */
 class DropDetector {
 public:
@@ -54,6 +60,18 @@ public:
      */
     void update(double currentFPS, double averageFPS);
 
+    /**
+     * @brief Update detector at an explicit time
+     * 
+     * For frames that are not live (replay): debouncing and drop
+     * timestamps follow the given clock instead of the wall clock.
+     * 
+     * @param currentFPS Current instantaneous FPS
+     * @param averageFPS Rolling average FPS
+     * @param now Time of the frame
+     */
+    void update(double currentFPS, double averageFPS, std::chrono::steady_clock::time_point now);
+
     /**
      * @brief Check if a drop is currently occurring
      * 
@@ -67,9 +85,9 @@ public:
     /**
      * @brief Get the history of detected drops
      * 
-     * @return const std::vector<Drop>& Vector of all detected drops
+     * @return SampleView<Drop> Kept drops, oldest to newest (invalidated by update())
      */
-    const std::vector<Drop>& getDrops() const;
+    SampleView<Drop> getDrops() const;
 
     /**
      * @brief Get recent drops within a time window
@@ -107,11 +125,11 @@ public:
 
 private:
     double m_thresholdPercent;                        ///< Drop threshold percentage
-    std::vector<Drop> m_drops;                        ///< History of detected drops
+    static constexpr size_t MAX_DROP_HISTORY = 100;   ///< Maximum drops to keep in history
+    std::unique_ptr<RingBuffer<Drop, MAX_DROP_HISTORY>> m_drops;  ///< History of detected drops
     DropCallback m_callback;                          ///< Optional drop callback
     std::chrono::steady_clock::time_point m_lastDrop; ///< Last drop timestamp for debouncing
     static constexpr double DEBOUNCE_SECONDS = 0.5;   ///< Minimum time between drops
-    static constexpr size_t MAX_DROP_HISTORY = 100;   ///< Maximum drops to keep in history
 };
 
 } // namespace fps_monitor
@@ -1,74 +1,177 @@
 #include "fps_calculator.h"
 #include <algorithm>
-#include <numeric>
+#include <cmath>
+#include <limits>
 
 namespace fps_monitor {
 
-FpsCalculator::FpsCalculator(size_t historySize)
-    : m_currentFPS(0.0)
-    , m_averageFPS(0.0)
-    , m_historySize(std::min(historySize, MAX_HISTORY))
+FpsCalculator::FpsCalculator(size_t historySize, int64_t tickFrequency, double windowSeconds)
+    : m_totalSamples(0)
+    , m_lastTicks(0)
+    , m_historySize(std::max<size_t>(1, std::min(historySize, MAX_HISTORY)))
+    , m_windowTicks(0)
+    , m_windowCount(0)
+    , m_lastPresent(0)
 {
-    m_samples = std::make_unique<RingBuffer<double, MAX_HISTORY>>();
+    m_samples = std::make_unique<RingBuffer<uint32_t, MAX_HISTORY>>();
+    m_pending = std::make_unique<SpscRingBuffer<int64_t, PENDING_CAPACITY>>();
+    m_rolling = std::make_unique<RollingStats<uint32_t, MAX_HISTORY>>();
     
     // Initialize high-resolution timer frequency
     QueryPerformanceFrequency(&m_frequency);
+    if (tickFrequency > 0) {
+        m_frequency.QuadPart = tickFrequency;
+    }
+
+    if (windowSeconds > 0.0) {
+        m_windowTicks = static_cast<uint64_t>(windowSeconds * static_cast<double>(m_frequency.QuadPart));
+    }
 }
 
 FpsCalculator::~FpsCalculator() = default;
 
 void FpsCalculator::update(double deltaTime) {
-    static constexpr double MAX_FPS = 1000.0;
-    
     // Avoid division by zero
     if (deltaTime <= 0.0) {
         return;
     }
 
-    // Calculate instantaneous FPS: 1.0 / deltaTime
-    m_currentFPS = 1.0 / deltaTime;
+    // Store as ticks of the same clock the present path uses
+    double ticks = std::round(deltaTime * static_cast<double>(m_frequency.QuadPart));
+    pushSample(static_cast<uint64_t>(std::min(ticks, static_cast<double>(std::numeric_limits<uint32_t>::max()))));
+}
+
+void FpsCalculator::addFrameTime(uint32_t ticks) {
+    pushSample(ticks);
+}
+
+void FpsCalculator::addPresent(int64_t qpcTimestamp) {
+    if (m_lastPresent != 0 && qpcTimestamp > m_lastPresent) {
+        pushSample(static_cast<uint64_t>(qpcTimestamp - m_lastPresent));
+    }
+    m_lastPresent = qpcTimestamp;
+}
 
-    // Clamp to reasonable values (0-MAX_FPS)
-    m_currentFPS = std::max(0.0, std::min(m_currentFPS, MAX_FPS));
+bool FpsCalculator::submitPresent(int64_t qpcTimestamp) {
+    return m_pending->push(qpcTimestamp);
+}
 
-    // Store sample in ring buffer
-    m_samples->push(m_currentFPS);
+size_t FpsCalculator::processPending(size_t maxPresents) {
+    int64_t batch[DRAIN_BATCH_SIZE];
+    size_t total = 0;
+    size_t count = 0;
+
+    // Bounded so a runaway producer can't starve the caller
+    size_t limit = std::min(maxPresents, PENDING_CAPACITY);
+    while (total < limit && (count = m_pending->popBulk(batch, std::min(DRAIN_BATCH_SIZE, limit - total))) > 0) {
+        for (size_t i = 0; i < count; ++i) {
+            addPresent(batch[i]);
+        }
+        total += count;
+    }
 
-    // Update rolling average
-    m_averageFPS = calculateAverage();
+    return total;
 }
 
 double FpsCalculator::getCurrentFPS() const {
-    return m_currentFPS;
+    return ticksToFPS(m_lastTicks);
+}
+
+double FpsCalculator::getCurrentFrameTimeMs() const {
+    return m_lastTicks * 1000.0 / static_cast<double>(m_frequency.QuadPart);
 }
 
 double FpsCalculator::getAverageFPS() const {
-    return m_averageFPS;
+    uint64_t sum = m_rolling->sum();
+    if (sum == 0) {
+        return 0.0;
+    }
+
+    return static_cast<double>(m_rolling->count()) * static_cast<double>(m_frequency.QuadPart)
+         / static_cast<double>(sum);
+}
+
+double FpsCalculator::getAverageFrameTimeMs() const {
+    return m_rolling->mean() * 1000.0 / static_cast<double>(m_frequency.QuadPart);
+}
+
+double FpsCalculator::getMinFPS() const {
+    // Slowest frame has the most ticks
+    return ticksToFPS(m_rolling->max());
+}
+
+double FpsCalculator::getMaxFPS() const {
+    return ticksToFPS(m_rolling->min());
 }
 
 std::vector<double> FpsCalculator::getSamples() const {
-    return m_samples->getAll();
+    SampleView<uint32_t> view = getSampleView();
+    std::vector<double> result;
+    result.reserve(view.size());
+    view.forEach([this, &result](uint32_t ticks) { result.push_back(ticksToFPS(ticks)); });
+    return result;
+}
+
+SampleView<uint32_t> FpsCalculator::getSampleView() const {
+    return m_samples->view().last(m_windowCount);
+}
+
+SampleView<uint32_t> FpsCalculator::getRetainedView() const {
+    return m_samples->view();
+}
+
+int64_t FpsCalculator::getTickFrequency() const {
+    return m_frequency.QuadPart;
 }
 
 size_t FpsCalculator::getSampleCount() const {
     return m_samples->size();
 }
 
+uint64_t FpsCalculator::getTotalSamples() const {
+    return m_totalSamples;
+}
+
 void FpsCalculator::reset() {
     m_samples->clear();
-    m_currentFPS = 0.0;
-    m_averageFPS = 0.0;
+    m_pending->clear();
+    m_rolling->reset();
+    m_windowCount = 0;
+    m_totalSamples = 0;
+    m_lastTicks = 0;
+    m_lastPresent = 0;
 }
 
-double FpsCalculator::calculateAverage() const {
-    auto samples = m_samples->getAll();
-    if (samples.empty()) {
-        return 0.0;
+double FpsCalculator::ticksToFPS(double ticks) const {
+    return ticks > 0.0 ? static_cast<double>(m_frequency.QuadPart) / ticks : 0.0;
+}
+
+void FpsCalculator::pushSample(uint64_t ticks) {
+    if (ticks == 0) {
+        return;
     }
 
-    // Calculate mean of all samples
-    double sum = std::accumulate(samples.begin(), samples.end(), 0.0);
-    return sum / samples.size();
+    // Saturate pathological gaps (~7 minutes at a 10 MHz QPC)
+    uint32_t sample = static_cast<uint32_t>(std::min<uint64_t>(ticks, std::numeric_limits<uint32_t>::max()));
+
+    // A full window slides; read the evicted sample before the ring overwrites it
+    if (m_windowCount == m_historySize) {
+        m_rolling->evict(getSampleView().front());
+        --m_windowCount;
+    }
+
+    m_samples->push(sample);
+    ++m_totalSamples;
+    m_lastTicks = sample;
+    m_rolling->push(sample);
+    ++m_windowCount;
+
+    // Then drop the frames that no longer fit the window duration (the
+    // newest always stays); integer sums are exact, so no renormalization
+    while (m_windowTicks != 0 && m_windowCount > 1 && m_rolling->sum() > m_windowTicks) {
+        m_rolling->evict(getSampleView().front());
+        --m_windowCount;
+    }
 }
 
 } // namespace fps_monitor
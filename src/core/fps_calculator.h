@@ -1,9 +1,12 @@
 #pragma once
 
 #include <windows.h>
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include "ring_buffer.h"
+#include "spsc_ring_buffer.h"
+#include "rolling_stats.h"
 
 namespace fps_monitor {
 
@@ -11,17 +14,33 @@ namespace fps_monitor {
  * @brief High-precision FPS calculation engine
  * 
  * Uses QueryPerformanceCounter for microsecond precision timing.
- * Calculates instantaneous FPS and maintains a rolling average.
- * Stores samples in a ring buffer for graph visualization.
+ * Samples are stored as raw 32-bit QPC tick deltas (frame times), not
+ * FPS; FPS and milliseconds are derived on read, so nothing is clamped and
+ * the average is frames over elapsed time rather than a mean of rates.
+ * The rolling tick sum and sliding-window min/max are exact and O(1) per
+ * sample. Samples are kept in a ring buffer for graph visualization.
+ *
+ * The window holds at most historySize samples and, given a window
+ * duration, only the newest frames that fit in it, so it spans the same
+ * time at any frame rate. Evicted samples stay retained (up to
+ * MAX_HISTORY) until the ring wraps.
+ * 
+ * Presents captured on another thread are handed over through a lock-free
+ * SPSC queue: the capture thread calls submitPresent() and the thread that
+ * owns the calculator drains them with processPending().
  */
 class FpsCalculator {
 public:
+    static constexpr size_t MAX_HISTORY = 8192; ///< Maximum samples (~16 seconds at 500 FPS)
+
     /**
      * @brief Construct a new FPS Calculator
      * 
-     * @param historySize Number of samples to keep for averaging and graphing
+     * @param historySize Most samples in the averaging and graphing window
+     * @param tickFrequency Ticks per second of the samples (0 = QueryPerformanceFrequency)
+     * @param windowSeconds Longest time the window spans (0 = limited by historySize only)
      */
-    explicit FpsCalculator(size_t historySize = 120);
+    explicit FpsCalculator(size_t historySize = 120, int64_t tickFrequency = 0, double windowSeconds = 0.0);
 
     /**
      * @brief Destroy the FPS Calculator
@@ -37,6 +56,46 @@ public:
      */
     void update(double deltaTime);
 
+    /**
+     * @brief Add a frame time measured elsewhere (e.g. a replayed recording)
+     * 
+     * @param ticks Frame time in ticks of getTickFrequency()
+     */
+    void addFrameTime(uint32_t ticks);
+
+    /**
+     * @brief Update the FPS calculator with a captured present
+     * 
+     * Frame time is the interval since the previous present. The first
+     * present after construction or reset() only establishes the baseline.
+     * 
+     * @param qpcTimestamp QueryPerformanceCounter timestamp of the present
+     */
+    void addPresent(int64_t qpcTimestamp);
+
+    /**
+     * @brief Queue a captured present for processing (producer thread only)
+     * 
+     * Wait-free; safe to call from the capture thread concurrently with the
+     * owning thread's other calls.
+     * 
+     * @param qpcTimestamp QueryPerformanceCounter timestamp of the present
+     * @return true if queued
+     * @return false if the queue is full (present dropped)
+     */
+    bool submitPresent(int64_t qpcTimestamp);
+
+    /**
+     * @brief Process presents queued by submitPresent()
+     * 
+     * A limit no larger than MAX_HISTORY guarantees every new sample is
+     * still in getRetainedView() afterwards (e.g. for recording).
+     * 
+     * @param maxPresents Most presents to process
+     * @return size_t Number of presents processed
+     */
+    size_t processPending(size_t maxPresents = PENDING_CAPACITY);
+
     /**
      * @brief Get the current instantaneous FPS
      * 
@@ -44,24 +103,87 @@ public:
      */
     double getCurrentFPS() const;
 
+    /**
+     * @brief Get the current frame time
+     * 
+     * @return double Most recent frame time in milliseconds (0 if no samples)
+     */
+    double getCurrentFrameTimeMs() const;
+
     /**
      * @brief Get the rolling average FPS
      * 
-     * Averaged over the configured history window.
+     * Frames divided by elapsed time over the window.
      * 
      * @return double Average FPS value
      */
     double getAverageFPS() const;
 
     /**
-     * @brief Get all FPS samples for graph rendering
+     * @brief Get the average frame time over the history window
+     * 
+     * @return double Average frame time in milliseconds (0 if no samples)
+     */
+    double getAverageFrameTimeMs() const;
+
+    /**
+     * @brief Get the minimum FPS in the history window
+     * 
+     * O(1); derived from the longest frame time in the window.
+     * 
+     * @return double Window minimum (0 if no samples)
+     */
+    double getMinFPS() const;
+
+    /**
+     * @brief Get the maximum FPS in the history window
+     * 
+     * O(1); derived from the shortest frame time in the window.
+     * 
+     * @return double Window maximum (0 if no samples)
+     */
+    double getMaxFPS() const;
+
+    /**
+     * @brief Get all samples as FPS values
      * 
-     * Returns samples in chronological order (oldest to newest).
+     * Returns a copy in chronological order (oldest to newest). Allocates;
+     * per-frame consumers should use getSampleView() instead.
      * 
      * @return std::vector<double> Vector of FPS samples
      */
     std::vector<double> getSamples() const;
 
+    /**
+     * @brief Get a zero-copy view of the configured history window
+     * 
+     * Covers the frame times of the window in QPC ticks, oldest to newest.
+     * Divide getTickFrequency() by a sample to get FPS. Invalidated by the
+     * next update(), addPresent() or processPending().
+     * 
+     * @return SampleView<uint32_t> View over frame-time samples
+     */
+    SampleView<uint32_t> getSampleView() const;
+
+    /**
+     * @brief Get a zero-copy view of every retained sample
+     * 
+     * The window and the samples before it, up to MAX_HISTORY in all:
+     * consumers that must see every new sample (recording, streaming
+     * statistics) read it here, as frames can leave a time-limited window
+     * as soon as they arrive. Invalidated like getSampleView().
+     * 
+     * @return SampleView<uint32_t> View over frame-time samples (oldest to newest)
+     */
+    SampleView<uint32_t> getRetainedView() const;
+
+    /**
+     * @brief Get the tick rate of the stored samples
+     * 
+     * @return int64_t QPC ticks per second
+     */
+    int64_t getTickFrequency() const;
+
     /**
      * @brief Get the number of samples currently stored
      * 
@@ -69,6 +191,15 @@ public:
      */
     size_t getSampleCount() const;
 
+    /**
+     * @brief Get the number of samples produced since construction or reset()
+     * 
+     * Lets consumers identify the samples added since they last looked.
+     * 
+     * @return uint64_t Total sample count
+     */
+    uint64_t getTotalSamples() const;
+
     /**
      * @brief Reset the calculator, clearing all samples
      */
@@ -76,19 +207,34 @@ public:
 
 private:
     /**
-     * @brief Calculate average from current samples
+     * @brief Convert a frame time to FPS
+     * 
+     * @param ticks Frame time in QPC ticks
+     * @return double FPS (0 if ticks is 0)
+     */
+    double ticksToFPS(double ticks) const;
+
+    /**
+     * @brief Store a frame time and slide the rolling window
      * 
-     * @return double The calculated average FPS
+     * @param ticks Frame time in QPC ticks (0 is ignored, longer than
+     *              UINT32_MAX is saturated)
      */
-    double calculateAverage() const;
+    void pushSample(uint64_t ticks);
 
-    static constexpr size_t MAX_HISTORY = 600; ///< Maximum samples (10 seconds at 60 FPS)
+    static constexpr size_t PENDING_CAPACITY = 1024; ///< Queued presents (~2s at 500 FPS)
+    static constexpr size_t DRAIN_BATCH_SIZE = 64;   ///< Presents popped per batch
     
-    std::unique_ptr<RingBuffer<double, MAX_HISTORY>> m_samples; ///< FPS sample storage
-    double m_currentFPS;                                         ///< Current instantaneous FPS
-    double m_averageFPS;                                         ///< Rolling average FPS
-    size_t m_historySize;                                        ///< Configured history size
+    std::unique_ptr<RingBuffer<uint32_t, MAX_HISTORY>> m_samples; ///< Frame times in QPC ticks
+    std::unique_ptr<SpscRingBuffer<int64_t, PENDING_CAPACITY>> m_pending; ///< Presents from capture thread
+    std::unique_ptr<RollingStats<uint32_t, MAX_HISTORY>> m_rolling; ///< Window tick sum/min/max
+    uint64_t m_totalSamples;                                     ///< Samples since construction/reset
+    uint32_t m_lastTicks;                                        ///< Most recent frame time in ticks
+    size_t m_historySize;                                        ///< Most samples in the window
+    uint64_t m_windowTicks;                                      ///< Longest window span (0 = unlimited)
+    size_t m_windowCount;                                        ///< Samples in the window
     LARGE_INTEGER m_frequency;                                   ///< QueryPerformanceFrequency result
+    int64_t m_lastPresent;                                       ///< QPC timestamp of previous present (0 if none)
 };
 
 } // namespace fps_monitor
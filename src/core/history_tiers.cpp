@@ -0,0 +1,217 @@
+#include "history_tiers.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace fps_monitor {
+
+HistoryTiers::HistoryTiers(int64_t tickFrequency)
+    : m_fine(std::make_unique<RingBuffer<Bucket, FINE_CAPACITY>>())
+    , m_coarse(std::make_unique<RingBuffer<Bucket, COARSE_CAPACITY>>())
+    , m_frames(FRAME_CAPACITY)
+    , m_fineTicks(std::max<uint64_t>(static_cast<uint64_t>(tickFrequency) / 10, 1))
+{
+    reset();
+}
+
+HistoryTiers::~HistoryTiers() = default;
+
+void HistoryTiers::add(uint32_t ticks) {
+    if (ticks == 0) {
+        return;
+    }
+
+    // Close the buckets this frame's end has moved past; after a stall of
+    // more than the coarse tier's span, the open second is finished and
+    // only the span's worth of empty buckets emitted
+    m_clock += ticks;
+    uint64_t fineIndex = m_clock / m_fineTicks;
+    const uint64_t maxGap = COARSE_CAPACITY * FINE_PER_COARSE;
+    if (fineIndex - m_fineIndex > maxGap) {
+        do {
+            closeFine();
+        } while (m_fineIndex % FINE_PER_COARSE != 0);
+        uint64_t resume = fineIndex - maxGap;
+        m_fineIndex = std::max(m_fineIndex, resume - resume % FINE_PER_COARSE);
+    }
+    while (m_fineIndex < fineIndex) {
+        closeFine();
+    }
+
+    if (m_openFine.frames == 0) {
+        m_openFine.shortest = ticks;
+        m_openFine.longest = ticks;
+    } else {
+        m_openFine.shortest = std::min(m_openFine.shortest, ticks);
+        m_openFine.longest = std::max(m_openFine.longest, ticks);
+    }
+    ++m_openFine.frames;
+    m_openFine.ticks += ticks;
+
+    if (m_frameCount < FRAME_CAPACITY) {
+        m_frames[m_frameCount++] = ticks;
+    }
+}
+
+void HistoryTiers::reset() {
+    m_fine->clear();
+    m_coarse->clear();
+    m_frameCount = 0;
+    m_fineFrameStart = 0;
+    m_openFine = {0, 0, 0, 0, 0};
+    m_openCoarse = {0, 0, 0, 0, 0};
+    m_fineIndex = 0;
+    m_fineTotal = 0;
+    m_coarseTotal = 0;
+    m_clock = 0;
+}
+
+SampleView<HistoryTiers::Bucket> HistoryTiers::getView(Tier tier) const {
+    return tier == Tier::Coarse ? m_coarse->view() : m_fine->view();
+}
+
+uint64_t HistoryTiers::getTotalBuckets(Tier tier) const {
+    return tier == Tier::Coarse ? m_coarseTotal : m_fineTotal;
+}
+
+HistoryTiers::Bucket HistoryTiers::getSessionTotals() const {
+    Bucket total = m_openCoarse;
+    m_coarse->view().forEach([&total](const Bucket& bucket) { merge(total, bucket); });
+    return total;
+}
+
+double HistoryTiers::estimateSlowFrame(double fraction) const {
+    Bucket total = getSessionTotals();
+    if (total.frames == 0) {
+        return 0.0;
+    }
+
+    // The coarse tier plus the fine buckets of the open second
+    SampleView<Bucket> coarse = m_coarse->view();
+    SampleView<Bucket> fine = m_fine->view().last(static_cast<size_t>(m_fineIndex % FINE_PER_COARSE));
+
+    // At least one frame, so short sessions still report a slow frame
+    double target = std::max(1.0, fraction * static_cast<double>(total.frames));
+    double shorter = total.shortest;
+    double longer = total.longest;
+
+    // The estimated count falls as the time grows: bisect to 1/100 tick
+    for (int i = 0; i < 48 && longer - shorter > 0.01; ++i) {
+        double ticks = (shorter + longer) * 0.5;
+        double count = 0.0;
+        auto accumulate = [&count, ticks](const Bucket& bucket) {
+            if (bucket.frames > 0) {
+                count += framesLongerThan(bucket, ticks);
+            }
+        };
+        coarse.forEach(accumulate);
+        fine.forEach(accumulate);
+
+        if (count >= target) {
+            shorter = ticks;
+        } else {
+            longer = ticks;
+        }
+    }
+
+    return shorter;
+}
+
+double HistoryTiers::getBucketSeconds(Tier tier) {
+    return tier == Tier::Coarse ? 1.0 : 1.0 / FINE_PER_COARSE;
+}
+
+HistoryTiers::Tier HistoryTiers::selectTier(double viewSeconds, size_t columns) {
+    double fineSpan = FINE_CAPACITY * getBucketSeconds(Tier::Fine);
+    if (viewSeconds > fineSpan || getBucketSeconds(Tier::Coarse) * columns <= viewSeconds) {
+        return Tier::Coarse;
+    }
+    return Tier::Fine;
+}
+
+void HistoryTiers::closeFine() {
+    Bucket bucket = m_openFine;
+    size_t stored = m_frameCount - m_fineFrameStart;
+    bucket.low1 = slowFrame(m_frames.data() + m_fineFrameStart, stored);
+
+    m_fine->push(bucket);
+    ++m_fineTotal;
+    merge(m_openCoarse, bucket);
+
+    m_openFine = {0, 0, 0, 0, 0};
+    m_fineFrameStart = m_frameCount;
+    ++m_fineIndex;
+
+    if (m_fineIndex % FINE_PER_COARSE == 0) {
+        closeCoarse();
+    }
+}
+
+void HistoryTiers::closeCoarse() {
+    // Reordering the fine runs is harmless: their 1% values are taken
+    Bucket bucket = m_openCoarse;
+    bucket.low1 = slowFrame(m_frames.data(), m_frameCount);
+
+    m_coarse->push(bucket);
+    ++m_coarseTotal;
+
+    m_openCoarse = {0, 0, 0, 0, 0};
+    m_frameCount = 0;
+    m_fineFrameStart = 0;
+}
+
+uint32_t HistoryTiers::slowFrame(uint32_t* first, size_t count) {
+    if (count == 0) {
+        return 0;
+    }
+
+    // Same rank as the exact percentile engine, without interpolation
+    size_t rank = static_cast<size_t>(0.01 * (count - 1));
+    std::nth_element(first, first + rank, first + count, std::greater<uint32_t>());
+    return first[rank];
+}
+
+void HistoryTiers::merge(Bucket& total, const Bucket& bucket) {
+    if (bucket.frames == 0) {
+        return;
+    }
+
+    if (total.frames == 0) {
+        total.shortest = bucket.shortest;
+        total.longest = bucket.longest;
+    } else {
+        total.shortest = std::min(total.shortest, bucket.shortest);
+        total.longest = std::max(total.longest, bucket.longest);
+    }
+    // Upper bound only; closeCoarse() recomputes it from the frames
+    total.low1 = std::max(total.low1, bucket.low1);
+    total.frames += bucket.frames;
+    total.ticks += bucket.ticks;
+}
+
+double HistoryTiers::framesLongerThan(const Bucket& bucket, double ticks) {
+    const double frames = bucket.frames;
+    if (ticks < bucket.shortest) {
+        return frames;
+    }
+    if (ticks >= bucket.longest) {
+        return 0.0;
+    }
+
+    // Frame times are heavy-tailed: interpolate the count on a log time
+    // scale, from every frame at the shortest through the frames at or
+    // above low1 (its rank + 1) to the single longest frame
+    double lowCount = std::floor(0.01 * (frames - 1.0)) + 1.0;
+    double from = bucket.shortest, to = bucket.low1, fromCount = frames, toCount = lowCount;
+    if (ticks >= bucket.low1) {
+        from = bucket.low1;
+        to = bucket.longest;
+        fromCount = lowCount;
+        toCount = 1.0;
+    }
+
+    double position = (to > from) ? std::log(ticks / from) / std::log(to / from) : 1.0;
+    return fromCount + (toCount - fromCount) * position;
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "ring_buffer.h"
+#include "sample_view.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Multi-resolution frame-time history for long sessions
+ *
+ * Full-resolution frame times stay in FpsCalculator's window; this class
+ * rolls every frame up into fixed-interval aggregates on the session
+ * clock (the sum of frame times), so an hour of history costs a few
+ * hundred kilobytes regardless of frame rate:
+ * - Fine tier: one bucket per 100 ms for the last 10 minutes
+ * - Coarse tier: one bucket per second for the last hour
+ *
+ * A bucket keeps the shortest, longest and 1% slowest frame time, the
+ * frame count and the total ticks (the average is frames over ticks). A
+ * frame belongs to the bucket its end falls in; intervals without a frame
+ * (a long stall) produce empty buckets, so the buckets stay evenly
+ * spaced in time (a stall longer than an hour is shortened to one).
+ *
+ * All storage is allocated at construction; add() never allocates. The
+ * frames of the open second are kept for the 1% values, up to
+ * FRAME_CAPACITY (beyond it frames still count towards the other fields).
+ * Not thread-safe: owned by the analysis thread.
+ */
+class HistoryTiers {
+public:
+    /**
+     * @brief Aggregate of the frames ending in one interval
+     */
+    struct Bucket {
+        uint32_t shortest;      ///< Shortest frame in ticks (0 if empty)
+        uint32_t longest;       ///< Longest frame in ticks (0 if empty)
+        uint32_t low1;          ///< 1% slowest frame time in ticks (0 if empty)
+        uint32_t frames;        ///< Frames in the interval
+        uint64_t ticks;         ///< Sum of the frame times
+    };
+
+    /**
+     * @brief Aggregation levels, finest first
+     */
+    enum class Tier {
+        Fine,       ///< 100 ms buckets
+        Coarse,     ///< 1 s buckets
+        Count
+    };
+
+    static constexpr size_t TIER_COUNT = static_cast<size_t>(Tier::Count);    ///< Aggregation levels
+    static constexpr size_t FINE_CAPACITY = 6000;       ///< Fine buckets kept (10 minutes)
+    static constexpr size_t COARSE_CAPACITY = 3600;     ///< Coarse buckets kept (1 hour)
+    static constexpr size_t FINE_PER_COARSE = 10;       ///< Fine buckets per coarse bucket
+    static constexpr size_t FRAME_CAPACITY = 8192;      ///< Frames of the open second kept for 1% values
+
+    /**
+     * @brief Construct empty tiers
+     *
+     * @param tickFrequency Ticks per second of the frame times
+     */
+    explicit HistoryTiers(int64_t tickFrequency);
+
+    /**
+     * @brief Destroy the History Tiers
+     */
+    ~HistoryTiers();
+
+    /**
+     * @brief Add the next frame time
+     *
+     * @param ticks Frame time in ticks (0 is ignored)
+     */
+    void add(uint32_t ticks);
+
+    /**
+     * @brief Clear every tier (new session)
+     */
+    void reset();
+
+    /**
+     * @brief Get the closed buckets of a tier (oldest to newest)
+     *
+     * @param tier Aggregation level
+     * @return SampleView<Bucket> View (invalidated by the next add())
+     */
+    SampleView<Bucket> getView(Tier tier) const;
+
+    /**
+     * @brief Get the number of buckets a tier closed since the last reset
+     *
+     * Lets consumers identify the buckets added since they last looked.
+     *
+     * @param tier Aggregation level
+     * @return uint64_t Total closed buckets
+     */
+    uint64_t getTotalBuckets(Tier tier) const;
+
+    /**
+     * @brief Aggregate every frame still covered by the tiers
+     *
+     * The coarse tier plus the closed fine buckets of the open second (the
+     * last hour, less the open 100 ms).
+     *
+     * @return Bucket Session totals (frames == 0 if nothing was closed yet;
+     *                low1 is only an upper bound)
+     */
+    Bucket getSessionTotals() const;
+
+    /**
+     * @brief Estimate the frame time exceeded by a share of the session's frames
+     *
+     * Uses the buckets covered by getSessionTotals(): within a bucket the
+     * number of frames longer than a given time is interpolated (on a log
+     * time scale) between its shortest (all frames), 1% and longest frame
+     * (one frame); the estimates are summed over the buckets and the time
+     * bisected.
+     *
+     * @param fraction Share of frames, e.g. 0.01 for the 1% low
+     * @return double Frame time in ticks (0 if there are no frames)
+     */
+    double estimateSlowFrame(double fraction) const;
+
+    /**
+     * @brief Get the duration of one bucket
+     *
+     * @param tier Aggregation level
+     * @return double Seconds per bucket
+     */
+    static double getBucketSeconds(Tier tier);
+
+    /**
+     * @brief Pick the tier to draw a time span from
+     *
+     * The coarsest tier that still gives every pixel column at least one
+     * bucket, or the coarse tier when the span is longer than the fine
+     * tier keeps.
+     *
+     * @param viewSeconds Displayed span
+     * @param columns Pixel columns of the graph
+     * @return Tier Tier to draw
+     */
+    static Tier selectTier(double viewSeconds, size_t columns);
+
+private:
+    /**
+     * @brief Close the open fine bucket (and the open second on its boundary)
+     */
+    void closeFine();
+
+    /**
+     * @brief Close the open coarse bucket
+     */
+    void closeCoarse();
+
+    /**
+     * @brief Get the 1% slowest frame of a run of frames (reorders them)
+     *
+     * @param first First frame
+     * @param count Frames (may be 0)
+     * @return uint32_t 1% slowest frame time in ticks (0 if count is 0)
+     */
+    static uint32_t slowFrame(uint32_t* first, size_t count);
+
+    /**
+     * @brief Fold a bucket into a running aggregate
+     *
+     * @param total Aggregate to update
+     * @param bucket Bucket to add (empty buckets are ignored)
+     */
+    static void merge(Bucket& total, const Bucket& bucket);
+
+    /**
+     * @brief Estimate how many frames of a bucket are longer than a time
+     *
+     * @param bucket Non-empty bucket
+     * @param ticks Frame time
+     * @return double Estimated frame count
+     */
+    static double framesLongerThan(const Bucket& bucket, double ticks);
+
+    std::unique_ptr<RingBuffer<Bucket, FINE_CAPACITY>> m_fine;      ///< 100 ms buckets
+    std::unique_ptr<RingBuffer<Bucket, COARSE_CAPACITY>> m_coarse;  ///< 1 s buckets
+    std::vector<uint32_t> m_frames;     ///< Frames of the open second (FRAME_CAPACITY)
+    size_t m_frameCount;                ///< Frames stored in m_frames
+    size_t m_fineFrameStart;            ///< First frame of the open fine bucket in m_frames
+    Bucket m_openFine;                  ///< Fine bucket being filled
+    Bucket m_openCoarse;                ///< Coarse bucket being filled (closed fine buckets)
+    uint64_t m_fineIndex;               ///< Absolute index of the open fine bucket
+    uint64_t m_fineTotal;               ///< Fine buckets closed
+    uint64_t m_coarseTotal;             ///< Coarse buckets closed
+    uint64_t m_clock;                   ///< Session time in ticks (end of the last frame)
+    uint64_t m_fineTicks;               ///< Ticks per fine bucket
+};
+
+} // namespace fps_monitor
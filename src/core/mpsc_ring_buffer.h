@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace fps_monitor {
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4324) // Structure padded due to alignment specifier (intended)
+#endif
+
+/**
+ * @brief Lock-free multi-producer/single-consumer ring buffer
+ *
+ * Bounded queue for handing fixed-size records from any number of threads
+ * to one consumer (e.g. log lines to the writer thread). Every slot
+ * carries a sequence number: a producer claims a slot by advancing the
+ * head with a compare-and-swap, fills it and publishes it by bumping the
+ * slot's sequence; the consumer reads slots in order as their sequence
+ * says they are complete. No producer ever waits for another, except
+ * that the consumer cannot pass a slot that is claimed but not yet
+ * published.
+ *
+ * Like SpscRingBuffer, a full buffer rejects new elements.
+ *
+ * @tparam T The type of data to store (should be trivially copyable)
+ * @tparam N The fixed capacity of the buffer (must be a power of two)
+ */
+template<typename T, size_t N>
+class MpscRingBuffer {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "MpscRingBuffer capacity must be a power of two");
+
+public:
+    /**
+     * @brief Construct a new MPSC Ring Buffer object
+     */
+    MpscRingBuffer() : m_head(0), m_tail(0) {
+        for (size_t i = 0; i < N; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Indices are shared between threads; copying would break the protocol
+    MpscRingBuffer(const MpscRingBuffer&) = delete;
+    MpscRingBuffer& operator=(const MpscRingBuffer&) = delete;
+
+    /**
+     * @brief Push a new element (any thread)
+     *
+     * @param value The value to push
+     * @return true if stored
+     * @return false if the buffer is full
+     */
+    bool push(const T& value) {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+
+        for (;;) {
+            slot = &m_slots[head & MASK];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(head);
+
+            if (difference == 0) {
+                // Free slot for this lap: claim it
+                if (m_head.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (difference < 0) {
+                // Still holds the previous lap's element: full
+                return false;
+            } else {
+                // Another producer claimed it first
+                head = m_head.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = value;
+        slot->sequence.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop the oldest element (consumer only)
+     *
+     * @param value Output value
+     * @return true if an element was popped
+     * @return false if the buffer is empty (or the oldest slot is still being written)
+     */
+    bool pop(T& value) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[tail & MASK];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1) {
+            return false;
+        }
+
+        value = slot.value;
+        slot.sequence.store(tail + N, std::memory_order_release);
+        m_tail.store(tail + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /**
+     * @brief Check if the buffer is empty (consumer only)
+     *
+     * @return true if no published element is waiting
+     * @return false otherwise
+     */
+    bool isEmpty() const {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        return m_slots[tail & MASK].sequence.load(std::memory_order_acquire) != tail + 1;
+    }
+
+    /**
+     * @brief Get the maximum capacity of the buffer
+     *
+     * @return size_t Maximum number of elements the buffer can hold
+     */
+    constexpr size_t capacity() const {
+        return N;
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;  ///< Assumed destructive interference size
+    static constexpr size_t MASK = N - 1;          ///< Index mask (replaces modulo)
+
+    /**
+     * @brief One element and its publication state
+     */
+    struct Slot {
+        std::atomic<size_t> sequence;   ///< Equals the claiming index when free, index + 1 once published
+        T value;                        ///< Stored element
+    };
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;  ///< Next index to claim (producers)
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;  ///< Next index to read (consumer-owned)
+    alignas(CACHE_LINE_SIZE) std::array<Slot, N> m_slots; ///< Internal storage
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+} // namespace fps_monitor
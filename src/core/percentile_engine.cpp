@@ -0,0 +1,111 @@
+#include "percentile_engine.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+namespace fps_monitor {
+
+std::unique_ptr<PercentileEngine> PercentileEngine::create(PercentileMode mode, size_t maxSamples,
+                                                           int64_t ticksPerSecond) {
+    switch (mode) {
+        case PercentileMode::Histogram:
+            return std::make_unique<HistogramPercentileEngine>(ticksPerSecond);
+        case PercentileMode::Exact:
+        default:
+            return std::make_unique<ExactPercentileEngine>(maxSamples, ticksPerSecond);
+    }
+}
+
+ExactPercentileEngine::ExactPercentileEngine(size_t maxSamples, int64_t ticksPerSecond)
+    : m_ticksPerSecond(static_cast<double>(ticksPerSecond))
+{
+    m_scratch.reserve(maxSamples);
+}
+
+void ExactPercentileEngine::prepare(const SampleView<uint32_t>& window) {
+    m_scratch.clear();
+    m_scratch.insert(m_scratch.end(), window.firstData(), window.firstData() + window.firstSize());
+    m_scratch.insert(m_scratch.end(), window.secondData(), window.secondData() + window.secondSize());
+}
+
+double ExactPercentileEngine::lowFPS(double fraction) {
+    if (m_scratch.empty()) {
+        return 0.0;
+    }
+
+    if (m_scratch.size() == 1) {
+        return m_ticksPerSecond / m_scratch[0];
+    }
+
+    // Rank from the slowest frame, interpolated like a sorted lookup
+    double index = fraction * (m_scratch.size() - 1);
+    size_t lowerIndex = std::min(static_cast<size_t>(std::floor(index)), m_scratch.size() - 1);
+    double weight = index - lowerIndex;
+
+    auto nth = m_scratch.begin() + lowerIndex;
+    std::nth_element(m_scratch.begin(), nth, m_scratch.end(), std::greater<uint32_t>());
+    double frameTicks = *nth;
+
+    if (weight > 0.0 && lowerIndex + 1 < m_scratch.size()) {
+        // After partitioning, the next rank is the longest frame to the right
+        double nextTicks = *std::max_element(nth + 1, m_scratch.end());
+        frameTicks = frameTicks * (1.0 - weight) + nextTicks * weight;
+    }
+
+    return frameTicks > 0.0 ? m_ticksPerSecond / frameTicks : 0.0;
+}
+
+void ExactPercentileEngine::reset() {
+    m_scratch.clear();
+}
+
+HistogramPercentileEngine::HistogramPercentileEngine(int64_t ticksPerSecond)
+    : m_bins(BIN_COUNT, 0)
+    , m_total(0)
+    , m_maxFrameTimeMs(0.0)
+    , m_msPerTick(1000.0 / static_cast<double>(ticksPerSecond))
+{
+}
+
+void HistogramPercentileEngine::add(uint32_t ticks) {
+    if (ticks == 0) {
+        return;
+    }
+
+    double frameTimeMs = ticks * m_msPerTick;
+    size_t bin = std::min(static_cast<size_t>(frameTimeMs / BIN_WIDTH_MS), BIN_COUNT - 1);
+
+    ++m_bins[bin];
+    ++m_total;
+    m_maxFrameTimeMs = std::max(m_maxFrameTimeMs, frameTimeMs);
+}
+
+double HistogramPercentileEngine::lowFPS(double fraction) {
+    if (m_total == 0) {
+        return 0.0;
+    }
+
+    // Walk down from the slowest frames until the requested share is covered
+    double target = std::max(1.0, fraction * static_cast<double>(m_total));
+    uint64_t cumulative = 0;
+
+    for (size_t bin = BIN_COUNT; bin-- > 0;) {
+        cumulative += m_bins[bin];
+        if (static_cast<double>(cumulative) >= target) {
+            double frameTimeMs = (bin == BIN_COUNT - 1)
+                ? m_maxFrameTimeMs
+                : (bin + 0.5) * BIN_WIDTH_MS;
+            return 1000.0 / frameTimeMs;
+        }
+    }
+
+    return 0.0;
+}
+
+void HistogramPercentileEngine::reset() {
+    std::fill(m_bins.begin(), m_bins.end(), 0);
+    m_total = 0;
+    m_maxFrameTimeMs = 0.0;
+}
+
+} // namespace fps_monitor
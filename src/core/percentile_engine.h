@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "sample_view.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Percentile backend selection
+ */
+enum class PercentileMode {
+    Exact,      ///< Selection (nth_element) over the current sample window
+    Histogram   ///< Streaming frame-time histogram over the whole session
+};
+
+/**
+ * @brief Pluggable backend for low-percentile FPS queries (0.1% / 1% / 5% lows)
+ *
+ * Samples are frame times in QPC ticks; results are FPS. Percentiles are
+ * taken over frame times (the slowest frames) and converted, which is what
+ * "1% low" means in capture tools. Exact backends answer from the window
+ * passed to prepare(); streaming backends accumulate every sample passed to
+ * add() and ignore prepare(). Neither sorts.
+ */
+class PercentileEngine {
+public:
+    virtual ~PercentileEngine() = default;
+
+    /**
+     * @brief Create a backend
+     *
+     * @param mode Backend type
+     * @param maxSamples Largest window expected (pre-sizes exact scratch storage)
+     * @param ticksPerSecond Tick rate of the samples (QPC frequency)
+     * @return std::unique_ptr<PercentileEngine> New backend
+     */
+    static std::unique_ptr<PercentileEngine> create(PercentileMode mode, size_t maxSamples,
+                                                    int64_t ticksPerSecond);
+
+    /**
+     * @brief Feed one new sample (streaming backends)
+     *
+     * @param ticks Frame time in ticks
+     */
+    virtual void add(uint32_t ticks) { (void)ticks; }
+
+    /**
+     * @brief Load the window to query (exact backends)
+     *
+     * @param window Current frame-time window in ticks
+     */
+    virtual void prepare(const SampleView<uint32_t>& window) { (void)window; }
+
+    /**
+     * @brief Get the FPS value at a low percentile
+     *
+     * @param fraction Fraction of slowest frames (0.001 = 0.1% low)
+     * @return double FPS at that percentile (0 if no samples)
+     */
+    virtual double lowFPS(double fraction) = 0;
+
+    /**
+     * @brief Check whether the backend accumulates the whole session
+     *
+     * @return true for streaming backends
+     * @return false for window backends
+     */
+    virtual bool isStreaming() const = 0;
+
+    /**
+     * @brief Discard all accumulated state
+     */
+    virtual void reset() = 0;
+};
+
+/**
+ * @brief Exact percentiles via nth_element on a reusable scratch buffer
+ *
+ * O(n) average per query with no allocation once the scratch buffer has
+ * reached the window size. Interpolates between neighbouring ranks like a
+ * sorted lookup would.
+ */
+class ExactPercentileEngine : public PercentileEngine {
+public:
+    /**
+     * @brief Construct a new Exact Percentile Engine
+     *
+     * @param maxSamples Largest window expected
+     * @param ticksPerSecond Tick rate of the samples
+     */
+    ExactPercentileEngine(size_t maxSamples, int64_t ticksPerSecond);
+
+    void prepare(const SampleView<uint32_t>& window) override;
+    double lowFPS(double fraction) override;
+    bool isStreaming() const override { return false; }
+    void reset() override;
+
+private:
+    std::vector<uint32_t> m_scratch;  ///< Window copy, partially reordered by queries
+    double m_ticksPerSecond;          ///< Sample tick rate
+};
+
+/**
+ * @brief Streaming percentiles from a fixed-bin frame-time histogram
+ *
+ * Bins are 0.01 ms wide up to MAX_FRAME_TIME_MS, plus one overflow bin.
+ * add() is O(1) and queries are O(bins), independent of session length,
+ * which suits multi-minute benchmark captures.
+ */
+class HistogramPercentileEngine : public PercentileEngine {
+public:
+    /**
+     * @brief Construct a new Histogram Percentile Engine
+     * 
+     * @param ticksPerSecond Tick rate of the samples
+     */
+    explicit HistogramPercentileEngine(int64_t ticksPerSecond);
+
+    void add(uint32_t ticks) override;
+    double lowFPS(double fraction) override;
+    bool isStreaming() const override { return true; }
+    void reset() override;
+
+private:
+    static constexpr double BIN_WIDTH_MS = 0.01;       ///< Histogram resolution
+    static constexpr double MAX_FRAME_TIME_MS = 250.0; ///< Largest binned frame time
+    static constexpr size_t BIN_COUNT = static_cast<size_t>(MAX_FRAME_TIME_MS / BIN_WIDTH_MS) + 1;
+
+    std::vector<uint32_t> m_bins;  ///< Frame counts per bin (last bin = overflow)
+    uint64_t m_total;              ///< Frames recorded
+    double m_maxFrameTimeMs;       ///< Largest frame time seen (represents overflow bin)
+    double m_msPerTick;            ///< Tick to millisecond conversion
+};
+
+} // namespace fps_monitor
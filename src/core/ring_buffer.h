@@ -1,8 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 #include <mutex>
 #include <stdexcept>
+#include "sample_view.h"
 
 namespace fps_monitor {
 
@@ -97,6 +99,27 @@ public:
         return result;
     }
 
+    /**
+     * @brief Get a zero-copy view of all elements (oldest to newest)
+     * 
+     * The view aliases internal storage: it is invalidated by the next
+     * push() or clear(), so it must only be used by the thread that writes
+     * the buffer (or while writers are otherwise excluded).
+     * 
+     * @return SampleView<T> View over the current elements
+     */
+    SampleView<T> view() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_size == 0) {
+            return SampleView<T>();
+        }
+
+        size_t oldest = (m_head + N - m_size) % N;
+        size_t firstSize = std::min(m_size, N - oldest);
+        return SampleView<T>(m_buffer.data() + oldest, firstSize,
+                             m_buffer.data(), m_size - firstSize);
+    }
+
     /**
      * @brief Get the current number of elements in the buffer
      * 
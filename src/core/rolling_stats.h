@@ -0,0 +1,216 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+namespace fps_monitor {
+
+/**
+ * @brief Fixed-capacity monotonic queue for sliding-window extrema
+ *
+ * Keeps the candidates for the window minimum (Compare = std::less) or
+ * maximum (Compare = std::greater) in order, so the extreme is always at
+ * the front. Each element is pushed and popped at most once: O(1) amortised
+ * per sample, with storage preallocated for N entries.
+ *
+ * @tparam T Value type
+ * @tparam Compare Strict ordering that keeps the front extreme
+ * @tparam N Maximum window size
+ */
+template<typename T, typename Compare, size_t N>
+class MonotonicQueue {
+public:
+    MonotonicQueue() : m_head(0), m_count(0) {}
+
+    /**
+     * @brief Add the newest value
+     *
+     * @param sequence Monotonic sample sequence number
+     * @param value Sample value
+     */
+    void push(uint64_t sequence, T value) {
+        // Drop candidates that can never be the extreme again
+        while (m_count > 0 && !Compare()(m_entries[index(m_count - 1)].value, value)) {
+            --m_count;
+        }
+
+        m_entries[index(m_count)] = {sequence, value};
+        ++m_count;
+    }
+
+    /**
+     * @brief Remove entries older than the window start
+     *
+     * @param firstSequence Sequence number of the oldest sample still in the window
+     */
+    void evictBefore(uint64_t firstSequence) {
+        while (m_count > 0 && m_entries[m_head].sequence < firstSequence) {
+            m_head = (m_head + 1) % N;
+            --m_count;
+        }
+    }
+
+    /**
+     * @brief Get the window extreme (queue must not be empty)
+     *
+     * @return T Minimum or maximum of the window
+     */
+    T front() const {
+        return m_entries[m_head].value;
+    }
+
+    bool empty() const { return m_count == 0; }  ///< True if no samples
+
+    /**
+     * @brief Remove all entries
+     */
+    void clear() {
+        m_head = 0;
+        m_count = 0;
+    }
+
+private:
+    struct Entry {
+        uint64_t sequence;  ///< Sample sequence number
+        T value;            ///< Sample value
+    };
+
+    size_t index(size_t offset) const {
+        return (m_head + offset) % N;
+    }
+
+    std::array<Entry, N> m_entries;  ///< Ring storage
+    size_t m_head;                   ///< Front entry
+    size_t m_count;                  ///< Live entries
+};
+
+/**
+ * @brief O(1) rolling sum, mean, min and max over a sliding sample window
+ *
+ * Integral samples (e.g. QPC tick deltas) are summed exactly in 64 bits.
+ * Floating-point samples use Neumaier (improved Kahan) compensation so that
+ * adding the new sample and subtracting the evicted one does not accumulate
+ * drift.
+ *
+ * The caller owns the sample storage and passes the evicted value when the
+ * window slides or shrinks.
+ *
+ * @tparam T Sample type
+ * @tparam N Maximum window size
+ */
+template<typename T, size_t N>
+class RollingStats {
+public:
+    /// Accumulator type: exact for integers, compensated double otherwise
+    using SumType = typename std::conditional<std::is_integral<T>::value, uint64_t, double>::type;
+
+    RollingStats() : m_sum(0), m_compensation(0.0), m_count(0), m_nextSequence(0) {}
+
+    /**
+     * @brief Add a sample while the window is still filling
+     *
+     * @param value New sample
+     */
+    void push(T value) {
+        addToSum(value);
+        ++m_count;
+        pushExtrema(value);
+    }
+
+    /**
+     * @brief Add a sample and evict the oldest one
+     *
+     * @param value New sample
+     * @param evicted Sample leaving the window
+     */
+    void push(T value, T evicted) {
+        addToSum(value);
+        subtractFromSum(evicted);
+        pushExtrema(value);
+    }
+
+    /**
+     * @brief Remove the oldest sample without adding one (window shrinks)
+     *
+     * @param evicted Sample leaving the window
+     */
+    void evict(T evicted) {
+        subtractFromSum(evicted);
+        --m_count;
+        uint64_t firstSequence = m_nextSequence - m_count;
+        m_min.evictBefore(firstSequence);
+        m_max.evictBefore(firstSequence);
+    }
+
+    /**
+     * @brief Remove all samples
+     */
+    void reset() {
+        m_sum = 0;
+        m_compensation = 0.0;
+        m_count = 0;
+        m_nextSequence = 0;
+        m_min.clear();
+        m_max.clear();
+    }
+
+    /// Window sum
+    SumType sum() const {
+        if constexpr (std::is_integral<T>::value) {
+            return m_sum;
+        } else {
+            return m_sum + m_compensation;
+        }
+    }
+
+    size_t count() const { return m_count; }                              ///< Window sample count
+    double mean() const { return m_count > 0 ? static_cast<double>(sum()) / m_count : 0.0; } ///< Window mean
+    T min() const { return m_min.empty() ? T() : m_min.front(); }          ///< Window minimum
+    T max() const { return m_max.empty() ? T() : m_max.front(); }          ///< Window maximum
+
+private:
+    void addToSum(T value) {
+        if constexpr (std::is_integral<T>::value) {
+            m_sum += static_cast<SumType>(value);
+        } else {
+            double total = m_sum + value;
+            if ((m_sum >= 0.0 ? m_sum : -m_sum) >= (value >= 0.0 ? value : -value)) {
+                m_compensation += (m_sum - total) + value;
+            } else {
+                m_compensation += (value - total) + m_sum;
+            }
+            m_sum = total;
+        }
+    }
+
+    void subtractFromSum(T value) {
+        if constexpr (std::is_integral<T>::value) {
+            m_sum -= static_cast<SumType>(value);
+        } else {
+            addToSum(-value);
+        }
+    }
+
+    void pushExtrema(T value) {
+        uint64_t sequence = m_nextSequence++;
+        if (sequence + 1 > m_count) {
+            uint64_t firstSequence = sequence + 1 - m_count;
+            m_min.evictBefore(firstSequence);
+            m_max.evictBefore(firstSequence);
+        }
+        m_min.push(sequence, value);
+        m_max.push(sequence, value);
+    }
+
+    SumType m_sum;                                     ///< Running sum
+    double m_compensation;                             ///< Neumaier compensation term (floating point only)
+    size_t m_count;                                    ///< Samples in window
+    uint64_t m_nextSequence;                           ///< Sequence number of next sample
+    MonotonicQueue<T, std::less<T>, N> m_min;          ///< Window minimum candidates
+    MonotonicQueue<T, std::greater<T>, N> m_max;       ///< Window maximum candidates
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+
+namespace fps_monitor {
+
+/**
+ * @brief Read-only, non-owning view over ring buffer contents
+ *
+ * A ring buffer's live elements occupy at most two contiguous segments of
+ * its storage. SampleView exposes both segments in chronological order
+ * (oldest to newest) so consumers can iterate history without copying it.
+ *
+ * A view aliases the buffer's storage and is invalidated by the next write
+ * to that buffer; it must not outlive the current frame.
+ *
+ * @tparam T The element type
+ */
+template<typename T>
+class SampleView {
+public:
+    /**
+     * @brief Construct an empty view
+     */
+    SampleView()
+        : m_first(nullptr), m_firstSize(0), m_second(nullptr), m_secondSize(0) {}
+
+    /**
+     * @brief Construct a view from two contiguous segments
+     *
+     * @param first Oldest segment
+     * @param firstSize Number of elements in the oldest segment
+     * @param second Newest segment (may be nullptr if secondSize == 0)
+     * @param secondSize Number of elements in the newest segment
+     */
+    SampleView(const T* first, size_t firstSize, const T* second, size_t secondSize)
+        : m_first(first), m_firstSize(firstSize), m_second(second), m_secondSize(secondSize) {}
+
+    /**
+     * @brief Get the number of elements in the view
+     *
+     * @return size_t Element count
+     */
+    size_t size() const {
+        return m_firstSize + m_secondSize;
+    }
+
+    /**
+     * @brief Check if the view is empty
+     *
+     * @return true if size() == 0
+     * @return false otherwise
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Access element by chronological index (0 = oldest)
+     *
+     * No bounds checking.
+     *
+     * @param index Element index
+     * @return const T& The element
+     */
+    const T& operator[](size_t index) const {
+        return index < m_firstSize ? m_first[index] : m_second[index - m_firstSize];
+    }
+
+    /**
+     * @brief Get the oldest element (view must not be empty)
+     *
+     * @return const T& Oldest element
+     */
+    const T& front() const {
+        return (*this)[0];
+    }
+
+    /**
+     * @brief Get the newest element (view must not be empty)
+     *
+     * @return const T& Newest element
+     */
+    const T& back() const {
+        return (*this)[size() - 1];
+    }
+
+    /**
+     * @brief Get a view of the newest count elements
+     *
+     * @param count Number of trailing elements (clamped to size())
+     * @return SampleView Trailing sub-view
+     */
+    SampleView last(size_t count) const {
+        if (count >= size()) {
+            return *this;
+        }
+
+        if (count <= m_secondSize) {
+            return SampleView(m_second + (m_secondSize - count), count, nullptr, 0);
+        }
+
+        size_t fromFirst = count - m_secondSize;
+        return SampleView(m_first + (m_firstSize - fromFirst), fromFirst, m_second, m_secondSize);
+    }
+
+    /**
+     * @brief Invoke a function on every element, oldest to newest
+     *
+     * @param func Callable taking const T&
+     */
+    template<typename Func>
+    void forEach(Func&& func) const {
+        for (size_t i = 0; i < m_firstSize; ++i) {
+            func(m_first[i]);
+        }
+        for (size_t i = 0; i < m_secondSize; ++i) {
+            func(m_second[i]);
+        }
+    }
+
+    const T* firstData() const { return m_first; }       ///< Oldest segment
+    size_t firstSize() const { return m_firstSize; }     ///< Oldest segment length
+    const T* secondData() const { return m_second; }     ///< Newest segment
+    size_t secondSize() const { return m_secondSize; }   ///< Newest segment length
+
+private:
+    const T* m_first;       ///< Oldest contiguous segment
+    size_t m_firstSize;     ///< Elements in oldest segment
+    const T* m_second;      ///< Newest contiguous segment
+    size_t m_secondSize;    ///< Elements in newest segment
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,97 @@
+#include "session_pool.h"
+#include <algorithm>
+
+namespace fps_monitor {
+
+SessionPool::SessionPool(const AnalysisThread::Settings& settings, size_t sessionCount)
+    : m_count(std::min(std::max<size_t>(sessionCount, 1), MAX_SESSIONS))
+{
+    for (size_t i = 0; i < m_count; ++i) {
+        m_sessions[i].analysis = std::make_unique<AnalysisThread>(settings);
+        m_sessions[i].processId = 0;
+
+        // Long enough for any executable name, so assigning never reallocates
+        m_sessions[i].name.reserve(MAX_PATH);
+    }
+}
+
+SessionPool::~SessionPool() {
+    stop();
+}
+
+size_t SessionPool::getCapacity() const {
+    return m_count;
+}
+
+AnalysisThread& SessionPool::get(size_t session) {
+    return *m_sessions[session].analysis;
+}
+
+bool SessionPool::start() {
+    for (size_t i = 0; i < m_count; ++i) {
+        // Only the primary session times the overlay while no game is found
+        m_sessions[i].analysis->setOverlayTiming(i == PRIMARY_SESSION);
+        if (!m_sessions[i].analysis->start()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SessionPool::stop() {
+    for (size_t i = 0; i < m_count; ++i) {
+        m_sessions[i].analysis->stop();
+    }
+}
+
+void SessionPool::assign(size_t session, uint32_t processId, const std::string& name) {
+    if (session >= m_count) {
+        return;
+    }
+
+    Session& entry = m_sessions[session];
+    entry.processId = processId;
+    entry.name = name;
+    entry.analysis->requestReset(processId, name);
+}
+
+size_t SessionPool::acquire(uint32_t processId, const std::string& name) {
+    for (size_t i = PRIMARY_SESSION + 1; i < m_count; ++i) {
+        if (m_sessions[i].processId == 0) {
+            assign(i, processId, name);
+            return i;
+        }
+    }
+    return INVALID_SESSION;
+}
+
+void SessionPool::release(size_t session) {
+    if (session != PRIMARY_SESSION && session < m_count && m_sessions[session].processId != 0) {
+        assign(session, 0, std::string());
+    }
+}
+
+size_t SessionPool::find(uint32_t processId) const {
+    for (size_t i = 0; i < m_count; ++i) {
+        if (processId != 0 && m_sessions[i].processId == processId) {
+            return i;
+        }
+    }
+    return INVALID_SESSION;
+}
+
+uint32_t SessionPool::getProcess(size_t session) const {
+    return session < m_count ? m_sessions[session].processId : 0;
+}
+
+const std::string& SessionPool::getName(size_t session) const {
+    return m_sessions[session].name;
+}
+
+void SessionPool::updateSettings(const AnalysisThread::LiveSettings& settings) {
+    for (size_t i = 0; i < m_count; ++i) {
+        m_sessions[i].analysis->updateSettings(settings);
+    }
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "analysis_thread.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Fixed pool of per-process tracking sessions
+ *
+ * Each session is a complete analysis pipeline (AnalysisThread with its
+ * own present queue, sample ring, statistics and drop detector). All of
+ * them are constructed when the pool is created, so the memory used per
+ * session is bounded and allocated once; tracking another game only
+ * assigns it a free session.
+ *
+ * Session 0 is the primary session: it follows the foreground game and
+ * falls back to timing the overlay itself. The others are handed out by
+ * acquire() for additional games and given back with release(); idle
+ * sessions sleep until they are assigned.
+ *
+ * Not thread-safe: assign and release on one thread (the UI thread). The
+ * sessions themselves are AnalysisThreads and follow its threading model.
+ */
+class SessionPool {
+public:
+    static constexpr size_t MAX_SESSIONS = 4;               ///< Largest pool
+    static constexpr size_t PRIMARY_SESSION = 0;            ///< Foreground game / overlay timing
+    static constexpr size_t INVALID_SESSION = SIZE_MAX;     ///< No session
+
+    /**
+     * @brief Construct a pool and every session in it (not started)
+     *
+     * @param settings Analysis configuration shared by all sessions
+     * @param sessionCount Sessions to create (1 - MAX_SESSIONS)
+     */
+    SessionPool(const AnalysisThread::Settings& settings, size_t sessionCount);
+
+    /**
+     * @brief Destroy the pool (stops every session)
+     */
+    ~SessionPool();
+
+    // Prevent copying
+    SessionPool(const SessionPool&) = delete;
+    SessionPool& operator=(const SessionPool&) = delete;
+
+    /**
+     * @brief Get the number of sessions
+     *
+     * @return size_t Sessions in the pool
+     */
+    size_t getCapacity() const;
+
+    /**
+     * @brief Get a session's pipeline
+     *
+     * Configure capture sources, callbacks and recorders through it before
+     * start().
+     *
+     * @param session Session index (< getCapacity())
+     * @return AnalysisThread& Session pipeline
+     */
+    AnalysisThread& get(size_t session);
+
+    /**
+     * @brief Start every session's thread
+     *
+     * Secondary sessions start idle (no overlay timing).
+     *
+     * @return true if all threads are running
+     * @return false otherwise
+     */
+    bool start();
+
+    /**
+     * @brief Stop and join every session's thread
+     */
+    void stop();
+
+    /**
+     * @brief Point a session at a process, resetting its results
+     *
+     * @param session Session index
+     * @param processId Process to track (0 for none)
+     * @param name Process name
+     */
+    void assign(size_t session, uint32_t processId, const std::string& name);
+
+    /**
+     * @brief Assign a free secondary session to a process
+     *
+     * @param processId Process to track
+     * @param name Process name
+     * @return size_t Session index, or INVALID_SESSION if all are in use
+     */
+    size_t acquire(uint32_t processId, const std::string& name);
+
+    /**
+     * @brief Return a secondary session to the pool
+     *
+     * @param session Session index
+     */
+    void release(size_t session);
+
+    /**
+     * @brief Find the session tracking a process
+     *
+     * @param processId Process ID (not 0)
+     * @return size_t Session index, or INVALID_SESSION
+     */
+    size_t find(uint32_t processId) const;
+
+    /**
+     * @brief Get the process a session tracks
+     *
+     * @param session Session index
+     * @return uint32_t Process ID (0 if idle)
+     */
+    uint32_t getProcess(size_t session) const;
+
+    /**
+     * @brief Get the name of the process a session tracks
+     *
+     * @param session Session index
+     * @return const std::string& Process name (empty if idle)
+     */
+    const std::string& getName(size_t session) const;
+
+    /**
+     * @brief Apply reloaded settings to every session
+     *
+     * @param settings New settings
+     */
+    void updateSettings(const AnalysisThread::LiveSettings& settings);
+
+private:
+    /**
+     * @brief One pooled pipeline
+     */
+    struct Session {
+        std::unique_ptr<AnalysisThread> analysis;   ///< Pipeline (created with the pool)
+        uint32_t processId;                         ///< Tracked process (0 = idle)
+        std::string name;                           ///< Tracked process name
+    };
+
+    Session m_sessions[MAX_SESSIONS];   ///< Sessions (first m_count in use)
+    size_t m_count;                     ///< Sessions created
+};
+
+} // namespace fps_monitor
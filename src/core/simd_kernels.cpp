@@ -0,0 +1,367 @@
+#include "simd_kernels.h"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define FPS_MONITOR_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+// MSVC accepts intrinsics in any function; GCC/Clang need per-function targets
+#if defined(FPS_MONITOR_SIMD_X86) && !defined(_MSC_VER)
+#define FPS_MONITOR_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define FPS_MONITOR_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FPS_MONITOR_TARGET_SSE41
+#define FPS_MONITOR_TARGET_AVX2
+#endif
+
+namespace fps_monitor {
+
+namespace {
+
+constexpr uint32_t MAX_SIGNED_TICKS = static_cast<uint32_t>(std::numeric_limits<int32_t>::max());
+constexpr size_t COUNT_FLUSH_BLOCK = 1u << 16;  ///< Vectors per 32-bit lane count flush
+
+// ---------------------------------------------------------------------------
+// Scalar kernels (also used for SIMD tails)
+// ---------------------------------------------------------------------------
+
+inline float graphY(uint32_t ticks, const GraphTransform& t) {
+    float fps = t.ticksPerSecond / static_cast<float>(static_cast<int32_t>(std::min(ticks, MAX_SIGNED_TICKS)));
+    fps = std::max(t.minFPS, std::min(fps, t.maxFPS));
+    return t.bottom - (fps - t.minFPS) * t.scale;
+}
+
+uint64_t sumScalar(const uint32_t* data, size_t count) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += data[i];
+    }
+    return total;
+}
+
+uint32_t minScalar(const uint32_t* data, size_t count) {
+    uint32_t result = std::numeric_limits<uint32_t>::max();
+    for (size_t i = 0; i < count; ++i) {
+        result = std::min(result, data[i]);
+    }
+    return result;
+}
+
+uint32_t maxScalar(const uint32_t* data, size_t count) {
+    uint32_t result = 0;
+    for (size_t i = 0; i < count; ++i) {
+        result = std::max(result, data[i]);
+    }
+    return result;
+}
+
+size_t countAboveScalar(const uint32_t* data, size_t count, uint32_t threshold) {
+    size_t result = 0;
+    for (size_t i = 0; i < count; ++i) {
+        result += data[i] > threshold ? 1 : 0;
+    }
+    return result;
+}
+
+void toGraphYScalar(const uint32_t* data, size_t count, const GraphTransform& transform, float* out) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = graphY(data[i], transform);
+    }
+}
+
+#if defined(FPS_MONITOR_SIMD_X86)
+
+// ---------------------------------------------------------------------------
+// SSE4.1 kernels (4 samples per step)
+// ---------------------------------------------------------------------------
+
+FPS_MONITOR_TARGET_SSE41
+uint64_t sumSSE41(const uint32_t* data, size_t count) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        acc = _mm_add_epi64(acc, _mm_cvtepu32_epi64(v));
+        acc = _mm_add_epi64(acc, _mm_cvtepu32_epi64(_mm_srli_si128(v, 8)));
+    }
+
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + sumScalar(data + i, count - i);
+}
+
+FPS_MONITOR_TARGET_SSE41
+uint32_t minSSE41(const uint32_t* data, size_t count) {
+    __m128i acc = _mm_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc = _mm_min_epu32(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+    }
+
+    alignas(16) uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return std::min(minScalar(lanes, 4), minScalar(data + i, count - i));
+}
+
+FPS_MONITOR_TARGET_SSE41
+uint32_t maxSSE41(const uint32_t* data, size_t count) {
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc = _mm_max_epu32(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+    }
+
+    alignas(16) uint32_t lanes[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return std::max(maxScalar(lanes, 4), maxScalar(data + i, count - i));
+}
+
+FPS_MONITOR_TARGET_SSE41
+size_t countAboveSSE41(const uint32_t* data, size_t count, uint32_t threshold) {
+    if (threshold == std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    // x > threshold  <=>  max(x, threshold + 1) == x
+    __m128i limit = _mm_set1_epi32(static_cast<int>(threshold + 1));
+    size_t result = 0;
+    size_t i = 0;
+    while (i + 4 <= count) {
+        // Lane counters are 32-bit; flush before they can overflow
+        __m128i acc = _mm_setzero_si128();
+        for (size_t block = 0; block < COUNT_FLUSH_BLOCK && i + 4 <= count; ++block, i += 4) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            acc = _mm_sub_epi32(acc, _mm_cmpeq_epi32(_mm_max_epu32(v, limit), v));
+        }
+
+        alignas(16) uint32_t lanes[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        result += static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+
+    return result + countAboveScalar(data + i, count - i, threshold);
+}
+
+FPS_MONITOR_TARGET_SSE41
+void toGraphYSSE41(const uint32_t* data, size_t count, const GraphTransform& transform, float* out) {
+    __m128i maxTicks = _mm_set1_epi32(static_cast<int>(MAX_SIGNED_TICKS));
+    __m128 ticksPerSecond = _mm_set1_ps(transform.ticksPerSecond);
+    __m128 minFPS = _mm_set1_ps(transform.minFPS);
+    __m128 maxFPS = _mm_set1_ps(transform.maxFPS);
+    __m128 bottom = _mm_set1_ps(transform.bottom);
+    __m128 scale = _mm_set1_ps(transform.scale);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128i v = _mm_min_epu32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), maxTicks);
+        __m128 fps = _mm_div_ps(ticksPerSecond, _mm_cvtepi32_ps(v));
+        fps = _mm_max_ps(minFPS, _mm_min_ps(fps, maxFPS));
+        _mm_storeu_ps(out + i, _mm_sub_ps(bottom, _mm_mul_ps(_mm_sub_ps(fps, minFPS), scale)));
+    }
+
+    toGraphYScalar(data + i, count - i, transform, out + i);
+}
+
+// ---------------------------------------------------------------------------
+// AVX2 kernels (8 samples per step)
+// ---------------------------------------------------------------------------
+
+FPS_MONITOR_TARGET_AVX2
+uint64_t sumAVX2(const uint32_t* data, size_t count) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 4));
+        acc0 = _mm256_add_epi64(acc0, _mm256_cvtepu32_epi64(lo));
+        acc1 = _mm256_add_epi64(acc1, _mm256_cvtepu32_epi64(hi));
+    }
+
+    alignas(32) uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc0, acc1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sumScalar(data + i, count - i);
+}
+
+FPS_MONITOR_TARGET_AVX2
+uint32_t minAVX2(const uint32_t* data, size_t count) {
+    __m256i acc = _mm256_set1_epi32(-1);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc = _mm256_min_epu32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    }
+
+    alignas(32) uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return std::min(minScalar(lanes, 8), minScalar(data + i, count - i));
+}
+
+FPS_MONITOR_TARGET_AVX2
+uint32_t maxAVX2(const uint32_t* data, size_t count) {
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc = _mm256_max_epu32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)));
+    }
+
+    alignas(32) uint32_t lanes[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return std::max(maxScalar(lanes, 8), maxScalar(data + i, count - i));
+}
+
+FPS_MONITOR_TARGET_AVX2
+size_t countAboveAVX2(const uint32_t* data, size_t count, uint32_t threshold) {
+    if (threshold == std::numeric_limits<uint32_t>::max()) {
+        return 0;
+    }
+
+    __m256i limit = _mm256_set1_epi32(static_cast<int>(threshold + 1));
+    size_t result = 0;
+    size_t i = 0;
+    while (i + 8 <= count) {
+        __m256i acc = _mm256_setzero_si256();
+        for (size_t block = 0; block < COUNT_FLUSH_BLOCK && i + 8 <= count; ++block, i += 8) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+            acc = _mm256_sub_epi32(acc, _mm256_cmpeq_epi32(_mm256_max_epu32(v, limit), v));
+        }
+
+        alignas(32) uint32_t lanes[8];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        for (uint32_t lane : lanes) {
+            result += lane;
+        }
+    }
+
+    return result + countAboveScalar(data + i, count - i, threshold);
+}
+
+FPS_MONITOR_TARGET_AVX2
+void toGraphYAVX2(const uint32_t* data, size_t count, const GraphTransform& transform, float* out) {
+    __m256i maxTicks = _mm256_set1_epi32(static_cast<int>(MAX_SIGNED_TICKS));
+    __m256 ticksPerSecond = _mm256_set1_ps(transform.ticksPerSecond);
+    __m256 minFPS = _mm256_set1_ps(transform.minFPS);
+    __m256 maxFPS = _mm256_set1_ps(transform.maxFPS);
+    __m256 bottom = _mm256_set1_ps(transform.bottom);
+    __m256 scale = _mm256_set1_ps(transform.scale);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i v = _mm256_min_epu32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), maxTicks);
+        __m256 fps = _mm256_div_ps(ticksPerSecond, _mm256_cvtepi32_ps(v));
+        fps = _mm256_max_ps(minFPS, _mm256_min_ps(fps, maxFPS));
+        _mm256_storeu_ps(out + i, _mm256_sub_ps(bottom, _mm256_mul_ps(_mm256_sub_ps(fps, minFPS), scale)));
+    }
+
+    toGraphYScalar(data + i, count - i, transform, out + i);
+}
+
+// ---------------------------------------------------------------------------
+// CPU feature detection
+// ---------------------------------------------------------------------------
+
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuidex(info, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<uint32_t>(info[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+uint64_t readXcr0() {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax = 0;
+    uint32_t edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+#endif // FPS_MONITOR_SIMD_X86
+
+} // namespace
+
+SimdLevel SimdKernels::detect() {
+#if defined(FPS_MONITOR_SIMD_X86)
+    uint32_t regs[4];
+    cpuid(0, 0, regs);
+    uint32_t maxLeaf = regs[0];
+
+    cpuid(1, 0, regs);
+    bool sse41 = (regs[2] & (1u << 19)) != 0;
+    bool osxsave = (regs[2] & (1u << 27)) != 0;
+    bool avx = (regs[2] & (1u << 28)) != 0;
+
+    // AVX state must be enabled by the OS (XMM and YMM bits in XCR0)
+    if (avx && osxsave && (readXcr0() & 0x6) == 0x6 && maxLeaf >= 7) {
+        cpuid(7, 0, regs);
+        if ((regs[1] & (1u << 5)) != 0) {
+            return SimdLevel::AVX2;
+        }
+    }
+
+    if (sse41) {
+        return SimdLevel::SSE41;
+    }
+#endif
+
+    return SimdLevel::Scalar;
+}
+
+const SimdKernels& SimdKernels::get() {
+    static const SimdKernels& best = get(detect());
+    return best;
+}
+
+const SimdKernels& SimdKernels::get(SimdLevel level) {
+    static const SimdKernels scalar(SimdLevel::Scalar, sumScalar, minScalar, maxScalar,
+                                    countAboveScalar, toGraphYScalar);
+#if defined(FPS_MONITOR_SIMD_X86)
+    static const SimdKernels sse41(SimdLevel::SSE41, sumSSE41, minSSE41, maxSSE41,
+                                   countAboveSSE41, toGraphYSSE41);
+    static const SimdKernels avx2(SimdLevel::AVX2, sumAVX2, minAVX2, maxAVX2,
+                                  countAboveAVX2, toGraphYAVX2);
+    static const SimdLevel supported = detect();
+
+    SimdLevel effective = std::min(level, supported);
+    switch (effective) {
+        case SimdLevel::AVX2:
+            return avx2;
+        case SimdLevel::SSE41:
+            return sse41;
+        case SimdLevel::Scalar:
+        default:
+            return scalar;
+    }
+#else
+    (void)level;
+    return scalar;
+#endif
+}
+
+const char* SimdKernels::name() const {
+    switch (m_level) {
+        case SimdLevel::AVX2:
+            return "avx2";
+        case SimdLevel::SSE41:
+            return "sse4.1";
+        case SimdLevel::Scalar:
+        default:
+            return "scalar";
+    }
+}
+
+} // namespace fps_monitor
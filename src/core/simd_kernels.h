@@ -0,0 +1,182 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "sample_view.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Instruction set used by a SimdKernels instance
+ */
+enum class SimdLevel {
+    Scalar,     ///< Portable C++ loops
+    SSE41,      ///< 128-bit SSE4.1
+    AVX2        ///< 256-bit AVX2
+};
+
+/**
+ * @brief Mapping from frame times to graph Y coordinates
+ *
+ * y = bottom - (clamp(ticksPerSecond / ticks, minFPS, maxFPS) - minFPS) * scale
+ */
+struct GraphTransform {
+    float ticksPerSecond;  ///< Sample tick rate
+    float minFPS;          ///< FPS at the bottom edge
+    float maxFPS;          ///< FPS at the top edge
+    float bottom;          ///< Y coordinate of the bottom edge
+    float scale;           ///< Pixels per FPS
+};
+
+/**
+ * @brief Batch reductions over frame-time samples (QPC ticks)
+ *
+ * Kernels exist for AVX2, SSE4.1 and plain C++; get() picks the best set
+ * the CPU and OS support (via CPUID/XGETBV) once, on first use. All levels
+ * produce bit-identical results: the integer reductions are exact and the
+ * graph transform uses single-precision arithmetic in every path.
+ *
+ * Frame times are expected to be non-zero. For the graph transform, ticks
+ * above INT32_MAX are saturated (they are clamped to minFPS anyway).
+ */
+class SimdKernels {
+public:
+    /**
+     * @brief Get the kernels for the best supported instruction set
+     *
+     * @return const SimdKernels& Kernel set (static lifetime)
+     */
+    static const SimdKernels& get();
+
+    /**
+     * @brief Get the kernels for a specific instruction set
+     *
+     * Falls back to the best supported level at or below the request, so
+     * benchmarks can compare levels safely on any machine.
+     *
+     * @param level Requested instruction set
+     * @return const SimdKernels& Kernel set (static lifetime)
+     */
+    static const SimdKernels& get(SimdLevel level);
+
+    /**
+     * @brief Detect the best instruction set the CPU and OS support
+     *
+     * @return SimdLevel Supported level
+     */
+    static SimdLevel detect();
+
+    /**
+     * @brief Get the instruction set of this kernel set
+     *
+     * @return SimdLevel Kernel level
+     */
+    SimdLevel level() const { return m_level; }
+
+    /**
+     * @brief Get a printable name for the instruction set
+     *
+     * @return const char* "scalar", "sse4.1" or "avx2"
+     */
+    const char* name() const;
+
+    /**
+     * @brief Sum of frame times
+     *
+     * @param data Samples
+     * @param count Number of samples
+     * @return uint64_t Exact sum (0 if empty)
+     */
+    uint64_t sum(const uint32_t* data, size_t count) const { return m_sum(data, count); }
+
+    /**
+     * @brief Shortest frame time
+     *
+     * @param data Samples
+     * @param count Number of samples
+     * @return uint32_t Minimum (UINT32_MAX if empty)
+     */
+    uint32_t min(const uint32_t* data, size_t count) const { return m_min(data, count); }
+
+    /**
+     * @brief Longest frame time
+     *
+     * @param data Samples
+     * @param count Number of samples
+     * @return uint32_t Maximum (0 if empty)
+     */
+    uint32_t max(const uint32_t* data, size_t count) const { return m_max(data, count); }
+
+    /**
+     * @brief Count frames longer than a threshold (i.e. below an FPS limit)
+     *
+     * @param data Samples
+     * @param count Number of samples
+     * @param threshold Frame time in ticks
+     * @return size_t Number of samples > threshold
+     */
+    size_t countAbove(const uint32_t* data, size_t count, uint32_t threshold) const {
+        return m_countAbove(data, count, threshold);
+    }
+
+    /**
+     * @brief Convert frame times to graph Y coordinates
+     *
+     * @param data Samples
+     * @param count Number of samples
+     * @param transform Scale and offset
+     * @param out Destination (count floats)
+     */
+    void toGraphY(const uint32_t* data, size_t count, const GraphTransform& transform, float* out) const {
+        m_toGraphY(data, count, transform, out);
+    }
+
+    /// @name SampleView overloads (both segments, oldest to newest)
+    /// @{
+    uint64_t sum(const SampleView<uint32_t>& samples) const {
+        return sum(samples.firstData(), samples.firstSize()) + sum(samples.secondData(), samples.secondSize());
+    }
+
+    uint32_t min(const SampleView<uint32_t>& samples) const {
+        uint32_t a = min(samples.firstData(), samples.firstSize());
+        uint32_t b = min(samples.secondData(), samples.secondSize());
+        return a < b ? a : b;
+    }
+
+    uint32_t max(const SampleView<uint32_t>& samples) const {
+        uint32_t a = max(samples.firstData(), samples.firstSize());
+        uint32_t b = max(samples.secondData(), samples.secondSize());
+        return a > b ? a : b;
+    }
+
+    size_t countAbove(const SampleView<uint32_t>& samples, uint32_t threshold) const {
+        return countAbove(samples.firstData(), samples.firstSize(), threshold)
+             + countAbove(samples.secondData(), samples.secondSize(), threshold);
+    }
+
+    void toGraphY(const SampleView<uint32_t>& samples, const GraphTransform& transform, float* out) const {
+        toGraphY(samples.firstData(), samples.firstSize(), transform, out);
+        toGraphY(samples.secondData(), samples.secondSize(), transform, out + samples.firstSize());
+    }
+    /// @}
+
+private:
+    using SumFunc = uint64_t (*)(const uint32_t*, size_t);
+    using ExtremeFunc = uint32_t (*)(const uint32_t*, size_t);
+    using CountFunc = size_t (*)(const uint32_t*, size_t, uint32_t);
+    using TransformFunc = void (*)(const uint32_t*, size_t, const GraphTransform&, float*);
+
+    SimdKernels(SimdLevel level, SumFunc sum, ExtremeFunc min, ExtremeFunc max,
+                CountFunc countAbove, TransformFunc toGraphY)
+        : m_level(level), m_sum(sum), m_min(min), m_max(max)
+        , m_countAbove(countAbove), m_toGraphY(toGraphY) {}
+
+    SimdLevel m_level;            ///< Instruction set
+    SumFunc m_sum;                ///< Sum kernel
+    ExtremeFunc m_min;            ///< Minimum kernel
+    ExtremeFunc m_max;            ///< Maximum kernel
+    CountFunc m_countAbove;       ///< Threshold count kernel
+    TransformFunc m_toGraphY;     ///< Graph coordinate kernel
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace fps_monitor {
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4324) // Structure padded due to alignment specifier (intended)
+#endif
+
+/**
+ * @brief Wait-free single-producer/single-consumer ring buffer
+ *
+ * Lock-free alternative to RingBuffer for handing samples from one thread
+ * to another (e.g. the present capture thread to the main loop). Exactly
+ * one thread may call the producer methods and exactly one thread the
+ * consumer methods; every operation completes in a bounded number of steps.
+ *
+ * Head and tail live on separate cache lines, and each side keeps a cached
+ * copy of the other's index so the shared line is only touched when the
+ * cache says the buffer is full (producer) or empty (consumer).
+ *
+ * Unlike RingBuffer, a full buffer rejects new elements instead of
+ * overwriting the oldest, since the producer cannot safely move the tail.
+ *
+ * @tparam T The type of data to store (should be trivially copyable)
+ * @tparam N The fixed capacity of the buffer (must be a power of two)
+ */
+template<typename T, size_t N>
+class SpscRingBuffer {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "SpscRingBuffer capacity must be a power of two");
+
+public:
+    /**
+     * @brief Construct a new SPSC Ring Buffer object
+     */
+    SpscRingBuffer() : m_head(0), m_cachedTail(0), m_tail(0), m_cachedHead(0), m_buffer{} {}
+
+    // Indices are shared between threads; copying would break the protocol
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    /**
+     * @brief Push a new element (producer only)
+     *
+     * @param value The value to push
+     * @return true if stored
+     * @return false if the buffer is full
+     */
+    bool push(const T& value) {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_cachedTail == N) {
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            if (head - m_cachedTail == N) {
+                return false;
+            }
+        }
+
+        m_buffer[head & MASK] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop the oldest element (consumer only)
+     *
+     * @param value Output value
+     * @return true if an element was popped
+     * @return false if the buffer is empty
+     */
+    bool pop(T& value) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_cachedHead) {
+            m_cachedHead = m_head.load(std::memory_order_acquire);
+            if (tail == m_cachedHead) {
+                return false;
+            }
+        }
+
+        value = m_buffer[tail & MASK];
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Pop up to maxCount elements in order (consumer only)
+     *
+     * Publishes the new tail once for the whole batch.
+     *
+     * @param out Destination buffer
+     * @param maxCount Capacity of the destination buffer
+     * @return size_t Number of elements popped
+     */
+    size_t popBulk(T* out, size_t maxCount) {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+
+        size_t available = m_cachedHead - tail;
+        size_t count = available < maxCount ? available : maxCount;
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = m_buffer[(tail + i) & MASK];
+        }
+
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    /**
+     * @brief Get the current number of elements
+     *
+     * Exact when called from the producer or consumer with the other side
+     * idle; otherwise a snapshot that may already be stale.
+     *
+     * @return size_t Number of elements currently stored
+     */
+    size_t size() const {
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+        const size_t head = m_head.load(std::memory_order_acquire);
+        return head - tail;
+    }
+
+    /**
+     * @brief Get the maximum capacity of the buffer
+     *
+     * @return size_t Maximum number of elements the buffer can hold
+     */
+    constexpr size_t capacity() const {
+        return N;
+    }
+
+    /**
+     * @brief Check if the buffer is empty
+     *
+     * @return true if size() == 0
+     * @return false otherwise
+     */
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief Discard all elements (consumer only)
+     */
+    void clear() {
+        m_tail.store(m_head.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t CACHE_LINE_SIZE = 64;  ///< Assumed destructive interference size
+    static constexpr size_t MASK = N - 1;          ///< Index mask (replaces modulo)
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;  ///< Next write index (producer-owned)
+    size_t m_cachedTail;                                  ///< Producer's view of m_tail
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;  ///< Next read index (consumer-owned)
+    size_t m_cachedHead;                                  ///< Consumer's view of m_head
+    alignas(CACHE_LINE_SIZE) std::array<T, N> m_buffer;   ///< Internal storage
+};
+
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+} // namespace fps_monitor
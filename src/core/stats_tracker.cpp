@@ -1,12 +1,21 @@
 #include "stats_tracker.h"
+#include "simd_kernels.h"
 #include <algorithm>
-#include <numeric>
-#include <cmath>
 
 namespace fps_monitor {
 
-StatsTracker::StatsTracker(int updateIntervalMs)
-    : m_stats{0.0, 0.0, 0.0, 0.0, 0.0}
+StatsTracker::StatsTracker(int updateIntervalMs, size_t maxSamples, PercentileMode mode, int64_t tickFrequency)
+    : m_stats{0.0, 0.0, 0.0, 0.0, 0.0, 0.0}
+    , m_sessionStats{0.0, 0.0, 0.0, 0.0, 0.0, 0.0}
+    , m_percentiles(PercentileEngine::create(mode, maxSamples, tickFrequency))
+    , m_history(std::make_unique<HistoryTiers>(tickFrequency))
+    , m_sessionBuckets(0)
+    , m_samplesSeen(0)
+    , m_sessionFrames(0)
+    , m_sessionTicks(0)
+    , m_sessionShortest(0)
+    , m_sessionLongest(0)
+    , m_tickFrequency(static_cast<double>(tickFrequency))
     , m_lastUpdate(std::chrono::steady_clock::now())
     , m_updateInterval(updateIntervalMs)
 {
@@ -14,13 +23,28 @@ StatsTracker::StatsTracker(int updateIntervalMs)
 
 StatsTracker::~StatsTracker() = default;
 
-void StatsTracker::update(const std::vector<double>& samples) {
+void StatsTracker::addSamples(const SampleView<uint32_t>& samples, uint64_t totalSamples) {
+    // Source was reset: start a new session
+    if (totalSamples < m_samplesSeen) {
+        resetSession();
+    }
+
+    // Feed only the samples that arrived since the last call
+    size_t newCount = static_cast<size_t>(std::min<uint64_t>(totalSamples - m_samplesSeen, samples.size()));
+    samples.last(newCount).forEach([this](uint32_t ticks) { addSample(ticks); });
+    m_samplesSeen = totalSamples;
+}
+
+void StatsTracker::update(const SampleView<uint32_t>& samples, uint64_t totalSamples, bool force) {
+    addSamples(samples, totalSamples);
+
     auto now = std::chrono::steady_clock::now();
     auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - m_lastUpdate);
 
     // Only update if interval has elapsed
-    if (elapsed >= m_updateInterval) {
+    if (force || elapsed >= m_updateInterval) {
         calculateStats(samples);
+        calculateSessionStats();
         m_lastUpdate = now;
     }
 }
@@ -29,6 +53,14 @@ const StatsTracker::Stats& StatsTracker::getStats() const {
     return m_stats;
 }
 
+const StatsTracker::Stats& StatsTracker::getSessionStats() const {
+    return m_sessionStats;
+}
+
+const HistoryTiers& StatsTracker::getHistory() const {
+    return *m_history;
+}
+
 double StatsTracker::get01PercentLow() const {
     return m_stats.percentile01;
 }
@@ -37,6 +69,10 @@ double StatsTracker::get1PercentLow() const {
     return m_stats.percentile1;
 }
 
+double StatsTracker::get5PercentLow() const {
+    return m_stats.percentile5;
+}
+
 double StatsTracker::getMin() const {
     return m_stats.min;
 }
@@ -49,56 +85,104 @@ double StatsTracker::getAverage() const {
     return m_stats.average;
 }
 
+void StatsTracker::setUpdateInterval(int updateIntervalMs) {
+    m_updateInterval = std::chrono::milliseconds(updateIntervalMs);
+}
+
 void StatsTracker::reset() {
-    m_stats = {0.0, 0.0, 0.0, 0.0, 0.0};
+    m_stats = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    m_samplesSeen = 0;
+    resetSession();
     m_lastUpdate = std::chrono::steady_clock::now();
 }
 
-void StatsTracker::calculateStats(const std::vector<double>& samples) {
-    if (samples.empty()) {
-        m_stats = {0.0, 0.0, 0.0, 0.0, 0.0};
-        return;
+void StatsTracker::calculateStats(const SampleView<uint32_t>& samples) {
+    if (m_percentiles->isStreaming()) {
+        if (m_sessionFrames == 0) {
+            m_stats = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            return;
+        }
+
+        // Session-wide: frames over elapsed frame time is the true average
+        m_stats.min = m_tickFrequency / m_sessionLongest;
+        m_stats.max = m_tickFrequency / m_sessionShortest;
+        m_stats.average = m_sessionFrames * m_tickFrequency / static_cast<double>(m_sessionTicks);
+    } else {
+        if (samples.empty()) {
+            m_stats = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+            return;
+        }
+
+        // Vectorized reductions over the window; no copy or sort needed
+        const SimdKernels& kernels = SimdKernels::get();
+        uint32_t shortest = kernels.min(samples);
+        uint32_t longest = kernels.max(samples);
+        uint64_t sum = kernels.sum(samples);
+
+        // Samples are never 0 ticks (FpsCalculator drops them)
+        m_stats.min = m_tickFrequency / longest;
+        m_stats.max = m_tickFrequency / shortest;
+        m_stats.average = samples.size() * m_tickFrequency / static_cast<double>(sum);
+
+        m_percentiles->prepare(samples);
     }
 
-    // Sort samples for percentile calculation
-    std::vector<double> sorted = samples;
-    std::sort(sorted.begin(), sorted.end());
-
-    // Calculate basic stats
-    m_stats.min = sorted.front();
-    m_stats.max = sorted.back();
-    m_stats.average = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
-
     // Calculate percentiles
-    m_stats.percentile01 = calculatePercentile(sorted, 0.001);
-    m_stats.percentile1 = calculatePercentile(sorted, 0.01);
+    m_stats.percentile01 = m_percentiles->lowFPS(0.001);
+    m_stats.percentile1 = m_percentiles->lowFPS(0.01);
+    m_stats.percentile5 = m_percentiles->lowFPS(0.05);
 }
 
-double StatsTracker::calculatePercentile(const std::vector<double>& sortedSamples, double percentile) const {
-    if (sortedSamples.empty()) {
-        return 0.0;
+void StatsTracker::calculateSessionStats() {
+    uint64_t buckets = m_history->getTotalBuckets(HistoryTiers::Tier::Fine);
+    if (buckets == m_sessionBuckets) {
+        return;
     }
+    m_sessionBuckets = buckets;
 
-    if (sortedSamples.size() == 1) {
-        return sortedSamples[0];
+    HistoryTiers::Bucket totals = m_history->getSessionTotals();
+    if (totals.frames == 0) {
+        m_sessionStats = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        return;
     }
 
-    // Calculate the index for the percentile
-    double index = percentile * (sortedSamples.size() - 1);
-    size_t lowerIndex = static_cast<size_t>(std::floor(index));
-    size_t upperIndex = static_cast<size_t>(std::ceil(index));
+    m_sessionStats.min = m_tickFrequency / totals.longest;
+    m_sessionStats.max = m_tickFrequency / totals.shortest;
+    m_sessionStats.average = totals.frames * m_tickFrequency / static_cast<double>(totals.ticks);
+    m_sessionStats.percentile01 = m_tickFrequency / m_history->estimateSlowFrame(0.001);
+    m_sessionStats.percentile1 = m_tickFrequency / m_history->estimateSlowFrame(0.01);
+    m_sessionStats.percentile5 = m_tickFrequency / m_history->estimateSlowFrame(0.05);
+}
 
-    // Clamp indices
-    lowerIndex = std::min(lowerIndex, sortedSamples.size() - 1);
-    upperIndex = std::min(upperIndex, sortedSamples.size() - 1);
+void StatsTracker::addSample(uint32_t ticks) {
+    if (ticks == 0) {
+        return;
+    }
 
-    // Linear interpolation between the two nearest values
-    if (lowerIndex == upperIndex) {
-        return sortedSamples[lowerIndex];
+    if (m_sessionFrames == 0) {
+        m_sessionShortest = ticks;
+        m_sessionLongest = ticks;
+    } else {
+        m_sessionShortest = std::min(m_sessionShortest, ticks);
+        m_sessionLongest = std::max(m_sessionLongest, ticks);
     }
 
-    double weight = index - lowerIndex;
-    return sortedSamples[lowerIndex] * (1.0 - weight) + sortedSamples[upperIndex] * weight;
+    ++m_sessionFrames;
+    m_sessionTicks += ticks;
+    m_percentiles->add(ticks);
+    m_history->add(ticks);
+}
+
+void StatsTracker::resetSession() {
+    m_sessionFrames = 0;
+    m_sessionTicks = 0;
+    m_sessionShortest = 0;
+    m_sessionLongest = 0;
+    m_samplesSeen = 0;
+    m_percentiles->reset();
+    m_history->reset();
+    m_sessionBuckets = 0;
+    m_sessionStats = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
 }
 
-} // namespace fps_monitor
\ No newline at end of file
+} // namespace fps_monitor
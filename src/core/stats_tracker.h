@@ -1,16 +1,29 @@
 #pragma once
 
-#include <vector>
 #include <chrono>
+#include <cstdint>
+#include <memory>
+#include "sample_view.h"
+#include "percentile_engine.h"
+#include "history_tiers.h"
 
 namespace fps_monitor {
 
 /**
  * @brief Performance statistics calculator
  * 
- * Calculates percentile-based metrics (0.1% lows, 1% lows) and
- * basic statistics (min, max, average) from FPS samples.
+ * Calculates percentile-based metrics (0.1%, 1% and 5% lows) and
+ * basic statistics (min, max, average) from frame-time samples in QPC
+ * ticks. All results are reported as FPS.
  * Updates periodically for performance efficiency.
+ * 
+ * Percentiles come from a pluggable PercentileEngine: exact selection over
+ * the current window, or a streaming histogram covering the whole session
+ * (in which case min/max/average are session-wide too).
+ * 
+ * Every sample is also rolled up into HistoryTiers; session statistics
+ * (the last hour) are derived from those aggregates on each update, so
+ * long sessions never retain individual frames.
  */
 class StatsTracker {
 public:
@@ -23,14 +36,20 @@ public:
         double max;            ///< Maximum FPS
         double percentile01;   ///< 0.1% low FPS
         double percentile1;    ///< 1% low FPS
+        double percentile5;    ///< 5% low FPS
     };
 
     /**
      * @brief Construct a new Stats Tracker
      * 
      * @param updateIntervalMs Milliseconds between stats updates (default: 500ms)
+     * @param maxSamples Largest sample window expected (pre-sizes scratch storage)
+     * @param mode Percentile backend
+     * @param tickFrequency Tick rate of the samples (FpsCalculator::getTickFrequency())
      */
-    explicit StatsTracker(int updateIntervalMs = 500);
+    explicit StatsTracker(int updateIntervalMs = 500, size_t maxSamples = 600,
+                          PercentileMode mode = PercentileMode::Exact,
+                          int64_t tickFrequency = 10000000);
 
     /**
      * @brief Destroy the Stats Tracker
@@ -38,13 +57,31 @@ public:
     ~StatsTracker();
 
     /**
-     * @brief Update tracker with new FPS samples
+     * @brief Feed new frame-time samples to the streaming accumulators
+     * 
+     * Only the samples added since the previous addSamples() or update()
+     * are consumed, so a view reaching further back than the statistics
+     * window (FpsCalculator::getRetainedView()) loses none of them.
+     * 
+     * @param samples View ending at the newest frame time in ticks
+     * @param totalSamples Samples produced since the source was reset
+     *                     (FpsCalculator::getTotalSamples())
+     */
+    void addSamples(const SampleView<uint32_t>& samples, uint64_t totalSamples);
+
+    /**
+     * @brief Update tracker with new frame-time samples
      * 
-     * Only recalculates statistics if update interval has elapsed.
+     * Samples added since the previous call are fed to the streaming
+     * accumulators every call (as addSamples()); statistics are only
+     * recalculated if the update interval has elapsed.
      * 
-     * @param samples Vector of FPS samples to analyze
+     * @param samples View of frame times in ticks to analyze (oldest to newest)
+     * @param totalSamples Samples produced since the source was reset
+     *                     (FpsCalculator::getTotalSamples())
+     * @param force Recalculate now, regardless of the update interval
      */
-    void update(const std::vector<double>& samples);
+    void update(const SampleView<uint32_t>& samples, uint64_t totalSamples, bool force = false);
 
     /**
      * @brief Get the current statistics
@@ -53,6 +90,23 @@ public:
      */
     const Stats& getStats() const;
 
+    /**
+     * @brief Get the session statistics (from the history aggregates)
+     * 
+     * Covers the last hour; the lows are estimates (see
+     * HistoryTiers::estimateSlowFrame()).
+     * 
+     * @return const Stats& Reference to session stats
+     */
+    const Stats& getSessionStats() const;
+
+    /**
+     * @brief Get the aggregated history
+     * 
+     * @return const HistoryTiers& Tiers (updated by update())
+     */
+    const HistoryTiers& getHistory() const;
+
     /**
      * @brief Get 0.1% low FPS value
      * 
@@ -67,6 +121,13 @@ public:
      */
     double get1PercentLow() const;
 
+    /**
+     * @brief Get 5% low FPS value
+     * 
+     * @return double 5% percentile
+     */
+    double get5PercentLow() const;
+
     /**
      * @brief Get minimum FPS
      * 
@@ -88,6 +149,15 @@ public:
      */
     double getAverage() const;
 
+    /**
+     * @brief Set the update interval
+     * 
+     * Takes effect from the next update().
+     * 
+     * @param updateIntervalMs Milliseconds between stats updates
+     */
+    void setUpdateInterval(int updateIntervalMs);
+
     /**
      * @brief Reset all statistics
      */
@@ -99,18 +169,38 @@ private:
      * 
      * @param samples Samples to analyze
      */
-    void calculateStats(const std::vector<double>& samples);
+    void calculateStats(const SampleView<uint32_t>& samples);
+
+    /**
+     * @brief Calculate the session statistics from the history aggregates
+     * 
+     * Skipped when no bucket was closed since the last calculation.
+     */
+    void calculateSessionStats();
 
     /**
-     * @brief Calculate percentile value from sorted samples
+     * @brief Feed a new sample to the session accumulators
      * 
-     * @param sortedSamples Pre-sorted sample vector
-     * @param percentile Percentile to calculate (0.0 - 1.0)
-     * @return double The percentile value
+     * @param ticks New frame time in ticks
+     */
+    void addSample(uint32_t ticks);
+
+    /**
+     * @brief Clear session accumulators
      */
-    double calculatePercentile(const std::vector<double>& sortedSamples, double percentile) const;
+    void resetSession();
 
     Stats m_stats;                                        ///< Current statistics
+    Stats m_sessionStats;                                 ///< Statistics of the aggregated history
+    std::unique_ptr<PercentileEngine> m_percentiles;      ///< Percentile backend
+    std::unique_ptr<HistoryTiers> m_history;              ///< Aggregated session history
+    uint64_t m_sessionBuckets;                            ///< Fine buckets at the last session calculation
+    uint64_t m_samplesSeen;                               ///< Source sample count at last update
+    uint64_t m_sessionFrames;                             ///< Frames since session start
+    uint64_t m_sessionTicks;                              ///< Total frame time since session start
+    uint32_t m_sessionShortest;                           ///< Shortest frame since session start
+    uint32_t m_sessionLongest;                            ///< Longest frame since session start
+    double m_tickFrequency;                               ///< Sample ticks per second
     std::chrono::steady_clock::time_point m_lastUpdate;   ///< Last update timestamp
     std::chrono::milliseconds m_updateInterval;           ///< Update interval
 };
@@ -0,0 +1,188 @@
+#include "stutter_analyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace fps_monitor {
+
+StutterAnalyzer::StutterAnalyzer(int64_t tickFrequency, double refreshRate, double medianFactor)
+    : m_stutters(std::make_unique<RingBuffer<Stutter, HISTORY_CAPACITY>>())
+    , m_tickFrequency(static_cast<double>(tickFrequency))
+    // WINDOW squares of the limit must fit in 64 bits; a change of a whole
+    // second is a stall, not pacing
+    , m_deltaLimit(std::min<int64_t>(tickFrequency, int64_t(1) << 28))
+    , m_medianFactor(2.0)
+    , m_refreshTicks(0.0)
+{
+    setMedianFactor(medianFactor);
+    setRefreshRate(refreshRate);
+    reset();
+}
+
+StutterAnalyzer::~StutterAnalyzer() = default;
+
+void StutterAnalyzer::update(const SampleView<uint32_t>& samples, uint64_t totalSamples) {
+    // Source was reset: start over
+    if (totalSamples < m_samplesSeen) {
+        reset();
+    }
+
+    // Analyze only the samples that arrived since the last call
+    size_t newCount = static_cast<size_t>(std::min<uint64_t>(totalSamples - m_samplesSeen, samples.size()));
+    m_sampleNumber = totalSamples - newCount;
+    samples.last(newCount).forEach([this](uint32_t ticks) { addSample(ticks); });
+    m_samplesSeen = totalSamples;
+
+    if (m_windowCount == 0) {
+        m_stats.medianMs = 0.0;
+        m_stats.frameToFrameVariance = 0.0;
+        return;
+    }
+
+    double msPerTick = 1000.0 / m_tickFrequency;
+    m_stats.medianMs = binTicks(m_medianBin) * msPerTick;
+    if (m_deltaCount > 0) {
+        double count = static_cast<double>(m_deltaCount);
+        double mean = m_deltaSum / count;
+        double variance = std::max(0.0, m_deltaSquares / count - mean * mean);
+        m_stats.frameToFrameVariance = variance * msPerTick * msPerTick;
+    } else {
+        m_stats.frameToFrameVariance = 0.0;
+    }
+}
+
+const StutterAnalyzer::Stats& StutterAnalyzer::getStats() const {
+    return m_stats;
+}
+
+SampleView<StutterAnalyzer::Stutter> StutterAnalyzer::getStutters() const {
+    return m_stutters->view();
+}
+
+uint64_t StutterAnalyzer::getTotalStutters() const {
+    return m_totalStutters;
+}
+
+void StutterAnalyzer::setMedianFactor(double medianFactor) {
+    m_medianFactor = std::max(1.5, std::min(medianFactor, 10.0));
+}
+
+void StutterAnalyzer::setRefreshRate(double refreshRate) {
+    m_refreshTicks = (refreshRate > 0.0) ? m_tickFrequency / refreshRate : 0.0;
+}
+
+void StutterAnalyzer::reset() {
+    m_stats = {0.0, 0.0, 0, {0, 0, 0}};
+    m_stutters->clear();
+    m_totalStutters = 0;
+    std::memset(m_windowBins, 0, sizeof(m_windowBins));
+    std::memset(m_deltas, 0, sizeof(m_deltas));
+    std::memset(m_binCounts, 0, sizeof(m_binCounts));
+    m_windowCount = 0;
+    m_windowHead = 0;
+    m_medianBin = 0;
+    m_belowMedian = 0;
+    m_deltaSum = 0;
+    m_deltaSquares = 0;
+    m_deltaCount = 0;
+    m_previous = 0;
+    m_sampleNumber = 0;
+    m_samplesSeen = 0;
+}
+
+void StutterAnalyzer::addSample(uint32_t ticks) {
+    uint64_t sample = m_sampleNumber++;
+    if (ticks == 0) {
+        return;
+    }
+
+    // Judge the frame against the window before it joins
+    if (m_windowCount >= MIN_WINDOW) {
+        double median = binTicks(m_medianBin);
+        double excess = ticks - median;
+
+        uint32_t missed = 0;
+        if (m_refreshTicks > 0.0 && excess >= m_refreshTicks) {
+            missed = static_cast<uint32_t>(std::min(excess / m_refreshTicks, 1e9));
+            for (size_t level = 0; level < HITCH_LEVELS; ++level) {
+                if (missed >= HITCH_INTERVALS[level]) {
+                    ++m_stats.hitches[level];
+                }
+            }
+        }
+
+        bool stutter = ticks > m_medianFactor * median;
+        if (stutter) {
+            ++m_stats.stutters;
+        }
+        if (stutter || missed > 0) {
+            m_stutters->push({sample, ticks, static_cast<uint32_t>(median), missed});
+            ++m_totalStutters;
+        }
+    }
+
+    // Full window: the frame replaces the oldest one (whose slot is the head)
+    size_t slot = m_windowHead;
+    if (m_windowCount == WINDOW) {
+        size_t oldBin = m_windowBins[slot];
+        --m_binCounts[oldBin];
+        if (oldBin < m_medianBin) {
+            --m_belowMedian;
+        }
+
+        // The first frame after a reset has no delta
+        if (m_deltaCount == m_windowCount) {
+            m_deltaSum -= m_deltas[slot];
+            m_deltaSquares -= static_cast<uint64_t>(m_deltas[slot] * m_deltas[slot]);
+            --m_deltaCount;
+        }
+        --m_windowCount;
+    }
+
+    size_t bin = binOf(ticks);
+    m_windowBins[slot] = static_cast<uint16_t>(bin);
+    ++m_binCounts[bin];
+    if (bin < m_medianBin) {
+        ++m_belowMedian;
+    }
+
+    int64_t delta = 0;
+    if (m_previous != 0) {
+        delta = std::max(-m_deltaLimit, std::min<int64_t>(static_cast<int64_t>(ticks) - m_previous, m_deltaLimit));
+        m_deltaSum += delta;
+        m_deltaSquares += static_cast<uint64_t>(delta * delta);
+        ++m_deltaCount;
+    }
+    m_deltas[slot] = delta;
+    m_previous = ticks;
+
+    m_windowHead = (m_windowHead + 1) % WINDOW;
+    ++m_windowCount;
+    updateMedian();
+}
+
+void StutterAnalyzer::updateMedian() {
+    // Lower median: rank (n - 1) / 2 lies in [below, below + count of the bin).
+    // One frame in and one out moves the rank by at most one, so the bin
+    // only steps over the empty bins between neighbouring frame times
+    size_t rank = (m_windowCount - 1) / 2;
+    while (m_belowMedian > rank) {
+        --m_medianBin;
+        m_belowMedian -= m_binCounts[m_medianBin];
+    }
+    while (m_belowMedian + m_binCounts[m_medianBin] <= rank) {
+        m_belowMedian += m_binCounts[m_medianBin];
+        ++m_medianBin;
+    }
+}
+
+size_t StutterAnalyzer::binOf(uint32_t ticks) {
+    size_t bin = static_cast<size_t>(std::log2(static_cast<double>(ticks)) * BINS_PER_OCTAVE);
+    return std::min(bin, BIN_COUNT - 1);
+}
+
+double StutterAnalyzer::binTicks(size_t bin) {
+    return std::exp2((static_cast<double>(bin) + 0.5) / BINS_PER_OCTAVE);
+}
+
+} // namespace fps_monitor
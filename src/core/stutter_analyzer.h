@@ -0,0 +1,177 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "ring_buffer.h"
+#include "sample_view.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Frame-pacing and stutter analysis
+ *
+ * Complements DropDetector (FPS against the average) with per-frame
+ * measures over a rolling window of WINDOW frame times:
+ * - Frame-to-frame variance: spread of the change between consecutive
+ *   frame times (exact integer sums, so nothing drifts)
+ * - Stutters: frames longer than a factor times the rolling median
+ * - Hitches: frames at least 1, 2 or 4 refresh intervals longer than the
+ *   median (the frame was shown that many refreshes late)
+ *
+ * The median comes from a histogram of the window on a log scale
+ * (BINS_PER_OCTAVE bins per doubling, about 4% wide) whose median bin is
+ * moved as frames enter and leave, so every frame costs O(1) amortised
+ * work. Each frame is compared against the median of the frames before it.
+ *
+ * Stutters are kept in a fixed ring of HISTORY_CAPACITY entries numbered
+ * like FpsCalculator's samples, so they can be placed on the graph. All
+ * storage is allocated at construction. Not thread-safe: owned by the
+ * analysis thread.
+ */
+class StutterAnalyzer {
+public:
+    static constexpr size_t HITCH_LEVELS = 3;           ///< Hitch counters
+    static constexpr uint32_t HITCH_INTERVALS[HITCH_LEVELS] = {1, 2, 4};    ///< Refresh intervals per counter
+
+    /**
+     * @brief A frame flagged as a stutter or hitch
+     */
+    struct Stutter {
+        uint64_t sample;            ///< Sample number (as FpsCalculator::getTotalSamples() counts)
+        uint32_t ticks;             ///< Frame time in ticks
+        uint32_t medianTicks;       ///< Rolling median before the frame
+        uint32_t missedIntervals;   ///< Whole refresh intervals over the median
+    };
+
+    /**
+     * @brief Frame-pacing statistics
+     */
+    struct Stats {
+        double medianMs;                    ///< Rolling median frame time
+        double frameToFrameVariance;        ///< Variance of consecutive frame-time changes (ms^2, window)
+        uint64_t stutters;                  ///< Frames over the median factor (session)
+        uint64_t hitches[HITCH_LEVELS];     ///< Frames 1/2/4+ refresh intervals over the median (session)
+    };
+
+    static constexpr size_t WINDOW = 128;               ///< Frames in the rolling median and variance
+    static constexpr size_t MIN_WINDOW = 16;            ///< Frames before anything is flagged
+    static constexpr size_t HISTORY_CAPACITY = 256;     ///< Stutters kept for markers
+    static constexpr size_t BINS_PER_OCTAVE = 16;       ///< Median histogram resolution
+    static constexpr size_t BIN_COUNT = 32 * BINS_PER_OCTAVE;   ///< Covers every 32-bit frame time
+
+    /**
+     * @brief Construct a new Stutter Analyzer
+     *
+     * @param tickFrequency Tick rate of the samples
+     * @param refreshRate Display refresh rate in Hz (0 disables hitch counts)
+     * @param medianFactor Stutter threshold as a multiple of the median
+     */
+    StutterAnalyzer(int64_t tickFrequency, double refreshRate, double medianFactor);
+
+    /**
+     * @brief Destroy the Stutter Analyzer
+     */
+    ~StutterAnalyzer();
+
+    /**
+     * @brief Analyze the samples that arrived since the last call
+     *
+     * @param samples View of frame times in ticks (oldest to newest)
+     * @param totalSamples Samples produced since the source was reset
+     *                     (FpsCalculator::getTotalSamples())
+     */
+    void update(const SampleView<uint32_t>& samples, uint64_t totalSamples);
+
+    /**
+     * @brief Get the frame-pacing statistics
+     *
+     * @return const Stats& Reference to current stats
+     */
+    const Stats& getStats() const;
+
+    /**
+     * @brief Get the recent stutters (oldest to newest)
+     *
+     * @return SampleView<Stutter> View into the ring (invalidated by update())
+     */
+    SampleView<Stutter> getStutters() const;
+
+    /**
+     * @brief Get the stutters recorded since the last reset
+     *
+     * @return uint64_t Stutter count (the ring keeps the newest)
+     */
+    uint64_t getTotalStutters() const;
+
+    /**
+     * @brief Set the stutter threshold
+     *
+     * @param medianFactor Multiple of the median (1.5 - 10.0)
+     */
+    void setMedianFactor(double medianFactor);
+
+    /**
+     * @brief Set the display refresh rate
+     *
+     * @param refreshRate Refresh rate in Hz (0 disables hitch counts)
+     */
+    void setRefreshRate(double refreshRate);
+
+    /**
+     * @brief Clear the window, counters and stutters
+     */
+    void reset();
+
+private:
+    /**
+     * @brief Analyze one frame, then add it to the window
+     *
+     * @param ticks Frame time in ticks
+     */
+    void addSample(uint32_t ticks);
+
+    /**
+     * @brief Move the median bin after the window changed
+     */
+    void updateMedian();
+
+    /**
+     * @brief Get the median histogram bin of a frame time
+     *
+     * @param ticks Frame time in ticks (> 0)
+     * @return size_t Bin index
+     */
+    static size_t binOf(uint32_t ticks);
+
+    /**
+     * @brief Get the representative frame time of a bin (its geometric centre)
+     *
+     * @param bin Bin index
+     * @return double Frame time in ticks
+     */
+    static double binTicks(size_t bin);
+
+    Stats m_stats;                                          ///< Current statistics
+    std::unique_ptr<RingBuffer<Stutter, HISTORY_CAPACITY>> m_stutters;  ///< Recent stutters
+    uint64_t m_totalStutters;                               ///< Stutters since reset
+    uint16_t m_windowBins[WINDOW];                          ///< Histogram bin of each window frame
+    int64_t m_deltas[WINDOW];                               ///< Change from the previous frame (ring, clamped)
+    uint16_t m_binCounts[BIN_COUNT];                        ///< Window histogram
+    size_t m_windowCount;                                   ///< Frames in the window
+    size_t m_windowHead;                                    ///< Next window slot
+    size_t m_medianBin;                                     ///< Bin holding the median frame
+    size_t m_belowMedian;                                   ///< Window frames in lower bins
+    int64_t m_deltaSum;                                     ///< Sum of the window's deltas
+    uint64_t m_deltaSquares;                                ///< Sum of their squares
+    size_t m_deltaCount;                                    ///< Deltas in the window
+    uint32_t m_previous;                                    ///< Previous frame time (0 = none)
+    uint64_t m_sampleNumber;                                ///< Number of the next frame
+    uint64_t m_samplesSeen;                                 ///< Source sample count at last update
+    double m_tickFrequency;                                 ///< Sample ticks per second
+    int64_t m_deltaLimit;                                   ///< Delta clamp (keeps the squares in 64 bits)
+    double m_medianFactor;                                  ///< Stutter threshold
+    double m_refreshTicks;                                  ///< Refresh interval in ticks (0 = unknown)
+};
+
+} // namespace fps_monitor
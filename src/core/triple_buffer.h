@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace fps_monitor {
+
+/**
+ * @brief Wait-free single-writer/single-reader latest-value exchange
+ *
+ * Three slots rotate between the writer (back), the reader (front) and a
+ * shared middle slot. publish() swaps the finished back slot into the
+ * middle; acquire() swaps the middle slot to the front if it holds a newer
+ * value. Neither side ever blocks or retries, and the reader always sees a
+ * complete value, however large T is (unlike a seqlock, whose reader would
+ * have to copy it and retry on a concurrent write).
+ *
+ * Intermediate values the reader never acquired are simply overwritten.
+ * A slot handed back to the writer holds an older published value; writers
+ * can use that to update it incrementally.
+ *
+ * @tparam T The published state (default constructible)
+ */
+template<typename T>
+class TripleBuffer {
+public:
+    /**
+     * @brief Construct a new Triple Buffer (slots are value-initialized)
+     */
+    TripleBuffer()
+        : m_slots(new T[3]())
+        , m_back(0)
+        , m_middle(1)
+        , m_front(2)
+    {
+    }
+
+    // Slot indices are shared between threads; copying would break the protocol
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    /**
+     * @brief Get the slot being written (writer only)
+     *
+     * @return T& Back slot
+     */
+    T& back() { return m_slots[m_back]; }
+
+    /**
+     * @brief Make the back slot the latest value (writer only)
+     */
+    void publish() {
+        uint8_t previous = m_middle.exchange(static_cast<uint8_t>(m_back | FRESH), std::memory_order_acq_rel);
+        m_back = previous & INDEX_MASK;
+    }
+
+    /**
+     * @brief Move the latest published value to the front (reader only)
+     *
+     * @return true if a value newer than the current front was acquired
+     * @return false if nothing was published since the last acquire
+     */
+    bool acquire() {
+        if ((m_middle.load(std::memory_order_relaxed) & FRESH) == 0) {
+            return false;
+        }
+        uint8_t previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * @brief Get the last acquired value (reader only)
+     *
+     * Stays valid and unchanged until the next acquire().
+     *
+     * @return const T& Front slot
+     */
+    const T& front() const { return m_slots[m_front]; }
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;      ///< Slot index bits of m_middle
+    static constexpr uint8_t FRESH = 0x4;           ///< Middle slot not yet acquired
+
+    std::unique_ptr<T[]> m_slots;       ///< The three slots
+    uint8_t m_back;                     ///< Writer's slot
+    std::atomic<uint8_t> m_middle;      ///< Shared slot index | FRESH
+    uint8_t m_front;                    ///< Reader's slot
+};
+
+} // namespace fps_monitor
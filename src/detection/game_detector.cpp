@@ -7,24 +7,119 @@
 
 namespace fps_monitor {
 
+GameDetector* GameDetector::s_tracking = nullptr;
+
 GameDetector::GameDetector()
     : m_gameWindow(nullptr)
     , m_autoDetect(true)
+    , m_fullScanNeeded(true)
+    , m_lastFullScan(0)
+    , m_foregroundHook(nullptr)
+    , m_objectHook(nullptr)
+    , m_locationHook(nullptr)
+    , m_locationProcess(0)
 {
+    m_dirty.reserve(MAX_DIRTY_WINDOWS);
+}
+
+GameDetector::~GameDetector() {
+    stopEventTracking();
+}
+
+bool GameDetector::startEventTracking() {
+    if (s_tracking) {
+        return s_tracking == this;
+    }
+
+    // Out of context: no DLL injection, events arrive through our message queue
+    const DWORD flags = WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS;
+    m_foregroundHook = SetWinEventHook(EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND,
+                                       nullptr, winEventCallback, 0, 0, flags);
+    m_objectHook = SetWinEventHook(EVENT_OBJECT_CREATE, EVENT_OBJECT_HIDE,
+                                   nullptr, winEventCallback, 0, 0, flags);
+    if (!m_foregroundHook || !m_objectHook) {
+        stopEventTracking();
+        return false;
+    }
+
+    s_tracking = this;
+    trackForegroundProcess(GetForegroundWindow());
+    m_fullScanNeeded = true;
+    return true;
+}
+
+void GameDetector::stopEventTracking() {
+    for (HWINEVENTHOOK* hook : {&m_foregroundHook, &m_objectHook, &m_locationHook}) {
+        if (*hook) {
+            UnhookWinEvent(*hook);
+            *hook = nullptr;
+        }
+    }
+    m_locationProcess = 0;
+
+    if (s_tracking == this) {
+        s_tracking = nullptr;
+    }
 }
 
-GameDetector::~GameDetector() = default;
+bool GameDetector::isTrackingEvents() const {
+    return m_objectHook != nullptr;
+}
 
 HWND GameDetector::detectGame() {
     if (!m_autoDetect) {
         return m_gameWindow;
     }
 
-    m_gameWindow = nullptr;
-    EnumWindows(enumWindowsCallback, reinterpret_cast<LPARAM>(this));
+    // Without hooks nothing reports changes, so every call rescans
+    bool rescan = !isTrackingEvents() || m_fullScanNeeded
+               || GetTickCount64() - m_lastFullScan >= FULL_SCAN_INTERVAL_MS;
+    if (rescan) {
+        fullScan();
+    } else {
+        for (HWND hwnd : m_dirty) {
+            evaluate(hwnd);
+        }
+    }
+    m_dirty.clear();
+
+    m_gameWindow = selectGame();
     return m_gameWindow;
 }
 
+size_t GameDetector::detectGames(HWND* games, size_t maxGames) {
+    HWND primary = detectGame();
+    if (!primary || maxGames == 0) {
+        return 0;
+    }
+
+    DWORD primaryProcess = 0;
+    GetWindowThreadProcessId(primary, &primaryProcess);
+    games[0] = primary;
+    size_t count = 1;
+
+    for (const Candidate& candidate : m_candidates) {
+        if (count >= maxGames) {
+            break;
+        }
+        if (!candidate.allowed || candidate.processId == primaryProcess) {
+            continue;
+        }
+
+        // One window per process (a game may own several fullscreen windows)
+        bool listed = false;
+        for (size_t i = 1; i < count; ++i) {
+            DWORD processId = 0;
+            GetWindowThreadProcessId(games[i], &processId);
+            listed = listed || processId == candidate.processId;
+        }
+        if (!listed) {
+            games[count++] = candidate.hwnd;
+        }
+    }
+    return count;
+}
+
 bool GameDetector::isGameRunning(const std::string& processName) {
     HWND game = detectGame();
     if (!game) {
@@ -35,16 +130,23 @@ bool GameDetector::isGameRunning(const std::string& processName) {
     return currentProcess == processName;
 }
 
+void GameDetector::invalidateMonitors() {
+    m_monitors.clear();
+    m_fullScanNeeded = true;
+}
+
 HWND GameDetector::getGameWindow() const {
     return m_gameWindow;
 }
 
 void GameDetector::setWhitelist(const std::string& whitelist) {
     m_whitelist = parseList(whitelist);
+    m_fullScanNeeded = true;
 }
 
 void GameDetector::setBlacklist(const std::string& blacklist) {
     m_blacklist = parseList(blacklist);
+    m_fullScanNeeded = true;
 }
 
 void GameDetector::setAutoDetect(bool enabled) {
@@ -65,23 +167,159 @@ bool GameDetector::isFullscreen(HWND hwnd) {
     RECT windowRect;
     GetWindowRect(hwnd, &windowRect);
 
-    // Get monitor info
-    HMONITOR monitor = MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST);
-    MONITORINFO monitorInfo = {};
-    monitorInfo.cbSize = sizeof(MONITORINFO);
-    GetMonitorInfo(monitor, &monitorInfo);
+    // Get monitor rect (cached per monitor)
+    RECT monitorRect;
+    if (!getMonitorRect(MonitorFromWindow(hwnd, MONITOR_DEFAULTTONEAREST), monitorRect)) {
+        return false;
+    }
 
     // Check if window covers entire monitor
-    return (windowRect.left <= monitorInfo.rcMonitor.left &&
-            windowRect.top <= monitorInfo.rcMonitor.top &&
-            windowRect.right >= monitorInfo.rcMonitor.right &&
-            windowRect.bottom >= monitorInfo.rcMonitor.bottom);
+    return (windowRect.left <= monitorRect.left &&
+            windowRect.top <= monitorRect.top &&
+            windowRect.right >= monitorRect.right &&
+            windowRect.bottom >= monitorRect.bottom);
 }
 
 std::string GameDetector::getProcessName(HWND hwnd) {
     DWORD processId = 0;
     GetWindowThreadProcessId(hwnd, &processId);
+    return getCachedProcessName(processId);
+}
+
+void GameDetector::fullScan() {
+    m_candidates.clear();
+    m_monitors.clear();
+    m_processNames.clear();
+    EnumWindows(enumWindowsCallback, reinterpret_cast<LPARAM>(this));
+
+    m_fullScanNeeded = false;
+    m_lastFullScan = GetTickCount64();
+}
+
+void GameDetector::evaluate(HWND hwnd) {
+    auto it = std::find_if(m_candidates.begin(), m_candidates.end(),
+                           [hwnd](const Candidate& candidate) { return candidate.hwnd == hwnd; });
+    size_t index = static_cast<size_t>(it - m_candidates.begin());
+
+    if (!IsWindow(hwnd) || !isFullscreen(hwnd)) {
+        if (it != m_candidates.end()) {
+            removeCandidate(index);
+        }
+        return;
+    }
 
+    DWORD processId = 0;
+    GetWindowThreadProcessId(hwnd, &processId);
+    const std::string& processName = getCachedProcessName(processId);
+    bool allowed = !processName.empty() && !isBlacklisted(processName) && isWhitelisted(processName);
+
+    if (it != m_candidates.end()) {
+        it->processId = processId;
+        it->allowed = allowed;
+    } else {
+        m_candidates.push_back({hwnd, processId, allowed});
+    }
+}
+
+void GameDetector::removeCandidate(size_t index) {
+    DWORD processId = m_candidates[index].processId;
+    m_candidates.erase(m_candidates.begin() + static_cast<std::ptrdiff_t>(index));
+
+    bool processLeft = std::any_of(m_candidates.begin(), m_candidates.end(),
+                                   [processId](const Candidate& candidate) { return candidate.processId == processId; });
+    if (!processLeft) {
+        m_processNames.erase(processId);
+    }
+}
+
+HWND GameDetector::selectGame() const {
+    HWND foreground = GetForegroundWindow();
+    HWND fallback = nullptr;
+    bool previousAllowed = false;
+
+    for (const Candidate& candidate : m_candidates) {
+        if (!candidate.allowed) {
+            continue;
+        }
+        if (candidate.hwnd == foreground) {
+            return foreground;
+        }
+        if (candidate.hwnd == m_gameWindow) {
+            previousAllowed = true;
+        }
+        if (!fallback) {
+            fallback = candidate.hwnd;
+        }
+    }
+
+    return previousAllowed ? m_gameWindow : fallback;
+}
+
+void GameDetector::markDirty(HWND hwnd) {
+    if (m_fullScanNeeded || std::find(m_dirty.begin(), m_dirty.end(), hwnd) != m_dirty.end()) {
+        return;
+    }
+
+    // A burst of changes (e.g. a desktop switch) is cheaper to rescan
+    if (m_dirty.size() >= MAX_DIRTY_WINDOWS) {
+        m_fullScanNeeded = true;
+        m_dirty.clear();
+        return;
+    }
+    m_dirty.push_back(hwnd);
+}
+
+void GameDetector::trackForegroundProcess(HWND foreground) {
+    DWORD processId = 0;
+    if (foreground) {
+        GetWindowThreadProcessId(foreground, &processId);
+    }
+    if (processId == m_locationProcess) {
+        return;
+    }
+
+    // Location changes are frequent system-wide (the cursor is one), so only
+    // the foreground process is followed; that is where games go fullscreen
+    if (m_locationHook) {
+        UnhookWinEvent(m_locationHook);
+        m_locationHook = nullptr;
+    }
+    m_locationProcess = processId;
+    if (processId != 0) {
+        m_locationHook = SetWinEventHook(EVENT_OBJECT_LOCATIONCHANGE, EVENT_OBJECT_LOCATIONCHANGE,
+                                         nullptr, winEventCallback, processId, 0,
+                                         WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+    }
+}
+
+bool GameDetector::getMonitorRect(HMONITOR monitor, RECT& rect) {
+    for (const MonitorRect& cached : m_monitors) {
+        if (cached.monitor == monitor) {
+            rect = cached.rect;
+            return true;
+        }
+    }
+
+    MONITORINFO monitorInfo = {};
+    monitorInfo.cbSize = sizeof(MONITORINFO);
+    if (!monitor || !GetMonitorInfo(monitor, &monitorInfo)) {
+        return false;
+    }
+
+    m_monitors.push_back({monitor, monitorInfo.rcMonitor});
+    rect = monitorInfo.rcMonitor;
+    return true;
+}
+
+const std::string& GameDetector::getCachedProcessName(DWORD processId) {
+    auto it = m_processNames.find(processId);
+    if (it == m_processNames.end()) {
+        it = m_processNames.emplace(processId, queryProcessName(processId)).first;
+    }
+    return it->second;
+}
+
+std::string GameDetector::queryProcessName(DWORD processId) {
     if (processId == 0) {
         return "";
     }
@@ -143,30 +381,32 @@ std::vector<std::string> GameDetector::parseList(const std::string& list) {
 BOOL CALLBACK GameDetector::enumWindowsCallback(HWND hwnd, LPARAM lParam) {
     auto* detector = reinterpret_cast<GameDetector*>(lParam);
 
-    // Check if fullscreen
-    if (!detector->isFullscreen(hwnd)) {
-        return TRUE; // Continue enumeration
-    }
+    // Fullscreen windows only; names are looked up (and filtered) for those
+    detector->evaluate(hwnd);
+    return TRUE; // Continue enumeration
+}
 
-    // Get process name
-    std::string processName = detector->getProcessName(hwnd);
-    if (processName.empty()) {
-        return TRUE;
+void CALLBACK GameDetector::winEventCallback(HWINEVENTHOOK, DWORD event, HWND hwnd, LONG idObject,
+                                             LONG idChild, DWORD, DWORD) {
+    GameDetector* detector = s_tracking;
+    if (!detector || !hwnd) {
+        return;
     }
 
-    // Check blacklist
-    if (detector->isBlacklisted(processName)) {
-        return TRUE;
+    if (event == EVENT_SYSTEM_FOREGROUND) {
+        detector->markDirty(hwnd);
+        detector->trackForegroundProcess(hwnd);
+        return;
     }
 
-    // Check whitelist
-    if (!detector->isWhitelisted(processName)) {
-        return TRUE;
+    // Windows themselves, not their caret, scroll bars or child controls
+    if (idObject != OBJID_WINDOW || idChild != CHILDID_SELF) {
+        return;
     }
-
-    // Found a valid game
-    detector->m_gameWindow = hwnd;
-    return FALSE; // Stop enumeration
+    if (event != EVENT_OBJECT_DESTROY && GetAncestor(hwnd, GA_ROOT) != hwnd) {
+        return;
+    }
+    detector->markDirty(hwnd);
 }
 
 } // namespace fps_monitor
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <windows.h>
+#include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace fps_monitor {
@@ -11,6 +13,15 @@ namespace fps_monitor {
  * 
  * Detects fullscreen games and borderless windowed applications.
  * Supports whitelist/blacklist filtering.
+ * 
+ * Keeps the set of fullscreen windows between calls. With event tracking
+ * (startEventTracking()) WinEvent hooks report created, destroyed, shown,
+ * hidden and foreground windows plus moves within the foreground process,
+ * and detectGame() re-evaluates only those. Monitor rectangles and process
+ * names are cached; a full EnumWindows pass runs on the first call, after
+ * too many changes at once and once per FULL_SCAN_INTERVAL_MS as a safety
+ * net (missed events, PID reuse). Display changes are reported through
+ * invalidateMonitors().
  */
 class GameDetector {
 public:
@@ -24,13 +35,54 @@ public:
      */
     ~GameDetector();
 
+    /**
+     * @brief Follow window changes through WinEvent hooks
+     * 
+     * Must be called on the thread that pumps messages: the hooks are out
+     * of context and delivered through its message queue. Only one
+     * detector can track events at a time.
+     * 
+     * @return true if the hooks were installed
+     * @return false otherwise (detectGame() keeps enumerating all windows)
+     */
+    bool startEventTracking();
+
+    /**
+     * @brief Remove the WinEvent hooks (detectGame() goes back to polling)
+     */
+    void stopEventTracking();
+
+    /**
+     * @brief Check whether WinEvent hooks are installed
+     * 
+     * @return true if tracking events
+     * @return false if polling
+     */
+    bool isTrackingEvents() const;
+
     /**
      * @brief Detect a fullscreen game
      * 
+     * Prefers the foreground window, then the previous game, then the
+     * topmost remaining fullscreen window.
+     * 
      * @return HWND Handle to detected game window (nullptr if none)
      */
     HWND detectGame();
 
+    /**
+     * @brief Detect every fullscreen game, one window per process
+     * 
+     * Runs detectGame() and lists its result first, followed by the other
+     * allowed fullscreen windows in Z-order (e.g. a second title on
+     * another monitor).
+     * 
+     * @param games Receives the game windows
+     * @param maxGames Capacity of games
+     * @return size_t Number of windows written
+     */
+    size_t detectGames(HWND* games, size_t maxGames);
+
     /**
      * @brief Check if a specific game is running
      * 
@@ -40,6 +92,15 @@ public:
      */
     bool isGameRunning(const std::string& processName);
 
+    /**
+     * @brief Drop the cached monitor rectangles and rescan on the next call
+     * 
+     * Call on WM_DISPLAYCHANGE: a game switching to exclusive fullscreen
+     * changes its monitor's resolution, which the cache would otherwise
+     * keep until the next safety-net scan.
+     */
+    void invalidateMonitors();
+
     /**
      * @brief Get the current game window
      * 
@@ -68,23 +129,117 @@ public:
      */
     void setAutoDetect(bool enabled);
 
-private:
     /**
-     * @brief Check if window is fullscreen
+     * @brief Get process name from window
      * 
      * @param hwnd Window handle
-     * @return true if fullscreen
+     * @return std::string Process name (cached per process)
+     */
+    std::string getProcessName(HWND hwnd);
+
+private:
+    static constexpr uint64_t FULL_SCAN_INTERVAL_MS = 60000;   ///< Safety-net rescan period
+    static constexpr size_t MAX_DIRTY_WINDOWS = 256;           ///< More changes than this trigger a rescan
+
+    /**
+     * @brief A visible window covering its monitor
+     */
+    struct Candidate {
+        HWND hwnd;          ///< Window
+        DWORD processId;    ///< Owning process
+        bool allowed;       ///< Passes the whitelist and blacklist
+    };
+
+    /**
+     * @brief Cached monitor rectangle
+     */
+    struct MonitorRect {
+        HMONITOR monitor;   ///< Monitor handle
+        RECT rect;          ///< Monitor area in virtual-screen coordinates
+    };
+
+    /**
+     * @brief Re-evaluate every top-level window and reset the caches
+     */
+    void fullScan();
+
+    /**
+     * @brief Add, update or remove one window in the candidate set
+     * 
+     * @param hwnd Top-level window (may be destroyed)
+     */
+    void evaluate(HWND hwnd);
+
+    /**
+     * @brief Remove a window from the candidate set
+     * 
+     * Drops the cached process name once no candidate of the process is left.
+     * 
+     * @param index Candidate index
+     */
+    void removeCandidate(size_t index);
+
+    /**
+     * @brief Choose the game among the allowed candidates
+     * 
+     * @return HWND Game window (nullptr if none)
+     */
+    HWND selectGame() const;
+
+    /**
+     * @brief Queue a window for evaluation by the next detectGame()
+     * 
+     * @param hwnd Changed window
+     */
+    void markDirty(HWND hwnd);
+
+    /**
+     * @brief Follow moves and resizes of the foreground window's process
+     * 
+     * @param foreground New foreground window
+     */
+    void trackForegroundProcess(HWND foreground);
+
+    /**
+     * @brief Get a monitor's rectangle (cached)
+     * 
+     * @param monitor Monitor handle
+     * @param rect Receives the monitor area
+     * @return true if known
      * @return false otherwise
      */
-    bool isFullscreen(HWND hwnd);
+    bool getMonitorRect(HMONITOR monitor, RECT& rect);
 
     /**
-     * @brief Get process name from window
+     * @brief Get a process's executable name (cached)
+     * 
+     * @param processId Process ID
+     * @return const std::string& File name, empty if it cannot be queried
+     */
+    const std::string& getCachedProcessName(DWORD processId);
+
+    /**
+     * @brief Query a process's executable name
+     * 
+     * @param processId Process ID
+     * @return std::string File name, empty if it cannot be queried
+     */
+    static std::string queryProcessName(DWORD processId);
+
+    /**
+     * @brief WinEvent hook callback (delivered on the tracking thread)
+     */
+    static void CALLBACK winEventCallback(HWINEVENTHOOK hook, DWORD event, HWND hwnd, LONG idObject,
+                                          LONG idChild, DWORD eventThread, DWORD eventTime);
+
+    /**
+     * @brief Check if window is fullscreen
      * 
      * @param hwnd Window handle
-     * @return std::string Process name
+     * @return true if fullscreen
+     * @return false otherwise
      */
-    std::string getProcessName(HWND hwnd);
+    bool isFullscreen(HWND hwnd);
 
     /**
      * @brief Check if process is in whitelist
@@ -125,6 +280,20 @@ private:
     bool m_autoDetect;                      ///< Auto-detection enabled
     std::vector<std::string> m_whitelist;   ///< Process whitelist
     std::vector<std::string> m_blacklist;   ///< Process blacklist
+
+    std::vector<Candidate> m_candidates;    ///< Fullscreen windows (Z-order of the last scan)
+    std::vector<MonitorRect> m_monitors;    ///< Monitor rectangle cache
+    std::unordered_map<DWORD, std::string> m_processNames;  ///< Process name cache
+    std::vector<HWND> m_dirty;              ///< Windows changed since the last detectGame()
+    bool m_fullScanNeeded;                  ///< Next detectGame() rescans everything
+    uint64_t m_lastFullScan;                ///< GetTickCount64() of the last rescan
+
+    HWINEVENTHOOK m_foregroundHook;         ///< EVENT_SYSTEM_FOREGROUND
+    HWINEVENTHOOK m_objectHook;             ///< EVENT_OBJECT_CREATE .. EVENT_OBJECT_HIDE
+    HWINEVENTHOOK m_locationHook;           ///< EVENT_OBJECT_LOCATIONCHANGE of one process
+    DWORD m_locationProcess;                ///< Process m_locationHook follows
+
+    static GameDetector* s_tracking;        ///< Detector receiving WinEvents
 };
 
 } // namespace fps_monitor
@@ -0,0 +1,482 @@
+// Winsock must come before windows.h (network_exporter.h)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mswsock.h>
+#include "network_exporter.h"
+#include "thread_config.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+#pragma comment(lib, "ws2_32.lib")
+
+namespace fps_monitor {
+
+namespace {
+
+constexpr ULONG_PTR SOCKET_KEY = 1;     // Completions of the socket
+constexpr ULONG_PTR WAKE_KEY = 2;       // Posted by stop()
+constexpr DWORD SHUTDOWN_MS = 500;      // Longest stop() waits for the last sends
+
+uint32_t toHundredths(double fps) {
+    return static_cast<uint32_t>(std::llround(std::max(0.0, std::min(fps, 1e6)) * 100.0));
+}
+
+} // namespace
+
+NetworkExporter::NetworkExporter()
+    : m_dropped(0)
+    , m_unreported(0)
+    , m_sent(0)
+    , m_targets{}
+    , m_port(nullptr)
+    , m_stopRequested(false)
+    , m_winsock(false)
+    , m_protocol(Protocol::Udp)
+    , m_flushMs(100)
+    , m_tickFrequency(0)
+    , m_instanceId(0)
+    , m_socket(INVALID_SOCKET)
+    , m_state(State::Disconnected)
+    , m_connectOverlapped{}
+    , m_connectPending(false)
+    , m_announcePending(false)
+    , m_slots{}
+    , m_sequence(0)
+    , m_previous{}
+{
+}
+
+NetworkExporter::~NetworkExporter() {
+    stop();
+}
+
+bool NetworkExporter::start(const std::string& host, int port, Protocol protocol, int flushMs, int64_t tickFrequency) {
+    if (m_thread.joinable()) {
+        return true;
+    }
+
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0) {
+        return false;
+    }
+    m_winsock = true;
+
+    m_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (!m_port) {
+        stop();
+        return false;
+    }
+
+    m_host = host;
+    m_service = std::to_string(port);
+    m_protocol = protocol;
+    m_flushMs = static_cast<DWORD>(std::max(20, std::min(flushMs, 1000)));
+    m_tickFrequency = tickFrequency;
+
+    // Differs between runs and between machines started at the same moment
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    m_instanceId = static_cast<uint32_t>(now.QuadPart) ^ (GetCurrentProcessId() << 16);
+
+    char name[MAX_COMPUTERNAME_LENGTH + 1];
+    DWORD length = static_cast<DWORD>(sizeof(name));
+    m_hostName = GetComputerNameA(name, &length) ? std::string(name, length) : std::string();
+
+    m_stopRequested = false;
+    m_thread = std::thread(&NetworkExporter::threadMain, this);
+    return true;
+}
+
+void NetworkExporter::stop() {
+    if (m_thread.joinable()) {
+        m_stopRequested = true;
+        PostQueuedCompletionStatus(m_port, 0, WAKE_KEY, nullptr);
+        m_thread.join();
+    }
+
+    if (m_port) {
+        CloseHandle(m_port);
+        m_port = nullptr;
+    }
+    if (m_winsock) {
+        WSACleanup();
+        m_winsock = false;
+    }
+}
+
+void NetworkExporter::submitFrame(size_t session, uint32_t ticks) {
+    if (session < network::MAX_SESSIONS) {
+        push({network::RecordKind::Frame, network::EventType::Drop, static_cast<uint8_t>(session), ticks, 0});
+    }
+}
+
+void NetworkExporter::submitDrop(size_t session, double currentFPS, double averageFPS) {
+    if (session < network::MAX_SESSIONS) {
+        push({network::RecordKind::Event, network::EventType::Drop, static_cast<uint8_t>(session),
+              toHundredths(currentFPS), toHundredths(averageFPS)});
+    }
+}
+
+void NetworkExporter::submitTarget(size_t session, uint32_t processId, const std::string& name) {
+    if (session >= network::MAX_SESSIONS) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_targetMutex);
+        Target& target = m_targets[session];
+        target.announced = true;
+        target.processId = processId;
+        target.nameLength = std::min(name.size(), network::MAX_NAME_BYTES);
+        std::memcpy(target.name, name.data(), target.nameLength);
+    }
+
+    // Marks where the new target's frames start; the name is read when encoded
+    push({network::RecordKind::Event, network::EventType::Target, static_cast<uint8_t>(session), processId, 0});
+}
+
+uint64_t NetworkExporter::getSentPackets() const {
+    return m_sent.load(std::memory_order_relaxed);
+}
+
+uint64_t NetworkExporter::getDroppedRecords() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+void NetworkExporter::threadMain() {
+    ThreadConfig ioThread;
+    ioThread.priority = THREAD_PRIORITY_BELOW_NORMAL;
+    applyThreadConfig(ioThread);
+
+    ULONGLONG now = GetTickCount64();
+    ULONGLONG nextConnect = now;
+    ULONGLONG nextFlush = now + m_flushMs;
+    ULONGLONG nextAnnounce = now + ANNOUNCE_MS;
+
+    while (!m_stopRequested) {
+        now = GetTickCount64();
+        if (m_state == State::Disconnected && now >= nextConnect) {
+            // Name resolution blocks this thread only; records queue meanwhile
+            connect();
+            now = GetTickCount64();
+            nextConnect = now + RECONNECT_MS;
+        }
+
+        if (now >= nextFlush) {
+            bool announce = m_state == State::Connected && (m_announcePending || now >= nextAnnounce);
+            flush(announce);
+            if (announce) {
+                m_announcePending = false;
+                nextAnnounce = now + ANNOUNCE_MS;
+            }
+            nextFlush = now + m_flushMs;
+        }
+
+        DWORD timeout = static_cast<DWORD>(nextFlush - std::min(GetTickCount64(), nextFlush));
+        DWORD bytes = 0;
+        ULONG_PTR key = 0;
+        OVERLAPPED* overlapped = nullptr;
+        BOOL success = GetQueuedCompletionStatus(m_port, &bytes, &key, &overlapped, timeout);
+        if (overlapped) {
+            complete(overlapped, success != FALSE, bytes);
+        }
+    }
+
+    // Send what is left and give it a moment to leave before closing
+    if (m_state == State::Connected) {
+        flush(false);
+    }
+    ULONGLONG deadline = GetTickCount64() + SHUTDOWN_MS;
+    while (m_state == State::Connected && isSending()) {
+        now = GetTickCount64();
+        if (now >= deadline) {
+            break;
+        }
+        DWORD bytes = 0;
+        ULONG_PTR key = 0;
+        OVERLAPPED* overlapped = nullptr;
+        BOOL success = GetQueuedCompletionStatus(m_port, &bytes, &key, &overlapped, static_cast<DWORD>(deadline - now));
+        if (overlapped) {
+            complete(overlapped, success != FALSE, bytes);
+        }
+    }
+    disconnect();
+}
+
+void NetworkExporter::connect() {
+    bool tcp = (m_protocol == Protocol::Tcp);
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = tcp ? SOCK_STREAM : SOCK_DGRAM;
+    hints.ai_protocol = tcp ? IPPROTO_TCP : IPPROTO_UDP;
+
+    addrinfo* address = nullptr;
+    if (getaddrinfo(m_host.c_str(), m_service.c_str(), &hints, &address) != 0 || !address) {
+        return;
+    }
+
+    SOCKET handle = WSASocketW(address->ai_family, address->ai_socktype, address->ai_protocol,
+                               nullptr, 0, WSA_FLAG_OVERLAPPED);
+    if (handle == INVALID_SOCKET) {
+        freeaddrinfo(address);
+        return;
+    }
+    m_socket = handle;
+    if (!CreateIoCompletionPort(reinterpret_cast<HANDLE>(handle), m_port, SOCKET_KEY, 0)) {
+        freeaddrinfo(address);
+        disconnect();
+        return;
+    }
+
+    if (!tcp) {
+        // A connected datagram socket sends with plain WSASend
+        if (::connect(handle, address->ai_addr, static_cast<int>(address->ai_addrlen)) == 0) {
+            m_state = State::Connected;
+            m_announcePending = true;
+        } else {
+            disconnect();
+        }
+        freeaddrinfo(address);
+        return;
+    }
+
+    // Packets are batched already
+    BOOL noDelay = TRUE;
+    setsockopt(handle, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+    // ConnectEx needs a bound socket (any local address and port)
+    sockaddr_storage local = {};
+    local.ss_family = static_cast<ADDRESS_FAMILY>(address->ai_family);
+    GUID guid = WSAID_CONNECTEX;
+    LPFN_CONNECTEX connectEx = nullptr;
+    DWORD bytes = 0;
+    if (bind(handle, reinterpret_cast<const sockaddr*>(&local), static_cast<int>(address->ai_addrlen)) != 0 ||
+        WSAIoctl(handle, SIO_GET_EXTENSION_FUNCTION_POINTER, &guid, sizeof(guid),
+                 &connectEx, sizeof(connectEx), &bytes, nullptr, nullptr) != 0) {
+        freeaddrinfo(address);
+        disconnect();
+        return;
+    }
+
+    std::memset(&m_connectOverlapped, 0, sizeof(m_connectOverlapped));
+    m_state = State::Connecting;
+    m_connectPending = true;
+    if (!connectEx(handle, address->ai_addr, static_cast<int>(address->ai_addrlen),
+                   nullptr, 0, nullptr, &m_connectOverlapped) && WSAGetLastError() != WSA_IO_PENDING) {
+        m_connectPending = false;
+        disconnect();
+    }
+    freeaddrinfo(address);
+}
+
+void NetworkExporter::disconnect() {
+    m_state = State::Disconnected;
+    if (m_socket == INVALID_SOCKET) {
+        return;
+    }
+
+    closesocket(static_cast<SOCKET>(m_socket));
+    m_socket = INVALID_SOCKET;
+
+    // Closing aborts what is in flight; collect those completions now so
+    // none arrives once a new socket is connected
+    while (m_connectPending || isSending()) {
+        DWORD bytes = 0;
+        ULONG_PTR key = 0;
+        OVERLAPPED* overlapped = nullptr;
+        BOOL success = GetQueuedCompletionStatus(m_port, &bytes, &key, &overlapped, INFINITE);
+        if (overlapped) {
+            complete(overlapped, success != FALSE, bytes);
+        } else if (!success) {
+            break;
+        }
+    }
+}
+
+bool NetworkExporter::isSending() const {
+    return std::any_of(std::begin(m_slots), std::end(m_slots), [](const SendSlot& slot) { return slot.busy; });
+}
+
+void NetworkExporter::complete(OVERLAPPED* overlapped, bool success, DWORD bytes) {
+    if (overlapped == &m_connectOverlapped) {
+        m_connectPending = false;
+        if (m_state != State::Connecting) {
+            return;
+        }
+        if (success && setsockopt(static_cast<SOCKET>(m_socket), SOL_SOCKET, SO_UPDATE_CONNECT_CONTEXT, nullptr, 0) == 0) {
+            m_state = State::Connected;
+            m_announcePending = true;
+        } else {
+            disconnect();
+        }
+        return;
+    }
+
+    // The overlapped is the slot's first member
+    SendSlot* slot = reinterpret_cast<SendSlot*>(overlapped);
+    slot->busy = false;
+    if (m_state != State::Connected) {
+        return;
+    }
+
+    if (success && bytes == slot->size) {
+        m_sent.fetch_add(1, std::memory_order_relaxed);
+    } else if (m_protocol == Protocol::Tcp) {
+        // A broken stream cannot resume mid-packet
+        disconnect();
+    }
+}
+
+void NetworkExporter::flush(bool announce) {
+    SendSlot* slot = nullptr;
+
+    if (announce) {
+        Target targets[network::MAX_SESSIONS];
+        {
+            std::lock_guard<std::mutex> lock(m_targetMutex);
+            std::copy(std::begin(m_targets), std::end(m_targets), targets);
+        }
+
+        slot = reserve(slot);
+        if (slot) {
+            size_t length = std::min(m_hostName.size(), network::MAX_NAME_BYTES);
+            encodeName(slot, network::EventType::Host, 0, 0, m_hostName.data(), length);
+        }
+        for (size_t session = 0; session < network::MAX_SESSIONS; ++session) {
+            if (targets[session].announced && (slot = reserve(slot)) != nullptr) {
+                encodeName(slot, network::EventType::Target, session, targets[session].processId,
+                           targets[session].name, targets[session].nameLength);
+            }
+        }
+    }
+
+    // One queue's worth at most, so steady producers cannot keep this thread here
+    Record record;
+    for (size_t drained = 0; drained < QUEUE_CAPACITY && m_queue.pop(record); ++drained) {
+        slot = reserve(slot);
+        if (!slot) {
+            discard(1);
+            continue;
+        }
+        encode(slot, record);
+    }
+
+    if (slot) {
+        if (slot->size > sizeof(network::PacketHeader)) {
+            sendPacket(slot);
+        } else {
+            slot->busy = false;
+        }
+    }
+}
+
+NetworkExporter::SendSlot* NetworkExporter::beginPacket() {
+    for (SendSlot& slot : m_slots) {
+        if (!slot.busy) {
+            slot.busy = true;
+            slot.size = sizeof(network::PacketHeader);
+            std::fill(std::begin(m_previous), std::end(m_previous), 0u);
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+NetworkExporter::SendSlot* NetworkExporter::reserve(SendSlot* slot) {
+    if (m_state != State::Connected) {
+        if (slot) {
+            slot->busy = false;
+        }
+        return nullptr;
+    }
+    if (slot && slot->size + network::MAX_RECORD_BYTES <= network::MAX_PACKET_BYTES) {
+        return slot;
+    }
+    if (slot) {
+        sendPacket(slot);
+    }
+    return (m_state == State::Connected) ? beginPacket() : nullptr;
+}
+
+void NetworkExporter::sendPacket(SendSlot* slot) {
+    network::PacketHeader header;
+    header.magic = network::MAGIC;
+    header.version = network::VERSION;
+    header.headerSize = static_cast<uint16_t>(sizeof(network::PacketHeader));
+    header.sequence = m_sequence++;
+    header.payloadSize = static_cast<uint32_t>(slot->size - sizeof(network::PacketHeader));
+    header.droppedRecords = static_cast<uint32_t>(std::min<uint64_t>(m_unreported.exchange(0), UINT32_MAX));
+    header.instanceId = m_instanceId;
+    header.tickFrequency = m_tickFrequency;
+    std::memcpy(slot->data, &header, sizeof(header));
+
+    // The provider captures the WSABUF array before WSASend returns
+    WSABUF buffer;
+    buffer.buf = reinterpret_cast<CHAR*>(slot->data);
+    buffer.len = static_cast<ULONG>(slot->size);
+    std::memset(&slot->overlapped, 0, sizeof(slot->overlapped));
+    if (WSASend(static_cast<SOCKET>(m_socket), &buffer, 1, nullptr, 0, &slot->overlapped, nullptr) != 0 &&
+        WSAGetLastError() != WSA_IO_PENDING) {
+        slot->busy = false;
+        if (m_protocol == Protocol::Tcp) {
+            disconnect();
+        }
+    }
+}
+
+void NetworkExporter::push(const Record& record) {
+    if (!m_queue.push(record)) {
+        discard(1);
+    }
+}
+
+void NetworkExporter::encode(SendSlot* slot, const Record& record) {
+    size_t session = record.session;
+    uint8_t* out = slot->data + slot->size;
+    size_t length = 0;
+
+    if (record.kind == network::RecordKind::Frame) {
+        int64_t delta = static_cast<int64_t>(record.first) - static_cast<int64_t>(m_previous[session]);
+        m_previous[session] = record.first;
+        length = recording::writeVarint(
+            network::makeHead(recording::zigzagEncode(delta), session, network::RecordKind::Frame), out);
+    } else if (record.event == network::EventType::Drop) {
+        length = recording::writeVarint(
+            network::makeHead(static_cast<uint64_t>(network::EventType::Drop), session, network::RecordKind::Event), out);
+        length += recording::writeVarint(record.first, out + length);
+        length += recording::writeVarint(record.second, out + length);
+    } else {
+        // Names are read when encoded: two changes between flushes both carry the newer one
+        Target target;
+        {
+            std::lock_guard<std::mutex> lock(m_targetMutex);
+            target = m_targets[session];
+        }
+        encodeName(slot, network::EventType::Target, session, record.first, target.name, target.nameLength);
+        return;
+    }
+
+    slot->size += length;
+}
+
+void NetworkExporter::encodeName(SendSlot* slot, network::EventType type, size_t session, uint32_t processId,
+                                 const char* name, size_t length) {
+    uint8_t* out = slot->data + slot->size;
+    size_t size = recording::writeVarint(
+        network::makeHead(static_cast<uint64_t>(type), session, network::RecordKind::Event), out);
+    if (type == network::EventType::Target) {
+        size += recording::writeVarint(processId, out + size);
+    }
+    size += recording::writeVarint(length, out + size);
+    std::memcpy(out + size, name, length);
+    slot->size += size + length;
+}
+
+void NetworkExporter::discard(uint64_t count) {
+    m_dropped.fetch_add(count, std::memory_order_relaxed);
+    m_unreported.fetch_add(count, std::memory_order_relaxed);
+}
+
+} // namespace fps_monitor
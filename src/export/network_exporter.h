@@ -0,0 +1,299 @@
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "mpsc_ring_buffer.h"
+#include "network_format.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Streams frame times and drops to a remote collector
+ *
+ * Sessions' analysis threads submit frames, drops and target changes
+ * into a bounded lock-free queue; a full queue drops the record (counted
+ * and reported in the next packet), so a slow network never stalls the
+ * capture pipeline.
+ *
+ * A dedicated I/O thread owns the socket and an I/O completion port.
+ * Every flush interval it drains the queue into network_format.h packets
+ * and sends them with overlapped WSASend from a fixed pool of send
+ * buffers; when every buffer is still in flight the batch is discarded
+ * instead of queued. UDP packets are single datagrams; TCP connects with
+ * ConnectEx, reconnects after RECONNECT_MS when the collector goes away
+ * and discards records while disconnected. The host name and every
+ * session's target are re-announced each ANNOUNCE_MS.
+ *
+ * Name resolution (getaddrinfo) runs on the I/O thread, never on the
+ * caller's.
+ */
+class NetworkExporter {
+public:
+    /**
+     * @brief Transport
+     */
+    enum class Protocol {
+        Udp,        ///< One datagram per packet (losses are tolerated)
+        Tcp         ///< Packets on one stream (reconnects)
+    };
+
+    static constexpr size_t QUEUE_CAPACITY = 16384;     ///< Records between flushes
+    static constexpr size_t SEND_SLOTS = 8;             ///< Packets in flight
+    static constexpr DWORD RECONNECT_MS = 2000;         ///< Wait before reconnecting
+    static constexpr DWORD ANNOUNCE_MS = 5000;          ///< Host/target re-announcement interval
+
+    /**
+     * @brief Construct a stopped Network Exporter
+     */
+    NetworkExporter();
+
+    /**
+     * @brief Destroy the Network Exporter (stops it)
+     */
+    ~NetworkExporter();
+
+    // Prevent copying
+    NetworkExporter(const NetworkExporter&) = delete;
+    NetworkExporter& operator=(const NetworkExporter&) = delete;
+
+    /**
+     * @brief Start the I/O thread
+     *
+     * Connection problems are not errors: the thread keeps retrying.
+     *
+     * @param host Collector host name or address
+     * @param port Collector port
+     * @param protocol Transport
+     * @param flushMs Milliseconds between packets (20 - 1000)
+     * @param tickFrequency Ticks per second of the submitted frame times
+     * @return true if the I/O thread is running
+     * @return false if Winsock or the completion port is unavailable
+     */
+    bool start(const std::string& host, int port, Protocol protocol, int flushMs, int64_t tickFrequency);
+
+    /**
+     * @brief Send what is queued, then stop and join the I/O thread
+     */
+    void stop();
+
+    /**
+     * @brief Check if the exporter is running
+     *
+     * @return true if started
+     * @return false otherwise
+     */
+    bool isRunning() const { return m_thread.joinable(); }
+
+    /**
+     * @brief Queue a frame time (any thread, never blocks)
+     *
+     * @param session Session index (< network::MAX_SESSIONS)
+     * @param ticks Frame time in ticks
+     */
+    void submitFrame(size_t session, uint32_t ticks);
+
+    /**
+     * @brief Queue a drop (any thread, never blocks)
+     *
+     * @param session Session index
+     * @param currentFPS FPS during the drop
+     * @param averageFPS Average FPS before the drop
+     */
+    void submitDrop(size_t session, double currentFPS, double averageFPS);
+
+    /**
+     * @brief Set a session's target and queue its announcement (any thread)
+     *
+     * @param session Session index
+     * @param processId Tracked process (0 for none)
+     * @param name Process name (truncated to network::MAX_NAME_BYTES)
+     */
+    void submitTarget(size_t session, uint32_t processId, const std::string& name);
+
+    /**
+     * @brief Get the packets sent so far
+     *
+     * @return uint64_t Completed sends
+     */
+    uint64_t getSentPackets() const;
+
+    /**
+     * @brief Get the records discarded so far
+     *
+     * @return uint64_t Records lost to a full queue, busy buffers or no connection
+     */
+    uint64_t getDroppedRecords() const;
+
+private:
+    /**
+     * @brief One queued record
+     */
+    struct Record {
+        network::RecordKind kind;   ///< Frame or event
+        network::EventType event;   ///< Drop or Target (events only)
+        uint8_t session;            ///< Session index
+        uint32_t first;             ///< Ticks or current FPS x 100
+        uint32_t second;            ///< Average FPS x 100
+    };
+
+    /**
+     * @brief A session's current target
+     */
+    struct Target {
+        bool announced;                         ///< Ever assigned (re-announce it)
+        uint32_t processId;                     ///< Tracked process
+        size_t nameLength;                      ///< Bytes used in name
+        char name[network::MAX_NAME_BYTES];     ///< Process name (not terminated)
+    };
+
+    /**
+     * @brief Connection state (I/O thread)
+     */
+    enum class State {
+        Disconnected,   ///< Waiting to (re)connect
+        Connecting,     ///< ConnectEx pending (TCP)
+        Connected       ///< Sending
+    };
+
+    /**
+     * @brief One packet buffer and its overlapped send
+     */
+    struct SendSlot {
+        OVERLAPPED overlapped;                      ///< Send operation (first member)
+        bool busy;                                  ///< Send in flight
+        size_t size;                                ///< Packet bytes
+        uint8_t data[network::MAX_PACKET_BYTES];    ///< Header and records
+    };
+
+    /**
+     * @brief I/O thread body
+     */
+    void threadMain();
+
+    /**
+     * @brief Resolve the collector and open (or start connecting) the socket
+     */
+    void connect();
+
+    /**
+     * @brief Close the socket; pending sends complete with errors
+     */
+    void disconnect();
+
+    /**
+     * @brief Check if any send is in flight
+     *
+     * @return true if a send slot is busy
+     * @return false otherwise
+     */
+    bool isSending() const;
+
+    /**
+     * @brief Handle a dequeued completion
+     *
+     * @param overlapped Completed operation
+     * @param success The operation succeeded
+     * @param bytes Bytes transferred
+     */
+    void complete(OVERLAPPED* overlapped, bool success, DWORD bytes);
+
+    /**
+     * @brief Drain the queue into packets and send them
+     *
+     * @param announce Start with the host and every target
+     */
+    void flush(bool announce);
+
+    /**
+     * @brief Take a free send slot and start a packet in it
+     *
+     * @return SendSlot* Slot, or nullptr if all are in flight
+     */
+    SendSlot* beginPacket();
+
+    /**
+     * @brief Make room for one record, sending the packet if it is full
+     *
+     * @param slot Packet being built, or nullptr to start one
+     * @return SendSlot* Packet with room, or nullptr if none can be sent
+     */
+    SendSlot* reserve(SendSlot* slot);
+
+    /**
+     * @brief Fill in the header and send a packet
+     *
+     * @param slot Slot from beginPacket() with records
+     */
+    void sendPacket(SendSlot* slot);
+
+    /**
+     * @brief Queue a record, counting it as discarded if the queue is full
+     *
+     * @param record Record
+     */
+    void push(const Record& record);
+
+    /**
+     * @brief Encode a record into a packet
+     *
+     * @param slot Packet being built
+     * @param record Record
+     */
+    void encode(SendSlot* slot, const Record& record);
+
+    /**
+     * @brief Encode a named event (Host or Target)
+     *
+     * @param slot Packet being built
+     * @param type Event type
+     * @param session Session index
+     * @param processId Process ID (Target only)
+     * @param name Name bytes
+     * @param length Name length
+     */
+    void encodeName(SendSlot* slot, network::EventType type, size_t session, uint32_t processId,
+                    const char* name, size_t length);
+
+    /**
+     * @brief Count records that could not be sent
+     *
+     * @param count Records discarded
+     */
+    void discard(uint64_t count);
+
+    MpscRingBuffer<Record, QUEUE_CAPACITY> m_queue;     ///< Producers -> I/O thread
+    std::atomic<uint64_t> m_dropped;                    ///< Records discarded (total)
+    std::atomic<uint64_t> m_unreported;                 ///< Discarded since the last packet
+    std::atomic<uint64_t> m_sent;                       ///< Packets sent
+    std::mutex m_targetMutex;                           ///< Guards m_targets
+    Target m_targets[network::MAX_SESSIONS];            ///< Current target per session
+
+    std::thread m_thread;                               ///< I/O thread
+    HANDLE m_port;                                      ///< I/O completion port
+    std::atomic<bool> m_stopRequested;                  ///< Thread should flush and exit
+    bool m_winsock;                                     ///< WSAStartup succeeded
+    std::string m_host;                                 ///< Collector host
+    std::string m_service;                              ///< Collector port
+    Protocol m_protocol;                                ///< Transport
+    DWORD m_flushMs;                                    ///< Flush interval
+    int64_t m_tickFrequency;                            ///< Frame time tick rate
+    uint32_t m_instanceId;                              ///< PacketHeader::instanceId
+    std::string m_hostName;                             ///< Computer name
+
+    // I/O thread state
+    uintptr_t m_socket;                                 ///< SOCKET (INVALID_SOCKET when closed)
+    State m_state;                                      ///< Connection state
+    OVERLAPPED m_connectOverlapped;                     ///< ConnectEx operation
+    bool m_connectPending;                              ///< ConnectEx in flight
+    bool m_announcePending;                             ///< Announce on the next flush (new connection)
+    SendSlot m_slots[SEND_SLOTS];                       ///< Packet buffers
+    uint32_t m_sequence;                                ///< Next PacketHeader::sequence
+    uint32_t m_previous[network::MAX_SESSIONS];         ///< Frame predictor of the open packet
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "recording_format.h"
+
+namespace fps_monitor {
+namespace network {
+
+/**
+ * @brief Frame-time streaming packet format
+ *
+ * Every packet is a fixed PacketHeader followed by payloadSize bytes of
+ * records; over TCP packets follow each other on the stream (the header
+ * carries the length), over UDP each is one datagram of at most
+ * MAX_PACKET_BYTES. Packets are self-contained, so a lost datagram only
+ * loses its own records.
+ *
+ * Records reuse the .fpsr encoding (recording_format.h) with the session
+ * in the varint head: head = (value << 3) | (session << 1) | kind.
+ *
+ * - Frame (kind 0): value is the zigzag-encoded difference between this
+ *   frame time and the session's previous one in the packet, in ticks
+ *   (the predictor starts at 0 in every packet).
+ * - Event (kind 1): value is the EventType, followed by its payload
+ *   (varints unless noted):
+ *   - Host: name length, name bytes (computer name, UTF-8); session 0.
+ *   - Target: process ID, name length, name bytes. Precedes the frames of
+ *     a new target; repeated every few seconds for collectors joining late.
+ *   - Drop: current FPS x 100, average FPS x 100 (at the preceding frame).
+ *
+ * All integers are little-endian.
+ */
+
+constexpr uint32_t MAGIC = 0x4E535046;          ///< "FPSN"
+constexpr uint16_t VERSION = 1;                 ///< Current format version
+constexpr size_t MAX_PACKET_BYTES = 1400;       ///< Header and payload (fits an Ethernet MTU)
+constexpr size_t MAX_SESSIONS = 4;              ///< Sessions the head can address
+constexpr size_t MAX_NAME_BYTES = recording::MAX_NAME_BYTES;    ///< Longest name sent
+
+/**
+ * @brief Packet header (32 bytes)
+ */
+struct PacketHeader {
+    uint32_t magic;             ///< MAGIC
+    uint16_t version;           ///< VERSION
+    uint16_t headerSize;        ///< sizeof(PacketHeader); records start here
+    uint32_t sequence;          ///< Packets sent before this one (gaps are lost packets)
+    uint32_t payloadSize;       ///< Record bytes after the header
+    uint32_t droppedRecords;    ///< Records discarded by the sender since the previous packet
+    uint32_t instanceId;        ///< Random per run (tells restarts and machines apart)
+    int64_t tickFrequency;      ///< Ticks per second of the frame times
+};
+
+static_assert(sizeof(PacketHeader) == 32, "PacketHeader layout is part of the format");
+
+constexpr size_t MAX_PAYLOAD_BYTES = MAX_PACKET_BYTES - sizeof(PacketHeader);  ///< Record bytes per packet
+constexpr size_t MAX_RECORD_BYTES = 3 * recording::MAX_VARINT_BYTES + MAX_NAME_BYTES;  ///< Longest record
+
+/**
+ * @brief Record kinds (head bit 0)
+ */
+enum class RecordKind : uint8_t {
+    Frame = 0,      ///< Frame time
+    Event = 1       ///< Event record
+};
+
+/**
+ * @brief Event record types
+ */
+enum class EventType : uint8_t {
+    Host = 0,       ///< Sending machine
+    Target = 1,     ///< Capture target of a session
+    Drop = 2        ///< FPS drop detected
+};
+
+/**
+ * @brief Build a record head
+ *
+ * @param value Zigzag frame delta or EventType
+ * @param session Session index (< MAX_SESSIONS)
+ * @param kind Record kind
+ * @return uint64_t Head to write as a varint
+ */
+inline uint64_t makeHead(uint64_t value, size_t session, RecordKind kind) {
+    return (value << 3) | (static_cast<uint64_t>(session & (MAX_SESSIONS - 1)) << 1)
+        | static_cast<uint64_t>(kind);
+}
+
+} // namespace network
+} // namespace fps_monitor
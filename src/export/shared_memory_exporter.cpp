@@ -0,0 +1,238 @@
+#include "shared_memory_exporter.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace fps_monitor {
+
+namespace {
+
+constexpr const char* WRITER_LOCK_SUFFIX = ".Writer";   // Named mutex held by the section's writer
+
+// Seqlock write bracket; the interlocked increment is a full barrier
+void beginWrite(FpsmHeader& header) {
+    InterlockedIncrement(reinterpret_cast<volatile LONG*>(&header.sequence));
+}
+
+void endWrite(FpsmHeader& header) {
+    InterlockedIncrement(reinterpret_cast<volatile LONG*>(&header.sequence));
+}
+
+bool isCompatible(const FpsmHeader& header) {
+    return header.magic == FPSM_MAGIC && header.version == FPSM_VERSION
+        && header.headerSize == sizeof(FpsmHeader) && header.sectionSize == sizeof(FpsmSection)
+        && header.frameCapacity == FPSM_FRAME_CAPACITY && header.dropCapacity == FPSM_DROP_CAPACITY;
+}
+
+FpsmStats toExport(const StatsTracker::Stats& stats) {
+    return {stats.average, stats.min, stats.max, stats.percentile01, stats.percentile1, stats.percentile5};
+}
+
+} // namespace
+
+SharedMemoryExporter::SharedMemoryExporter()
+    : m_writerLock(nullptr)
+    , m_mapping(nullptr)
+    , m_section(nullptr)
+    , m_epochBase(0)
+    , m_published(false)
+    , m_pending{}
+    , m_pendingTotal(0)
+    , m_copiedTotal(0)
+    , m_targetChanged(false)
+    , m_processId(0)
+    , m_processName{}
+{
+}
+
+SharedMemoryExporter::~SharedMemoryExporter() {
+    close();
+}
+
+bool SharedMemoryExporter::open(size_t session) {
+    close();
+
+    // One writer per section; readers never open the lock
+    m_name = FPSM_SECTION_PREFIX + std::to_string(session);
+    m_writerLock = CreateMutexA(nullptr, FALSE, (m_name + WRITER_LOCK_SUFFIX).c_str());
+    if (!m_writerLock) {
+        return false;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        close();
+        return false;
+    }
+
+    m_mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                   0, static_cast<DWORD>(sizeof(FpsmSection)), m_name.c_str());
+    if (!m_mapping) {
+        close();
+        return false;
+    }
+    bool existing = (GetLastError() == ERROR_ALREADY_EXISTS);
+
+    // A smaller section left by an older layout fails to map at this size
+    m_section = static_cast<FpsmSection*>(MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, sizeof(FpsmSection)));
+    if (!m_section) {
+        close();
+        return false;
+    }
+
+    // Readers kept a previous monitor's section open: take it over if the
+    // layout matches (a section never initialised is still zero-filled)
+    FpsmHeader& header = m_section->header;
+    if (existing && header.magic != 0 && !isCompatible(header)) {
+        UnmapViewOfFile(m_section);
+        m_section = nullptr;
+        close();
+        return false;
+    }
+
+    // A writer that died mid-write left the sequence odd: finish that write
+    if ((header.sequence & 1) == 0) {
+        beginWrite(header);
+    }
+    if (existing) {
+        // New frames and drops start over; the epoch tells readers so
+        m_epochBase = header.epoch + 1;
+        std::memset(reinterpret_cast<char*>(&header) + offsetof(FpsmHeader, tickFrequency), 0,
+                    sizeof(FpsmHeader) - offsetof(FpsmHeader, tickFrequency));
+        header.epoch = m_epochBase;
+    }
+    header.magic = FPSM_MAGIC;
+    header.version = FPSM_VERSION;
+    header.headerSize = static_cast<uint16_t>(sizeof(FpsmHeader));
+    header.sectionSize = static_cast<uint32_t>(sizeof(FpsmSection));
+    header.frameCapacity = FPSM_FRAME_CAPACITY;
+    header.dropCapacity = FPSM_DROP_CAPACITY;
+    header.writerActive = 1;
+    endWrite(header);
+
+    m_published = false;
+    m_pendingTotal = 0;
+    m_copiedTotal = 0;
+    return true;
+}
+
+void SharedMemoryExporter::close() {
+    if (m_section) {
+        beginWrite(m_section->header);
+        m_section->header.writerActive = 0;
+        endWrite(m_section->header);
+
+        UnmapViewOfFile(m_section);
+        m_section = nullptr;
+    }
+    if (m_mapping) {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+    if (m_writerLock) {
+        CloseHandle(m_writerLock);
+        m_writerLock = nullptr;
+    }
+    m_epochBase = 0;
+}
+
+bool SharedMemoryExporter::isOpen() const {
+    return m_section != nullptr;
+}
+
+const std::string& SharedMemoryExporter::getName() const {
+    return m_name;
+}
+
+void SharedMemoryExporter::setTarget(uint32_t processId, const std::string& name) {
+    size_t length = std::min(name.size(), static_cast<size_t>(FPSM_MAX_NAME_BYTES - 1));
+    std::memcpy(m_processName, name.data(), length);
+    m_processName[length] = '\0';
+    m_processId = processId;
+    m_targetChanged = true;
+}
+
+void SharedMemoryExporter::addDrop(const DropDetector::Drop& drop, uint64_t frame, uint64_t epoch) {
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+
+    FpsmDrop& entry = m_pending[m_pendingTotal % FPSM_DROP_CAPACITY];
+    entry.frame = frame;
+    entry.qpcTime = now.QuadPart;
+    entry.averageFps = static_cast<float>(drop.averageFPS);
+    entry.currentFps = static_cast<float>(drop.currentFPS);
+    entry.magnitude = static_cast<float>(drop.magnitude);
+    entry.epoch = static_cast<uint32_t>(m_epochBase + epoch);
+    ++m_pendingTotal;
+}
+
+void SharedMemoryExporter::publish(const AnalysisSnapshot& snapshot) {
+    if (!m_section) {
+        return;
+    }
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+
+    FpsmHeader& header = m_section->header;
+    beginWrite(header);
+
+    copyFrames(snapshot);
+    copyDrops();
+    if (m_targetChanged) {
+        header.processId = m_processId;
+        std::memcpy(header.processName, m_processName, sizeof(header.processName));
+        m_targetChanged = false;
+    }
+
+    header.tickFrequency = snapshot.tickFrequency;
+    header.publishQpc = now.QuadPart;
+    header.epoch = m_epochBase + snapshot.epoch;
+    header.totalFrames = snapshot.totalSamples;
+    header.currentFps = snapshot.currentFPS;
+    header.averageFps = snapshot.averageFPS;
+    header.stats = toExport(snapshot.stats);
+    header.sessionStats = toExport(snapshot.sessionStats);
+
+    endWrite(header);
+    m_published = true;
+}
+
+void SharedMemoryExporter::copyFrames(const AnalysisSnapshot& snapshot) {
+    FpsmHeader& header = m_section->header;
+    SampleView<uint32_t> samples = snapshot.getSampleView();
+    uint64_t total = snapshot.totalSamples;
+    size_t count = samples.size();
+
+    // Within an epoch only the frames since the last publish are new; older
+    // ones stay in the section ring after they leave the sample window
+    bool contiguous = m_published && m_epochBase + snapshot.epoch == header.epoch
+        && total >= header.totalFrames && total - header.totalFrames <= count;
+    size_t copyCount = contiguous ? static_cast<size_t>(total - header.totalFrames) : count;
+
+    uint64_t index = total - copyCount;
+    samples.last(copyCount).forEach([this, &index](uint32_t ticks) {
+        m_section->frames[index++ % FPSM_FRAME_CAPACITY] = ticks;
+    });
+
+    size_t frameCount = contiguous ? header.frameCount + copyCount : count;
+    header.frameCount = static_cast<uint32_t>(std::min<size_t>(frameCount, FPSM_FRAME_CAPACITY));
+}
+
+void SharedMemoryExporter::copyDrops() {
+    FpsmHeader& header = m_section->header;
+    uint64_t queued = m_pendingTotal - m_copiedTotal;
+    if (queued == 0) {
+        return;
+    }
+
+    // Drops overwritten in the queue still count
+    uint64_t copyCount = std::min<uint64_t>(queued, FPSM_DROP_CAPACITY);
+    header.totalDrops += queued - copyCount;
+    for (uint64_t drop = m_pendingTotal - copyCount; drop < m_pendingTotal; ++drop) {
+        m_section->drops[header.totalDrops++ % FPSM_DROP_CAPACITY] = m_pending[drop % FPSM_DROP_CAPACITY];
+    }
+
+    header.dropCount = static_cast<uint32_t>(std::min<uint64_t>(header.dropCount + queued, FPSM_DROP_CAPACITY));
+    m_copiedTotal = m_pendingTotal;
+}
+
+} // namespace fps_monitor
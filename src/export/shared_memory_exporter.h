@@ -0,0 +1,138 @@
+#pragma once
+
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "analysis_thread.h"
+#include "shared_memory_format.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Publishes a session's results into a named shared-memory section
+ *
+ * Lets dashboards and capture overlays in other processes read live frame
+ * times, statistics and drops without an ETW session of their own. The
+ * section layout is described by shared_memory_format.h, a plain C header
+ * external tools can include.
+ *
+ * The attached AnalysisThread calls every method except open() and
+ * close() on its own thread: drops and target changes are queued, and
+ * publish() copies them together with the new frame times and the current
+ * statistics into the section inside one seqlock write. Readers map the
+ * section read-only and never block the writer. Frame times are copied
+ * incrementally, like AnalysisSnapshot, so a publish costs a few hundred
+ * bytes at most; nothing is allocated after open().
+ *
+ * A section outlives the monitor while readers keep it open; a restarted
+ * monitor takes it over and starts a new epoch, so readers can stay
+ * attached. A named mutex next to the section keeps a second monitor from
+ * publishing into it at the same time.
+ */
+class SharedMemoryExporter {
+public:
+    /**
+     * @brief Construct a closed Shared Memory Exporter
+     */
+    SharedMemoryExporter();
+
+    /**
+     * @brief Destroy the Shared Memory Exporter (closes it)
+     */
+    ~SharedMemoryExporter();
+
+    // Prevent copying
+    SharedMemoryExporter(const SharedMemoryExporter&) = delete;
+    SharedMemoryExporter& operator=(const SharedMemoryExporter&) = delete;
+
+    /**
+     * @brief Create the section of a session, or take over a previous one
+     *
+     * An existing section of the same layout (kept open by readers) is
+     * re-initialised under the seqlock: its epoch moves on and the frames,
+     * drops and statistics start over. Fails if another monitor publishes
+     * the section or it has a different layout.
+     *
+     * @param session Session index (named FPSM_SECTION_PREFIX + index)
+     * @return true if the section is mapped
+     * @return false otherwise
+     */
+    bool open(size_t session);
+
+    /**
+     * @brief Mark the section stopped and unmap it
+     *
+     * The section stays readable until its last reader closes it.
+     */
+    void close();
+
+    /**
+     * @brief Check if the section is mapped
+     *
+     * @return true if open
+     * @return false otherwise
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Get the section name
+     *
+     * @return const std::string& Name (empty until opened)
+     */
+    const std::string& getName() const;
+
+    /**
+     * @brief Queue a target change for the next publish
+     *
+     * @param processId Tracked process (0 for overlay timing)
+     * @param name Process name (truncated to FPSM_MAX_NAME_BYTES - 1)
+     */
+    void setTarget(uint32_t processId, const std::string& name);
+
+    /**
+     * @brief Queue a drop for the next publish
+     *
+     * Only the newest FPSM_DROP_CAPACITY drops between publishes are kept.
+     *
+     * @param drop Detected drop
+     * @param frame Frames of the epoch up to and including the dropped one
+     * @param epoch Epoch of the frame number
+     */
+    void addDrop(const DropDetector::Drop& drop, uint64_t frame, uint64_t epoch);
+
+    /**
+     * @brief Write a snapshot and the queued events into the section
+     *
+     * @param snapshot Snapshot about to be published
+     */
+    void publish(const AnalysisSnapshot& snapshot);
+
+private:
+    /**
+     * @brief Copy the frame times the section is missing
+     *
+     * @param snapshot Snapshot being published
+     */
+    void copyFrames(const AnalysisSnapshot& snapshot);
+
+    /**
+     * @brief Move the queued drops into the section
+     */
+    void copyDrops();
+
+    HANDLE m_writerLock;                        ///< Named mutex of the section's writer
+    HANDLE m_mapping;                           ///< Section handle
+    FpsmSection* m_section;                     ///< Mapped view
+    uint64_t m_epochBase;                       ///< Added to the analysis epoch (epochs of earlier writers)
+    std::string m_name;                         ///< Section name
+    bool m_published;                           ///< Section holds a snapshot
+    FpsmDrop m_pending[FPSM_DROP_CAPACITY];     ///< Drops since the last publish (ring)
+    uint64_t m_pendingTotal;                    ///< Drops queued since open()
+    uint64_t m_copiedTotal;                     ///< Drops written to the section
+    bool m_targetChanged;                       ///< Target to write on the next publish
+    uint32_t m_processId;                       ///< Queued target process
+    char m_processName[FPSM_MAX_NAME_BYTES];    ///< Queued target name
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,116 @@
+#pragma once
+
+/*
+ * FPS Monitor shared-memory export, layout version 1
+ *
+ * Plain C (C89 types from <stdint.h>) so external tools can include it as is.
+ *
+ * Every analysis session publishes into its own named section,
+ * FPSM_SECTION_PREFIX followed by the session index ("Local\FpsMonitor.Session0"
+ * is the foreground game), mapped read-only by readers:
+ *
+ *     HANDLE mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, L"Local\\FpsMonitor.Session0");
+ *     const FpsmSection* section = (const FpsmSection*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+ *
+ * Check magic, version and headerSize before anything else; sectionSize and
+ * the capacities are fixed for the life of the section.
+ *
+ * The section lives as long as any handle to it: a reader that keeps it
+ * open sees writerActive drop to 0 when the monitor stops, and back to 1
+ * with a new epoch (frames and drops restarting from 0) if it starts again.
+ *
+ * Consistency (seqlock): the writer makes header.sequence odd before it
+ * changes anything and even again afterwards. A reader copies what it
+ * needs straight out of the view and keeps the copy only if the sequence
+ * was even and unchanged around it:
+ *
+ *     do {
+ *         begin = section->header.sequence;
+ *         MemoryBarrier();
+ *         ...copy fields, frames or drops...
+ *         MemoryBarrier();
+ *     } while ((begin & 1) || section->header.sequence != begin);
+ *
+ * The writer never waits for readers. Readers can retry at most once per
+ * publish (every analysis wake-up, a few hundred per second at most).
+ *
+ * Rings: frame n (0-based since the epoch started) is stored at
+ * frames[n % FPSM_FRAME_CAPACITY]; the frameCount newest frames, numbered
+ * totalFrames - frameCount to totalFrames - 1, are valid. Drops work the
+ * same with totalDrops, dropCount and FPSM_DROP_CAPACITY. A reader that
+ * remembers totalFrames only needs to copy the frames added since.
+ *
+ * All integers are little-endian; times are QueryPerformanceCounter ticks
+ * unless noted.
+ */
+
+#include <stdint.h>
+
+#define FPSM_MAGIC 0x4D535046u                          /* "FPSM" */
+#define FPSM_VERSION 1u                                 /* Current layout version */
+#define FPSM_SECTION_PREFIX "Local\\FpsMonitor.Session" /* Followed by the session index (0 - 3) */
+#define FPSM_SECTION_PREFIX_W L"Local\\FpsMonitor.Session"
+#define FPSM_FRAME_CAPACITY 8192u                       /* Frame times kept (power of two) */
+#define FPSM_DROP_CAPACITY 64u                          /* Drops kept (power of two) */
+#define FPSM_MAX_NAME_BYTES 64u                         /* Target name, NUL-terminated UTF-8 */
+
+/* Frame rate statistics in FPS (StatsTracker::Stats) */
+typedef struct FpsmStats {
+    double average;         /* Mean FPS */
+    double min;             /* Minimum FPS */
+    double max;             /* Maximum FPS */
+    double percentile01;    /* 0.1% low FPS */
+    double percentile1;     /* 1% low FPS */
+    double percentile5;     /* 5% low FPS */
+} FpsmStats;
+
+/* FPS drop (32 bytes) */
+typedef struct FpsmDrop {
+    uint64_t frame;         /* Frames of the epoch before the drop was detected */
+    int64_t qpcTime;        /* When it was detected */
+    float averageFps;       /* Average FPS before the drop */
+    float currentFps;       /* FPS during the drop */
+    float magnitude;        /* Drop fraction (0 - 1) */
+    uint32_t epoch;         /* Low 32 bits of the epoch of frame */
+} FpsmDrop;
+
+/* Section header (256 bytes, at offset 0) */
+typedef struct FpsmHeader {
+    /* Written once when the section is created */
+    uint32_t magic;                 /* FPSM_MAGIC */
+    uint16_t version;               /* FPSM_VERSION */
+    uint16_t headerSize;            /* sizeof(FpsmHeader); frames start here */
+    uint32_t sectionSize;           /* sizeof(FpsmSection) */
+    uint32_t frameCapacity;         /* FPSM_FRAME_CAPACITY */
+    uint32_t dropCapacity;          /* FPSM_DROP_CAPACITY */
+
+    /* Seqlock: odd while the writer updates everything below */
+    volatile uint32_t sequence;
+
+    int64_t tickFrequency;          /* Ticks per second of the frame times */
+    int64_t publishQpc;             /* When the writer last published */
+    uint64_t epoch;                 /* Incremented on a target change or writer restart (frames restart) */
+    uint64_t totalFrames;           /* Frames since the epoch started */
+    uint64_t totalDrops;            /* Drops since the writer started */
+    uint32_t frameCount;            /* Valid frames in the ring */
+    uint32_t dropCount;             /* Valid drops in the ring */
+    uint32_t processId;             /* Tracked process (0 = overlay timing or idle) */
+    uint32_t writerActive;          /* 1 while the monitor publishes, 0 once it has stopped */
+    double currentFps;              /* FPS over the last second */
+    double averageFps;              /* FPS over the sample window */
+    FpsmStats stats;                /* Current window statistics */
+    FpsmStats sessionStats;         /* Statistics of the last hour */
+    char processName[FPSM_MAX_NAME_BYTES];  /* Tracked process name */
+} FpsmHeader;
+
+/* Whole section */
+typedef struct FpsmSection {
+    FpsmHeader header;
+    uint32_t frames[FPSM_FRAME_CAPACITY];   /* Frame times in ticks (ring, see above) */
+    FpsmDrop drops[FPSM_DROP_CAPACITY];     /* Drops (ring) */
+} FpsmSection;
+
+/* The layout is part of the format */
+typedef char fpsm_drop_size_check[(sizeof(FpsmDrop) == 32) ? 1 : -1];
+typedef char fpsm_header_size_check[(sizeof(FpsmHeader) == 256) ? 1 : -1];
+typedef char fpsm_section_size_check[(sizeof(FpsmSection) == 256 + 4 * FPSM_FRAME_CAPACITY + 32 * FPSM_DROP_CAPACITY) ? 1 : -1];
@@ -1,51 +1,172 @@
 #include <windows.h>
+#include <algorithm>
+#include <cstdio>
+#include <cwchar>
 #include <memory>
 #include <string>
+#include <vector>
 
 // Core modules
 #include "core/config.h"
-#include "core/fps_calculator.h"
-#include "core/drop_detector.h"
-#include "core/stats_tracker.h"
+#include "core/analysis_thread.h"
+#include "core/config_watcher.h"
+#include "core/session_pool.h"
+#include "core/simd_kernels.h"
 
 // Overlay modules
 #include "overlay/window_manager.h"
+#include "overlay/render_device.h"
 #include "overlay/d2d_renderer.h"
+#include "overlay/damage_tracker.h"
 #include "overlay/graph_renderer.h"
 #include "overlay/text_renderer.h"
 #include "overlay/theme_manager.h"
+#include "overlay/session_overlay.h"
+
+// Capture modules
+#include "capture/present_tracer.h"
+
+// Recording modules
+#include "recording/session_recorder.h"
+#include "recording/replay_source.h"
 
 // Detection modules
 #include "detection/game_detector.h"
 #include "detection/window_tracker.h"
 
+// Telemetry modules
+#include "telemetry/system_sampler.h"
+
+// Export modules
+#include "export/shared_memory_exporter.h"
+#include "export/network_exporter.h"
+
 // Utils modules
 #include "utils/timer.h"
+#include "utils/frame_scheduler.h"
 #include "utils/logger.h"
+#include "utils/alloc_counter.h"
+#include "utils/thread_config.h"
+#include "utils/stage_profiler.h"
+#include "utils/process_usage.h"
+#include "utils/directory_watcher.h"
 
 using namespace fps_monitor;
 
+static_assert(PresentTracer::MAX_TARGETS >= SessionPool::MAX_SESSIONS,
+              "every session needs a tracer slot");
+static_assert(network::MAX_SESSIONS >= SessionPool::MAX_SESSIONS,
+              "every session needs a packet session number");
+
+/**
+ * @brief Options given on the command line
+ */
+struct LaunchOptions {
+    std::string replayPath;     ///< --replay <file.fpsr>: replay instead of capturing
+    double replaySpeed = 1.0;   ///< --replay-speed=<x>: 1 = real time, 0 = as fast as possible
+    double replayStart = 0.0;   ///< --replay-start=<seconds>: first replayed second
+};
+
+/**
+ * @brief Split a WinMain command line into arguments (double quotes group)
+ */
+static std::vector<std::string> splitCommandLine(const char* commandLine) {
+    std::vector<std::string> args;
+    std::string current;
+    bool quoted = false;
+    bool pending = false;
+
+    for (const char* c = commandLine ? commandLine : ""; *c; ++c) {
+        if (*c == '"') {
+            quoted = !quoted;
+            pending = true;
+        } else if ((*c == ' ' || *c == '\t') && !quoted) {
+            if (pending) {
+                args.push_back(current);
+                current.clear();
+                pending = false;
+            }
+        } else {
+            current += *c;
+            pending = true;
+        }
+    }
+    if (pending) {
+        args.push_back(current);
+    }
+    return args;
+}
+
+/**
+ * @brief Parse the command line
+ * 
+ * @return true if every argument was understood
+ * @return false otherwise
+ */
+static bool parseLaunchOptions(const char* commandLine, LaunchOptions& options) {
+    std::vector<std::string> args = splitCommandLine(commandLine);
+
+    try {
+        for (size_t i = 0; i < args.size(); ++i) {
+            const std::string& arg = args[i];
+            if (arg == "--replay" && i + 1 < args.size()) {
+                options.replayPath = args[++i];
+            } else if (arg.compare(0, 15, "--replay-speed=") == 0) {
+                options.replaySpeed = std::stod(arg.substr(15));
+            } else if (arg.compare(0, 15, "--replay-start=") == 0) {
+                options.replayStart = std::stod(arg.substr(15));
+            } else {
+                return false;
+            }
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Get the primary display's refresh rate (0 if unknown)
+ */
+static double queryRefreshRate() {
+    DEVMODEA mode = {};
+    mode.dmSize = sizeof(mode);
+    // 0 and 1 stand for the hardware default rate
+    if (!EnumDisplaySettingsA(nullptr, ENUM_CURRENT_SETTINGS, &mode) || mode.dmDisplayFrequency <= 1) {
+        return 0.0;
+    }
+    return static_cast<double>(mode.dmDisplayFrequency);
+}
+
 /**
  * @brief Main application class
  */
 class FPSMonitorApp {
 public:
-    FPSMonitorApp() : m_running(false), m_visible(true) {}
+    FPSMonitorApp() : m_running(false), m_visible(true) {
+        for (size_t& handle : m_sessionHandles) {
+            handle = FrameScheduler::INVALID_HANDLE_ID;
+        }
+    }
 
-    bool initialize() {
+    bool initialize(const LaunchOptions& options) {
         // 1. Load configuration
         LOG_INFO("Loading configuration...");
         m_config = std::make_unique<Config>();
         if (!m_config->load("config.ini")) {
             LOG_WARNING("Failed to load config.ini, using defaults");
         }
+        m_settings = m_config->getSnapshot();
+        m_settingsVersion = m_settings->version;
+        m_profileLogSeconds = m_settings->performance.profileLogSeconds;
+        m_viewSeconds = clampViewSeconds(m_settings->graph.viewSeconds);
 
         // 2. Initialize logger
         LOG_INFO("FPS Monitor Overlay starting...");
 
         // 3. Initialize theme manager
         m_themeManager = std::make_unique<ThemeManager>();
-        const auto& displaySettings = m_config->getDisplaySettings();
+        const auto& displaySettings = m_settings->display;
         if (!m_themeManager->loadTheme(displaySettings.theme)) {
             LOG_WARNING("Failed to load theme, using default");
         }
@@ -53,80 +174,133 @@ public:
         // 4. Create high-resolution timer
         m_timer = std::make_unique<Timer>();
 
-        // 5. Initialize FPS calculator
-        const auto& graphSettings = m_config->getGraphSettings();
-        size_t historySize = static_cast<size_t>(graphSettings.historySeconds * 60.0);
-        m_fpsCalculator = std::make_unique<FpsCalculator>(historySize);
+        // 5-7. Initialize the analysis stage (FPS calculator, stats tracker
+        // and drop detector run on their own thread)
+        const auto& graphSettings = m_settings->graph;
+        const auto& perfSettings = m_settings->performance;
+        const auto& detectionSettings = m_settings->detection;
+        const auto& threadingSettings = m_settings->threading;
+        LOG_INFO(std::string("Sample kernels: ") + SimdKernels::get().name());
+
+        // Replay mode: a recording stands in for present capture
+        if (!options.replayPath.empty() && !openReplay(options.replayPath)) {
+            MessageBoxA(nullptr, "Failed to open replay file", "Error", MB_OK | MB_ICONERROR);
+            return false;
+        }
 
-        // 6. Initialize stats tracker
-        const auto& perfSettings = m_config->getPerformanceSettings();
-        m_statsTracker = std::make_unique<StatsTracker>(perfSettings.statsUpdateMs);
+        AnalysisThread::Settings analysisSettings;
+        analysisSettings.historySeconds = graphSettings.historySeconds;
+        analysisSettings.statsUpdateMs = perfSettings.statsUpdateMs;
+        analysisSettings.percentileMode = (perfSettings.percentileMode == "histogram")
+            ? PercentileMode::Histogram
+            : PercentileMode::Exact;
+        analysisSettings.dropThresholdPercent = detectionSettings.dropThresholdPercent;
+        analysisSettings.stutterFactor = detectionSettings.stutterFactor;
+        analysisSettings.refreshRate = queryRefreshRate();
+        analysisSettings.tickIntervalMs = perfSettings.updateRateMs;
+        analysisSettings.tickFrequency = m_replay ? m_replay->getTickFrequency() : 0;
+        analysisSettings.thread.priority = parseThreadPriority(threadingSettings.analysisPriority);
+        analysisSettings.thread.affinityMask = threadingSettings.analysisAffinity;
+
+        // Every session is allocated up front; a replay has a single one
+        size_t sessionCount = m_replay ? 1 : static_cast<size_t>(std::max(m_settings->sessions.maxSessions, 1));
+        m_sessions = std::make_unique<SessionPool>(analysisSettings, sessionCount);
+        m_analysis = &m_sessions->get(SessionPool::PRIMARY_SESSION);
+
+        // System load for drop annotation (live capture only; recordings have none)
+        const auto& telemetrySettings = m_settings->telemetry;
+        if (telemetrySettings.enabled && !m_replay) {
+            m_telemetry = std::make_unique<SystemSampler>();
+            if (m_telemetry->start(telemetrySettings.sampleMs)) {
+                LOG_INFO("System telemetry sampling every " + std::to_string(telemetrySettings.sampleMs) + " ms");
+            } else {
+                LOG_WARNING("Performance counters unavailable, drops are not annotated");
+                m_telemetry.reset();
+            }
+        }
 
-        // 7. Initialize drop detector
-        const auto& detectionSettings = m_config->getDetectionSettings();
-        m_dropDetector = std::make_unique<DropDetector>(detectionSettings.dropThresholdPercent);
+        // Shared-memory export of every session for external readers
+        if (m_settings->exports.sharedMemory) {
+            openExporters();
+        }
+        // Streaming to a collector (live capture only)
+        if (m_settings->exports.network != "off" && !m_replay) {
+            startNetworkExport();
+        }
 
-        // Set drop callback for logging
-        m_dropDetector->setDropCallback([](const DropDetector::Drop& drop) {
-            LOG_WARNING("FPS drop detected: " + std::to_string(drop.magnitude * 100.0) + "%");
+        // Set drop callbacks for logging
+        m_analysis->setDropCallback([this](const DropDetector::Drop& drop) {
+            logDrop(drop, SessionPool::PRIMARY_SESSION);
         });
+        for (size_t i = SessionPool::PRIMARY_SESSION + 1; i < m_sessions->getCapacity(); ++i) {
+            m_sessions->get(i).setDropCallback([this, i](const DropDetector::Drop& drop) {
+                logDrop(drop, i);
+            });
+        }
 
         // 8. Initialize game detector (optional for Phase 1)
         m_gameDetector = std::make_unique<GameDetector>();
-        const auto& gameSettings = m_config->getGameDetectionSettings();
+        const auto& gameSettings = m_settings->gameDetection;
         m_gameDetector->setAutoDetect(gameSettings.autoDetect);
         m_gameDetector->setWhitelist(gameSettings.whitelist);
         m_gameDetector->setBlacklist(gameSettings.blacklist);
+        if (!m_gameDetector->startEventTracking()) {
+            LOG_WARNING("Window event hooks unavailable, game detection polls all windows");
+        }
 
-        // 9. Create overlay window
-        m_windowManager = std::make_unique<WindowManager>();
-        
-        // Calculate position based on config
-        int x = 0, y = 0;
-        calculateWindowPosition(x, y);
+        if (m_replay) {
+            double frequency = static_cast<double>(m_replay->getTickFrequency());
+            uint64_t startTime = static_cast<uint64_t>(std::max(0.0, options.replayStart) * frequency);
+            m_analysis->setReplaySource(m_replay.get(), options.replaySpeed, startTime);
+        } else {
+            startCapture(threadingSettings);
+        }
 
-        if (!m_windowManager->create(displaySettings.width, displaySettings.height, x, y)) {
-            MessageBoxA(nullptr, "Failed to create overlay window", "Error", MB_OK | MB_ICONERROR);
+        if (!m_sessions->start()) {
+            LOG_ERROR("Failed to start analysis thread");
             return false;
         }
 
-        // 10. Initialize Direct2D renderer
-        m_d2dRenderer = std::make_unique<D2DRenderer>();
-        if (!m_d2dRenderer->initialize(m_windowManager->getHandle())) {
+        // 9-10. Create overlay window and Direct2D renderer; the swap chain
+        // backend needs a window without redirection surface, so falling back
+        // to the HWND target means recreating the window
+        if (!m_renderDevice.initialize()) {
+            MessageBoxA(nullptr, "Failed to initialize Direct2D", "Error", MB_OK | MB_ICONERROR);
+            return false;
+        }
+        bool useSwapChain = (perfSettings.renderBackend != "hwnd");
+        if (useSwapChain && !createOverlay(D2DRenderer::Backend::SwapChain)) {
+            LOG_WARNING("Swap chain backend unavailable, falling back to HWND render target");
+            useSwapChain = false;
+        }
+        if (!useSwapChain && !createOverlay(D2DRenderer::Backend::Hwnd)) {
             MessageBoxA(nullptr, "Failed to initialize Direct2D", "Error", MB_OK | MB_ICONERROR);
             return false;
         }
+        m_backend = useSwapChain ? D2DRenderer::Backend::SwapChain : D2DRenderer::Backend::Hwnd;
+        LOG_INFO(std::string("Render backend: ") + (useSwapChain ? "swapchain" : "hwnd"));
+        m_damage.setBounds(static_cast<float>(displaySettings.width), static_cast<float>(getOverlayHeight()));
 
         // 11. Initialize graph renderer
         m_graphRenderer = std::make_unique<GraphRenderer>();
-        if (!m_graphRenderer->initialize(m_d2dRenderer->getRenderTarget())) {
+        if (!m_graphRenderer->initialize(&m_d2dRenderer->getResources())) {
             MessageBoxA(nullptr, "Failed to initialize graph renderer", "Error", MB_OK | MB_ICONERROR);
             return false;
         }
 
         // Configure graph renderer
         m_graphRenderer->setShowGrid(graphSettings.showGrid);
+        m_graphRenderer->setShowFill(graphSettings.showFill);
         m_graphRenderer->setLineWidth(static_cast<float>(graphSettings.lineWidth));
+        m_graphRenderer->setMaxSamples(AnalysisSnapshot::CAPACITY);
 
         // 12. Initialize text renderer
-        std::wstring fontFamily = L"Consolas";
-        std::string fontFamilyStr = m_themeManager->getStyleProperty("font_family");
-        if (!fontFamilyStr.empty()) {
-            fontFamily = std::wstring(fontFamilyStr.begin(), fontFamilyStr.end());
-        }
-
-        float fontSize = 14.0f;
-        std::string fontSizeStr = m_themeManager->getStyleProperty("font_size");
-        if (!fontSizeStr.empty()) {
-            try {
-                fontSize = std::stof(fontSizeStr);
-            } catch (const std::exception&) {
-                // Keep default on parse error
-            }
-        }
+        const ThemeManager::Palette& palette = m_themeManager->getPalette();
+        std::wstring fontFamily = palette.fontFamily;
+        float fontSize = palette.fontSize;
 
         m_textRenderer = std::make_unique<TextRenderer>();
-        if (!m_textRenderer->initialize(m_d2dRenderer->getRenderTarget(), fontFamily, fontSize)) {
+        if (!m_textRenderer->initialize(&m_d2dRenderer->getResources(), fontFamily, fontSize)) {
             MessageBoxA(nullptr, "Failed to initialize text renderer", "Error", MB_OK | MB_ICONERROR);
             return false;
         }
@@ -136,8 +310,8 @@ public:
             LOG_WARNING("Failed to register F12 hotkey");
         }
 
-        // Create brushes for rendering
-        createBrushes();
+        // Register theme brushes (created on first use, rebuilt after device loss)
+        registerBrushes();
 
         // Show window
         m_windowManager->show();
@@ -150,38 +324,98 @@ public:
         m_running = true;
         m_timer->start();
 
-        const auto& perfSettings = m_config->getPerformanceSettings();
-        const double targetFrameTime = perfSettings.updateRateMs / 1000.0;
+        // This thread owns the window and renders
+        const auto& threadingSettings = m_settings->threading;
+        ThreadConfig uiThread;
+        uiThread.priority = parseThreadPriority(threadingSettings.uiPriority);
+        uiThread.affinityMask = threadingSettings.uiAffinity;
+        if (!applyThreadConfig(uiThread)) {
+            LOG_WARNING("Failed to apply UI thread priority/affinity");
+        }
+
+        const auto& perfSettings = m_settings->performance;
+        if (!m_scheduler.initialize(perfSettings.updateRateMs)) {
+            LOG_WARNING("Failed to create frame timer, using wait timeouts");
+        }
+        LOG_INFO(std::string("Frame timer: ") + (m_scheduler.isHighResolution() ? "high resolution" : "standard"));
+
+        // Wake when the analysis thread publishes new results
+        m_snapshotHandle = m_scheduler.addHandle(m_analysis->getSnapshotEvent());
+        for (size_t i = SessionPool::PRIMARY_SESSION + 1; i < m_sessions->getCapacity(); ++i) {
+            m_sessionHandles[i] = m_scheduler.addHandle(m_sessions->get(i).getSnapshotEvent());
+        }
+
+        // Wake when config.ini is reloaded; the watcher thread parses it
+        if (m_configWatcher.start(m_config.get())) {
+            m_scheduler.addHandle(m_configWatcher.getChangeEvent());
+        } else {
+            LOG_WARNING("Failed to watch config.ini, configuration edits need a restart");
+        }
+
+        // Wake when the theme file is saved; colours are swapped between frames
+        m_themeFile = m_themeManager->getCurrentThemeFile();
+        if (!m_themeFile.empty()) {
+            if (m_themeWatcher.start(ThemeManager::THEME_DIRECTORY)) {
+                m_scheduler.addHandle(m_themeWatcher.getEvent());
+            } else {
+                LOG_WARNING("Failed to watch the theme directory, theme edits need a restart");
+            }
+        }
+
+        m_messagesStage = m_profiler.addStage("messages");
+        m_snapshotStage = m_profiler.addStage("snapshot");
+        m_damageStage = m_profiler.addStage("damage");
+        m_graphStage = m_profiler.addStage("graph");
+        m_textStage = m_profiler.addStage("text");
+        m_endDrawStage = m_profiler.addStage("end_draw");
+        m_frameStage = m_profiler.addStage("frame");
 
         LOG_INFO("Entering main loop...");
 
         while (m_running) {
             // Process Windows messages
-            if (!m_windowManager->processMessages()) {
+            bool alive = false;
+            {
+                StageProfiler::Scope messages(m_profiler, m_messagesStage);
+                alive = m_windowManager->processMessages();
+            }
+            if (!alive) {
                 m_running = false;
                 break;
             }
 
+            bool visible = m_windowManager->isVisible();
+            reloadThemeIfChanged();
+            applyConfigChanges();
+
             // Update timer and calculate delta time
             double deltaTime = m_timer->getDeltaTime();
 
-            // Update FPS calculator
-            m_fpsCalculator->update(deltaTime);
-
-            // Update stats tracker
-            auto samples = m_fpsCalculator->getSamples();
-            m_statsTracker->update(samples);
-
-            // Check for drops
-            m_dropDetector->update(m_fpsCalculator->getCurrentFPS(), m_fpsCalculator->getAverageFPS());
+            // Point the capture at the foreground game; without one the
+            // analysis thread times its own ticks while the overlay is shown
+            updateCaptureTarget(deltaTime);
+            m_analysis->setOverlayTiming(visible);
+
+            // Take the latest published results (never blocks the analysis thread)
+            ++m_frameCount;
+            bool fresh = false;
+            {
+                StageProfiler::Scope acquire(m_profiler, m_snapshotStage);
+                fresh = m_analysis->acquireSnapshot();
+            }
+            if (fresh) {
+                reportReplayEnd(m_analysis->getSnapshot());
+            }
+            updateProfile(deltaTime, m_analysis->getSnapshot());
 
             // Render overlay if visible
-            if (m_windowManager->isVisible()) {
-                render();
+            if (visible) {
+                StageProfiler::Scope frame(m_profiler, m_frameStage);
+                render(m_analysis->getSnapshot());
             }
+            renderSessions(visible);
 
-            // Sleep to maintain target FPS (60 FPS)
-            Sleep(static_cast<DWORD>(targetFrameTime * 1000));
+            waitForWork(visible, fresh);
         }
 
         LOG_INFO("Main loop exited");
@@ -191,145 +425,811 @@ public:
         LOG_INFO("Shutting down...");
 
         // Clean up in reverse order
+        m_configWatcher.stop();
+        // Join the analysis thread while the tracer it queries still exists;
+        // the tracer's callback only queues into the (still alive) calculators
+        if (m_sessions) {
+            m_sessions->stop();
+        }
+        m_presentTracer.reset();
+        for (auto& overlay : m_sessionOverlays) {
+            overlay.reset();
+        }
+        m_analysis = nullptr;
+        m_sessions.reset();
+        m_telemetry.reset();
+        for (auto& exporter : m_exporters) {
+            exporter.reset();
+        }
+        stopNetworkExport();
+        stopRecording();
+        m_replay.reset();
         m_textRenderer.reset();
         m_graphRenderer.reset();
         m_d2dRenderer.reset();
         m_windowManager.reset();
+        m_renderDevice.shutdown();
         m_gameDetector.reset();
-        m_dropDetector.reset();
-        m_statsTracker.reset();
-        m_fpsCalculator.reset();
         m_timer.reset();
         m_themeManager.reset();
         m_config.reset();
 
-        // Release brushes
-        releaseBrushes();
-
         LOG_INFO("Shutdown complete");
     }
 
 private:
-    void calculateWindowPosition(int& x, int& y) {
-        const auto& displaySettings = m_config->getDisplaySettings();
-        
-        // Get primary monitor dimensions
-        int screenWidth = GetSystemMetrics(SM_CXSCREEN);
-        int screenHeight = GetSystemMetrics(SM_CYSCREEN);
+    bool isSteadyState() const {
+        // Scratch buffers grow to their final size during the first frames
+        return m_frameCount > WARMUP_FRAMES;
+    }
+
+    void updateCaptureTarget(double deltaTime) {
+        if (m_presentTracer && m_presentTracer->hasFailed()) {
+            recoverCapture();
+        }
+        if (!m_presentTracer || !m_presentTracer->isRunning()) {
+            return;
+        }
 
+        // Window enumeration is expensive; re-detect about once per second
+        m_detectAccumulator += deltaTime;
+        if (m_detectAccumulator < GAME_DETECT_INTERVAL) {
+            return;
+        }
+        m_detectAccumulator = 0.0;
+
+        // The foreground game first, then one window per other game
+        HWND games[SessionPool::MAX_SESSIONS] = {};
+        DWORD processIds[SessionPool::MAX_SESSIONS] = {};
+        size_t gameCount = m_gameDetector->detectGames(games, m_sessions->getCapacity());
+        for (size_t i = 0; i < gameCount; ++i) {
+            GetWindowThreadProcessId(games[i], &processIds[i]);
+        }
+
+        DWORD processId = gameCount > 0 ? processIds[0] : 0;
+        if (processId != m_presentTracer->getTargetProcess(SessionPool::PRIMARY_SESSION)) {
+            std::string name = processId ? m_gameDetector->getProcessName(games[0]) : std::string();
+            LOG_INFO("Capturing presents for process " + std::to_string(processId) + " " + name);
+            m_presentTracer->setTargetProcess(SessionPool::PRIMARY_SESSION, processId);
+            m_sessions->assign(SessionPool::PRIMARY_SESSION, processId, name);
+        }
+
+        // Release sessions whose game exited or became the foreground game
+        for (size_t session = SessionPool::PRIMARY_SESSION + 1; session < m_sessions->getCapacity(); ++session) {
+            uint32_t tracked = m_sessions->getProcess(session);
+            if (tracked == 0 || std::find(processIds + 1, processIds + gameCount, tracked) != processIds + gameCount) {
+                continue;
+            }
+            LOG_INFO("Session " + std::to_string(session) + " stopped tracking " + m_sessions->getName(session));
+            m_presentTracer->setTargetProcess(session, 0);
+            m_sessions->release(session);
+            m_sessionOverlays[session].reset();
+        }
+
+        // Give every other game a free session
+        for (size_t i = 1; i < gameCount; ++i) {
+            if (m_sessions->find(processIds[i]) != SessionPool::INVALID_SESSION) {
+                continue;
+            }
+            std::string name = m_gameDetector->getProcessName(games[i]);
+            size_t session = m_sessions->acquire(processIds[i], name);
+            if (session == SessionPool::INVALID_SESSION) {
+                break;
+            }
+            LOG_INFO("Session " + std::to_string(session) + " capturing presents for process "
+                     + std::to_string(processIds[i]) + " " + name);
+            m_presentTracer->setTargetProcess(session, processIds[i]);
+            createSessionOverlay(session, games[i]);
+        }
+    }
+
+    void recoverCapture() {
+        LOG_ERROR("Present capture stopped unexpectedly (ETW status "
+                  + std::to_string(m_presentTracer->getExitStatus()) + "), restarting");
+        if (m_presentTracer->start()) {
+            return;
+        }
+
+        // Sessions now time the overlay: stop naming the games they tracked
+        LOG_ERROR("Present capture unavailable, falling back to overlay timing");
+        for (size_t session = SessionPool::PRIMARY_SESSION + 1; session < m_sessions->getCapacity(); ++session) {
+            if (m_sessions->getProcess(session) != 0) {
+                m_sessions->release(session);
+                m_sessionOverlays[session].reset();
+            }
+        }
+        m_sessions->assign(SessionPool::PRIMARY_SESSION, 0, std::string());
+    }
+
+    void createSessionOverlay(size_t session, HWND game) {
+        if (!m_settings->sessions.overlayPerSession) {
+            return;
+        }
+
+        // Same corner as the main overlay, on the monitor the game runs on
+        const auto& displaySettings = m_settings->display;
+        MONITORINFO monitor = {};
+        monitor.cbSize = sizeof(monitor);
+        if (!GetMonitorInfoA(MonitorFromWindow(game, MONITOR_DEFAULTTONEAREST), &monitor)) {
+            return;
+        }
+
+        // Graph style follows the latest configuration, like the main overlay
+        std::shared_ptr<const Config::Settings> settings = m_config->getSnapshot();
+        const auto& graphSettings = settings->graph;
+        SessionOverlay::Layout layout;
+        layout.width = displaySettings.width;
+        layout.height = displaySettings.height;
+        layout.maxSamples = AnalysisSnapshot::CAPACITY;
+        layout.showGrid = graphSettings.showGrid;
+        layout.showFill = graphSettings.showFill;
+        layout.lineWidth = static_cast<float>(graphSettings.lineWidth);
+        calculateWindowPosition(monitor.rcMonitor, layout.width, layout.height, session, layout.x, layout.y);
+
+        auto overlay = std::make_unique<SessionOverlay>();
+        if (!overlay->create(&m_renderDevice, m_backend, m_themeManager.get(), layout, m_sessions->getName(session))) {
+            LOG_WARNING("Failed to create overlay for session " + std::to_string(session));
+            return;
+        }
+        overlay->setVisible(m_windowManager->isVisible());
+        m_sessionOverlays[session] = std::move(overlay);
+    }
+
+    void renderSessions(bool visible) {
+        for (size_t session = SessionPool::PRIMARY_SESSION + 1; session < m_sessions->getCapacity(); ++session) {
+            SessionOverlay* overlay = m_sessionOverlays[session].get();
+            m_sessionFresh[session] = false;
+            if (!overlay) {
+                continue;
+            }
+
+            // Extra overlays follow the main overlay's visibility (F12)
+            overlay->setVisible(visible);
+            AnalysisThread& analysis = m_sessions->get(session);
+            m_sessionFresh[session] = analysis.acquireSnapshot();
+            if (visible) {
+                overlay->render(analysis.getSnapshot());
+            }
+        }
+    }
+
+    int getOverlayHeight() const {
+        const auto& displaySettings = m_settings->display;
+        bool showProfiler = m_settings->performance.showProfiler;
+        return displaySettings.height + (showProfiler ? static_cast<int>(PROFILE_PANEL_HEIGHT) : 0);
+    }
+
+    void updateProfile(double deltaTime, const AnalysisSnapshot& snapshot) {
+        const auto& perfSettings = m_settings->performance;
+        m_profileElapsed += deltaTime;
+        if (m_profileElapsed < PROFILE_INTERVAL) {
+            return;
+        }
+        m_profileLogElapsed += m_profileElapsed;
+        m_profileElapsed = 0.0;
+
+        // Once per second: summarize both threads and the process
+        m_profiler.summarize(m_profile);
+        m_usage.sample();
+
+        if (perfSettings.showProfiler) {
+            formatProfilePanel(snapshot.profile);
+        }
+
+        if (m_profileLogSeconds > 0 && m_profileLogElapsed >= m_profileLogSeconds) {
+            m_profileLogElapsed = 0.0;
+            char usage[96];
+            std::snprintf(usage, sizeof(usage), "Profile: cpu %.2f%%, working set %.1f MB, private %.1f MB",
+                          m_usage.getCpuPercent(),
+                          static_cast<double>(m_usage.getWorkingSetBytes()) / (1024.0 * 1024.0),
+                          static_cast<double>(m_usage.getPrivateBytes()) / (1024.0 * 1024.0));
+            std::string line = usage;
+            appendProfileStages(line, "ui", m_profile);
+            appendProfileStages(line, "analysis", snapshot.profile);
+            LOG_INFO(line);
+        }
+    }
+
+    static void appendProfileStages(std::string& line, const char* thread, const StageProfiler::Summary& summary) {
+        line += std::string(" | ") + thread + " p50/p99 us:";
+        for (size_t i = 0; i < summary.stageCount; ++i) {
+            const auto& stage = summary.stages[i];
+            char text[64];
+            std::snprintf(text, sizeof(text), " %s %.0f/%.0f", stage.name, stage.p50Us, stage.p99Us);
+            line += text;
+        }
+    }
+
+    void formatProfilePanel(const StageProfiler::Summary& analysisProfile) {
+        // Line 0: process usage; then two stages per line (UI, then analysis)
+        wchar_t text[64];
+        std::swprintf(text, 64, L"CPU %.2f%%  WS %.1f MB", m_usage.getCpuPercent(),
+                      static_cast<double>(m_usage.getWorkingSetBytes()) / (1024.0 * 1024.0));
+        m_profileLines[0] = text;
+
+        const StageProfiler::StageStats* stages[StageProfiler::MAX_STAGES * 2];
+        size_t stageCount = 0;
+        for (size_t i = 0; i < m_profile.stageCount; ++i) {
+            stages[stageCount++] = &m_profile.stages[i];
+        }
+        for (size_t i = 0; i < analysisProfile.stageCount; ++i) {
+            stages[stageCount++] = &analysisProfile.stages[i];
+        }
+
+        for (size_t line = 1; line < PROFILE_PANEL_LINES; ++line) {
+            size_t first = (line - 1) * 2;
+            text[0] = L'\0';
+            int length = 0;
+            for (size_t i = first; i < std::min(first + 2, stageCount) && length >= 0; ++i) {
+                length += std::swprintf(text + length, 64 - length, L"%-8hs%4.0f/%-5.0f",
+                                        stages[i]->name, stages[i]->p50Us, stages[i]->p99Us);
+            }
+            m_profileLines[line] = text;
+        }
+
+        const auto& displaySettings = m_settings->display;
+        float top = static_cast<float>(displaySettings.height);
+        m_damage.add(D2D1::RectF(0.0f, top, static_cast<float>(displaySettings.width), top + PROFILE_PANEL_HEIGHT));
+    }
+
+    void renderProfilePanel() {
+        const auto& displaySettings = m_settings->display;
+        float y = static_cast<float>(displaySettings.height) + 4.0f;
+        for (size_t line = 0; line < PROFILE_PANEL_LINES; ++line) {
+            if (!m_profileLines[line].empty()) {
+                m_textRenderer->renderText(m_profileLines[line], 10.0f, y,
+                                       brush(ThemeManager::ColorRole::TextSecondary), false);
+            }
+            y += PROFILE_LINE_HEIGHT;
+        }
+    }
+
+    void startCapture(const Config::ThreadingSettings& threadingSettings) {
+        // Start present capture; without it the overlay can only time its own loop
+        m_presentTracer = std::make_unique<PresentTracer>();
+        m_presentTracer->setPresentCallback([this](size_t slot, int64_t qpcTimestamp) {
+            // Tracer slots are session indices; only slots of the pool get a process
+            return m_sessions->get(slot).submitPresent(qpcTimestamp);
+        });
+        ThreadConfig captureThread;
+        captureThread.priority = parseThreadPriority(threadingSettings.capturePriority);
+        captureThread.affinityMask = threadingSettings.captureAffinity;
+        m_presentTracer->setThreadConfig(captureThread);
+        if (!m_presentTracer->start()) {
+            if (m_presentTracer->isInUseElsewhere()) {
+                LOG_WARNING("Another overlay instance is capturing presents, falling back to overlay timing");
+            } else {
+                LOG_WARNING("Present capture unavailable (requires administrator or Performance Log Users), "
+                            "falling back to overlay timing");
+            }
+        }
+
+        if (m_presentTracer->isRunning()) {
+            // Queried on the analysis thread; the tracer outlives it
+            PresentTracer* tracer = m_presentTracer.get();
+            for (size_t session = 0; session < m_sessions->getCapacity(); ++session) {
+                m_sessions->get(session).setCaptureSource(tracer->getDataEvent(session), [tracer, session]() {
+                    return tracer->isRunning() && tracer->getTargetProcess(session) != 0;
+                });
+            }
+        }
+        startRecording();
+    }
+
+    bool openReplay(const std::string& path) {
+        m_replay = std::make_unique<ReplaySource>();
+        if (!m_replay->open(path)) {
+            LOG_ERROR("Cannot replay " + path);
+            m_replay.reset();
+            return false;
+        }
+
+        double frequency = static_cast<double>(m_replay->getTickFrequency());
+        LOG_INFO("Replaying " + path + ": " + std::to_string(m_replay->getFrameCount()) + " frames, "
+                 + std::to_string(static_cast<double>(m_replay->getDuration()) / frequency) + " s, "
+                 + std::to_string(m_replay->getRecordedDropCount()) + " recorded drops");
+        if (m_replay->isTruncated()) {
+            LOG_WARNING("Recording ends with an incomplete record");
+        }
+        return true;
+    }
+
+    void reportReplayEnd(const AnalysisSnapshot& snapshot) {
+        if (!m_replay || !snapshot.replayFinished || m_replayReported) {
+            return;
+        }
+        m_replayReported = true;
+
+        const auto& stats = snapshot.stats;
+        LOG_INFO("Replay finished: avg " + std::to_string(stats.average) + " FPS, 1% low "
+                 + std::to_string(stats.percentile1) + ", 0.1% low " + std::to_string(stats.percentile01)
+                 + ", " + std::to_string(snapshot.dropCount) + " drops at "
+                 + std::to_string(m_settings->detection.dropThresholdPercent) + "% (recorded: "
+                 + std::to_string(m_replay->getRecordedDropCount()) + ")");
+
+        const auto& session = snapshot.sessionStats;
+        const auto& pacing = snapshot.stutterStats;
+        LOG_INFO("Replay pacing: " + std::to_string(pacing.stutters) + " stutters, hitches "
+                 + std::to_string(pacing.hitches[0]) + "/" + std::to_string(pacing.hitches[1]) + "/"
+                 + std::to_string(pacing.hitches[2]) + " (1/2/4+ refreshes late), frame-to-frame variance "
+                 + std::to_string(pacing.frameToFrameVariance) + " ms^2");
+        LOG_INFO("Replay session (aggregated): min " + std::to_string(session.min) + " FPS, 1% low ~"
+                 + std::to_string(session.percentile1) + ", 0.1% low ~" + std::to_string(session.percentile01));
+    }
+
+    static double clampViewSeconds(double viewSeconds) {
+        // 0 keeps the frame-time graph; the coarse tier holds an hour
+        double longest = HistoryTiers::COARSE_CAPACITY * HistoryTiers::getBucketSeconds(HistoryTiers::Tier::Coarse);
+        return std::clamp(viewSeconds, 0.0, longest);
+    }
+
+    void logDrop(const DropDetector::Drop& drop, size_t session) {
+        // Runs on the session's analysis thread; the sampler outlives every session
+        char load[128] = "";
+        SystemSampler::Sample sample;
+        LARGE_INTEGER now;
+        QueryPerformanceCounter(&now);
+        if (m_telemetry && m_telemetry->findSample(now.QuadPart, sample)) {
+            int length = snprintf(load, sizeof(load), " (%s: CPU %.0f%%, busiest core %.0f%%",
+                                  SystemSampler::getBoundName(SystemSampler::classify(sample)),
+                                  sample.cpuPercent, sample.busiestCorePercent);
+            if (sample.gpuPercent >= 0.0f) {
+                length += snprintf(load + length, sizeof(load) - length, ", GPU %.0f%%", sample.gpuPercent);
+            }
+            if (sample.cpuMHz >= 0.0f) {
+                length += snprintf(load + length, sizeof(load) - length, ", %.0f MHz", sample.cpuMHz);
+            }
+            snprintf(load + length, sizeof(load) - length, ")");
+        }
+
+        if (session == SessionPool::PRIMARY_SESSION) {
+            LOG_WARNINGF("FPS drop detected: %.1f%%%s", drop.magnitude * 100.0, load);
+        } else {
+            LOG_WARNINGF("FPS drop detected in session %zu: %.1f%%%s", session, drop.magnitude * 100.0, load);
+        }
+    }
+
+    void startRecording() {
+        const auto& recordingSettings = m_settings->recording;
+        if (!recordingSettings.enabled) {
+            return;
+        }
+
+        // One file per run, named after the local start time
+        CreateDirectoryA(recordingSettings.directory.c_str(), nullptr);
+        SYSTEMTIME now;
+        GetLocalTime(&now);
+        char fileName[64];
+        snprintf(fileName, sizeof(fileName), "fps_%04u%02u%02u_%02u%02u%02u.fpsr",
+                 now.wYear, now.wMonth, now.wDay, now.wHour, now.wMinute, now.wSecond);
+        std::string path = recordingSettings.directory + "\\" + fileName;
+
+        m_recorder = std::make_unique<SessionRecorder>();
+        if (!m_recorder->open(path, m_analysis->getTickFrequency())) {
+            LOG_WARNING("Failed to create recording " + path);
+            m_recorder.reset();
+            return;
+        }
+
+        m_analysis->setRecorder(m_recorder.get());
+        LOG_INFO("Recording to " + path);
+    }
+
+    void stopRecording() {
+        if (!m_recorder) {
+            return;
+        }
+
+        m_recorder->close();
+        if (m_recorder->hasFailed()) {
+            LOG_ERROR("Recording incomplete: write failed");
+        }
+        LOG_INFO("Recorded " + std::to_string(m_recorder->getFrameCount()) + " frames, "
+                 + std::to_string(m_recorder->getBytesWritten()) + " bytes");
+        m_recorder.reset();
+    }
+
+    void openExporters() {
+        for (size_t session = 0; session < m_sessions->getCapacity(); ++session) {
+            auto exporter = std::make_unique<SharedMemoryExporter>();
+            if (!exporter->open(session)) {
+                LOG_WARNING("Cannot create shared memory " + exporter->getName()
+                            + " (another monitor running, or a section of another layout)");
+                continue;
+            }
+
+            m_sessions->get(session).setExporter(exporter.get());
+            LOG_INFO("Publishing session " + std::to_string(session) + " to " + exporter->getName());
+            m_exporters[session] = std::move(exporter);
+        }
+    }
+
+    void startNetworkExport() {
+        const auto& exportSettings = m_settings->exports;
+        if (exportSettings.host.empty() || exportSettings.port < 1 || exportSettings.port > 65535) {
+            LOG_WARNING("Network export needs a host and a port (1 - 65535), disabled");
+            return;
+        }
+        if (exportSettings.network != "udp" && exportSettings.network != "tcp") {
+            LOG_WARNING("Unknown network export protocol " + exportSettings.network + ", disabled");
+            return;
+        }
+
+        NetworkExporter::Protocol protocol = (exportSettings.network == "tcp")
+            ? NetworkExporter::Protocol::Tcp
+            : NetworkExporter::Protocol::Udp;
+        m_network = std::make_unique<NetworkExporter>();
+        if (!m_network->start(exportSettings.host, exportSettings.port, protocol, exportSettings.flushMs,
+                              m_analysis->getTickFrequency())) {
+            LOG_WARNING("Winsock unavailable, network export disabled");
+            m_network.reset();
+            return;
+        }
+
+        for (size_t session = 0; session < m_sessions->getCapacity(); ++session) {
+            m_sessions->get(session).setNetworkExporter(m_network.get(), session);
+        }
+        LOG_INFO("Streaming to " + exportSettings.host + ":" + std::to_string(exportSettings.port)
+                 + " over " + exportSettings.network);
+    }
+
+    void stopNetworkExport() {
+        if (!m_network) {
+            return;
+        }
+
+        m_network->stop();
+        LOG_INFO("Network export: " + std::to_string(m_network->getSentPackets()) + " packets sent, "
+                 + std::to_string(m_network->getDroppedRecords()) + " records dropped");
+        m_network.reset();
+    }
+
+    bool createOverlay(D2DRenderer::Backend backend) {
+        const auto& displaySettings = m_settings->display;
+
+        m_d2dRenderer.reset();
+        m_windowManager = std::make_unique<WindowManager>();
+
+        // Calculate position based on config (primary monitor)
+        RECT screen = { 0, 0, GetSystemMetrics(SM_CXSCREEN), GetSystemMetrics(SM_CYSCREEN) };
+        int x = 0, y = 0;
+        calculateWindowPosition(screen, displaySettings.width, getOverlayHeight(), SessionPool::PRIMARY_SESSION, x, y);
+
+        bool noRedirection = (backend == D2DRenderer::Backend::SwapChain);
+        if (!m_windowManager->create(displaySettings.width, getOverlayHeight(), x, y, noRedirection)) {
+            LOG_ERROR("Failed to create overlay window");
+            return false;
+        }
+
+        // Mode switches (e.g. a game going exclusive fullscreen) resize monitors
+        m_windowManager->setMessageCallback([this](HWND, UINT msg, WPARAM, LPARAM) -> LRESULT {
+            if (msg == WM_DISPLAYCHANGE && m_gameDetector) {
+                m_gameDetector->invalidateMonitors();
+            }
+            return 1;   // Not consumed: default handling continues
+        });
+
+        m_d2dRenderer = std::make_unique<D2DRenderer>();
+        return m_d2dRenderer->initialize(&m_renderDevice, m_windowManager->getHandle(), backend);
+    }
+
+    void waitForWork(bool visible, bool freshSnapshot) {
+        bool tracing = m_presentTracer && m_presentTracer->isRunning();
+
+        // Rendering is paced by the frame timer while results keep coming;
+        // once a snapshot brings nothing new, sleep until the next one is
+        // published (a game that stopped presenting publishes none)
+        m_scheduler.setHandleEnabled(m_snapshotHandle, visible && !freshSnapshot);
+
+        // Extra overlays wake the thread the same way for their own session
+        bool anyFresh = freshSnapshot;
+        for (size_t session = SessionPool::PRIMARY_SESSION + 1; session < m_sessions->getCapacity(); ++session) {
+            bool active = visible && m_sessionOverlays[session];
+            anyFresh = anyFresh || (active && m_sessionFresh[session]);
+            m_scheduler.setHandleEnabled(m_sessionHandles[session], active && !m_sessionFresh[session]);
+        }
+        m_scheduler.setFrameEnabled(visible && anyFresh);
+
+        // Hidden: only messages (the hotkey) wake the thread, plus a slow tick
+        // while tracing to re-detect the game
+        DWORD timeout = INFINITE;
+        if (tracing) {
+            timeout = static_cast<DWORD>(GAME_DETECT_INTERVAL * 1000.0);
+        }
+
+        m_scheduler.wait(timeout);
+    }
+
+    void calculateWindowPosition(const RECT& area, int width, int height, size_t slot, int& x, int& y) {
+        const auto& displaySettings = m_settings->display;
+
+        // Overlays of one corner stack away from the edge by session index,
+        // so extra games on the primary monitor do not cover the main overlay
         const int margin = 20;
+        const int stack = static_cast<int>(slot) * (height + margin);
 
         switch (displaySettings.position) {
             case Config::Position::TopLeft:
-                x = margin;
-                y = margin;
+                x = area.left + margin;
+                y = area.top + margin + stack;
                 break;
             case Config::Position::TopRight:
-                x = screenWidth - displaySettings.width - margin;
-                y = margin;
+                x = area.right - width - margin;
+                y = area.top + margin + stack;
                 break;
             case Config::Position::BottomLeft:
-                x = margin;
-                y = screenHeight - displaySettings.height - margin;
+                x = area.left + margin;
+                y = area.bottom - height - margin - stack;
                 break;
             case Config::Position::BottomRight:
-                x = screenWidth - displaySettings.width - margin;
-                y = screenHeight - displaySettings.height - margin;
+                x = area.right - width - margin;
+                y = area.bottom - height - margin - stack;
                 break;
             case Config::Position::Custom:
-                x = displaySettings.customX;
-                y = displaySettings.customY;
+                x = area.left + displaySettings.customX;
+                y = area.top + displaySettings.customY + stack;
                 break;
             default:
-                x = screenWidth - displaySettings.width - margin;
-                y = margin;
+                x = area.right - width - margin;
+                y = area.top + margin + stack;
                 break;
         }
     }
 
-    void createBrushes() {
-        auto bg = m_themeManager->getColor("background");
-        auto line = m_themeManager->getColor("graph_line");
-        auto textPrimary = m_themeManager->getColor("text_primary");
-        auto textSecondary = m_themeManager->getColor("text_secondary");
+    void registerBrushes() {
+        // Keyed by theme colour name, so the renderers' own defaults (grid,
+        // shadow) take the theme colour too; registering again recolours in place
+        ResourceCache& resources = m_d2dRenderer->getResources();
+        const ThemeManager::Palette& palette = m_themeManager->getPalette();
+        for (size_t i = 0; i < ThemeManager::COLOR_COUNT; ++i) {
+            auto role = static_cast<ThemeManager::ColorRole>(i);
+            const ThemeManager::Color& color = palette[role];
+            m_brushes[i] = resources.addBrush(ThemeManager::getColorName(role),
+                                              D2D1::ColorF(color.r, color.g, color.b, color.a));
+
+            // Create now rather than in the first frame
+            resources.getBrush(m_brushes[i]);
+        }
 
-        m_bgBrush = m_d2dRenderer->createSolidBrush(bg.r, bg.g, bg.b, bg.a);
-        m_lineBrush = m_d2dRenderer->createSolidBrush(line.r, line.g, line.b, line.a);
-        m_textBrush = m_d2dRenderer->createSolidBrush(textPrimary.r, textPrimary.g, textPrimary.b, textPrimary.a);
-        m_textSecondaryBrush = m_d2dRenderer->createSolidBrush(textSecondary.r, textSecondary.g, textSecondary.b, textSecondary.a);
+        m_graphRenderer->setDropMarkerBrush(brush(ThemeManager::ColorRole::DropMarker));
     }
 
-    void releaseBrushes() {
-        if (m_bgBrush) m_bgBrush->Release();
-        if (m_lineBrush) m_lineBrush->Release();
-        if (m_textBrush) m_textBrush->Release();
-        if (m_textSecondaryBrush) m_textSecondaryBrush->Release();
+    ResourceCache::BrushHandle brush(ThemeManager::ColorRole role) const {
+        return m_brushes[static_cast<size_t>(role)];
     }
 
-    void render() {
+    void reloadThemeIfChanged() {
+        if (!m_themeWatcher.poll(m_themeFile)) {
+            return;
+        }
+
+        // A file still being written fails to parse and keeps the old palette
+        if (!m_themeManager->reloadTheme()) {
+            LOG_WARNING("Theme file changed but could not be parsed, keeping current theme");
+            return;
+        }
+
+        // Fonts are fixed at startup; colours apply from the next frame
+        registerBrushes();
+        for (auto& overlay : m_sessionOverlays) {
+            if (overlay) {
+                overlay->registerBrushes();
+            }
+        }
+        m_damage.invalidateAll();
+        LOG_INFO("Theme reloaded: " + m_themeManager->getCurrentTheme());
+    }
+
+    void applyConfigChanges() {
+        // One atomic load per iteration; a snapshot is only taken after a reload
+        if (m_config->getVersion() == m_settingsVersion) {
+            return;
+        }
+        std::shared_ptr<const Config::Settings> settings = m_config->getSnapshot();
+        m_settingsVersion = settings->version;
+
+        // Layout, theme, backend, threads and capture keep the startup
+        // snapshot (m_settings); these apply from the next frame
+        const auto& graphSettings = settings->graph;
+        m_graphRenderer->setShowGrid(graphSettings.showGrid);
+        m_graphRenderer->setShowFill(graphSettings.showFill);
+        m_graphRenderer->setLineWidth(static_cast<float>(graphSettings.lineWidth));
+        m_viewSeconds = clampViewSeconds(graphSettings.viewSeconds);
+        for (auto& overlay : m_sessionOverlays) {
+            if (overlay) {
+                overlay->setGraphStyle(graphSettings.showGrid, graphSettings.showFill,
+                                       static_cast<float>(graphSettings.lineWidth));
+            }
+        }
+
+        const auto& perfSettings = settings->performance;
+        AnalysisThread::LiveSettings live;
+        live.statsUpdateMs = perfSettings.statsUpdateMs;
+        live.dropThresholdPercent = settings->detection.dropThresholdPercent;
+        live.stutterFactor = settings->detection.stutterFactor;
+        live.tickIntervalMs = perfSettings.updateRateMs;
+        m_sessions->updateSettings(live);
+        m_scheduler.setPeriod(perfSettings.updateRateMs);
+        m_profileLogSeconds = perfSettings.profileLogSeconds;
+
+        m_damage.invalidateAll();
+        LOG_INFO("Configuration reloaded (version " + std::to_string(m_settingsVersion) + ")");
+    }
+
+    void render(const AnalysisSnapshot& snapshot) {
         if (!m_d2dRenderer || !m_d2dRenderer->isInitialized()) {
             return;
         }
 
-        const auto& displaySettings = m_config->getDisplaySettings();
+        const auto& displaySettings = m_settings->display;
+        const float graphWidth = static_cast<float>(displaySettings.width) - 20.0f;
+        const float statsY = 140.0f;
+
+        double currentFPS = snapshot.currentFPS;
+        const auto& stats = snapshot.stats;
+
+        // Collect what changed since the last frame; skip the frame if nothing did
+        {
+            ScopedAllocationCheck noAllocs(isSteadyState());
+            StageProfiler::Scope damage(m_profiler, m_damageStage);
+            if (m_viewSeconds > 0.0) {
+                HistoryTiers::Tier tier = HistoryTiers::selectTier(m_viewSeconds, static_cast<size_t>(graphWidth));
+                m_graphRenderer->trackHistoryDamage(snapshot.getBucketView(tier),
+                                                    snapshot.totalBuckets[static_cast<size_t>(tier)],
+                                                    HistoryTiers::getBucketSeconds(tier), m_viewSeconds,
+                                                    snapshot.tickFrequency,
+                                                    10.0f, 50.0f, graphWidth, 80.0f, m_damage);
+            } else {
+                m_graphRenderer->trackDamage(snapshot.totalSamples, snapshot.minFPS, snapshot.maxFPS,
+                                             10.0f, 50.0f, graphWidth, 80.0f, m_damage);
+            }
+            m_textRenderer->trackFPS(currentFPS, 10.0f, 5.0f, m_damage);
+            m_textRenderer->trackStat(0, stats.average, 10.0f, statsY, m_damage);
+            m_textRenderer->trackStat(1, stats.min, 80.0f, statsY, m_damage);
+            m_textRenderer->trackStat(2, stats.max, 150.0f, statsY, m_damage);
+        }
 
-        m_d2dRenderer->beginDraw();
+        if (!m_d2dRenderer->beginDraw(m_damage)) {
+            return;
+        }
 
         // Clear background
-        auto bg = m_themeManager->getColor("background");
+        const auto& bg = m_themeManager->getColor(ThemeManager::ColorRole::Background);
         m_d2dRenderer->clear(bg.r, bg.g, bg.b, bg.a);
 
         // Render graph
-        auto samples = m_fpsCalculator->getSamples();
-        if (!samples.empty()) {
-            m_graphRenderer->setColors(m_lineBrush, nullptr);
-            m_graphRenderer->render(samples, 10.0f, 50.0f, 
-                                   static_cast<float>(displaySettings.width) - 20.0f, 80.0f);
+        {
+            ScopedAllocationCheck noAllocs(isSteadyState());
+            StageProfiler::Scope graph(m_profiler, m_graphStage);
+            SampleView<uint32_t> samples = snapshot.getSampleView();
+            m_graphRenderer->setColors(brush(ThemeManager::ColorRole::GraphLine),
+                                       brush(ThemeManager::ColorRole::GraphFill));
+            if (m_viewSeconds > 0.0) {
+                HistoryTiers::Tier tier = HistoryTiers::selectTier(m_viewSeconds, static_cast<size_t>(graphWidth));
+                m_graphRenderer->renderHistory(snapshot.getBucketView(tier), HistoryTiers::getBucketSeconds(tier),
+                                               m_viewSeconds, snapshot.tickFrequency,
+                                               10.0f, 50.0f, graphWidth, 80.0f);
+            } else if (!samples.empty()) {
+                m_graphRenderer->render(samples, snapshot.totalSamples, snapshot.tickFrequency,
+                                       snapshot.minFPS, snapshot.maxFPS,
+                                       10.0f, 50.0f, graphWidth, 80.0f);
+                if (m_settings->detection.showDropMarkers) {
+                    m_graphRenderer->renderMarkers(snapshot.getStutterView(), snapshot.totalSamples,
+                                                   samples.size(), 10.0f, 50.0f, graphWidth, 80.0f);
+                }
+            }
         }
 
-        // Render FPS text
-        double currentFPS = m_fpsCalculator->getCurrentFPS();
-        m_textRenderer->renderFPS(currentFPS, 10.0f, 5.0f, m_textBrush);
+        {
+            StageProfiler::Scope text(m_profiler, m_textStage);
+
+            // Render FPS text
+            m_textRenderer->renderFPS(currentFPS, 10.0f, 5.0f, brush(ThemeManager::ColorRole::TextPrimary));
 
-        // Render stats
-        const auto& stats = m_statsTracker->getStats();
-        float statsY = 140.0f;
-        m_textRenderer->renderStat(L"AVG:", stats.average, 10.0f, statsY, m_textSecondaryBrush);
-        m_textRenderer->renderStat(L"MIN:", stats.min, 80.0f, statsY, m_textSecondaryBrush);
-        m_textRenderer->renderStat(L"MAX:", stats.max, 150.0f, statsY, m_textSecondaryBrush);
+            // Render stats
+            ResourceCache::BrushHandle statsBrush = brush(ThemeManager::ColorRole::TextSecondary);
+            m_textRenderer->renderStat(L"AVG:", stats.average, 10.0f, statsY, statsBrush);
+            m_textRenderer->renderStat(L"MIN:", stats.min, 80.0f, statsY, statsBrush);
+            m_textRenderer->renderStat(L"MAX:", stats.max, 150.0f, statsY, statsBrush);
+
+            if (m_settings->performance.showProfiler) {
+                renderProfilePanel();
+            }
+        }
 
         // End drawing
-        if (!m_d2dRenderer->endDraw()) {
-            LOG_ERROR("Direct2D device lost, attempting recovery...");
-            // Device lost - would need to recreate resources
+        bool presented = false;
+        {
+            StageProfiler::Scope endDraw(m_profiler, m_endDrawStage);
+            presented = m_d2dRenderer->endDraw();
+        }
+        if (!presented) {
+            // The renderer rebuilt its target; brushes follow on first use
+            LOG_ERROR("Direct2D device lost, render target recreated");
+            m_damage.invalidateAll();
+        } else {
+            m_damage.clear();
         }
     }
 
     // Core components
     std::unique_ptr<Config> m_config;
-    std::unique_ptr<FpsCalculator> m_fpsCalculator;
-    std::unique_ptr<DropDetector> m_dropDetector;
-    std::unique_ptr<StatsTracker> m_statsTracker;
+    std::shared_ptr<const Config::Settings> m_settings;     // Snapshot the overlay was created with
+    uint64_t m_settingsVersion = 0;                         // Config version last applied
+    ConfigWatcher m_configWatcher;
+    std::unique_ptr<SessionPool> m_sessions;
+    AnalysisThread* m_analysis = nullptr;                   // Primary session (owned by m_sessions)
     std::unique_ptr<Timer> m_timer;
 
-    // Overlay components
+    // Overlay components (every window renders through m_renderDevice)
+    RenderDevice m_renderDevice;
+    D2DRenderer::Backend m_backend = D2DRenderer::Backend::Hwnd;
     std::unique_ptr<WindowManager> m_windowManager;
     std::unique_ptr<D2DRenderer> m_d2dRenderer;
     std::unique_ptr<GraphRenderer> m_graphRenderer;
+    double m_viewSeconds = 0.0;             // Live: Graph.view_seconds (0: frame-time graph)
     std::unique_ptr<TextRenderer> m_textRenderer;
     std::unique_ptr<ThemeManager> m_themeManager;
+    DamageTracker m_damage;
+    std::unique_ptr<SessionOverlay> m_sessionOverlays[SessionPool::MAX_SESSIONS];  // Extra games (index = session)
 
     // Detection components
     std::unique_ptr<GameDetector> m_gameDetector;
     std::unique_ptr<WindowTracker> m_windowTracker;
 
-    // Brushes
-    ID2D1SolidColorBrush* m_bgBrush = nullptr;
-    ID2D1SolidColorBrush* m_lineBrush = nullptr;
-    ID2D1SolidColorBrush* m_textBrush = nullptr;
-    ID2D1SolidColorBrush* m_textSecondaryBrush = nullptr;
+    // Main loop scheduling
+    FrameScheduler m_scheduler;
+    size_t m_snapshotHandle = FrameScheduler::INVALID_HANDLE_ID;
+    size_t m_sessionHandles[SessionPool::MAX_SESSIONS];         // Snapshot events of the extra sessions
+    bool m_sessionFresh[SessionPool::MAX_SESSIONS] = {};        // Snapshot taken this iteration
+
+    // Capture components
+    static constexpr double GAME_DETECT_INTERVAL = 1.0;
+    std::unique_ptr<PresentTracer> m_presentTracer;
+
+    // System telemetry (optional; shared by every session's drop callback)
+    std::unique_ptr<SystemSampler> m_telemetry;
+
+    // Shared-memory export (index = session; outlives the sessions)
+    std::unique_ptr<SharedMemoryExporter> m_exporters[SessionPool::MAX_SESSIONS];
+    std::unique_ptr<NetworkExporter> m_network;             // Shared by every session
+
+    // Recording components
+    std::unique_ptr<SessionRecorder> m_recorder;
+    std::unique_ptr<ReplaySource> m_replay;
+    bool m_replayReported = false;
+    double m_detectAccumulator = GAME_DETECT_INTERVAL; // Detect on the first tick
+
+    // Theme brush handles by ColorRole (owned by the renderer's resource cache)
+    ResourceCache::BrushHandle m_brushes[ThemeManager::COLOR_COUNT] = {};  // Set by registerBrushes()
+
+    // Theme hot reload
+    DirectoryWatcher m_themeWatcher;
+    std::string m_themeFile;
+
+    // Self-profiling
+    static constexpr double PROFILE_INTERVAL = 1.0;         ///< Seconds between summaries
+    static constexpr size_t PROFILE_PANEL_LINES = 7;        ///< Usage line + 2 stages per line
+    static constexpr float PROFILE_LINE_HEIGHT = 16.0f;
+    static constexpr float PROFILE_PANEL_HEIGHT = PROFILE_PANEL_LINES * PROFILE_LINE_HEIGHT + 8.0f;
+    StageProfiler m_profiler;
+    StageProfiler::Summary m_profile = {};
+    ProcessUsage m_usage;
+    std::wstring m_profileLines[PROFILE_PANEL_LINES];
+    double m_profileElapsed = 0.0;
+    double m_profileLogElapsed = 0.0;
+    int m_profileLogSeconds = 0;            // Live: Performance.profile_log_seconds
+    size_t m_messagesStage = StageProfiler::MAX_STAGES;
+    size_t m_snapshotStage = StageProfiler::MAX_STAGES;
+    size_t m_damageStage = StageProfiler::MAX_STAGES;
+    size_t m_graphStage = StageProfiler::MAX_STAGES;
+    size_t m_textStage = StageProfiler::MAX_STAGES;
+    size_t m_endDrawStage = StageProfiler::MAX_STAGES;
+    size_t m_frameStage = StageProfiler::MAX_STAGES;
 
     // State
+    static constexpr uint64_t WARMUP_FRAMES = 120;
+    uint64_t m_frameCount = 0;
     bool m_running;
     bool m_visible;
 };
@@ -342,17 +1242,25 @@ int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance,
     // Suppress unused parameter warnings
     (void)hInstance;
     (void)hPrevInstance;
-    (void)lpCmdLine;
     (void)nShowCmd;
 
     // Initialize logger
     Logger::getInstance().initialize("fps_monitor.log");
     LOG_INFO("=== FPS Monitor Overlay v1.0.0 ===");
 
+    LaunchOptions options;
+    if (!parseLaunchOptions(lpCmdLine, options)) {
+        MessageBoxA(nullptr,
+                    "Usage: fps-monitor-overlay [--replay <file.fpsr>] [--replay-speed=<x>] [--replay-start=<seconds>]",
+                    "FPS Monitor Overlay", MB_OK | MB_ICONINFORMATION);
+        Logger::getInstance().shutdown();
+        return 1;
+    }
+
     // Create and run application
     FPSMonitorApp app;
 
-    if (!app.initialize()) {
+    if (!app.initialize(options)) {
         MessageBoxA(nullptr, "Failed to initialize application", "Error", MB_OK | MB_ICONERROR);
         Logger::getInstance().shutdown();
         return 1;
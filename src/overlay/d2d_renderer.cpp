@@ -2,11 +2,36 @@
 
 namespace fps_monitor {
 
+namespace {
+
+/// Swap chain flags (must match between creation and ResizeBuffers)
+constexpr UINT SWAP_CHAIN_FLAGS = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
+/// The process is not DPI aware, so DIPs are pixels (as with the HWND target)
+constexpr float TARGET_DPI = 96.0f;
+
+/// Longest wait for the swap chain to accept a frame
+constexpr DWORD FRAME_WAIT_TIMEOUT_MS = 100;
+
+} // namespace
+
 D2DRenderer::D2DRenderer()
-    : m_factory(nullptr)
+    : m_device(nullptr)
+    , m_deviceGeneration(0)
     , m_renderTarget(nullptr)
+    , m_hwndTarget(nullptr)
+    , m_deviceContext(nullptr)
+    , m_swapChain(nullptr)
+    , m_targetBitmap(nullptr)
+    , m_dcompTarget(nullptr)
+    , m_dcompVisual(nullptr)
+    , m_frameLatencyWaitable(nullptr)
+    , m_dirtyCount(0)
+    , m_backend(Backend::Hwnd)
     , m_hwnd(nullptr)
     , m_initialized(false)
+    , m_contentLost(true)
+    , m_clipped(false)
 {
 }
 
@@ -14,23 +39,18 @@ D2DRenderer::~D2DRenderer() {
     shutdown();
 }
 
-bool D2DRenderer::initialize(HWND hwnd) {
+bool D2DRenderer::initialize(RenderDevice* device, HWND hwnd, Backend backend) {
     if (m_initialized) {
         return true;
     }
-
-    m_hwnd = hwnd;
-
-    // Create D2D factory
-    HRESULT hr = D2D1CreateFactory(
-        D2D1_FACTORY_TYPE_SINGLE_THREADED,
-        &m_factory
-    );
-
-    if (FAILED(hr)) {
+    if (!device || !device->getFactory()) {
         return false;
     }
 
+    m_device = device;
+    m_hwnd = hwnd;
+    m_backend = backend;
+
     // Create render target
     if (!createRenderTarget(hwnd)) {
         shutdown();
@@ -43,19 +63,53 @@ bool D2DRenderer::initialize(HWND hwnd) {
 
 void D2DRenderer::shutdown() {
     releaseRenderTarget();
+    m_device = nullptr;
+    m_initialized = false;
+}
 
-    if (m_factory) {
-        m_factory->Release();
-        m_factory = nullptr;
+bool D2DRenderer::beginDraw(const DamageTracker& damage) {
+    // Another window lost the shared device: this target lives on the old one
+    if (m_swapChain && m_deviceGeneration != m_device->getGeneration()) {
+        releaseRenderTarget();
     }
 
-    m_initialized = false;
-}
+    // Rebuild a target lost in an earlier frame (e.g. while the GPU was switching)
+    if (!m_renderTarget && !(m_initialized && recreateRenderTarget())) {
+        return false;
+    }
 
-void D2DRenderer::beginDraw() {
-    if (m_renderTarget) {
-        m_renderTarget->BeginDraw();
+    bool full = m_contentLost || damage.isFull();
+    if (!full && damage.isEmpty()) {
+        return false;
+    }
+
+    // Swap chain: block until it can queue another frame (released once per
+    // presented frame, i.e. each vblank)
+    if (m_frameLatencyWaitable) {
+        WaitForSingleObjectEx(m_frameLatencyWaitable, FRAME_WAIT_TIMEOUT_MS, TRUE);
     }
+
+    m_renderTarget->BeginDraw();
+
+    // Only the damaged area is cleared and redrawn; the target retains the rest
+    m_clipped = !full;
+    m_dirtyCount = 0;
+    if (m_clipped) {
+        m_renderTarget->PushAxisAlignedClip(damage.bounds(), D2D1_ANTIALIAS_MODE_ALIASED);
+
+        // Damage rectangles are pixel-aligned already
+        for (size_t i = 0; i < damage.count(); ++i) {
+            const D2D1_RECT_F& rect = damage.rects()[i];
+            m_dirtyRects[i] = {
+                static_cast<LONG>(rect.left), static_cast<LONG>(rect.top),
+                static_cast<LONG>(rect.right), static_cast<LONG>(rect.bottom)
+            };
+        }
+        m_dirtyCount = static_cast<UINT>(damage.count());
+    }
+
+    m_contentLost = false;
+    return true;
 }
 
 bool D2DRenderer::endDraw() {
@@ -63,12 +117,29 @@ bool D2DRenderer::endDraw() {
         return false;
     }
 
+    if (m_clipped) {
+        m_renderTarget->PopAxisAlignedClip();
+        m_clipped = false;
+    }
+
     HRESULT hr = m_renderTarget->EndDraw();
 
-    // Check for device lost
-    if (hr == D2DERR_RECREATE_TARGET) {
-        releaseRenderTarget();
-        return createRenderTarget(m_hwnd);
+    // Flip-model present on the next vblank; DXGI carries the undamaged area over
+    if (SUCCEEDED(hr) && m_backend == Backend::SwapChain) {
+        DXGI_PRESENT_PARAMETERS params = {};
+        params.DirtyRectsCount = m_dirtyCount;
+        params.pDirtyRects = m_dirtyCount > 0 ? m_dirtyRects : nullptr;
+        hr = m_swapChain->Present1(1, 0, &params);
+    }
+
+    // Check for device lost; brushes follow through the resource cache. The
+    // first window to notice replaces the shared devices
+    if (isDeviceLost(hr)) {
+        if (m_backend == Backend::SwapChain && m_deviceGeneration == m_device->getGeneration()) {
+            m_device->handleDeviceLost();
+        }
+        recreateRenderTarget();
+        return false;
     }
 
     return SUCCEEDED(hr);
@@ -80,46 +151,62 @@ void D2DRenderer::clear(float r, float g, float b, float a) {
     }
 }
 
-ID2D1SolidColorBrush* D2DRenderer::createSolidBrush(float r, float g, float b, float a) {
-    if (!m_renderTarget) {
-        return nullptr;
-    }
+ResourceCache& D2DRenderer::getResources() {
+    return m_resources;
+}
 
-    ID2D1SolidColorBrush* brush = nullptr;
-    m_renderTarget->CreateSolidColorBrush(
-        D2D1::ColorF(r, g, b, a),
-        &brush
-    );
+ID2D1RenderTarget* D2DRenderer::getRenderTarget() const {
+    return m_renderTarget;
+}
 
-    return brush;
+D2DRenderer::Backend D2DRenderer::getBackend() const {
+    return m_backend;
 }
 
-ID2D1HwndRenderTarget* D2DRenderer::getRenderTarget() const {
-    return m_renderTarget;
+HANDLE D2DRenderer::getFrameLatencyWaitable() const {
+    return m_frameLatencyWaitable;
 }
 
 ID2D1Factory* D2DRenderer::getFactory() const {
-    return m_factory;
+    return m_device ? m_device->getFactory() : nullptr;
 }
 
 bool D2DRenderer::resize(UINT width, UINT height) {
-    if (m_renderTarget) {
+    if (m_swapChain) {
+        // The back buffer must be unbound before the swap chain can resize
+        m_deviceContext->SetTarget(nullptr);
+        if (m_targetBitmap) {
+            m_targetBitmap->Release();
+            m_targetBitmap = nullptr;
+        }
+
+        HRESULT hr = m_swapChain->ResizeBuffers(0, width, height, DXGI_FORMAT_UNKNOWN, SWAP_CHAIN_FLAGS);
+        m_contentLost = true;
+        return SUCCEEDED(hr) && createSwapChainTarget();
+    }
+
+    if (m_hwndTarget) {
         D2D1_SIZE_U size = D2D1::SizeU(width, height);
-        HRESULT hr = m_renderTarget->Resize(size);
+        HRESULT hr = m_hwndTarget->Resize(size);
+        m_contentLost = true;
         return SUCCEEDED(hr);
     }
     return false;
 }
 
 bool D2DRenderer::isInitialized() const {
-    return m_initialized && m_renderTarget != nullptr;
+    return m_initialized;
 }
 
 bool D2DRenderer::createRenderTarget(HWND hwnd) {
-    if (!m_factory || !hwnd) {
+    if (!m_device || !m_device->getFactory() || !hwnd) {
         return false;
     }
 
+    if (m_backend == Backend::SwapChain) {
+        return createSwapChain(hwnd);
+    }
+
     RECT rc;
     GetClientRect(hwnd, &rc);
 
@@ -136,27 +223,184 @@ bool D2DRenderer::createRenderTarget(HWND hwnd) {
         D2D1_FEATURE_LEVEL_DEFAULT
     );
 
-    HRESULT hr = m_factory->CreateHwndRenderTarget(
+    // Keep the frame across presents so damaged frames only redraw what changed
+    HRESULT hr = m_device->getFactory()->CreateHwndRenderTarget(
         props,
-        D2D1::HwndRenderTargetProperties(hwnd, size),
-        &m_renderTarget
+        D2D1::HwndRenderTargetProperties(hwnd, size, D2D1_PRESENT_OPTIONS_RETAIN_CONTENTS),
+        &m_hwndTarget
     );
 
     if (FAILED(hr)) {
         return false;
     }
 
+    m_renderTarget = m_hwndTarget;
+    m_contentLost = true;
+    m_resources.attach(m_renderTarget);
+
     // Enable anti-aliasing
     m_renderTarget->SetAntialiasMode(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
 
     return true;
 }
 
+bool D2DRenderer::createSwapChain(HWND hwnd) {
+    RECT rc;
+    GetClientRect(hwnd, &rc);
+
+    UINT width = static_cast<UINT>(rc.right - rc.left);
+    UINT height = static_cast<UINT>(rc.bottom - rc.top);
+    if (width == 0 || height == 0) {
+        return false;
+    }
+
+    // Shared with the other windows; created by the first one
+    if (!m_device->ensureDevices()) {
+        return false;
+    }
+    m_deviceGeneration = m_device->getGeneration();
+    IDCompositionDevice* dcompDevice = m_device->getCompositionDevice();
+
+    // Composition swap chains must be flip model; premultiplied alpha keeps the overlay translucent
+    IDXGIFactory2* dxgiFactory = nullptr;
+    HRESULT hr = CreateDXGIFactory2(0, __uuidof(IDXGIFactory2), reinterpret_cast<void**>(&dxgiFactory));
+
+    if (SUCCEEDED(hr)) {
+        DXGI_SWAP_CHAIN_DESC1 desc = {};
+        desc.Width = width;
+        desc.Height = height;
+        desc.Format = DXGI_FORMAT_B8G8R8A8_UNORM;
+        desc.SampleDesc.Count = 1;
+        desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+        desc.BufferCount = 2;
+        desc.Scaling = DXGI_SCALING_STRETCH;
+        desc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_SEQUENTIAL;
+        desc.AlphaMode = DXGI_ALPHA_MODE_PREMULTIPLIED;
+        desc.Flags = SWAP_CHAIN_FLAGS;
+
+        hr = dxgiFactory->CreateSwapChainForComposition(m_device->getD3DDevice(), &desc, nullptr, &m_swapChain);
+        dxgiFactory->Release();
+    }
+
+    // One queued frame, so the waitable signals once per vblank
+    if (SUCCEEDED(hr)) {
+        IDXGISwapChain2* swapChain2 = nullptr;
+        hr = m_swapChain->QueryInterface(__uuidof(IDXGISwapChain2), reinterpret_cast<void**>(&swapChain2));
+        if (SUCCEEDED(hr)) {
+            swapChain2->SetMaximumFrameLatency(1);
+            m_frameLatencyWaitable = swapChain2->GetFrameLatencyWaitableObject();
+            swapChain2->Release();
+        }
+    }
+
+    if (SUCCEEDED(hr)) {
+        hr = m_device->getD2DDevice()->CreateDeviceContext(D2D1_DEVICE_CONTEXT_OPTIONS_NONE, &m_deviceContext);
+    }
+
+    // Composition tree: window target -> visual -> swap chain
+    if (SUCCEEDED(hr)) {
+        hr = dcompDevice->CreateTargetForHwnd(hwnd, TRUE, &m_dcompTarget);
+    }
+    if (SUCCEEDED(hr)) {
+        hr = dcompDevice->CreateVisual(&m_dcompVisual);
+    }
+    if (SUCCEEDED(hr)) {
+        hr = m_dcompVisual->SetContent(m_swapChain);
+    }
+    if (SUCCEEDED(hr)) {
+        hr = m_dcompTarget->SetRoot(m_dcompVisual);
+    }
+    if (SUCCEEDED(hr)) {
+        hr = dcompDevice->Commit();
+    }
+
+    if (FAILED(hr) || !createSwapChainTarget()) {
+        return false;
+    }
+
+    m_renderTarget = m_deviceContext;
+    m_contentLost = true;
+    m_resources.attach(m_renderTarget);
+    return true;
+}
+
+bool D2DRenderer::createSwapChainTarget() {
+    IDXGISurface* surface = nullptr;
+    HRESULT hr = m_swapChain->GetBuffer(0, __uuidof(IDXGISurface), reinterpret_cast<void**>(&surface));
+    if (FAILED(hr)) {
+        return false;
+    }
+
+    D2D1_BITMAP_PROPERTIES1 props = D2D1::BitmapProperties1(
+        D2D1_BITMAP_OPTIONS_TARGET | D2D1_BITMAP_OPTIONS_CANNOT_DRAW,
+        D2D1::PixelFormat(DXGI_FORMAT_B8G8R8A8_UNORM, D2D1_ALPHA_MODE_PREMULTIPLIED),
+        TARGET_DPI, TARGET_DPI
+    );
+
+    hr = m_deviceContext->CreateBitmapFromDxgiSurface(surface, &props, &m_targetBitmap);
+    surface->Release();
+
+    if (FAILED(hr)) {
+        return false;
+    }
+
+    m_deviceContext->SetTarget(m_targetBitmap);
+    m_deviceContext->SetDpi(TARGET_DPI, TARGET_DPI);
+
+    // Enable anti-aliasing
+    m_deviceContext->SetAntialiasMode(D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
+
+    return true;
+}
+
 void D2DRenderer::releaseRenderTarget() {
-    if (m_renderTarget) {
-        m_renderTarget->Release();
-        m_renderTarget = nullptr;
+    // Brushes first: they belong to the target
+    m_resources.attach(nullptr);
+    m_renderTarget = nullptr;
+
+    if (m_hwndTarget) {
+        m_hwndTarget->Release();
+        m_hwndTarget = nullptr;
+    }
+    if (m_targetBitmap) {
+        m_targetBitmap->Release();
+        m_targetBitmap = nullptr;
+    }
+    if (m_deviceContext) {
+        m_deviceContext->Release();
+        m_deviceContext = nullptr;
+    }
+    if (m_dcompVisual) {
+        m_dcompVisual->Release();
+        m_dcompVisual = nullptr;
     }
+    if (m_dcompTarget) {
+        m_dcompTarget->Release();
+        m_dcompTarget = nullptr;
+    }
+    if (m_frameLatencyWaitable) {
+        CloseHandle(m_frameLatencyWaitable);
+        m_frameLatencyWaitable = nullptr;
+    }
+    if (m_swapChain) {
+        m_swapChain->Release();
+        m_swapChain = nullptr;
+    }
+}
+
+bool D2DRenderer::recreateRenderTarget() {
+    releaseRenderTarget();
+    if (createRenderTarget(m_hwnd)) {
+        return true;
+    }
+
+    // Drop whatever was created; beginDraw() retries from scratch
+    releaseRenderTarget();
+    return false;
+}
+
+bool D2DRenderer::isDeviceLost(HRESULT hr) {
+    return hr == D2DERR_RECREATE_TARGET || hr == DXGI_ERROR_DEVICE_REMOVED || hr == DXGI_ERROR_DEVICE_RESET;
 }
 
 } // namespace fps_monitor
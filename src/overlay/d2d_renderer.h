@@ -1,21 +1,54 @@
 #pragma once
 
 #include <windows.h>
-#include <d2d1.h>
+#include <d2d1_1.h>
+#include <d3d11.h>
+#include <dxgi1_3.h>
+#include <dcomp.h>
 #include <memory>
+#include "damage_tracker.h"
+#include "render_device.h"
+#include "resource_cache.h"
 
 #pragma comment(lib, "d2d1.lib")
+#pragma comment(lib, "d3d11.lib")
+#pragma comment(lib, "dxgi.lib")
+#pragma comment(lib, "dcomp.lib")
 
 namespace fps_monitor {
 
 /**
  * @brief Direct2D rendering initialization and management
  * 
- * Manages Direct2D factory, render target, and brushes.
- * Handles hardware acceleration and device lost scenarios.
+ * Manages a window's render target and brushes.
+ * Handles hardware acceleration and device lost scenarios: when a frame
+ * fails with a lost device the target is released and rebuilt, and the
+ * ResourceCache recreates its brushes for the new target on demand.
+ * 
+ * Two presentation backends share the same drawing interface:
+ * - SwapChain: a D3D11 device with an ID2D1DeviceContext drawing into a
+ *   premultiplied-alpha flip-model swap chain, attached to the window with
+ *   DirectComposition (the window needs WS_EX_NOREDIRECTIONBITMAP). Frames
+ *   are presented with Present1 and the damaged rectangles; beginDraw()
+ *   waits on the swap chain's frame latency waitable object, so a drawn
+ *   frame is queued at most once per vblank.
+ * - Hwnd: the legacy ID2D1HwndRenderTarget on a redirected layered window.
+ * 
+ * The factory and GPU devices come from a RenderDevice shared by every
+ * overlay window; a renderer owns only its window's target. A device lost
+ * by one renderer is rebuilt once and the others follow on their next
+ * beginDraw().
  */
 class D2DRenderer {
 public:
+    /**
+     * @brief Presentation backend
+     */
+    enum class Backend {
+        SwapChain,  ///< D3D11 flip-model swap chain + DirectComposition
+        Hwnd        ///< ID2D1HwndRenderTarget
+    };
+
     /**
      * @brief Construct a new D2D Renderer
      */
@@ -29,11 +62,14 @@ public:
     /**
      * @brief Initialize Direct2D for the given window
      * 
+     * @param device Shared factory and devices (initialized; must outlive the renderer)
      * @param hwnd Window handle
+     * @param backend Presentation backend (SwapChain requires a window
+     *                created without a redirection bitmap)
      * @return true if initialized successfully
      * @return false otherwise
      */
-    bool initialize(HWND hwnd);
+    bool initialize(RenderDevice* device, HWND hwnd, Backend backend = Backend::Hwnd);
 
     /**
      * @brief Shutdown and release all resources
@@ -43,15 +79,25 @@ public:
     /**
      * @brief Begin drawing frame
      * 
-     * Must be called before any drawing operations.
+     * Must be called before any drawing operations. Unless the whole target
+     * is damaged (or its contents were lost), drawing is clipped to the
+     * bounding box of the damage; the rest of the retained frame stays as
+     * presented last time.
+     * 
+     * @param damage Regions changed since the last presented frame
+     * @return true if drawing started (call endDraw())
+     * @return false if nothing changed and the frame can be skipped
      */
-    void beginDraw();
+    bool beginDraw(const DamageTracker& damage);
 
     /**
      * @brief End drawing frame and present
      * 
+     * On device loss the target is recreated right away (or by the next
+     * beginDraw() if that fails); the next frame is drawn in full.
+     * 
      * @return true if successful
-     * @return false if device lost (requires reinitialization)
+     * @return false if the frame was lost (device lost or removed)
      */
     bool endDraw();
 
@@ -66,22 +112,41 @@ public:
     void clear(float r, float g, float b, float a);
 
     /**
-     * @brief Create a solid color brush
+     * @brief Get the cache of device-dependent resources
      * 
-     * @param r Red (0.0-1.0)
-     * @param g Green (0.0-1.0)
-     * @param b Blue (0.0-1.0)
-     * @param a Alpha (0.0-1.0)
-     * @return ID2D1SolidColorBrush* Brush pointer (managed by renderer)
+     * Follows the render target across device loss; renderers keep brush
+     * handles from it instead of brush or target pointers.
+     * 
+     * @return ResourceCache& Resource cache
      */
-    ID2D1SolidColorBrush* createSolidBrush(float r, float g, float b, float a);
+    ResourceCache& getResources();
 
     /**
      * @brief Get the render target
      * 
-     * @return ID2D1HwndRenderTarget* Render target pointer
+     * The device context for the SwapChain backend, the HWND target otherwise.
+     * Replaced on device loss; do not keep it across frames.
+     * 
+     * @return ID2D1RenderTarget* Render target pointer (nullptr while lost)
+     */
+    ID2D1RenderTarget* getRenderTarget() const;
+
+    /**
+     * @brief Get the active backend
+     * 
+     * @return Backend Backend passed to initialize()
+     */
+    Backend getBackend() const;
+
+    /**
+     * @brief Get the swap chain's frame latency waitable object
+     * 
+     * Signalled when the swap chain can accept the next frame; beginDraw()
+     * waits on it before drawing a frame, which paces presents to the display.
+     * 
+     * @return HANDLE Waitable object, or nullptr for the Hwnd backend
      */
-    ID2D1HwndRenderTarget* getRenderTarget() const;
+    HANDLE getFrameLatencyWaitable() const;
 
     /**
      * @brief Get the D2D factory
@@ -103,6 +168,8 @@ public:
     /**
      * @brief Check if initialized
      * 
+     * Stays true while a lost target waits to be rebuilt by beginDraw().
+     * 
      * @return true if ready to render
      * @return false otherwise
      */
@@ -118,15 +185,63 @@ private:
      */
     bool createRenderTarget(HWND hwnd);
 
+    /**
+     * @brief Create the D3D11 device, swap chain and composition tree
+     * 
+     * @param hwnd Window handle
+     * @return true if successful
+     * @return false otherwise
+     */
+    bool createSwapChain(HWND hwnd);
+
+    /**
+     * @brief Bind the device context to the swap chain's back buffer
+     * 
+     * @return true if successful
+     * @return false otherwise
+     */
+    bool createSwapChainTarget();
+
     /**
      * @brief Release render target and brushes
      */
     void releaseRenderTarget();
 
-    ID2D1Factory* m_factory;                  ///< D2D factory
-    ID2D1HwndRenderTarget* m_renderTarget;    ///< Render target
+    /**
+     * @brief Release the target and create a new one
+     * 
+     * @return true if the new target is ready
+     * @return false otherwise (nothing is left half-created)
+     */
+    bool recreateRenderTarget();
+
+    /**
+     * @brief Check for an error that invalidates the device or target
+     * 
+     * @param hr Result of EndDraw or Present1
+     * @return true if the target must be recreated
+     * @return false otherwise
+     */
+    static bool isDeviceLost(HRESULT hr);
+
+    RenderDevice* m_device;                   ///< Shared factory and devices (not owned)
+    uint64_t m_deviceGeneration;              ///< m_device generation the target was built on
+    ID2D1RenderTarget* m_renderTarget;        ///< Active render target (one of the two below)
+    ID2D1HwndRenderTarget* m_hwndTarget;      ///< Hwnd backend target
+    ID2D1DeviceContext* m_deviceContext;      ///< SwapChain backend target
+    IDXGISwapChain1* m_swapChain;             ///< Flip-model composition swap chain
+    ID2D1Bitmap1* m_targetBitmap;             ///< Back buffer as a D2D target
+    IDCompositionTarget* m_dcompTarget;       ///< Composition target for the window
+    IDCompositionVisual* m_dcompVisual;       ///< Visual showing the swap chain
+    HANDLE m_frameLatencyWaitable;            ///< Swap chain frame latency waitable
+    ResourceCache m_resources;                ///< Brushes on m_renderTarget
+    RECT m_dirtyRects[DamageTracker::MAX_RECTS];  ///< Damage of the frame being drawn
+    UINT m_dirtyCount;                        ///< Rectangles in m_dirtyRects (0 = full present)
+    Backend m_backend;                        ///< Active backend
     HWND m_hwnd;                              ///< Associated window
     bool m_initialized;                       ///< Initialization state
+    bool m_contentLost;                       ///< Target (re)created or resized; next frame draws in full
+    bool m_clipped;                           ///< Damage clip pushed by beginDraw()
 };
 
 } // namespace fps_monitor
@@ -0,0 +1,98 @@
+#include "damage_tracker.h"
+#include <algorithm>
+#include <cmath>
+
+namespace fps_monitor {
+
+namespace {
+
+float area(const D2D1_RECT_F& rect) {
+    return (rect.right - rect.left) * (rect.bottom - rect.top);
+}
+
+D2D1_RECT_F unite(const D2D1_RECT_F& a, const D2D1_RECT_F& b) {
+    return D2D1::RectF(
+        std::min(a.left, b.left), std::min(a.top, b.top),
+        std::max(a.right, b.right), std::max(a.bottom, b.bottom)
+    );
+}
+
+bool overlaps(const D2D1_RECT_F& a, const D2D1_RECT_F& b) {
+    return a.left <= b.right && b.left <= a.right && a.top <= b.bottom && b.top <= a.bottom;
+}
+
+} // namespace
+
+DamageTracker::DamageTracker()
+    : m_count(0)
+    , m_union(D2D1::RectF(0.0f, 0.0f, 0.0f, 0.0f))
+    , m_width(0.0f)
+    , m_height(0.0f)
+    , m_full(false)
+{
+    invalidateAll();
+}
+
+void DamageTracker::setBounds(float width, float height) {
+    m_width = width;
+    m_height = height;
+    invalidateAll();
+}
+
+void DamageTracker::add(const D2D1_RECT_F& rect) {
+    if (m_full) {
+        return;
+    }
+
+    // Snap outward to whole pixels and clip to the surface
+    D2D1_RECT_F snapped = D2D1::RectF(
+        std::max(0.0f, std::floor(rect.left)),
+        std::max(0.0f, std::floor(rect.top)),
+        std::min(m_width, std::ceil(rect.right)),
+        std::min(m_height, std::ceil(rect.bottom))
+    );
+    if (snapped.right <= snapped.left || snapped.bottom <= snapped.top) {
+        return;
+    }
+
+    m_union = (m_count == 0) ? snapped : unite(m_union, snapped);
+
+    // Grow an overlapping rectangle instead of adding a new one
+    for (size_t i = 0; i < m_count; ++i) {
+        if (overlaps(m_rects[i], snapped)) {
+            m_rects[i] = unite(m_rects[i], snapped);
+            return;
+        }
+    }
+
+    if (m_count < MAX_RECTS) {
+        m_rects[m_count++] = snapped;
+        return;
+    }
+
+    // List full: merge into the rectangle that grows the least
+    size_t best = 0;
+    float bestGrowth = 0.0f;
+    for (size_t i = 0; i < m_count; ++i) {
+        float growth = area(unite(m_rects[i], snapped)) - area(m_rects[i]);
+        if (i == 0 || growth < bestGrowth) {
+            best = i;
+            bestGrowth = growth;
+        }
+    }
+    m_rects[best] = unite(m_rects[best], snapped);
+}
+
+void DamageTracker::invalidateAll() {
+    m_union = D2D1::RectF(0.0f, 0.0f, m_width, m_height);
+    m_rects[0] = m_union;
+    m_count = 1;
+    m_full = true;
+}
+
+void DamageTracker::clear() {
+    m_count = 0;
+    m_full = false;
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <d2d1.h>
+#include <cstddef>
+
+namespace fps_monitor {
+
+/**
+ * @brief Collects the regions of the overlay that changed since the last frame
+ * 
+ * Renderers add the rectangles whose content they are about to change;
+ * the frame is then drawn clipped to those rectangles, or skipped
+ * entirely when nothing was added. Rectangles are snapped outward to
+ * whole pixels and kept in a small fixed list (no allocation), merging
+ * into the closest existing rectangle once the list is full.
+ */
+class DamageTracker {
+public:
+    static constexpr size_t MAX_RECTS = 4;    ///< Rectangles kept before merging
+
+    /**
+     * @brief Construct a new Damage Tracker (starts fully damaged)
+     */
+    DamageTracker();
+
+    /**
+     * @brief Set the surface size
+     * 
+     * Rectangles are clipped to it and the whole surface is damaged.
+     * 
+     * @param width Surface width in pixels
+     * @param height Surface height in pixels
+     */
+    void setBounds(float width, float height);
+
+    /**
+     * @brief Mark a rectangle as changed
+     * 
+     * @param rect Changed area in pixels
+     */
+    void add(const D2D1_RECT_F& rect);
+
+    /**
+     * @brief Mark the whole surface as changed
+     * 
+     * Used for the first frame, resizes and device loss.
+     */
+    void invalidateAll();
+
+    /**
+     * @brief Forget all damage (call after the frame was presented)
+     */
+    void clear();
+
+    /**
+     * @brief Check if anything changed
+     * 
+     * @return true if nothing needs to be drawn
+     * @return false otherwise
+     */
+    bool isEmpty() const { return m_count == 0; }
+
+    /**
+     * @brief Check if the whole surface is damaged
+     * 
+     * @return true if the frame should be drawn unclipped
+     * @return false otherwise
+     */
+    bool isFull() const { return m_full; }
+
+    /**
+     * @brief Get the bounding box of all damage
+     * 
+     * @return const D2D1_RECT_F& Union of the damaged rectangles
+     */
+    const D2D1_RECT_F& bounds() const { return m_union; }
+
+    /**
+     * @brief Get the damaged rectangles
+     * 
+     * @return const D2D1_RECT_F* count() pixel-aligned rectangles
+     */
+    const D2D1_RECT_F* rects() const { return m_rects; }
+
+    /**
+     * @brief Get the number of damaged rectangles
+     * 
+     * @return size_t Rectangle count
+     */
+    size_t count() const { return m_count; }
+
+private:
+    D2D1_RECT_F m_rects[MAX_RECTS];   ///< Damaged rectangles
+    size_t m_count;                   ///< Rectangles in use
+    D2D1_RECT_F m_union;              ///< Bounding box of m_rects
+    float m_width;                    ///< Surface width
+    float m_height;                   ///< Surface height
+    bool m_full;                      ///< Whole surface damaged
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,157 @@
+#include "glyph_cache.h"
+
+namespace fps_monitor {
+
+GlyphCache::GlyphCache()
+    : m_fontFace(nullptr)
+    , m_fontSize(0.0f)
+    , m_ascent(0.0f)
+    , m_missingAdvance(0.0f)
+{
+    for (size_t i = 0; i < CHAR_COUNT; ++i) {
+        m_indices[i] = 0;
+        m_advances[i] = 0.0f;
+    }
+}
+
+GlyphCache::~GlyphCache() {
+    if (m_fontFace) m_fontFace->Release();
+}
+
+bool GlyphCache::initialize(IDWriteFactory* factory, IDWriteTextFormat* format) {
+    if (!factory || !format || m_fontFace) {
+        return false;
+    }
+
+    // Resolve the same font DrawText would pick for this format
+    wchar_t familyName[128];
+    if (FAILED(format->GetFontFamilyName(familyName, 128))) {
+        return false;
+    }
+
+    IDWriteFontCollection* collection = nullptr;
+    format->GetFontCollection(&collection);
+    if (!collection && FAILED(factory->GetSystemFontCollection(&collection))) {
+        return false;
+    }
+
+    UINT32 familyIndex = 0;
+    BOOL exists = FALSE;
+    HRESULT hr = collection->FindFamilyName(familyName, &familyIndex, &exists);
+
+    IDWriteFontFamily* family = nullptr;
+    if (SUCCEEDED(hr) && exists) {
+        hr = collection->GetFontFamily(familyIndex, &family);
+    }
+    collection->Release();
+    if (!family) {
+        return false;
+    }
+
+    IDWriteFont* font = nullptr;
+    hr = family->GetFirstMatchingFont(format->GetFontWeight(), format->GetFontStretch(),
+                                      format->GetFontStyle(), &font);
+    family->Release();
+    if (FAILED(hr)) {
+        return false;
+    }
+
+    // The face carries bold/oblique simulations of the matched font
+    hr = font->CreateFontFace(&m_fontFace);
+    font->Release();
+    if (FAILED(hr)) {
+        m_fontFace = nullptr;
+        return false;
+    }
+
+    m_fontSize = format->GetFontSize();
+
+    DWRITE_FONT_METRICS fontMetrics;
+    m_fontFace->GetMetrics(&fontMetrics);
+    float scale = m_fontSize / static_cast<float>(fontMetrics.designUnitsPerEm);
+    m_ascent = static_cast<float>(fontMetrics.ascent) * scale;
+
+    UINT32 codePoints[CHAR_COUNT];
+    for (size_t i = 0; i < CHAR_COUNT; ++i) {
+        codePoints[i] = static_cast<UINT32>(FIRST_CHAR + i);
+    }
+    if (FAILED(m_fontFace->GetGlyphIndices(codePoints, static_cast<UINT32>(CHAR_COUNT), m_indices))) {
+        return false;
+    }
+
+    DWRITE_GLYPH_METRICS glyphMetrics[CHAR_COUNT];
+    if (FAILED(m_fontFace->GetDesignGlyphMetrics(m_indices, static_cast<UINT32>(CHAR_COUNT), glyphMetrics, FALSE))) {
+        return false;
+    }
+    for (size_t i = 0; i < CHAR_COUNT; ++i) {
+        m_advances[i] = static_cast<float>(glyphMetrics[i].advanceWidth) * scale;
+    }
+
+    UINT16 missingGlyph = 0;
+    DWRITE_GLYPH_METRICS missingMetrics;
+    if (SUCCEEDED(m_fontFace->GetDesignGlyphMetrics(&missingGlyph, 1, &missingMetrics, FALSE))) {
+        m_missingAdvance = static_cast<float>(missingMetrics.advanceWidth) * scale;
+    }
+
+    return true;
+}
+
+void GlyphCache::appendChar(wchar_t c, Run& run) const {
+    if (run.count >= MAX_GLYPHS) {
+        return;
+    }
+
+    UINT16 index = 0;
+    FLOAT advance = m_missingAdvance;
+    if (c >= FIRST_CHAR && c <= LAST_CHAR) {
+        index = m_indices[c - FIRST_CHAR];
+        advance = m_advances[c - FIRST_CHAR];
+    }
+
+    run.indices[run.count] = index;
+    run.advances[run.count] = advance;
+    run.width += advance;
+    ++run.count;
+}
+
+void GlyphCache::append(const char* text, size_t length, Run& run) const {
+    for (size_t i = 0; i < length; ++i) {
+        appendChar(static_cast<wchar_t>(static_cast<unsigned char>(text[i])), run);
+    }
+}
+
+void GlyphCache::append(const wchar_t* text, Run& run) const {
+    for (; *text; ++text) {
+        appendChar(*text, run);
+    }
+}
+
+void GlyphCache::draw(ID2D1RenderTarget* renderTarget, const Run& run, float x, float y,
+                      ID2D1Brush* brush, ID2D1Brush* shadowBrush, float shadowOffset) const {
+    if (!renderTarget || !m_fontFace || run.count == 0) {
+        return;
+    }
+
+    DWRITE_GLYPH_RUN glyphRun = {};
+    glyphRun.fontFace = m_fontFace;
+    glyphRun.fontEmSize = m_fontSize;
+    glyphRun.glyphCount = run.count;
+    glyphRun.glyphIndices = run.indices;
+    glyphRun.glyphAdvances = run.advances;
+    glyphRun.glyphOffsets = nullptr;
+    glyphRun.isSideways = FALSE;
+    glyphRun.bidiLevel = 0;
+
+    float baseline = y + m_ascent;
+
+    if (shadowBrush) {
+        renderTarget->DrawGlyphRun(D2D1::Point2F(x + shadowOffset, baseline + shadowOffset),
+                                   &glyphRun, shadowBrush, DWRITE_MEASURING_MODE_NATURAL);
+    }
+
+    if (brush) {
+        renderTarget->DrawGlyphRun(D2D1::Point2F(x, baseline), &glyphRun, brush, DWRITE_MEASURING_MODE_NATURAL);
+    }
+}
+
+} // namespace fps_monitor
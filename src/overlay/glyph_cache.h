@@ -0,0 +1,128 @@
+#pragma once
+
+#include <d2d1.h>
+#include <dwrite.h>
+#include <cstddef>
+
+namespace fps_monitor {
+
+/**
+ * @brief Pre-resolved glyphs of one text format for allocation-free drawing
+ * 
+ * The overlay only draws short ASCII strings (numbers and fixed labels),
+ * which need no shaping beyond the font's character map. The glyph index
+ * and advance of every printable ASCII character are looked up once, so a
+ * string becomes a glyph run by table lookup and is drawn with
+ * DrawGlyphRun instead of being laid out again by DrawText every frame.
+ */
+class GlyphCache {
+public:
+    static constexpr size_t MAX_GLYPHS = 32;    ///< Glyphs one run can hold
+
+    /**
+     * @brief A positioned string ready for drawing
+     */
+    struct Run {
+        UINT16 indices[MAX_GLYPHS];     ///< Glyph indices
+        FLOAT advances[MAX_GLYPHS];     ///< Glyph advances in DIPs
+        UINT32 count = 0;               ///< Glyphs in use
+        float width = 0.0f;             ///< Sum of the advances
+    };
+
+    /**
+     * @brief Construct a new Glyph Cache
+     */
+    GlyphCache();
+
+    /**
+     * @brief Destroy the Glyph Cache
+     */
+    ~GlyphCache();
+
+    // Prevent copying (owns the font face)
+    GlyphCache(const GlyphCache&) = delete;
+    GlyphCache& operator=(const GlyphCache&) = delete;
+
+    /**
+     * @brief Resolve the font face of a text format and cache its ASCII glyphs
+     * 
+     * @param factory DirectWrite factory
+     * @param format Text format (family, weight, style, stretch and size)
+     * @return true if the glyphs were cached
+     * @return false if the font could not be resolved
+     */
+    bool initialize(IDWriteFactory* factory, IDWriteTextFormat* format);
+
+    /**
+     * @brief Check if the cache is ready
+     * 
+     * @return true if initialize() succeeded
+     * @return false otherwise
+     */
+    bool isInitialized() const { return m_fontFace != nullptr; }
+
+    /**
+     * @brief Append characters to a run
+     * 
+     * Characters outside printable ASCII map to the font's missing glyph.
+     * Characters that do not fit in the run are dropped.
+     * 
+     * @param text Characters to append
+     * @param length Number of characters
+     * @param run Run to append to
+     */
+    void append(const char* text, size_t length, Run& run) const;
+
+    /**
+     * @brief Append characters to a run
+     * 
+     * @param text Characters to append (null-terminated)
+     * @param run Run to append to
+     */
+    void append(const wchar_t* text, Run& run) const;
+
+    /**
+     * @brief Draw a run, optionally with its drop shadow first
+     * 
+     * Both passes draw the same glyph run.
+     * 
+     * @param renderTarget Target to draw into (inside BeginDraw/EndDraw)
+     * @param run Glyphs to draw
+     * @param x Left edge
+     * @param y Top of the line box (as for DrawText)
+     * @param brush Text brush
+     * @param shadowBrush Shadow brush (nullptr for no shadow)
+     * @param shadowOffset Shadow offset in DIPs (down and right)
+     */
+    void draw(ID2D1RenderTarget* renderTarget, const Run& run, float x, float y,
+              ID2D1Brush* brush, ID2D1Brush* shadowBrush, float shadowOffset) const;
+
+    /**
+     * @brief Get the distance from the top of the line box to the baseline
+     * 
+     * @return float Ascent in DIPs
+     */
+    float getAscent() const { return m_ascent; }
+
+private:
+    static constexpr wchar_t FIRST_CHAR = L' ';     ///< First cached character
+    static constexpr wchar_t LAST_CHAR = L'~';      ///< Last cached character
+    static constexpr size_t CHAR_COUNT = LAST_CHAR - FIRST_CHAR + 1;
+
+    /**
+     * @brief Append one character to a run
+     * 
+     * @param c Character
+     * @param run Run to append to
+     */
+    void appendChar(wchar_t c, Run& run) const;
+
+    IDWriteFontFace* m_fontFace;        ///< Resolved font face
+    float m_fontSize;                   ///< Em size in DIPs
+    float m_ascent;                     ///< Ascent in DIPs
+    UINT16 m_indices[CHAR_COUNT];       ///< Glyph index per cached character
+    FLOAT m_advances[CHAR_COUNT];       ///< Advance per cached character (DIPs)
+    FLOAT m_missingAdvance;             ///< Advance of the missing glyph (DIPs)
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,123 @@
+#include "graph_decimator.h"
+#include <algorithm>
+
+namespace fps_monitor {
+
+GraphDecimator::GraphDecimator()
+    : m_samplesPerColumn(0)
+    , m_cachedEnd(0)
+    , m_lastTotal(0)
+    , m_firstBucket(0)
+    , m_completeEnd(0)
+{
+}
+
+bool GraphDecimator::update(const SampleView<uint32_t>& samples, uint64_t totalSamples,
+                            size_t columns, size_t windowSize) {
+    if (columns == 0 || samples.empty() || totalSamples < samples.size()) {
+        return false;
+    }
+
+    size_t window = std::max(windowSize, samples.size());
+    size_t samplesPerColumn = (window + columns - 1) / columns;
+    if (samplesPerColumn < 2) {
+        return false;
+    }
+
+    // A window spans at most this many (possibly partial) buckets
+    size_t bucketCapacity = window / samplesPerColumn + 2;
+
+    // New layout, or the source was reset: cached buckets are meaningless
+    if (samplesPerColumn != m_samplesPerColumn || totalSamples < m_lastTotal || bucketCapacity > m_ring.size()) {
+        configure(samplesPerColumn, bucketCapacity);
+    }
+    m_lastTotal = totalSamples;
+
+    uint64_t spc = m_samplesPerColumn;
+    uint64_t firstSample = totalSamples - samples.size();
+    uint64_t firstBucket = firstSample / spc;
+    uint64_t lastBucket = (totalSamples - 1) / spc;
+    uint64_t completeEnd = totalSamples / spc;   // Buckets below this have all their samples
+    bool firstPartial = (firstSample % spc) != 0;
+
+    // Cache buckets that completed since the last update
+    float unusedPosition = 0.0f;
+    for (uint64_t bucket = std::max(m_cachedEnd, firstBucket); bucket < completeEnd; ++bucket) {
+        m_ring[bucket % m_ring.size()] = computeBucket(samples, firstSample, bucket, unusedPosition);
+    }
+    m_cachedEnd = std::max(m_cachedEnd, completeEnd);
+
+    m_firstBucket = firstBucket;
+    m_completeEnd = completeEnd;
+
+    // Assemble oldest to newest; only the partial ends are rescanned
+    size_t bucketCount = static_cast<size_t>(lastBucket - firstBucket + 1);
+    m_ticks.resize(bucketCount * 2);
+    m_positions.resize(bucketCount);
+
+    for (size_t i = 0; i < bucketCount; ++i) {
+        uint64_t bucket = firstBucket + i;
+        bool live = (bucket == firstBucket && firstPartial) || bucket >= completeEnd;
+
+        Bucket extremes;
+        if (live) {
+            extremes = computeBucket(samples, firstSample, bucket, m_positions[i]);
+        } else {
+            extremes = m_ring[bucket % m_ring.size()];
+            m_positions[i] = static_cast<float>(bucket * spc - firstSample) + (spc - 1) * 0.5f;
+        }
+
+        m_ticks[i * 2] = extremes.first;
+        m_ticks[i * 2 + 1] = extremes.second;
+    }
+
+    return true;
+}
+
+void GraphDecimator::reset() {
+    m_samplesPerColumn = 0;
+    m_cachedEnd = 0;
+    m_lastTotal = 0;
+    m_firstBucket = 0;
+    m_completeEnd = 0;
+    m_ticks.clear();
+    m_positions.clear();
+}
+
+GraphDecimator::Bucket GraphDecimator::computeBucket(const SampleView<uint32_t>& samples, uint64_t firstSample,
+                                                     uint64_t bucket, float& positionOut) const {
+    uint64_t spc = m_samplesPerColumn;
+    uint64_t lastSample = firstSample + samples.size();
+    size_t begin = static_cast<size_t>(std::max(bucket * spc, firstSample) - firstSample);
+    size_t end = static_cast<size_t>(std::min((bucket + 1) * spc, lastSample) - firstSample);
+
+    size_t minIndex = begin;
+    size_t maxIndex = begin;
+    for (size_t i = begin + 1; i < end; ++i) {
+        if (samples[i] < samples[minIndex]) {
+            minIndex = i;
+        }
+        if (samples[i] > samples[maxIndex]) {
+            maxIndex = i;
+        }
+    }
+
+    positionOut = (begin + end - 1) * 0.5f;
+
+    if (minIndex <= maxIndex) {
+        return {samples[minIndex], samples[maxIndex]};
+    }
+    return {samples[maxIndex], samples[minIndex]};
+}
+
+void GraphDecimator::configure(size_t samplesPerColumn, size_t bucketCapacity) {
+    m_samplesPerColumn = samplesPerColumn;
+    m_cachedEnd = 0;
+
+    // Only reallocates when the layout grows (width or history change)
+    m_ring.resize(std::max(m_ring.size(), bucketCapacity));
+    m_ticks.reserve(m_ring.size() * 2);
+    m_positions.reserve(m_ring.size());
+}
+
+} // namespace fps_monitor
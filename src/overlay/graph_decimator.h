@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "sample_view.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Min/max level-of-detail reduction of frame times to pixel columns
+ *
+ * When the history holds more samples than the graph has pixel columns,
+ * drawing every sample just overdraws the same columns. The decimator
+ * groups samples into fixed buckets of samplesPerColumn and keeps the
+ * shortest and longest frame of each bucket, in the order they occurred,
+ * so every spike survives.
+ *
+ * Buckets are aligned to absolute sample numbers (FpsCalculator's total
+ * sample count), so completed buckets never change and are cached in a
+ * ring. Per frame only the newest (still filling) bucket and a partially
+ * evicted oldest bucket are recomputed.
+ */
+class GraphDecimator {
+public:
+    /**
+     * @brief Construct a new Graph Decimator
+     */
+    GraphDecimator();
+
+    /**
+     * @brief Reduce the sample window to per-column extrema
+     *
+     * @param samples Frame times in ticks (oldest to newest)
+     * @param totalSamples Samples produced since the source was reset
+     *                     (FpsCalculator::getTotalSamples())
+     * @param columns Pixel columns available
+     * @param windowSize Full history size; fixes the bucket width so it does
+     *                   not change while the history is still filling
+     * @return true if the output was updated and should be drawn
+     * @return false if there are too few samples per column to decimate
+     *         (draw the raw samples instead)
+     */
+    bool update(const SampleView<uint32_t>& samples, uint64_t totalSamples, size_t columns, size_t windowSize);
+
+    /**
+     * @brief Get the decimated frame times
+     *
+     * Two per bucket (first and second extreme in time order), oldest first.
+     *
+     * @return const uint32_t* pointCount() frame times in ticks
+     */
+    const uint32_t* ticks() const { return m_ticks.data(); }
+
+    /**
+     * @brief Get the sample position of each bucket
+     *
+     * Offset of the bucket's centre from the oldest sample of the window,
+     * in samples (same units as the raw sample index).
+     *
+     * @return const float* pointCount() / 2 positions
+     */
+    const float* positions() const { return m_positions.data(); }
+
+    /**
+     * @brief Get the number of decimated points
+     *
+     * @return size_t Point count (2 per bucket)
+     */
+    size_t pointCount() const { return m_ticks.size(); }
+
+    /**
+     * @brief Get the bucket number of the first output pair
+     *
+     * Bucket b is output pair (b - firstBucket()); every bucket maps to a
+     * fixed X position relative to its neighbours, which lets renderers
+     * cache drawn columns.
+     *
+     * @return uint64_t Oldest bucket in the window
+     */
+    uint64_t firstBucket() const { return m_firstBucket; }
+
+    /**
+     * @brief Get the end of the completed buckets
+     *
+     * Buckets below this number will not change any more; the ones from
+     * here to the end of the output are still filling.
+     *
+     * @return uint64_t One past the newest complete bucket
+     */
+    uint64_t completeEnd() const { return m_completeEnd; }
+
+    /**
+     * @brief Drop all cached buckets
+     */
+    void reset();
+
+private:
+    /**
+     * @brief Extremes of one bucket in time order
+     */
+    struct Bucket {
+        uint32_t first;     ///< Earlier of the two extremes
+        uint32_t second;    ///< Later of the two extremes
+    };
+
+    /**
+     * @brief Scan the live samples of a bucket
+     *
+     * @param samples Sample window
+     * @param firstSample Absolute number of samples[0]
+     * @param bucket Bucket number
+     * @param positionOut Bucket centre relative to samples[0]
+     * @return Bucket Extremes of the samples of this bucket present in the window
+     */
+    Bucket computeBucket(const SampleView<uint32_t>& samples, uint64_t firstSample,
+                         uint64_t bucket, float& positionOut) const;
+
+    /**
+     * @brief Reset the cache and size storage for a bucket layout
+     *
+     * @param samplesPerColumn New bucket width
+     * @param bucketCapacity Most buckets a window can span
+     */
+    void configure(size_t samplesPerColumn, size_t bucketCapacity);
+
+    std::vector<Bucket> m_ring;         ///< Cached complete buckets (indexed by bucket % size)
+    std::vector<uint32_t> m_ticks;      ///< Output frame times
+    std::vector<float> m_positions;     ///< Output bucket positions
+    size_t m_samplesPerColumn;          ///< Bucket width (0 = not configured)
+    uint64_t m_cachedEnd;               ///< Buckets below this number are cached
+    uint64_t m_lastTotal;               ///< totalSamples at the previous update
+    uint64_t m_firstBucket;             ///< Bucket of the first output pair
+    uint64_t m_completeEnd;             ///< One past the newest complete bucket
+};
+
+} // namespace fps_monitor
@@ -1,50 +1,117 @@
 #include "graph_renderer.h"
+#include "simd_kernels.h"
 #include <algorithm>
+#include <cmath>
 
 namespace fps_monitor {
 
 GraphRenderer::GraphRenderer()
-    : m_renderTarget(nullptr)
+    : m_resources(nullptr)
+    , m_generation(0)
+    , m_renderTarget(nullptr)
+    , m_factory(nullptr)
+    , m_strokeStyle(nullptr)
+    , m_lineHandle(ResourceCache::INVALID_BRUSH)
+    , m_fillHandle(ResourceCache::INVALID_BRUSH)
+    , m_dropMarkerHandle(ResourceCache::INVALID_BRUSH)
+    , m_gridHandle(ResourceCache::INVALID_BRUSH)
     , m_lineColor(nullptr)
     , m_fillColor(nullptr)
     , m_dropMarker(nullptr)
     , m_gridColor(nullptr)
     , m_showGrid(false)
+    , m_showFill(false)
     , m_lineWidth(2.0f)
     , m_smoothMinFPS(0.0)
     , m_smoothMaxFPS(60.0)
+    , m_cache(nullptr)
+    , m_cacheBitmap(nullptr)
+    , m_cacheColumns(0)
+    , m_cacheRows(0)
+    , m_cacheEnd(0)
+    , m_cacheTotal(0)
+    , m_cacheValid(false)
+    , m_snappedMinFPS(0.0)
+    , m_snappedMaxFPS(0.0)
+    , m_trackedTotal(UINT64_MAX)
 {
 }
 
-GraphRenderer::~GraphRenderer() = default;
+GraphRenderer::~GraphRenderer() {
+    releaseCache();
+    if (m_strokeStyle) m_strokeStyle->Release();
+    if (m_factory) m_factory->Release();
+}
 
-bool GraphRenderer::initialize(ID2D1HwndRenderTarget* renderTarget) {
-    if (!renderTarget) {
+bool GraphRenderer::initialize(ResourceCache* resources) {
+    if (!resources || !resources->getRenderTarget()) {
         return false;
     }
 
-    m_renderTarget = renderTarget;
+    releaseCache();
 
-    // Create default grid brush
-    m_renderTarget->CreateSolidColorBrush(
-        D2D1::ColorF(1.0f, 1.0f, 1.0f, 0.1f),
-        &m_gridColor
-    );
+    // The factory outlives device loss; only the target is re-read per frame
+    m_resources = resources;
+    m_generation = resources->getGeneration();
+    m_renderTarget = resources->getRenderTarget();
+    m_renderTarget->GetFactory(&m_factory);
+
+    // Round joins keep spikes from producing long miters
+    if (m_factory) {
+        m_factory->CreateStrokeStyle(
+            D2D1::StrokeStyleProperties(
+                D2D1_CAP_STYLE_FLAT,
+                D2D1_CAP_STYLE_FLAT,
+                D2D1_CAP_STYLE_ROUND,
+                D2D1_LINE_JOIN_ROUND
+            ),
+            nullptr,
+            0,
+            &m_strokeStyle
+        );
+    }
+
+    // Register default grid brush
+    m_gridHandle = m_resources->addBrush("grid_line", D2D1::ColorF(1.0f, 1.0f, 1.0f, 0.1f));
 
     return true;
 }
 
-void GraphRenderer::render(const std::vector<double>& samples, float x, float y, float width, float height) {
-    if (!m_renderTarget || !m_lineColor || samples.empty()) {
+void GraphRenderer::render(const SampleView<uint32_t>& samples, uint64_t totalSamples, int64_t tickFrequency,
+                           double sampleMin, double sampleMax,
+                           float x, float y, float width, float height) {
+    if (!bindResources() || !m_factory || samples.empty() || tickFrequency <= 0) {
         return;
     }
 
-    // Calculate scale
+    // Calculate scale (always, so smoothing stays current across modes)
     double minFPS, maxFPS;
-    calculateScale(samples, minFPS, maxFPS);
+    calculateScale(sampleMin, sampleMax, minFPS, maxFPS);
+
+    // More samples than pixel columns: draw per-column min/max instead. The
+    // window spans a fixed time, so the bucket width follows its sample count
+    size_t columns = static_cast<size_t>(std::max(width, 0.0f));
+    bool decimated = m_decimator.update(samples, totalSamples, columns, samples.size());
+    bool gridDrawn = false;
+
+    // Decimated history: scroll the cached columns instead of redrawing them
+    if (decimated) {
+        if (updateSnappedScale(sampleMin, sampleMax)) {
+            m_cacheValid = false;
+        }
+
+        if (m_showGrid && m_gridColor) {
+            renderGrid(x, y, width, height, m_snappedMinFPS, m_snappedMaxFPS);
+            gridDrawn = true;
+        }
+
+        if (renderCached(totalSamples, tickFrequency, x, y, columns, height)) {
+            return;
+        }
+    }
 
     // Render grid if enabled
-    if (m_showGrid && m_gridColor) {
+    if (m_showGrid && m_gridColor && !gridDrawn) {
         renderGrid(x, y, width, height, minFPS, maxFPS);
     }
 
@@ -54,58 +121,262 @@ void GraphRenderer::render(const std::vector<double>& samples, float x, float y,
         xStep = 0.0f;
     }
 
-    // Render line graph
-    for (size_t i = 1; i < samples.size(); ++i) {
-        double fps1 = samples[i - 1];
-        double fps2 = samples[i];
+    GraphTransform transform;
+    transform.ticksPerSecond = static_cast<float>(tickFrequency);
+    transform.minFPS = static_cast<float>(minFPS);
+    transform.maxFPS = static_cast<float>(maxFPS);
+    transform.bottom = y + height;
+    transform.scale = static_cast<float>(height / (maxFPS - minFPS));
 
-        // Clamp to scale
-        fps1 = std::max(minFPS, std::min(fps1, maxFPS));
-        fps2 = std::max(minFPS, std::min(fps2, maxFPS));
+    size_t count = decimated ? m_decimator.pointCount() : samples.size();
+    if (m_pointY.size() < count) {
+        m_pointY.resize(count);
+        m_points.resize(count);
+    }
 
-        // Convert to screen coordinates
-        float x1 = x + (i - 1) * xStep;
-        float x2 = x + i * xStep;
-        float y1 = y + height - static_cast<float>((fps1 - minFPS) / (maxFPS - minFPS) * height);
-        float y2 = y + height - static_cast<float>((fps2 - minFPS) / (maxFPS - minFPS) * height);
+    // Clamp, scale and offset every point in one vectorized pass
+    if (decimated) {
+        SimdKernels::get().toGraphY(m_decimator.ticks(), count, transform, m_pointY.data());
 
-        // Draw line segment
-        m_renderTarget->DrawLine(
-            D2D1::Point2F(x1, y1),
-            D2D1::Point2F(x2, y2),
-            m_lineColor,
-            m_lineWidth
-        );
+        const float* positions = m_decimator.positions();
+        for (size_t i = 0; i < count; ++i) {
+            m_points[i] = D2D1::Point2F(x + positions[i / 2] * xStep, m_pointY[i]);
+        }
+    } else {
+        SimdKernels::get().toGraphY(samples, transform, m_pointY.data());
+
+        for (size_t i = 0; i < count; ++i) {
+            m_points[i] = D2D1::Point2F(x + i * xStep, m_pointY[i]);
+        }
     }
+
+    drawShape(m_renderTarget, count, y + height);
 }
 
-void GraphRenderer::setColors(ID2D1SolidColorBrush* lineColor, ID2D1SolidColorBrush* fillColor) {
-    m_lineColor = lineColor;
-    m_fillColor = fillColor;
+void GraphRenderer::renderMarkers(const SampleView<StutterAnalyzer::Stutter>& stutters, uint64_t totalSamples,
+                                  size_t sampleCount, float x, float y, float width, float height) {
+    if (!bindResources() || !m_dropMarker || sampleCount < 2 || totalSamples < sampleCount) {
+        return;
+    }
+
+    // Same spacing as render(), by absolute sample number
+    uint64_t firstSample = totalSamples - sampleCount;
+    float xStep = width / static_cast<float>(sampleCount - 1);
+    stutters.forEach([&](const StutterAnalyzer::Stutter& stutter) {
+        if (stutter.sample < firstSample || stutter.sample >= totalSamples) {
+            return;
+        }
+
+        float markerX = x + static_cast<float>(stutter.sample - firstSample) * xStep;
+        float strokeWidth = 1.0f + 0.5f * static_cast<float>(std::min<uint32_t>(stutter.missedIntervals, 4));
+        m_renderTarget->DrawLine(D2D1::Point2F(markerX, y), D2D1::Point2F(markerX, y + height),
+                                 m_dropMarker, strokeWidth);
+    });
+}
+
+void GraphRenderer::renderHistory(const SampleView<HistoryTiers::Bucket>& buckets, double bucketSeconds,
+                                  double viewSeconds, int64_t tickFrequency,
+                                  float x, float y, float width, float height) {
+    if (!bindResources() || !m_factory || tickFrequency <= 0 || bucketSeconds <= 0.0 || width <= 0.0f) {
+        return;
+    }
+
+    size_t viewBuckets = 0;
+    SampleView<HistoryTiers::Bucket> shown = visibleBuckets(buckets, bucketSeconds, viewSeconds, viewBuckets);
+    double sampleMin, sampleMax;
+    if (!bucketRange(shown, tickFrequency, sampleMin, sampleMax)) {
+        return;
+    }
+
+    double minFPS, maxFPS;
+    calculateScale(sampleMin, sampleMax, minFPS, maxFPS);
+    if (m_showGrid && m_gridColor) {
+        renderGrid(x, y, width, height, minFPS, maxFPS);
+    }
+
+    // Two points per touched column (or per bucket when zoomed in); sized
+    // for the full width so a filling history never reallocates
+    size_t maxPoints = (static_cast<size_t>(width) + 2) * 2;
+    if (m_columnTicks.size() < maxPoints) {
+        m_columnTicks.resize(maxPoints);
+        m_columnX.resize(maxPoints / 2);
+    }
+    if (m_pointY.size() < maxPoints) {
+        m_pointY.resize(maxPoints);
+        m_points.resize(maxPoints);
+    }
+
+    // Merge the buckets of each pixel column; an empty bucket is an
+    // unbounded frame, so its column reaches the bottom
+    float step = width / static_cast<float>(viewBuckets);
+    float left = x + width - static_cast<float>(shown.size()) * step;
+    size_t count = 0;
+    long currentColumn = -1;
+    for (size_t i = 0; i < shown.size(); ++i) {
+        const HistoryTiers::Bucket& bucket = shown[i];
+        uint32_t longest = bucket.frames ? bucket.longest : UINT32_MAX;
+        uint32_t shortest = bucket.frames ? bucket.shortest : UINT32_MAX;
+        float centre = left + (static_cast<float>(i) + 0.5f) * step;
+        long column = static_cast<long>(std::floor(centre - x));
+
+        if (column != currentColumn && count < maxPoints) {
+            m_columnX[count / 2] = step >= 1.0f ? centre : x + static_cast<float>(column) + 0.5f;
+            m_columnTicks[count++] = longest;
+            m_columnTicks[count++] = shortest;
+            currentColumn = column;
+        } else {
+            m_columnTicks[count - 2] = std::max(m_columnTicks[count - 2], longest);
+            m_columnTicks[count - 1] = std::min(m_columnTicks[count - 1], shortest);
+        }
+    }
+
+    GraphTransform transform;
+    transform.ticksPerSecond = static_cast<float>(tickFrequency);
+    transform.minFPS = static_cast<float>(minFPS);
+    transform.maxFPS = static_cast<float>(maxFPS);
+    transform.bottom = y + height;
+    transform.scale = static_cast<float>(height / (maxFPS - minFPS));
+    SimdKernels::get().toGraphY(m_columnTicks.data(), count, transform, m_pointY.data());
+
+    for (size_t i = 0; i < count; ++i) {
+        m_points[i] = D2D1::Point2F(m_columnX[i / 2], m_pointY[i]);
+    }
+
+    drawShape(m_renderTarget, count, y + height);
+}
+
+void GraphRenderer::trackHistoryDamage(const SampleView<HistoryTiers::Bucket>& buckets, uint64_t totalBuckets,
+                                       double bucketSeconds, double viewSeconds, int64_t tickFrequency,
+                                       float x, float y, float width, float height, DamageTracker& damage) {
+    size_t viewBuckets = 0;
+    double sampleMin, sampleMax;
+    if (bucketSeconds > 0.0 && tickFrequency > 0 &&
+        bucketRange(visibleBuckets(buckets, bucketSeconds, viewSeconds, viewBuckets),
+                    tickFrequency, sampleMin, sampleMax)) {
+        trackDamage(totalBuckets, sampleMin, sampleMax, x, y, width, height, damage);
+        return;
+    }
+
+    // Nothing drawable: only the arrival of buckets changes the (empty) graph
+    if (totalBuckets != m_trackedTotal) {
+        m_trackedTotal = totalBuckets;
+        float pad = std::ceil(m_lineWidth);
+        damage.add(D2D1::RectF(x - pad, y - pad, x + width + pad, y + height + pad));
+    }
+}
+
+void GraphRenderer::trackDamage(uint64_t totalSamples, double sampleMin, double sampleMax,
+                                float x, float y, float width, float height, DamageTracker& damage) {
+    double minFPS, maxFPS;
+    paddedRange(sampleMin, sampleMax, minFPS, maxFPS);
+
+    // render() is not called without samples, so the scale cannot settle then
+    bool settling = totalSamples > 0 &&
+                    (std::abs(minFPS - m_smoothMinFPS) > SCALE_SETTLED ||
+                     std::abs(maxFPS - m_smoothMaxFPS) > SCALE_SETTLED);
+    if (totalSamples == m_trackedTotal && !settling) {
+        return;
+    }
+    m_trackedTotal = totalSamples;
+
+    // The stroke can reach half a line width past the graph edges
+    float pad = std::ceil(m_lineWidth);
+    damage.add(D2D1::RectF(x - pad, y - pad, x + width + pad, y + height + pad));
+}
+
+void GraphRenderer::setColors(ResourceCache::BrushHandle lineColor, ResourceCache::BrushHandle fillColor) {
+    m_lineHandle = lineColor;
+    m_fillHandle = fillColor;
 }
 
 void GraphRenderer::setShowGrid(bool enabled) {
     m_showGrid = enabled;
 }
 
+void GraphRenderer::setShowFill(bool enabled) {
+    // Cached columns were drawn with the old style
+    if (enabled != m_showFill) {
+        m_showFill = enabled;
+        m_cacheValid = false;
+    }
+}
+
 void GraphRenderer::setLineWidth(float width) {
-    m_lineWidth = width;
+    if (width != m_lineWidth) {
+        m_lineWidth = width;
+        m_cacheValid = false;
+    }
 }
 
-void GraphRenderer::setDropMarkerBrush(ID2D1SolidColorBrush* brush) {
-    m_dropMarker = brush;
+void GraphRenderer::setMaxSamples(size_t maxSamples) {
+    m_pointY.reserve(maxSamples);
+    m_points.reserve(maxSamples);
 }
 
-void GraphRenderer::calculateScale(const std::vector<double>& samples, double& minFPS, double& maxFPS) {
-    if (samples.empty()) {
-        minFPS = 0.0;
-        maxFPS = 60.0;
-        return;
+void GraphRenderer::setDropMarkerBrush(ResourceCache::BrushHandle brush) {
+    m_dropMarkerHandle = brush;
+}
+
+SampleView<HistoryTiers::Bucket> GraphRenderer::visibleBuckets(const SampleView<HistoryTiers::Bucket>& buckets,
+                                                               double bucketSeconds, double viewSeconds,
+                                                               size_t& viewBuckets) {
+    viewBuckets = static_cast<size_t>(std::max(1.0, std::ceil(viewSeconds / bucketSeconds)));
+    return buckets.last(viewBuckets);
+}
+
+bool GraphRenderer::bucketRange(const SampleView<HistoryTiers::Bucket>& buckets, int64_t tickFrequency,
+                                double& sampleMin, double& sampleMax) {
+    uint32_t shortest = UINT32_MAX;
+    uint32_t longest = 0;
+    buckets.forEach([&shortest, &longest](const HistoryTiers::Bucket& bucket) {
+        if (bucket.frames > 0) {
+            shortest = std::min(shortest, bucket.shortest);
+            longest = std::max(longest, bucket.longest);
+        }
+    });
+    if (longest == 0) {
+        return false;
     }
 
-    // Find min and max
-    minFPS = *std::min_element(samples.begin(), samples.end());
-    maxFPS = *std::max_element(samples.begin(), samples.end());
+    double frequency = static_cast<double>(tickFrequency);
+    sampleMin = frequency / longest;
+    sampleMax = frequency / shortest;
+    return true;
+}
+
+bool GraphRenderer::bindResources() {
+    if (!m_resources) {
+        return false;
+    }
+
+    // A new target invalidates the column cache bitmap
+    if (m_resources->getGeneration() != m_generation) {
+        releaseCache();
+        m_generation = m_resources->getGeneration();
+    }
+
+    m_renderTarget = m_resources->getRenderTarget();
+    m_lineColor = m_resources->getBrush(m_lineHandle);
+    m_fillColor = m_resources->getBrush(m_fillHandle);
+    m_dropMarker = m_resources->getBrush(m_dropMarkerHandle);
+    m_gridColor = m_resources->getBrush(m_gridHandle);
+    return m_renderTarget && m_lineColor;
+}
+
+void GraphRenderer::calculateScale(double sampleMin, double sampleMax, double& minFPS, double& maxFPS) {
+    paddedRange(sampleMin, sampleMax, minFPS, maxFPS);
+
+    // Smooth scale transitions
+    m_smoothMinFPS += (minFPS - m_smoothMinFPS) * SCALE_SMOOTH_FACTOR;
+    m_smoothMaxFPS += (maxFPS - m_smoothMaxFPS) * SCALE_SMOOTH_FACTOR;
+
+    minFPS = m_smoothMinFPS;
+    maxFPS = m_smoothMaxFPS;
+}
+
+void GraphRenderer::paddedRange(double sampleMin, double sampleMax, double& minFPS, double& maxFPS) {
+    minFPS = sampleMin;
+    maxFPS = sampleMax;
 
     // Add padding (10%)
     double range = maxFPS - minFPS;
@@ -118,13 +389,230 @@ void GraphRenderer::calculateScale(const std::vector<double>& samples, double& m
         minFPS = center - 5.0;
         maxFPS = center + 5.0;
     }
+}
 
-    // Smooth scale transitions
-    m_smoothMinFPS += (minFPS - m_smoothMinFPS) * SCALE_SMOOTH_FACTOR;
-    m_smoothMaxFPS += (maxFPS - m_smoothMaxFPS) * SCALE_SMOOTH_FACTOR;
+bool GraphRenderer::updateSnappedScale(double sampleMin, double sampleMax) {
+    double minFPS, maxFPS;
+    paddedRange(sampleMin, sampleMax, minFPS, maxFPS);
 
-    minFPS = m_smoothMinFPS;
-    maxFPS = m_smoothMaxFPS;
+    // Keep the current scale while the data fits and uses at least half of it
+    double snappedRange = m_snappedMaxFPS - m_snappedMinFPS;
+    if (snappedRange > 0.0 && minFPS >= m_snappedMinFPS && maxFPS <= m_snappedMaxFPS &&
+        (maxFPS - minFPS) * 2.0 >= snappedRange) {
+        return false;
+    }
+
+    double range = maxFPS - minFPS;
+    double step = 100.0;
+    if (range <= 60.0) {
+        step = 10.0;
+    } else if (range <= 150.0) {
+        step = 25.0;
+    } else if (range <= 300.0) {
+        step = 50.0;
+    }
+
+    double snappedMin = std::max(0.0, std::floor(minFPS / step) * step);
+    double snappedMax = std::max(snappedMin + step, std::ceil(maxFPS / step) * step);
+
+    bool changed = (snappedMin != m_snappedMinFPS || snappedMax != m_snappedMaxFPS);
+    m_snappedMinFPS = snappedMin;
+    m_snappedMaxFPS = snappedMax;
+    return changed;
+}
+
+bool GraphRenderer::renderCached(uint64_t totalSamples, int64_t tickFrequency,
+                                 float x, float y, size_t columns, float height) {
+    UINT32 rows = static_cast<UINT32>(std::ceil(height));
+    if (columns == 0 || rows == 0 || !ensureCache(static_cast<UINT32>(columns), rows)) {
+        return false;
+    }
+
+    uint64_t firstBucket = m_decimator.firstBucket();
+    uint64_t completeEnd = m_decimator.completeEnd();
+    size_t count = m_decimator.pointCount();
+    uint64_t lastBucket = firstBucket + count / 2 - 1;
+
+    // Cache-space Y (top = 0) for every decimated point, on the snapped scale
+    if (m_pointY.size() < count) {
+        m_pointY.resize(count);
+    }
+
+    GraphTransform transform;
+    transform.ticksPerSecond = static_cast<float>(tickFrequency);
+    transform.minFPS = static_cast<float>(m_snappedMinFPS);
+    transform.maxFPS = static_cast<float>(m_snappedMaxFPS);
+    transform.bottom = height;
+    transform.scale = static_cast<float>(height / (m_snappedMaxFPS - m_snappedMinFPS));
+    SimdKernels::get().toGraphY(m_decimator.ticks(), count, transform, m_pointY.data());
+
+    // Anything but a forward scroll of less than the ring needs a full redraw
+    bool full = !m_cacheValid || totalSamples < m_cacheTotal || completeEnd < m_cacheEnd ||
+                m_cacheEnd < firstBucket || completeEnd - m_cacheEnd >= m_cacheColumns;
+    uint64_t drawFrom = full ? firstBucket : m_cacheEnd;
+
+    if (full || drawFrom < completeEnd) {
+        m_cache->BeginDraw();
+        if (full) {
+            m_cache->Clear(D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.0f));
+        }
+        drawCacheColumns(drawFrom, completeEnd, height);
+
+        if (FAILED(m_cache->EndDraw())) {
+            releaseCache();
+            return false;
+        }
+    }
+
+    m_cacheEnd = completeEnd;
+    m_cacheTotal = totalSamples;
+    m_cacheValid = true;
+
+    // Blit the ring in (at most) two pieces; the live bucket owns the last column
+    float right = x + static_cast<float>(columns);
+    uint64_t visibleFrom = (lastBucket + 1 > columns) ? std::max(firstBucket, lastBucket + 1 - columns) : firstBucket;
+
+    for (uint64_t bucket = visibleFrom; bucket < completeEnd;) {
+        UINT32 column = static_cast<UINT32>(bucket % m_cacheColumns);
+        uint64_t end = std::min<uint64_t>(completeEnd, bucket + (m_cacheColumns - column));
+        float length = static_cast<float>(end - bucket);
+        float left = right - static_cast<float>(lastBucket + 1 - bucket);
+
+        m_renderTarget->DrawBitmap(
+            m_cacheBitmap,
+            D2D1::RectF(left, y, left + length, y + rows),
+            1.0f,
+            D2D1_BITMAP_INTERPOLATION_MODE_NEAREST_NEIGHBOR,
+            D2D1::RectF(static_cast<float>(column), 0.0f, static_cast<float>(column) + length, static_cast<float>(rows))
+        );
+
+        bucket = end;
+    }
+
+    // Still-filling bucket(s), joined to the newest cached column
+    size_t pointCount = 0;
+    uint64_t tailFrom = completeEnd > visibleFrom ? completeEnd - 1 : visibleFrom;
+    for (uint64_t bucket = tailFrom; bucket <= lastBucket; ++bucket) {
+        size_t index = static_cast<size_t>(bucket - firstBucket) * 2;
+        float centre = right - static_cast<float>(lastBucket - bucket) - 0.5f;
+
+        if (bucket >= completeEnd) {
+            m_points[pointCount++] = D2D1::Point2F(centre, y + m_pointY[index]);
+        }
+        m_points[pointCount++] = D2D1::Point2F(centre, y + m_pointY[index + 1]);
+    }
+
+    if (pointCount >= 2) {
+        drawShape(m_renderTarget, pointCount, y + height);
+    }
+
+    return true;
+}
+
+bool GraphRenderer::ensureCache(UINT32 columns, UINT32 rows) {
+    if (m_cache && m_cacheColumns == columns && m_cacheRows == rows) {
+        return true;
+    }
+
+    releaseCache();
+
+    HRESULT hr = m_renderTarget->CreateCompatibleRenderTarget(
+        D2D1::SizeF(static_cast<float>(columns), static_cast<float>(rows)),
+        &m_cache
+    );
+    if (FAILED(hr)) {
+        m_cache = nullptr;
+        return false;
+    }
+
+    if (FAILED(m_cache->GetBitmap(&m_cacheBitmap))) {
+        releaseCache();
+        return false;
+    }
+
+    m_cacheColumns = columns;
+    m_cacheRows = rows;
+    m_cacheValid = false;
+
+    // Largest strip: two points per column plus the join
+    size_t maxPoints = static_cast<size_t>(columns) * 2 + 4;
+    if (m_points.size() < maxPoints) {
+        m_points.resize(maxPoints);
+    }
+
+    return true;
+}
+
+void GraphRenderer::drawCacheColumns(uint64_t fromBucket, uint64_t toBucket, float baseline) {
+    uint64_t firstBucket = m_decimator.firstBucket();
+
+    for (uint64_t start = fromBucket; start < toBucket;) {
+        uint64_t base = start - start % m_cacheColumns;
+        uint64_t end = std::min<uint64_t>(toBucket, base + m_cacheColumns);
+
+        D2D1_RECT_F strip = D2D1::RectF(
+            static_cast<float>(start - base), 0.0f,
+            static_cast<float>(end - base), static_cast<float>(m_cacheRows)
+        );
+        m_cache->PushAxisAlignedClip(strip, D2D1_ANTIALIAS_MODE_ALIASED);
+        m_cache->Clear(D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.0f));
+
+        size_t pointCount = 0;
+
+        // Join from the previous column so the line stays continuous
+        if (start > firstBucket) {
+            size_t index = static_cast<size_t>(start - 1 - firstBucket) * 2 + 1;
+            m_points[pointCount++] = D2D1::Point2F(static_cast<float>(start - base) - 0.5f, m_pointY[index]);
+        }
+
+        for (uint64_t bucket = start; bucket < end; ++bucket) {
+            size_t index = static_cast<size_t>(bucket - firstBucket) * 2;
+            float centre = static_cast<float>(bucket - base) + 0.5f;
+            m_points[pointCount++] = D2D1::Point2F(centre, m_pointY[index]);
+            m_points[pointCount++] = D2D1::Point2F(centre, m_pointY[index + 1]);
+        }
+
+        drawShape(m_cache, pointCount, baseline);
+        m_cache->PopAxisAlignedClip();
+
+        start = end;
+    }
+}
+
+void GraphRenderer::drawShape(ID2D1RenderTarget* target, size_t count, float baseline) {
+    if (count == 0) {
+        return;
+    }
+
+    // Filled area first so the line stays on top
+    if (m_showFill && m_fillColor) {
+        ID2D1PathGeometry* area = buildGeometry(count, true, baseline);
+        if (area) {
+            target->FillGeometry(area, m_fillColor);
+            area->Release();
+        }
+    }
+
+    // Whole polyline in one draw call
+    ID2D1PathGeometry* line = buildGeometry(count, false, baseline);
+    if (line) {
+        target->DrawGeometry(line, m_lineColor, m_lineWidth, m_strokeStyle);
+        line->Release();
+    }
+}
+
+void GraphRenderer::releaseCache() {
+    if (m_cacheBitmap) {
+        m_cacheBitmap->Release();
+        m_cacheBitmap = nullptr;
+    }
+    if (m_cache) {
+        m_cache->Release();
+        m_cache = nullptr;
+    }
+    m_cacheColumns = 0;
+    m_cacheRows = 0;
+    m_cacheValid = false;
 }
 
 void GraphRenderer::renderGrid(float x, float y, float width, float height, double minFPS, double maxFPS) {
@@ -156,4 +644,44 @@ void GraphRenderer::renderGrid(float x, float y, float width, float height, doub
     }
 }
 
+ID2D1PathGeometry* GraphRenderer::buildGeometry(size_t count, bool closed, float baseline) const {
+    ID2D1PathGeometry* geometry = nullptr;
+    if (FAILED(m_factory->CreatePathGeometry(&geometry))) {
+        return nullptr;
+    }
+
+    ID2D1GeometrySink* sink = nullptr;
+    if (FAILED(geometry->Open(&sink))) {
+        geometry->Release();
+        return nullptr;
+    }
+
+    const D2D1_POINT_2F* points = m_points.data();
+    UINT32 pointCount = static_cast<UINT32>(count);
+
+    if (closed) {
+        // Down to the baseline at both ends so the area closes under the line
+        sink->BeginFigure(D2D1::Point2F(points[0].x, baseline), D2D1_FIGURE_BEGIN_FILLED);
+        sink->AddLines(points, pointCount);
+        sink->AddLine(D2D1::Point2F(points[count - 1].x, baseline));
+        sink->EndFigure(D2D1_FIGURE_END_CLOSED);
+    } else {
+        sink->BeginFigure(points[0], D2D1_FIGURE_BEGIN_HOLLOW);
+        if (pointCount > 1) {
+            sink->AddLines(points + 1, pointCount - 1);
+        }
+        sink->EndFigure(D2D1_FIGURE_END_OPEN);
+    }
+
+    HRESULT hr = sink->Close();
+    sink->Release();
+
+    if (FAILED(hr)) {
+        geometry->Release();
+        return nullptr;
+    }
+
+    return geometry;
+}
+
 } // namespace fps_monitor
@@ -1,7 +1,14 @@
 #pragma once
 
 #include <d2d1.h>
+#include <cstdint>
 #include <vector>
+#include "sample_view.h"
+#include "history_tiers.h"
+#include "stutter_analyzer.h"
+#include "graph_decimator.h"
+#include "damage_tracker.h"
+#include "resource_cache.h"
 
 namespace fps_monitor {
 
@@ -9,7 +16,26 @@ namespace fps_monitor {
  * @brief Live FPS graph rendering
  * 
  * Renders anti-aliased line graphs with auto-scaling and drop markers.
- * Optimized for smooth 60 FPS rendering.
+ * The whole polyline is built into one path geometry per frame from a
+ * preallocated point array and drawn with a single call, with an optional
+ * filled area underneath. Optimized for smooth 60 FPS rendering.
+ * 
+ * When the history is decimated to one bucket per pixel column, completed
+ * columns are drawn once into an offscreen bitmap used as a ring (column =
+ * bucket % width). Each frame only newly completed columns are drawn into
+ * it; the ring is blitted in two pieces and the still-filling newest column
+ * is drawn directly. The Y scale is snapped to coarse steps while cached so
+ * the bitmap only needs a full redraw when the snapped scale changes. Per-
+ * frame cost is then independent of history length.
+ * 
+ * Brushes are handles into the renderer's ResourceCache and are resolved
+ * at the start of every render(); the column cache is dropped when the
+ * cache reports a new target generation (device lost).
+ * 
+ * Spans longer than the frame window are drawn from a HistoryTiers tier
+ * instead (renderHistory()): one min/max pair per pixel column, like the
+ * decimated graph, built directly each frame since buckets arrive at most
+ * ten times a second.
  */
 class GraphRenderer {
 public:
@@ -26,22 +52,106 @@ public:
     /**
      * @brief Initialize the graph renderer
      * 
-     * @param renderTarget D2D render target
+     * @param resources Resource cache of the D2D renderer (must have a target)
      * @return true if initialized successfully
      * @return false otherwise
      */
-    bool initialize(ID2D1HwndRenderTarget* renderTarget);
+    bool initialize(ResourceCache* resources);
 
     /**
      * @brief Render the FPS graph
      * 
-     * @param samples FPS samples to render (oldest to newest)
+     * When there are more samples than pixel columns, each column is drawn
+     * from the min/max of its samples (GraphDecimator) so spikes survive.
+     * 
+     * @param samples Frame times in QPC ticks to render (oldest to newest)
+     * @param totalSamples Samples produced since the source was reset
+     *                     (FpsCalculator::getTotalSamples())
+     * @param tickFrequency Ticks per second of the samples
+     * @param sampleMin Minimum of samples (e.g. FpsCalculator::getMinFPS())
+     * @param sampleMax Maximum of samples (e.g. FpsCalculator::getMaxFPS())
+     * @param x X position
+     * @param y Y position
+     * @param width Graph width
+     * @param height Graph height
+     */
+    void render(const SampleView<uint32_t>& samples, uint64_t totalSamples, int64_t tickFrequency,
+                double sampleMin, double sampleMax,
+                float x, float y, float width, float height);
+
+    /**
+     * @brief Add the graph area to the damage if the next render() changes it
+     * 
+     * The graph changes when new samples arrived or the auto-scale is still
+     * easing towards its target.
+     * 
+     * @param totalSamples Samples produced since the source was reset
+     * @param sampleMin Minimum of samples
+     * @param sampleMax Maximum of samples
+     * @param x X position
+     * @param y Y position
+     * @param width Graph width
+     * @param height Graph height
+     * @param damage Frame damage to add to
+     */
+    void trackDamage(uint64_t totalSamples, double sampleMin, double sampleMax,
+                     float x, float y, float width, float height, DamageTracker& damage);
+
+    /**
+     * @brief Mark stutters on the frame-time graph
+     * 
+     * Draws a vertical line in the drop marker colour at every stutter
+     * still in the window, aligned with render()'s points (wider for
+     * frames that missed several refreshes). Call after render().
+     * 
+     * @param stutters Recent stutters (oldest to newest)
+     * @param totalSamples Samples produced since the source was reset
+     * @param sampleCount Samples in the graphed window
+     * @param x X position
+     * @param y Y position
+     * @param width Graph width
+     * @param height Graph height
+     */
+    void renderMarkers(const SampleView<StutterAnalyzer::Stutter>& stutters, uint64_t totalSamples,
+                       size_t sampleCount, float x, float y, float width, float height);
+
+    /**
+     * @brief Render a span of aggregated history
+     * 
+     * The newest bucket is at the right edge and the span fills the width,
+     * so a shorter history starts part way across. Each pixel column spans
+     * its buckets' shortest to longest frame; intervals without a frame
+     * drop to the bottom.
+     * 
+     * @param buckets Buckets of one tier (oldest to newest)
+     * @param bucketSeconds Duration of a bucket (HistoryTiers::getBucketSeconds())
+     * @param viewSeconds Displayed span
+     * @param tickFrequency Ticks per second of the frame times
+     * @param x X position
+     * @param y Y position
+     * @param width Graph width
+     * @param height Graph height
+     */
+    void renderHistory(const SampleView<HistoryTiers::Bucket>& buckets, double bucketSeconds, double viewSeconds,
+                       int64_t tickFrequency, float x, float y, float width, float height);
+
+    /**
+     * @brief Add the graph area to the damage if the next renderHistory() changes it
+     * 
+     * @param buckets Buckets of one tier (oldest to newest)
+     * @param totalBuckets Buckets the tier closed since the last reset
+     * @param bucketSeconds Duration of a bucket
+     * @param viewSeconds Displayed span
+     * @param tickFrequency Ticks per second of the frame times
      * @param x X position
      * @param y Y position
      * @param width Graph width
      * @param height Graph height
+     * @param damage Frame damage to add to
      */
-    void render(const std::vector<double>& samples, float x, float y, float width, float height);
+    void trackHistoryDamage(const SampleView<HistoryTiers::Bucket>& buckets, uint64_t totalBuckets,
+                            double bucketSeconds, double viewSeconds, int64_t tickFrequency,
+                            float x, float y, float width, float height, DamageTracker& damage);
 
     /**
      * @brief Set graph colors
@@ -49,7 +159,8 @@ public:
      * @param lineColor Line color brush
      * @param fillColor Fill color brush (optional)
      */
-    void setColors(ID2D1SolidColorBrush* lineColor, ID2D1SolidColorBrush* fillColor = nullptr);
+    void setColors(ResourceCache::BrushHandle lineColor,
+                   ResourceCache::BrushHandle fillColor = ResourceCache::INVALID_BRUSH);
 
     /**
      * @brief Enable/disable grid rendering
@@ -58,29 +169,162 @@ public:
      */
     void setShowGrid(bool enabled);
 
+    /**
+     * @brief Enable/disable the filled area under the line
+     * 
+     * Uses the fill brush passed to setColors(). Changing it redraws the
+     * column cache on the next frame.
+     * 
+     * @param enabled Fill enabled state
+     */
+    void setShowFill(bool enabled);
+
     /**
      * @brief Set line width
      * 
+     * Changing it redraws the column cache on the next frame.
+     * 
      * @param width Line width in pixels
      */
     void setLineWidth(float width);
 
+    /**
+     * @brief Pre-size per-frame scratch storage
+     * 
+     * Call once with the largest sample window so render() never allocates.
+     * 
+     * @param maxSamples Largest number of samples passed to render()
+     */
+    void setMaxSamples(size_t maxSamples);
+
     /**
      * @brief Set drop marker brush
      * 
      * @param brush Brush for drop markers
      */
-    void setDropMarkerBrush(ID2D1SolidColorBrush* brush);
+    void setDropMarkerBrush(ResourceCache::BrushHandle brush);
 
 private:
+    /**
+     * @brief Pick up the current target and resolve this frame's brushes
+     * 
+     * Drops the column cache if the target changed since the last frame.
+     * 
+     * @return true if the target and line brush are available
+     * @return false otherwise (nothing can be drawn)
+     */
+    bool bindResources();
+
+    /**
+     * @brief Get the buckets inside the displayed span
+     * 
+     * @param buckets Buckets of one tier
+     * @param bucketSeconds Duration of a bucket
+     * @param viewSeconds Displayed span
+     * @param viewBuckets Output span in buckets
+     * @return SampleView<HistoryTiers::Bucket> Newest buckets of the span
+     */
+    static SampleView<HistoryTiers::Bucket> visibleBuckets(const SampleView<HistoryTiers::Bucket>& buckets,
+                                                           double bucketSeconds, double viewSeconds,
+                                                           size_t& viewBuckets);
+
+    /**
+     * @brief Get the FPS range of the non-empty buckets
+     * 
+     * @param buckets Buckets to scan
+     * @param tickFrequency Ticks per second of the frame times
+     * @param sampleMin Output lowest FPS (longest frame)
+     * @param sampleMax Output highest FPS (shortest frame)
+     * @return true if any bucket has frames
+     * @return false otherwise
+     */
+    static bool bucketRange(const SampleView<HistoryTiers::Bucket>& buckets, int64_t tickFrequency,
+                            double& sampleMin, double& sampleMax);
+
     /**
      * @brief Calculate auto-scale values
      * 
-     * @param samples Sample data
+     * O(1): uses the precomputed sample extrema instead of scanning.
+     * 
+     * @param sampleMin Minimum sample value
+     * @param sampleMax Maximum sample value
      * @param minFPS Output minimum FPS
      * @param maxFPS Output maximum FPS
      */
-    void calculateScale(const std::vector<double>& samples, double& minFPS, double& maxFPS);
+    void calculateScale(double sampleMin, double sampleMax, double& minFPS, double& maxFPS);
+
+    /**
+     * @brief Add padding and enforce a minimum range around the extrema
+     * 
+     * @param sampleMin Minimum sample value
+     * @param sampleMax Maximum sample value
+     * @param minFPS Output minimum FPS
+     * @param maxFPS Output maximum FPS
+     */
+    static void paddedRange(double sampleMin, double sampleMax, double& minFPS, double& maxFPS);
+
+    /**
+     * @brief Pick the cached-graph scale, keeping the current one while it fits
+     * 
+     * @param sampleMin Minimum sample value
+     * @param sampleMax Maximum sample value
+     * @return true if the snapped scale changed (cache must be redrawn)
+     * @return false if the current snapped scale still fits
+     */
+    bool updateSnappedScale(double sampleMin, double sampleMax);
+
+    /**
+     * @brief Render the decimated graph through the column cache
+     * 
+     * @param totalSamples Samples produced since the source was reset
+     * @param tickFrequency Ticks per second of the samples
+     * @param x X position
+     * @param y Y position
+     * @param columns Graph width in whole pixels
+     * @param height Graph height
+     * @return true if rendered
+     * @return false if the cache is unavailable (caller draws directly)
+     */
+    bool renderCached(uint64_t totalSamples, int64_t tickFrequency,
+                      float x, float y, size_t columns, float height);
+
+    /**
+     * @brief (Re)create the cache bitmap if its size changed
+     * 
+     * @param columns Width in pixels
+     * @param rows Height in pixels
+     * @return true if the cache is usable
+     * @return false otherwise
+     */
+    bool ensureCache(UINT32 columns, UINT32 rows);
+
+    /**
+     * @brief Draw completed buckets into their cache columns
+     * 
+     * Splits at the ring wrap; each piece is clipped to its columns and
+     * cleared before drawing. Must be called between the cache's
+     * BeginDraw/EndDraw, with m_pointY holding cache-space Y coordinates
+     * for the decimator output.
+     * 
+     * @param fromBucket First bucket to draw
+     * @param toBucket One past the last bucket to draw
+     * @param baseline Y coordinate of the graph bottom in the cache
+     */
+    void drawCacheColumns(uint64_t fromBucket, uint64_t toBucket, float baseline);
+
+    /**
+     * @brief Draw the fill (if enabled) and line for m_points
+     * 
+     * @param target Render target to draw on
+     * @param count Number of points in m_points
+     * @param baseline Y coordinate of the graph bottom
+     */
+    void drawShape(ID2D1RenderTarget* target, size_t count, float baseline);
+
+    /**
+     * @brief Release the cache bitmap and target
+     */
+    void releaseCache();
 
     /**
      * @brief Render grid lines
@@ -94,16 +338,52 @@ private:
      */
     void renderGrid(float x, float y, float width, float height, double minFPS, double maxFPS);
 
-    ID2D1HwndRenderTarget* m_renderTarget;  ///< Render target
-    ID2D1SolidColorBrush* m_lineColor;      ///< Line color
-    ID2D1SolidColorBrush* m_fillColor;      ///< Fill color
-    ID2D1SolidColorBrush* m_dropMarker;     ///< Drop marker color
-    ID2D1SolidColorBrush* m_gridColor;      ///< Grid color
+    /**
+     * @brief Build a path geometry from the point array
+     * 
+     * @param count Number of points in m_points to use
+     * @param closed true to close the figure down to the baseline (fill),
+     *               false for an open polyline
+     * @param baseline Y coordinate of the graph bottom (closed figures only)
+     * @return ID2D1PathGeometry* New geometry (caller releases), or nullptr on failure
+     */
+    ID2D1PathGeometry* buildGeometry(size_t count, bool closed, float baseline) const;
+
+    ResourceCache* m_resources;             ///< Owner of the target and brushes
+    uint64_t m_generation;                  ///< Target generation the column cache belongs to
+    ID2D1RenderTarget* m_renderTarget;      ///< Render target (refreshed every frame)
+    ID2D1Factory* m_factory;                ///< Factory of the render target (for geometries)
+    ID2D1StrokeStyle* m_strokeStyle;        ///< Round-join stroke for the polyline
+    ResourceCache::BrushHandle m_lineHandle;        ///< Line color
+    ResourceCache::BrushHandle m_fillHandle;        ///< Fill color
+    ResourceCache::BrushHandle m_dropMarkerHandle;  ///< Drop marker color
+    ResourceCache::BrushHandle m_gridHandle;        ///< Grid color
+    ID2D1SolidColorBrush* m_lineColor;      ///< Line brush of this frame
+    ID2D1SolidColorBrush* m_fillColor;      ///< Fill brush of this frame
+    ID2D1SolidColorBrush* m_dropMarker;     ///< Drop marker brush of this frame
+    ID2D1SolidColorBrush* m_gridColor;      ///< Grid brush of this frame
     bool m_showGrid;                        ///< Grid enabled
+    bool m_showFill;                        ///< Fill under line enabled
     float m_lineWidth;                      ///< Line width
     double m_smoothMinFPS;                  ///< Smoothed min for scale transitions
     double m_smoothMaxFPS;                  ///< Smoothed max for scale transitions
+    std::vector<float> m_pointY;            ///< Per-sample Y coordinates (reused every frame)
+    std::vector<D2D1_POINT_2F> m_points;    ///< Polyline points (reused every frame)
+    std::vector<uint32_t> m_columnTicks;    ///< History columns: longest/shortest frame pairs
+    std::vector<float> m_columnX;           ///< History columns: X of each pair
+    GraphDecimator m_decimator;             ///< Per-column min/max cache
+    ID2D1BitmapRenderTarget* m_cache;       ///< Column ring (compatible render target)
+    ID2D1Bitmap* m_cacheBitmap;             ///< Bitmap of m_cache
+    UINT32 m_cacheColumns;                  ///< Cache width in pixels (= ring size in buckets)
+    UINT32 m_cacheRows;                     ///< Cache height in pixels
+    uint64_t m_cacheEnd;                    ///< Buckets below this are drawn in the cache
+    uint64_t m_cacheTotal;                  ///< totalSamples when the cache was last updated
+    bool m_cacheValid;                      ///< Cache contents usable
+    double m_snappedMinFPS;                 ///< Cached-graph scale bottom
+    double m_snappedMaxFPS;                 ///< Cached-graph scale top
+    uint64_t m_trackedTotal;                ///< totalSamples at the last trackDamage()
     static constexpr double SCALE_SMOOTH_FACTOR = 0.1; ///< Smoothing factor
+    static constexpr double SCALE_SETTLED = 0.01;      ///< Scale considered settled within this many FPS
 };
 
 } // namespace fps_monitor
@@ -0,0 +1,108 @@
+#include "render_device.h"
+
+namespace fps_monitor {
+
+RenderDevice::RenderDevice()
+    : m_factory(nullptr)
+    , m_d3dDevice(nullptr)
+    , m_d2dDevice(nullptr)
+    , m_dcompDevice(nullptr)
+    , m_generation(0)
+{
+}
+
+RenderDevice::~RenderDevice() {
+    shutdown();
+}
+
+bool RenderDevice::initialize() {
+    if (m_factory) {
+        return true;
+    }
+
+    // Create D2D factory (1.1 for device contexts)
+    HRESULT hr = D2D1CreateFactory(
+        D2D1_FACTORY_TYPE_SINGLE_THREADED,
+        &m_factory
+    );
+
+    return SUCCEEDED(hr);
+}
+
+void RenderDevice::shutdown() {
+    releaseDevices();
+
+    if (m_factory) {
+        m_factory->Release();
+        m_factory = nullptr;
+    }
+}
+
+bool RenderDevice::ensureDevices() {
+    if (m_dcompDevice) {
+        return true;
+    }
+    if (!m_factory) {
+        return false;
+    }
+
+    // BGRA support is required for Direct2D interop
+    HRESULT hr = D3D11CreateDevice(
+        nullptr,
+        D3D_DRIVER_TYPE_HARDWARE,
+        nullptr,
+        D3D11_CREATE_DEVICE_BGRA_SUPPORT,
+        nullptr, 0,
+        D3D11_SDK_VERSION,
+        &m_d3dDevice,
+        nullptr,
+        nullptr
+    );
+
+    if (FAILED(hr)) {
+        return false;
+    }
+
+    IDXGIDevice* dxgiDevice = nullptr;
+    hr = m_d3dDevice->QueryInterface(__uuidof(IDXGIDevice), reinterpret_cast<void**>(&dxgiDevice));
+    if (SUCCEEDED(hr)) {
+        hr = m_factory->CreateDevice(dxgiDevice, &m_d2dDevice);
+    }
+    if (SUCCEEDED(hr)) {
+        hr = DCompositionCreateDevice(dxgiDevice, __uuidof(IDCompositionDevice), reinterpret_cast<void**>(&m_dcompDevice));
+    }
+
+    if (dxgiDevice) {
+        dxgiDevice->Release();
+    }
+
+    if (FAILED(hr)) {
+        releaseDevices();
+        return false;
+    }
+    return true;
+}
+
+void RenderDevice::handleDeviceLost() {
+    releaseDevices();
+    ++m_generation;
+}
+
+void RenderDevice::releaseDevices() {
+    // Renderers still holding their targets keep the old devices alive until
+    // they rebuild; these are only this object's references
+    if (m_dcompDevice) {
+        m_dcompDevice->Release();
+        m_dcompDevice = nullptr;
+    }
+    if (m_d2dDevice) {
+        m_d2dDevice->Release();
+        m_d2dDevice = nullptr;
+    }
+    if (m_d3dDevice) {
+        m_d3dDevice->Release();
+        m_d3dDevice = nullptr;
+    }
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <windows.h>
+#include <d2d1_1.h>
+#include <d3d11.h>
+#include <dcomp.h>
+#include <cstdint>
+
+namespace fps_monitor {
+
+/**
+ * @brief Device-level Direct2D/Direct3D objects shared by every overlay window
+ *
+ * Owns the D2D factory and, for the swap chain backend, one D3D11 device
+ * with its D2D device and DirectComposition device. Each D2DRenderer
+ * creates only its window's swap chain, device context and composition
+ * target on top of them, so several overlays cost one GPU device.
+ *
+ * When a renderer reports a lost device, the devices are released and the
+ * generation counter incremented; every renderer whose target belongs to
+ * an older generation rebuilds it (recreating the devices on first use).
+ * All renderers must run on one thread (the factory is single-threaded).
+ */
+class RenderDevice {
+public:
+    /**
+     * @brief Construct an empty Render Device
+     */
+    RenderDevice();
+
+    /**
+     * @brief Destroy the Render Device (releases everything)
+     */
+    ~RenderDevice();
+
+    // Prevent copying (owns COM references)
+    RenderDevice(const RenderDevice&) = delete;
+    RenderDevice& operator=(const RenderDevice&) = delete;
+
+    /**
+     * @brief Create the D2D factory
+     *
+     * @return true if created
+     * @return false otherwise
+     */
+    bool initialize();
+
+    /**
+     * @brief Release the devices and the factory
+     */
+    void shutdown();
+
+    /**
+     * @brief Create the D3D11, D2D and composition devices if not present
+     *
+     * @return true if all three exist
+     * @return false otherwise (the swap chain backend is unavailable)
+     */
+    bool ensureDevices();
+
+    /**
+     * @brief Release the devices after a renderer saw them lost
+     *
+     * Increments the generation; targets of older generations must be
+     * recreated.
+     */
+    void handleDeviceLost();
+
+    /**
+     * @brief Get the device generation
+     *
+     * @return uint64_t Incremented by every handleDeviceLost()
+     */
+    uint64_t getGeneration() const { return m_generation; }
+
+    /**
+     * @brief Get the D2D factory
+     *
+     * @return ID2D1Factory1* Factory (nullptr before initialize())
+     */
+    ID2D1Factory1* getFactory() const { return m_factory; }
+
+    /**
+     * @brief Get the D3D11 device
+     *
+     * @return ID3D11Device* Device (nullptr unless ensureDevices() succeeded)
+     */
+    ID3D11Device* getD3DDevice() const { return m_d3dDevice; }
+
+    /**
+     * @brief Get the D2D device
+     *
+     * @return ID2D1Device* Device (nullptr unless ensureDevices() succeeded)
+     */
+    ID2D1Device* getD2DDevice() const { return m_d2dDevice; }
+
+    /**
+     * @brief Get the DirectComposition device
+     *
+     * @return IDCompositionDevice* Device (nullptr unless ensureDevices() succeeded)
+     */
+    IDCompositionDevice* getCompositionDevice() const { return m_dcompDevice; }
+
+private:
+    /**
+     * @brief Release the D3D11, D2D and composition devices
+     */
+    void releaseDevices();
+
+    ID2D1Factory1* m_factory;                 ///< D2D factory
+    ID3D11Device* m_d3dDevice;                ///< Shared D3D device (swap chain backend)
+    ID2D1Device* m_d2dDevice;                 ///< D2D device on m_d3dDevice
+    IDCompositionDevice* m_dcompDevice;       ///< DirectComposition device on m_d3dDevice
+    uint64_t m_generation;                    ///< Device generation
+};
+
+} // namespace fps_monitor
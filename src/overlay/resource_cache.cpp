@@ -0,0 +1,80 @@
+#include "resource_cache.h"
+#include <cstring>
+
+namespace fps_monitor {
+
+ResourceCache::ResourceCache()
+    : m_brushes{}
+    , m_brushCount(0)
+    , m_renderTarget(nullptr)
+    , m_generation(0)
+{
+}
+
+ResourceCache::~ResourceCache() {
+    releaseBrushes();
+}
+
+ResourceCache::BrushHandle ResourceCache::addBrush(const char* key, const D2D1_COLOR_F& color) {
+    for (size_t i = 0; i < m_brushCount; ++i) {
+        if (std::strcmp(m_brushes[i].key, key) == 0) {
+            setBrushColor(i, color);
+            return i;
+        }
+    }
+
+    if (m_brushCount >= MAX_BRUSHES) {
+        return INVALID_BRUSH;
+    }
+
+    Entry& entry = m_brushes[m_brushCount];
+    entry.key = key;
+    entry.color = color;
+    entry.brush = nullptr;
+    return m_brushCount++;
+}
+
+bool ResourceCache::setBrushColor(BrushHandle handle, const D2D1_COLOR_F& color) {
+    if (handle >= m_brushCount) {
+        return false;
+    }
+
+    Entry& entry = m_brushes[handle];
+    entry.color = color;
+    if (entry.brush) {
+        entry.brush->SetColor(color);
+    }
+    return true;
+}
+
+ID2D1SolidColorBrush* ResourceCache::getBrush(BrushHandle handle) {
+    if (handle >= m_brushCount || !m_renderTarget) {
+        return nullptr;
+    }
+
+    Entry& entry = m_brushes[handle];
+    if (!entry.brush) {
+        // First use on this target
+        if (FAILED(m_renderTarget->CreateSolidColorBrush(entry.color, &entry.brush))) {
+            entry.brush = nullptr;
+        }
+    }
+    return entry.brush;
+}
+
+void ResourceCache::attach(ID2D1RenderTarget* renderTarget) {
+    releaseBrushes();
+    m_renderTarget = renderTarget;
+    ++m_generation;
+}
+
+void ResourceCache::releaseBrushes() {
+    for (size_t i = 0; i < m_brushCount; ++i) {
+        if (m_brushes[i].brush) {
+            m_brushes[i].brush->Release();
+            m_brushes[i].brush = nullptr;
+        }
+    }
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <d2d1.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace fps_monitor {
+
+/**
+ * @brief Owner of the device-dependent Direct2D resources
+ *
+ * Brushes belong to the render target that created them and die with it
+ * (device lost, GPU switch, backend change). Instead of holding brush
+ * pointers, renderers register a brush once under a key (the theme colour
+ * name) and keep the returned handle; getBrush() resolves a handle to the
+ * brush of the current target, creating it on first use.
+ *
+ * When the target is replaced every brush is released and rebuilt lazily
+ * from its stored colour, and the generation counter is bumped so
+ * renderers with device resources of their own (e.g. the graph's column
+ * cache) know to drop them. Registering an existing key again only
+ * changes its colour in place, so re-applying a theme creates nothing.
+ *
+ * Storage is fixed; lookups neither allocate nor search.
+ */
+class ResourceCache {
+public:
+    using BrushHandle = size_t;
+
+    static constexpr size_t MAX_BRUSHES = 16;               ///< Registered brushes
+    static constexpr BrushHandle INVALID_BRUSH = SIZE_MAX;  ///< addBrush() failure / no brush
+
+    /**
+     * @brief Construct an empty Resource Cache
+     */
+    ResourceCache();
+
+    /**
+     * @brief Destroy the Resource Cache and release its brushes
+     */
+    ~ResourceCache();
+
+    // Prevent copying (owns the brushes)
+    ResourceCache(const ResourceCache&) = delete;
+    ResourceCache& operator=(const ResourceCache&) = delete;
+
+    /**
+     * @brief Register a solid colour brush, or recolour an existing one
+     *
+     * @param key Stable name of the brush (e.g. "graph_line"); must outlive the cache
+     * @param color Brush colour
+     * @return BrushHandle Handle for getBrush(), or INVALID_BRUSH if the cache is full
+     */
+    BrushHandle addBrush(const char* key, const D2D1_COLOR_F& color);
+
+    /**
+     * @brief Change the colour of a registered brush
+     *
+     * The existing brush is updated with SetColor; nothing is recreated.
+     *
+     * @param handle Handle from addBrush()
+     * @param color New colour
+     * @return true if the handle is valid
+     * @return false otherwise
+     */
+    bool setBrushColor(BrushHandle handle, const D2D1_COLOR_F& color);
+
+    /**
+     * @brief Resolve a handle to the brush of the current target
+     *
+     * Creates the brush if the target changed since it was last used.
+     *
+     * @param handle Handle from addBrush()
+     * @return ID2D1SolidColorBrush* Brush (owned by the cache), or nullptr
+     *         for an invalid handle or without a target
+     */
+    ID2D1SolidColorBrush* getBrush(BrushHandle handle);
+
+    /**
+     * @brief Switch to a new render target
+     *
+     * Releases every device resource of the previous target; brushes are
+     * recreated on their next getBrush(). Called by D2DRenderer whenever
+     * it creates or releases its target.
+     *
+     * @param renderTarget New target (nullptr while there is none)
+     */
+    void attach(ID2D1RenderTarget* renderTarget);
+
+    /**
+     * @brief Get the current render target
+     *
+     * @return ID2D1RenderTarget* Target, or nullptr while it is being rebuilt
+     */
+    ID2D1RenderTarget* getRenderTarget() const { return m_renderTarget; }
+
+    /**
+     * @brief Get the number of targets attached so far
+     *
+     * Changes whenever device resources created on the previous target
+     * became invalid.
+     *
+     * @return uint64_t Target generation
+     */
+    uint64_t getGeneration() const { return m_generation; }
+
+private:
+    /**
+     * @brief One registered brush
+     */
+    struct Entry {
+        const char* key;                ///< Registration key
+        D2D1_COLOR_F color;             ///< Colour to (re)create the brush with
+        ID2D1SolidColorBrush* brush;    ///< Brush on the current target (nullptr until used)
+    };
+
+    /**
+     * @brief Release all brushes (their colours stay registered)
+     */
+    void releaseBrushes();
+
+    Entry m_brushes[MAX_BRUSHES];       ///< Registered brushes
+    size_t m_brushCount;                ///< Entries in use
+    ID2D1RenderTarget* m_renderTarget;  ///< Current target (owned by D2DRenderer)
+    uint64_t m_generation;              ///< Incremented by attach()
+};
+
+} // namespace fps_monitor
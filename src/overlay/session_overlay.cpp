@@ -0,0 +1,162 @@
+#include "session_overlay.h"
+#include <algorithm>
+
+namespace fps_monitor {
+
+SessionOverlay::SessionOverlay()
+    : m_theme(nullptr)
+    , m_width(0.0f)
+    , m_height(0.0f)
+{
+    for (ResourceCache::BrushHandle& handle : m_brushes) {
+        handle = ResourceCache::INVALID_BRUSH;
+    }
+}
+
+SessionOverlay::~SessionOverlay() {
+    // Renderers hold resources of the window's target: release them first
+    m_text.reset();
+    m_graph.reset();
+    m_renderer.reset();
+    m_window.reset();
+}
+
+bool SessionOverlay::create(RenderDevice* device, D2DRenderer::Backend backend, const ThemeManager* theme,
+                            const Layout& layout, const std::string& label) {
+    if (!device || !theme) {
+        return false;
+    }
+
+    m_theme = theme;
+    m_width = static_cast<float>(layout.width);
+    m_height = static_cast<float>(layout.height);
+
+    // Executable names are ASCII in practice; widen byte by byte
+    m_label.assign(label.begin(), label.end());
+
+    m_window = std::make_unique<WindowManager>();
+    bool noRedirection = (backend == D2DRenderer::Backend::SwapChain);
+    if (!m_window->create(layout.width, layout.height, layout.x, layout.y, noRedirection)) {
+        return false;
+    }
+
+    m_renderer = std::make_unique<D2DRenderer>();
+    if (!m_renderer->initialize(device, m_window->getHandle(), backend)) {
+        return false;
+    }
+    m_damage.setBounds(m_width, m_height);
+
+    m_graph = std::make_unique<GraphRenderer>();
+    if (!m_graph->initialize(&m_renderer->getResources())) {
+        return false;
+    }
+    m_graph->setMaxSamples(std::min(layout.maxSamples, AnalysisSnapshot::CAPACITY));
+    setGraphStyle(layout.showGrid, layout.showFill, layout.lineWidth);
+
+    const ThemeManager::Palette& palette = m_theme->getPalette();
+    m_text = std::make_unique<TextRenderer>();
+    if (!m_text->initialize(&m_renderer->getResources(), palette.fontFamily, palette.fontSize)) {
+        return false;
+    }
+
+    registerBrushes();
+    return true;
+}
+
+void SessionOverlay::setVisible(bool visible) {
+    if (!m_window || visible == m_window->isVisible()) {
+        return;
+    }
+
+    if (visible) {
+        m_window->show();
+        m_damage.invalidateAll();
+    } else {
+        m_window->hide();
+    }
+}
+
+void SessionOverlay::setGraphStyle(bool showGrid, bool showFill, float lineWidth) {
+    if (!m_graph) {
+        return;
+    }
+
+    m_graph->setShowGrid(showGrid);
+    m_graph->setShowFill(showFill);
+    m_graph->setLineWidth(lineWidth);
+    m_damage.invalidateAll();
+}
+
+void SessionOverlay::registerBrushes() {
+    if (!m_renderer || !m_theme) {
+        return;
+    }
+
+    // Same keys as the main overlay, so the renderers' defaults take the theme colour
+    ResourceCache& resources = m_renderer->getResources();
+    const ThemeManager::Palette& palette = m_theme->getPalette();
+    for (size_t i = 0; i < ThemeManager::COLOR_COUNT; ++i) {
+        auto role = static_cast<ThemeManager::ColorRole>(i);
+        const ThemeManager::Color& color = palette[role];
+        m_brushes[i] = resources.addBrush(ThemeManager::getColorName(role),
+                                          D2D1::ColorF(color.r, color.g, color.b, color.a));
+    }
+
+    m_graph->setDropMarkerBrush(brush(ThemeManager::ColorRole::DropMarker));
+    m_damage.invalidateAll();
+}
+
+void SessionOverlay::render(const AnalysisSnapshot& snapshot) {
+    if (!m_renderer || !m_renderer->isInitialized() || !m_window->isVisible()) {
+        return;
+    }
+
+    const float graphWidth = m_width - 20.0f;
+    const float graphHeight = m_height - 80.0f;
+    const float statsY = m_height - STATS_Y_OFFSET;
+    const auto& stats = snapshot.stats;
+
+    m_graph->trackDamage(snapshot.totalSamples, snapshot.minFPS, snapshot.maxFPS,
+                         10.0f, 50.0f, graphWidth, graphHeight, m_damage);
+    m_text->trackFPS(snapshot.currentFPS, 10.0f, 5.0f, m_damage);
+    m_text->trackStat(0, stats.average, 10.0f, statsY, m_damage);
+    m_text->trackStat(1, stats.min, 80.0f, statsY, m_damage);
+    m_text->trackStat(2, stats.max, 150.0f, statsY, m_damage);
+
+    if (!m_renderer->beginDraw(m_damage)) {
+        return;
+    }
+
+    const auto& bg = m_theme->getColor(ThemeManager::ColorRole::Background);
+    m_renderer->clear(bg.r, bg.g, bg.b, bg.a);
+
+    SampleView<uint32_t> samples = snapshot.getSampleView();
+    if (!samples.empty()) {
+        m_graph->setColors(brush(ThemeManager::ColorRole::GraphLine), brush(ThemeManager::ColorRole::GraphFill));
+        m_graph->render(samples, snapshot.totalSamples, snapshot.tickFrequency,
+                        snapshot.minFPS, snapshot.maxFPS,
+                        10.0f, 50.0f, graphWidth, graphHeight);
+    }
+
+    // The label never changes; drawing it clipped to the damage is free
+    m_text->renderFPS(snapshot.currentFPS, 10.0f, 5.0f, brush(ThemeManager::ColorRole::TextPrimary));
+    m_text->renderText(m_label, 120.0f, 12.0f, brush(ThemeManager::ColorRole::TextSecondary), false);
+
+    ResourceCache::BrushHandle statsBrush = brush(ThemeManager::ColorRole::TextSecondary);
+    m_text->renderStat(L"AVG:", stats.average, 10.0f, statsY, statsBrush);
+    m_text->renderStat(L"MIN:", stats.min, 80.0f, statsY, statsBrush);
+    m_text->renderStat(L"MAX:", stats.max, 150.0f, statsY, statsBrush);
+
+    if (m_renderer->endDraw()) {
+        m_damage.clear();
+    } else {
+        // Target rebuilt (device lost); draw everything again
+        m_damage.invalidateAll();
+    }
+}
+
+ResourceCache::BrushHandle SessionOverlay::brush(ThemeManager::ColorRole role) const {
+    return m_brushes[static_cast<size_t>(role)];
+}
+
+} // namespace fps_monitor
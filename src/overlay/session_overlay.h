@@ -0,0 +1,123 @@
+#pragma once
+
+#include <windows.h>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "analysis_thread.h"
+#include "damage_tracker.h"
+#include "d2d_renderer.h"
+#include "graph_renderer.h"
+#include "text_renderer.h"
+#include "theme_manager.h"
+#include "window_manager.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Overlay window of one secondary tracking session
+ *
+ * A compact version of the main overlay (process name, FPS, graph and
+ * AVG/MIN/MAX) shown next to a game on its own monitor. The window draws
+ * through the RenderDevice shared with the main overlay and takes its
+ * colours from the same ThemeManager; it never takes input (the main
+ * overlay owns the hotkey).
+ */
+class SessionOverlay {
+public:
+    /**
+     * @brief Window placement and graph style
+     */
+    struct Layout {
+        int x;                  ///< Window X position (virtual screen)
+        int y;                  ///< Window Y position (virtual screen)
+        int width;              ///< Window width
+        int height;             ///< Window height
+        size_t maxSamples;      ///< Largest graph sample window
+        bool showGrid;          ///< Graph grid lines
+        bool showFill;          ///< Graph fill
+        float lineWidth;        ///< Graph line width
+    };
+
+    /**
+     * @brief Construct an empty Session Overlay
+     */
+    SessionOverlay();
+
+    /**
+     * @brief Destroy the Session Overlay (closes its window)
+     */
+    ~SessionOverlay();
+
+    // Prevent copying
+    SessionOverlay(const SessionOverlay&) = delete;
+    SessionOverlay& operator=(const SessionOverlay&) = delete;
+
+    /**
+     * @brief Create the window and its renderers
+     *
+     * @param device Shared render device (must outlive the overlay)
+     * @param backend Presentation backend of the main overlay
+     * @param theme Theme for colours and font (must outlive the overlay)
+     * @param layout Placement and graph style
+     * @param label Process name shown in the window
+     * @return true if the window can render
+     * @return false otherwise
+     */
+    bool create(RenderDevice* device, D2DRenderer::Backend backend, const ThemeManager* theme,
+                const Layout& layout, const std::string& label);
+
+    /**
+     * @brief Show or hide the window (follows the main overlay)
+     *
+     * @param visible Visibility
+     */
+    void setVisible(bool visible);
+
+    /**
+     * @brief Apply reloaded graph settings
+     *
+     * @param showGrid Graph grid lines
+     * @param showFill Graph fill
+     * @param lineWidth Graph line width
+     */
+    void setGraphStyle(bool showGrid, bool showFill, float lineWidth);
+
+    /**
+     * @brief Re-register the theme colours (after a theme reload)
+     */
+    void registerBrushes();
+
+    /**
+     * @brief Draw a snapshot of the session
+     *
+     * Only the regions that changed since the last frame are redrawn.
+     *
+     * @param snapshot Session's latest snapshot
+     */
+    void render(const AnalysisSnapshot& snapshot);
+
+private:
+    static constexpr float STATS_Y_OFFSET = 20.0f;  ///< Stats line distance from the bottom
+
+    /**
+     * @brief Get the brush of a theme colour
+     *
+     * @param role Colour role
+     * @return ResourceCache::BrushHandle Brush handle
+     */
+    ResourceCache::BrushHandle brush(ThemeManager::ColorRole role) const;
+
+    std::unique_ptr<WindowManager> m_window;        ///< Overlay window
+    std::unique_ptr<D2DRenderer> m_renderer;        ///< Window target on the shared device
+    std::unique_ptr<GraphRenderer> m_graph;         ///< FPS graph
+    std::unique_ptr<TextRenderer> m_text;           ///< Label, FPS and stats
+    const ThemeManager* m_theme;                    ///< Colours (not owned)
+    DamageTracker m_damage;                         ///< Changes since the last frame
+    ResourceCache::BrushHandle m_brushes[ThemeManager::COLOR_COUNT];    ///< Theme brushes by ColorRole
+    std::wstring m_label;                           ///< Process name
+    float m_width;                                  ///< Client width
+    float m_height;                                 ///< Client height
+};
+
+} // namespace fps_monitor
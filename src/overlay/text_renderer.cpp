@@ -1,6 +1,7 @@
 #include "text_renderer.h"
-#include <sstream>
-#include <iomanip>
+#include <charconv>
+#include <cstring>
+#include <cwchar>
 
 namespace fps_monitor {
 
@@ -8,10 +9,15 @@ TextRenderer::TextRenderer()
     : m_writeFactory(nullptr)
     , m_textFormat(nullptr)
     , m_largeTextFormat(nullptr)
-    , m_renderTarget(nullptr)
-    , m_shadowBrush(nullptr)
+    , m_resources(nullptr)
+    , m_shadowBrush(ResourceCache::INVALID_BRUSH)
+    , m_labelCount(0)
     , m_fontSize(14.0f)
 {
+    m_fpsText[0] = '\0';
+    for (size_t i = 0; i < MAX_STAT_SLOTS; ++i) {
+        m_statText[i][0] = '\0';
+    }
 }
 
 TextRenderer::~TextRenderer() {
@@ -20,12 +26,12 @@ TextRenderer::~TextRenderer() {
     if (m_writeFactory) m_writeFactory->Release();
 }
 
-bool TextRenderer::initialize(ID2D1HwndRenderTarget* renderTarget, const std::wstring& fontFamily, float fontSize) {
-    if (!renderTarget) {
+bool TextRenderer::initialize(ResourceCache* resources, const std::wstring& fontFamily, float fontSize) {
+    if (!resources) {
         return false;
     }
 
-    m_renderTarget = renderTarget;
+    m_resources = resources;
     m_fontSize = fontSize;
 
     // Create DirectWrite factory
@@ -71,90 +77,180 @@ bool TextRenderer::initialize(ID2D1HwndRenderTarget* renderTarget, const std::ws
         return false;
     }
 
-    // Create default shadow brush
-    m_renderTarget->CreateSolidColorBrush(
-        D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.8f),
-        &m_shadowBrush
-    );
+    // Resolve digit and label glyphs once; without them text falls back to DrawText
+    m_glyphs.initialize(m_writeFactory, m_textFormat);
+    m_largeGlyphs.initialize(m_writeFactory, m_largeTextFormat);
+
+    // Register default shadow brush
+    m_shadowBrush = m_resources->addBrush("text_shadow", D2D1::ColorF(0.0f, 0.0f, 0.0f, 0.8f));
 
     return true;
 }
 
-void TextRenderer::renderFPS(double fps, float x, float y, ID2D1SolidColorBrush* brush) {
-    if (!m_renderTarget || !m_largeTextFormat || !brush) {
+void TextRenderer::renderFPS(double fps, float x, float y, ResourceCache::BrushHandle brush) {
+    ID2D1RenderTarget* target = nullptr;
+    ID2D1SolidColorBrush* textBrush = nullptr;
+    ID2D1SolidColorBrush* shadowBrush = nullptr;
+    if (!m_largeTextFormat || !bindResources(brush, target, textBrush, shadowBrush)) {
         return;
     }
 
-    std::wostringstream oss;
-    oss << std::fixed << std::setprecision(0) << fps;
-    std::wstring text = oss.str();
+    char text[NUMBER_CHARS];
+    size_t length = formatNumber(fps, 0, text);
 
-    D2D1_RECT_F rect = D2D1::RectF(x, y, x + 200.0f, y + 100.0f);
-
-    // Draw shadow
-    if (m_shadowBrush) {
-        D2D1_RECT_F shadowRect = D2D1::RectF(x + 2, y + 2, x + 202.0f, y + 102.0f);
-        m_renderTarget->DrawText(
-            text.c_str(),
-            static_cast<UINT32>(text.length()),
-            m_largeTextFormat,
-            shadowRect,
-            m_shadowBrush
-        );
+    if (m_largeGlyphs.isInitialized()) {
+        GlyphCache::Run run;
+        m_largeGlyphs.append(text, length, run);
+        m_largeGlyphs.draw(target, run, x, y, textBrush, shadowBrush, 2.0f);
+        return;
     }
 
-    // Draw text
-    m_renderTarget->DrawText(
-        text.c_str(),
-        static_cast<UINT32>(text.length()),
-        m_largeTextFormat,
-        rect,
-        brush
-    );
+    wchar_t wideText[NUMBER_CHARS];
+    for (size_t i = 0; i <= length; ++i) {
+        wideText[i] = static_cast<wchar_t>(text[i]);
+    }
+    drawText(wideText, static_cast<UINT32>(length), m_largeTextFormat,
+             D2D1::RectF(x, y, x + 200.0f, y + 100.0f), target, textBrush, shadowBrush, 2.0f);
 }
 
-void TextRenderer::renderStat(const std::wstring& label, double value, float x, float y, ID2D1SolidColorBrush* brush) {
-    if (!m_renderTarget || !m_textFormat || !brush) {
+void TextRenderer::renderStat(const std::wstring& label, double value, float x, float y,
+                              ResourceCache::BrushHandle brush) {
+    ID2D1RenderTarget* target = nullptr;
+    ID2D1SolidColorBrush* textBrush = nullptr;
+    ID2D1SolidColorBrush* shadowBrush = nullptr;
+    if (!m_textFormat || !bindResources(brush, target, textBrush, shadowBrush)) {
         return;
     }
 
-    std::wostringstream oss;
-    oss << label << L" " << std::fixed << std::setprecision(1) << value;
-    std::wstring text = oss.str();
+    char text[NUMBER_CHARS];
+    size_t length = formatNumber(value, 1, text);
+
+    const GlyphCache::Run* labelRun = findLabel(label);
+    if (labelRun) {
+        GlyphCache::Run run = *labelRun;
+        m_glyphs.append(text, length, run);
+        m_glyphs.draw(target, run, x, y, textBrush, shadowBrush, 1.0f);
+        return;
+    }
 
-    renderText(text, x, y, brush, true);
+    // Uncached label: "LABEL value" through DrawText
+    wchar_t wideText[STAT_LABEL_CHARS + NUMBER_CHARS];
+    int written = std::swprintf(wideText, STAT_LABEL_CHARS + NUMBER_CHARS, L"%ls %hs", label.c_str(), text);
+    if (written > 0) {
+        drawText(wideText, static_cast<UINT32>(written), m_textFormat,
+                 D2D1::RectF(x, y, x + 500.0f, y + 50.0f), target, textBrush, shadowBrush, 1.0f);
+    }
 }
 
-void TextRenderer::renderText(const std::wstring& text, float x, float y, ID2D1SolidColorBrush* brush, bool withShadow) {
-    if (!m_renderTarget || !m_textFormat || !brush) {
+void TextRenderer::renderText(const std::wstring& text, float x, float y, ResourceCache::BrushHandle brush,
+                              bool withShadow) {
+    ID2D1RenderTarget* target = nullptr;
+    ID2D1SolidColorBrush* textBrush = nullptr;
+    ID2D1SolidColorBrush* shadowBrush = nullptr;
+    if (!m_textFormat || !bindResources(brush, target, textBrush, shadowBrush)) {
         return;
     }
 
-    D2D1_RECT_F rect = D2D1::RectF(x, y, x + 500.0f, y + 50.0f);
+    drawText(text.c_str(), static_cast<UINT32>(text.length()), m_textFormat,
+             D2D1::RectF(x, y, x + 500.0f, y + 50.0f), target, textBrush, shadowBrush,
+             withShadow ? 1.0f : 0.0f);
+}
+
+bool TextRenderer::bindResources(ResourceCache::BrushHandle brush, ID2D1RenderTarget*& target,
+                                 ID2D1SolidColorBrush*& textBrush, ID2D1SolidColorBrush*& shadowBrush) {
+    if (!m_resources) {
+        return false;
+    }
 
+    target = m_resources->getRenderTarget();
+    textBrush = m_resources->getBrush(brush);
+    shadowBrush = m_resources->getBrush(m_shadowBrush);
+    return target && textBrush;
+}
+
+void TextRenderer::drawText(const wchar_t* text, UINT32 length, IDWriteTextFormat* format,
+                            const D2D1_RECT_F& rect, ID2D1RenderTarget* target,
+                            ID2D1Brush* brush, ID2D1Brush* shadowBrush, float shadowOffset) {
     // Draw shadow
-    if (withShadow && m_shadowBrush) {
-        D2D1_RECT_F shadowRect = D2D1::RectF(x + 1, y + 1, x + 501.0f, y + 51.0f);
-        m_renderTarget->DrawText(
-            text.c_str(),
-            static_cast<UINT32>(text.length()),
-            m_textFormat,
-            shadowRect,
-            m_shadowBrush
-        );
+    if (shadowOffset > 0.0f && shadowBrush) {
+        D2D1_RECT_F shadowRect = D2D1::RectF(rect.left + shadowOffset, rect.top + shadowOffset,
+                                             rect.right + shadowOffset, rect.bottom + shadowOffset);
+        target->DrawText(text, length, format, shadowRect, shadowBrush);
     }
 
     // Draw text
-    m_renderTarget->DrawText(
-        text.c_str(),
-        static_cast<UINT32>(text.length()),
-        m_textFormat,
-        rect,
-        brush
-    );
+    target->DrawText(text, length, format, rect, brush);
+}
+
+const GlyphCache::Run* TextRenderer::findLabel(const std::wstring& label) {
+    if (!m_glyphs.isInitialized()) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < m_labelCount; ++i) {
+        if (label == m_labels[i].text) {
+            return &m_labels[i].run;
+        }
+    }
+
+    // Leave room for the value after the label
+    if (m_labelCount >= MAX_LABELS || label.length() >= STAT_LABEL_CHARS) {
+        return nullptr;
+    }
+
+    LabelRun& entry = m_labels[m_labelCount++];
+    std::wcscpy(entry.text, label.c_str());
+    entry.run = GlyphCache::Run();
+    m_glyphs.append(label.c_str(), entry.run);
+    m_glyphs.append(L" ", entry.run);
+    return &entry.run;
+}
+
+size_t TextRenderer::formatNumber(double value, int precision, char (&buffer)[NUMBER_CHARS]) {
+    std::to_chars_result result = std::to_chars(buffer, buffer + NUMBER_CHARS - 1, value,
+                                                std::chars_format::fixed, precision);
+    if (result.ec != std::errc()) {
+        // Out of range for the display
+        std::strcpy(buffer, "---");
+        return 3;
+    }
+
+    *result.ptr = '\0';
+    return static_cast<size_t>(result.ptr - buffer);
+}
+
+void TextRenderer::trackFPS(double fps, float x, float y, DamageTracker& damage) {
+    // Same formatting as renderFPS()
+    char text[NUMBER_CHARS];
+    formatNumber(fps, 0, text);
+    if (std::strcmp(text, m_fpsText) == 0) {
+        return;
+    }
+    std::strcpy(m_fpsText, text);
+
+    // Layout width plus the shadow offset
+    float lineHeight = m_fontSize * 2.5f * LINE_HEIGHT;
+    damage.add(D2D1::RectF(x, y, x + 202.0f, y + lineHeight + 2.0f));
+}
+
+void TextRenderer::trackStat(size_t slot, double value, float x, float y, DamageTracker& damage) {
+    if (slot >= MAX_STAT_SLOTS) {
+        return;
+    }
+
+    char text[NUMBER_CHARS];
+    formatNumber(value, 1, text);
+    if (std::strcmp(text, m_statText[slot]) == 0) {
+        return;
+    }
+    std::strcpy(m_statText[slot], text);
+
+    float width = m_fontSize * CHAR_WIDTH * static_cast<float>(STAT_CHARS);
+    float lineHeight = m_fontSize * LINE_HEIGHT;
+    damage.add(D2D1::RectF(x, y, x + width + 1.0f, y + lineHeight + 1.0f));
 }
 
-void TextRenderer::setShadowBrush(ID2D1SolidColorBrush* brush) {
+void TextRenderer::setShadowBrush(ResourceCache::BrushHandle brush) {
     m_shadowBrush = brush;
 }
 
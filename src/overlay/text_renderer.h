@@ -2,7 +2,11 @@
 
 #include <d2d1.h>
 #include <dwrite.h>
+#include <cstddef>
 #include <string>
+#include "damage_tracker.h"
+#include "glyph_cache.h"
+#include "resource_cache.h"
 
 #pragma comment(lib, "dwrite.lib")
 
@@ -13,9 +17,21 @@ namespace fps_monitor {
  * 
  * Renders FPS values and statistics with custom fonts and colors.
  * Includes drop shadow for readability.
+ * 
+ * Numbers and stat labels are drawn as cached glyph runs (GlyphCache):
+ * values are formatted with std::to_chars into fixed buffers and labels
+ * are resolved once, so a frame neither allocates nor lays out text.
+ * The shadow is the same glyph run drawn at an offset.
+ * 
+ * Glyphs and text formats are device-independent; the target and brushes
+ * come from the ResourceCache on every call, so text keeps drawing on the
+ * new target after device loss.
  */
 class TextRenderer {
 public:
+    static constexpr size_t MAX_STAT_SLOTS = 8;     ///< Statistics trackStat() can follow
+    static constexpr size_t MAX_LABELS = 8;         ///< Distinct stat labels kept as glyph runs
+
     /**
      * @brief Construct a new Text Renderer
      */
@@ -29,13 +45,13 @@ public:
     /**
      * @brief Initialize the text renderer
      * 
-     * @param renderTarget D2D render target
+     * @param resources Resource cache of the D2D renderer
      * @param fontFamily Font family name (e.g., "Consolas")
      * @param fontSize Font size
      * @return true if initialized successfully
      * @return false otherwise
      */
-    bool initialize(ID2D1HwndRenderTarget* renderTarget, const std::wstring& fontFamily, float fontSize);
+    bool initialize(ResourceCache* resources, const std::wstring& fontFamily, float fontSize);
 
     /**
      * @brief Render main FPS display (large, prominent)
@@ -45,7 +61,7 @@ public:
      * @param y Y position
      * @param brush Text color brush
      */
-    void renderFPS(double fps, float x, float y, ID2D1SolidColorBrush* brush);
+    void renderFPS(double fps, float x, float y, ResourceCache::BrushHandle brush);
 
     /**
      * @brief Render statistics text
@@ -56,7 +72,7 @@ public:
      * @param y Y position
      * @param brush Text color brush
      */
-    void renderStat(const std::wstring& label, double value, float x, float y, ID2D1SolidColorBrush* brush);
+    void renderStat(const std::wstring& label, double value, float x, float y, ResourceCache::BrushHandle brush);
 
     /**
      * @brief Render arbitrary text
@@ -67,22 +83,114 @@ public:
      * @param brush Text color brush
      * @param withShadow Add drop shadow
      */
-    void renderText(const std::wstring& text, float x, float y, ID2D1SolidColorBrush* brush, bool withShadow = true);
+    void renderText(const std::wstring& text, float x, float y, ResourceCache::BrushHandle brush,
+                    bool withShadow = true);
+
+    /**
+     * @brief Add the FPS area to the damage if its displayed digits changed
+     * 
+     * Compares the text renderFPS() would draw with the text at the
+     * previous call; call once per frame before drawing.
+     * 
+     * @param fps FPS value to display
+     * @param x X position
+     * @param y Y position
+     * @param damage Frame damage to add to
+     */
+    void trackFPS(double fps, float x, float y, DamageTracker& damage);
+
+    /**
+     * @brief Add a statistic's area to the damage if its displayed value changed
+     * 
+     * @param slot Statistic index (below MAX_STAT_SLOTS), one per renderStat() call site
+     * @param value Value to display
+     * @param x X position
+     * @param y Y position
+     * @param damage Frame damage to add to
+     */
+    void trackStat(size_t slot, double value, float x, float y, DamageTracker& damage);
 
     /**
      * @brief Set shadow color
      * 
      * @param brush Shadow brush
      */
-    void setShadowBrush(ID2D1SolidColorBrush* brush);
+    void setShadowBrush(ResourceCache::BrushHandle brush);
 
 private:
+    static constexpr size_t STAT_LABEL_CHARS = 12;  ///< Longest cached label (with terminator)
+    static constexpr size_t NUMBER_CHARS = 16;      ///< Formatted number buffer size
+
+    /**
+     * @brief A stat label resolved to glyphs (including the trailing space)
+     */
+    struct LabelRun {
+        wchar_t text[STAT_LABEL_CHARS];     ///< Label as passed to renderStat()
+        GlyphCache::Run run;                ///< Label glyphs followed by a space
+    };
+
+    /**
+     * @brief Format a value with a fixed number of decimals
+     * 
+     * @param value Value to format
+     * @param precision Decimals
+     * @param buffer Output (null-terminated)
+     * @return size_t Characters written (excluding the terminator)
+     */
+    static size_t formatNumber(double value, int precision, char (&buffer)[NUMBER_CHARS]);
+
+    /**
+     * @brief Find (or resolve and cache) the glyph run of a stat label
+     * 
+     * @param label Label text
+     * @return const GlyphCache::Run* Label run, or nullptr if it cannot be cached
+     */
+    const GlyphCache::Run* findLabel(const std::wstring& label);
+
+    /**
+     * @brief Resolve the target and brushes for one draw call
+     * 
+     * @param brush Text brush handle
+     * @param target Output render target
+     * @param textBrush Output text brush
+     * @param shadowBrush Output shadow brush (nullptr if none)
+     * @return true if the target and text brush are available
+     * @return false otherwise
+     */
+    bool bindResources(ResourceCache::BrushHandle brush, ID2D1RenderTarget*& target,
+                       ID2D1SolidColorBrush*& textBrush, ID2D1SolidColorBrush*& shadowBrush);
+
+    /**
+     * @brief Draw text through DrawText (used when no glyph cache is available)
+     * 
+     * @param text Characters to draw
+     * @param length Number of characters
+     * @param format Text format
+     * @param rect Layout rectangle
+     * @param target Render target
+     * @param brush Text brush
+     * @param shadowBrush Shadow brush (nullptr for no shadow)
+     * @param shadowOffset Shadow offset in DIPs (0 for no shadow)
+     */
+    static void drawText(const wchar_t* text, UINT32 length, IDWriteTextFormat* format,
+                         const D2D1_RECT_F& rect, ID2D1RenderTarget* target,
+                         ID2D1Brush* brush, ID2D1Brush* shadowBrush, float shadowOffset);
+
     IDWriteFactory* m_writeFactory;           ///< DirectWrite factory
     IDWriteTextFormat* m_textFormat;          ///< Normal text format
     IDWriteTextFormat* m_largeTextFormat;     ///< Large text format (for FPS)
-    ID2D1HwndRenderTarget* m_renderTarget;    ///< Render target
-    ID2D1SolidColorBrush* m_shadowBrush;      ///< Shadow brush
+    ResourceCache* m_resources;               ///< Owner of the target and brushes
+    ResourceCache::BrushHandle m_shadowBrush; ///< Shadow brush
+    GlyphCache m_glyphs;                      ///< Glyphs of the normal format
+    GlyphCache m_largeGlyphs;                 ///< Glyphs of the large format
+    LabelRun m_labels[MAX_LABELS];            ///< Cached stat labels
+    size_t m_labelCount;                      ///< Labels in use
     float m_fontSize;                         ///< Base font size
+    char m_fpsText[NUMBER_CHARS];             ///< FPS text at the last trackFPS()
+    char m_statText[MAX_STAT_SLOTS][NUMBER_CHARS];  ///< Stat values at the last trackStat()
+    static constexpr float LINE_HEIGHT = 1.5f;      ///< Conservative line height (x font size)
+    static constexpr float CHAR_WIDTH = 0.6f;       ///< Conservative glyph advance (x font size)
+    static constexpr size_t STAT_CHARS = 16;        ///< Widest "LABEL: value" text tracked
 };
 
 } // namespace fps_monitor
@@ -2,183 +2,284 @@
 #include <fstream>
 #include <sstream>
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cwchar>
 
 namespace fps_monitor {
 
+namespace {
+
+/// Theme file keys by ColorRole (also the ResourceCache brush keys)
+const char* const COLOR_NAMES[ThemeManager::COLOR_COUNT] = {
+    "background",
+    "graph_line",
+    "graph_fill",
+    "text_primary",
+    "text_secondary",
+    "text_shadow",
+    "drop_marker",
+    "grid_line",
+    "border"
+};
+
+bool keyEquals(const char* key, size_t keyLength, const char* name) {
+    return std::strlen(name) == keyLength && std::memcmp(key, name, keyLength) == 0;
+}
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+float parseFloat(const char* value, size_t length, float fallback) {
+    char buffer[32];
+    if (length == 0 || length >= sizeof(buffer)) {
+        return fallback;
+    }
+    std::memcpy(buffer, value, length);
+    buffer[length] = '\0';
+
+    char* end = nullptr;
+    float result = std::strtof(buffer, &end);
+    return end == buffer ? fallback : result;
+}
+
+} // namespace
+
 ThemeManager::ThemeManager()
-    : m_currentTheme("default")
+    : m_palette(defaultPalette())
+    , m_currentTheme("default")
+    , m_fromFile(false)
 {
-    loadDefaultTheme();
 }
 
 ThemeManager::~ThemeManager() = default;
 
 bool ThemeManager::loadTheme(const std::string& themeName) {
     // Validate theme name to prevent directory traversal
-    if (themeName.empty() || themeName.find("..") != std::string::npos ||
-        themeName.find("/") != std::string::npos || themeName.find("\\") != std::string::npos) {
-        loadDefaultTheme();
+    Palette palette;
+    if (!isValidThemeName(themeName) || !compileTheme(themeName, palette)) {
+        m_palette = defaultPalette();
+        m_currentTheme = "default";
+        m_fromFile = false;
         return false;
     }
-    
-    std::string filename = "resources/themes/" + themeName + ".json";
-    std::ifstream file(filename);
-
-    if (!file.is_open()) {
-        loadDefaultTheme();
-        return false;
-    }
-
-    // Read entire file
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    std::string json = buffer.str();
-
-    // Parse colors (simple parsing for hex colors)
-    m_colors["background"] = parseHexColor(parseJsonValue(json, "background"));
-    m_colors["graph_line"] = parseHexColor(parseJsonValue(json, "graph_line"));
-    m_colors["graph_fill"] = parseHexColor(parseJsonValue(json, "graph_fill"));
-    m_colors["text_primary"] = parseHexColor(parseJsonValue(json, "text_primary"));
-    m_colors["text_secondary"] = parseHexColor(parseJsonValue(json, "text_secondary"));
-    m_colors["text_shadow"] = parseHexColor(parseJsonValue(json, "text_shadow"));
-    m_colors["drop_marker"] = parseHexColor(parseJsonValue(json, "drop_marker"));
-    m_colors["grid_line"] = parseHexColor(parseJsonValue(json, "grid_line"));
-    m_colors["border"] = parseHexColor(parseJsonValue(json, "border"));
-
-    // Parse style properties
-    m_styles["font_family"] = parseJsonValue(json, "font_family");
-    m_styles["font_size"] = parseJsonValue(json, "font_size");
-    m_styles["border_width"] = parseJsonValue(json, "border_width");
-    m_styles["corner_radius"] = parseJsonValue(json, "corner_radius");
-    m_styles["graph_glow"] = parseJsonValue(json, "graph_glow");
 
+    m_palette = palette;
     m_currentTheme = themeName;
+    m_fromFile = true;
     return true;
 }
 
-ThemeManager::Color ThemeManager::getColor(const std::string& colorName) const {
-    auto it = m_colors.find(colorName);
-    if (it != m_colors.end()) {
-        return it->second;
+bool ThemeManager::reloadTheme() {
+    if (!m_fromFile) {
+        return false;
     }
-    return {0.0f, 0.0f, 0.0f, 1.0f}; // Default to black
-}
 
-std::string ThemeManager::getStyleProperty(const std::string& propertyName) const {
-    auto it = m_styles.find(propertyName);
-    if (it != m_styles.end()) {
-        return it->second;
+    // Compile aside; a half-written file keeps the current palette
+    Palette palette;
+    if (!compileTheme(m_currentTheme, palette)) {
+        return false;
     }
-    return "";
+
+    m_palette = palette;
+    return true;
+}
+
+const char* ThemeManager::getColorName(ColorRole role) {
+    size_t index = static_cast<size_t>(role);
+    return index < COLOR_COUNT ? COLOR_NAMES[index] : "";
 }
 
 std::string ThemeManager::getCurrentTheme() const {
     return m_currentTheme;
 }
 
-ThemeManager::Color ThemeManager::parseHexColor(const std::string& hexColor) const {
-    if (hexColor.empty() || hexColor.length() < 2 || hexColor[0] != '#') {
-        return {0.0f, 0.0f, 0.0f, 1.0f};
+std::string ThemeManager::getCurrentThemeFile() const {
+    return m_fromFile ? m_currentTheme + ".json" : std::string();
+}
+
+bool ThemeManager::compileTheme(const std::string& themeName, Palette& palette) {
+    std::string filename = std::string(THEME_DIRECTORY) + "/" + themeName + ".json";
+    std::ifstream file(filename);
+
+    if (!file.is_open()) {
+        return false;
     }
 
-    std::string hex = hexColor.substr(1); // Remove #
-    
-    // Parse RGB or RGBA
-    unsigned int r = 0, g = 0, b = 0, a = 255;
+    // Read entire file
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    palette = defaultPalette();
+    return parseTheme(buffer.str(), palette);
+}
 
-    try {
-        if (hex.length() >= 6) {
-            r = std::stoul(hex.substr(0, 2), nullptr, 16);
-            g = std::stoul(hex.substr(2, 2), nullptr, 16);
-            b = std::stoul(hex.substr(4, 2), nullptr, 16);
+bool ThemeManager::parseTheme(const std::string& json, Palette& palette) {
+    const char* text = json.data();
+    const size_t length = json.size();
+
+    // Pending key, once a string has been followed by ':'
+    const char* key = nullptr;
+    size_t keyLength = 0;
+    int depth = 0;
+    bool sawObject = false;
+    size_t pos = 0;
+
+    while (pos < length) {
+        char c = text[pos];
+
+        if (isSpace(c) || c == ',') {
+            ++pos;
+            continue;
         }
 
-        if (hex.length() >= 8) {
-            a = std::stoul(hex.substr(6, 2), nullptr, 16);
+        if (c == '{' || c == '[') {
+            ++depth;
+            sawObject = true;
+            key = nullptr;
+            ++pos;
+            continue;
         }
-    } catch (const std::exception&) {
-        // Return default on parse error
-        return {0.0f, 0.0f, 0.0f, 1.0f};
-    }
 
-    return {
-        r / 255.0f,
-        g / 255.0f,
-        b / 255.0f,
-        a / 255.0f
-    };
-}
+        if (c == '}' || c == ']') {
+            if (--depth < 0) {
+                return false;
+            }
+            key = nullptr;
+            ++pos;
+            continue;
+        }
+
+        // String or bare literal (number, true, false, null)
+        const char* token = text + pos;
+        size_t tokenLength = 0;
+        if (c == '"') {
+            size_t end = pos + 1;
+            while (end < length && text[end] != '"') {
+                end += (text[end] == '\\') ? 2 : 1;
+            }
+            if (end >= length) {
+                return false; // Unterminated string
+            }
+            token = text + pos + 1;
+            tokenLength = end - pos - 1;
+            pos = end + 1;
+        } else {
+            size_t end = pos;
+            while (end < length && !isSpace(text[end]) && text[end] != ',' &&
+                   text[end] != '}' && text[end] != ']' && text[end] != ':') {
+                ++end;
+            }
+            tokenLength = end - pos;
+            pos = end;
+            if (tokenLength == 0) {
+                return false; // Stray ':'
+            }
+        }
 
-std::string ThemeManager::parseJsonValue(const std::string& json, const std::string& key) const {
-    // Simple JSON parser - finds "key": "value" or "key": value
-    std::string searchKey = "\"" + key + "\"";
-    size_t pos = json.find(searchKey);
+        size_t next = pos;
+        while (next < length && isSpace(text[next])) {
+            ++next;
+        }
 
-    if (pos == std::string::npos) {
-        return "";
+        if (next < length && text[next] == ':') {
+            key = token;
+            keyLength = tokenLength;
+            pos = next + 1;
+        } else if (key) {
+            applyValue(key, keyLength, token, tokenLength, palette);
+            key = nullptr;
+        }
     }
 
-    // Find the colon
-    size_t colonPos = json.find(':', pos);
-    if (colonPos == std::string::npos) {
-        return "";
+    return sawObject && depth == 0;
+}
+
+void ThemeManager::applyValue(const char* key, size_t keyLength, const char* value, size_t valueLength,
+                              Palette& palette) {
+    for (size_t i = 0; i < COLOR_COUNT; ++i) {
+        if (keyEquals(key, keyLength, COLOR_NAMES[i])) {
+            parseHexColor(value, valueLength, palette.colors[i]);
+            return;
+        }
     }
 
-    // Skip whitespace after colon
-    size_t valueStart = colonPos + 1;
-    while (valueStart < json.length() && (json[valueStart] == ' ' || json[valueStart] == '\t' || json[valueStart] == '\n')) {
-        valueStart++;
+    if (keyEquals(key, keyLength, "font_family")) {
+        size_t count = std::min(valueLength, FONT_FAMILY_CHARS - 1);
+        if (count > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                palette.fontFamily[i] = static_cast<wchar_t>(static_cast<unsigned char>(value[i]));
+            }
+            palette.fontFamily[count] = L'\0';
+        }
+    } else if (keyEquals(key, keyLength, "font_size")) {
+        palette.fontSize = parseFloat(value, valueLength, palette.fontSize);
+    } else if (keyEquals(key, keyLength, "border_width")) {
+        palette.borderWidth = parseFloat(value, valueLength, palette.borderWidth);
+    } else if (keyEquals(key, keyLength, "corner_radius")) {
+        palette.cornerRadius = parseFloat(value, valueLength, palette.cornerRadius);
+    } else if (keyEquals(key, keyLength, "graph_glow")) {
+        palette.graphGlow = keyEquals(value, valueLength, "true");
     }
+}
 
-    // Check if value is quoted
-    bool quoted = (json[valueStart] == '"');
-    if (quoted) {
-        valueStart++;
+bool ThemeManager::parseHexColor(const char* hexColor, size_t length, Color& color) {
+    // Parse RGB or RGBA
+    if ((length != 7 && length != 9) || hexColor[0] != '#') {
+        return false;
     }
 
-    // Find end of value
-    size_t valueEnd = valueStart;
-    if (quoted) {
-        valueEnd = json.find('"', valueStart);
-    } else {
-        // Find comma or closing brace
-        while (valueEnd < json.length() && json[valueEnd] != ',' && json[valueEnd] != '}' && json[valueEnd] != '\n') {
-            valueEnd++;
+    unsigned int channels[4] = {0, 0, 0, 255};
+    for (size_t i = 0; i < (length - 1) / 2; ++i) {
+        int high = hexDigit(hexColor[1 + i * 2]);
+        int low = hexDigit(hexColor[2 + i * 2]);
+        if (high < 0 || low < 0) {
+            return false;
         }
+        channels[i] = static_cast<unsigned int>(high * 16 + low);
     }
 
-    if (valueEnd == std::string::npos || valueEnd <= valueStart) {
-        return "";
-    }
+    color = {
+        channels[0] / 255.0f,
+        channels[1] / 255.0f,
+        channels[2] / 255.0f,
+        channels[3] / 255.0f
+    };
+    return true;
+}
 
-    std::string value = json.substr(valueStart, valueEnd - valueStart);
-    
-    // Trim whitespace
-    value.erase(0, value.find_first_not_of(" \t\n\r"));
-    value.erase(value.find_last_not_of(" \t\n\r") + 1);
+ThemeManager::Palette ThemeManager::defaultPalette() {
+    // Matrix Green theme (default)
+    Palette palette = {};
+    palette.colors[static_cast<size_t>(ColorRole::Background)] = {0.0f, 0.0f, 0.0f, 0.7f};
+    palette.colors[static_cast<size_t>(ColorRole::GraphLine)] = {0.0f, 1.0f, 0.0f, 1.0f};
+    palette.colors[static_cast<size_t>(ColorRole::GraphFill)] = {0.0f, 1.0f, 0.0f, 0.2f};
+    palette.colors[static_cast<size_t>(ColorRole::TextPrimary)] = {0.0f, 1.0f, 0.0f, 1.0f};
+    palette.colors[static_cast<size_t>(ColorRole::TextSecondary)] = {0.0f, 0.87f, 0.0f, 1.0f};
+    palette.colors[static_cast<size_t>(ColorRole::TextShadow)] = {0.0f, 0.0f, 0.0f, 1.0f};
+    palette.colors[static_cast<size_t>(ColorRole::DropMarker)] = {1.0f, 1.0f, 0.0f, 1.0f};
+    palette.colors[static_cast<size_t>(ColorRole::GridLine)] = {0.0f, 1.0f, 0.0f, 0.2f};
+    palette.colors[static_cast<size_t>(ColorRole::Border)] = {0.0f, 1.0f, 0.0f, 1.0f};
 
-    return value;
+    std::wcscpy(palette.fontFamily, L"Consolas");
+    palette.fontSize = 14.0f;
+    palette.borderWidth = 0.0f;
+    palette.cornerRadius = 4.0f;
+    palette.graphGlow = true;
+    return palette;
 }
 
-void ThemeManager::loadDefaultTheme() {
-    // Matrix Green theme (default)
-    m_colors["background"] = {0.0f, 0.0f, 0.0f, 0.7f};
-    m_colors["graph_line"] = {0.0f, 1.0f, 0.0f, 1.0f};
-    m_colors["graph_fill"] = {0.0f, 1.0f, 0.0f, 0.2f};
-    m_colors["text_primary"] = {0.0f, 1.0f, 0.0f, 1.0f};
-    m_colors["text_secondary"] = {0.0f, 0.87f, 0.0f, 1.0f};
-    m_colors["text_shadow"] = {0.0f, 0.0f, 0.0f, 1.0f};
-    m_colors["drop_marker"] = {1.0f, 1.0f, 0.0f, 1.0f};
-    m_colors["grid_line"] = {0.0f, 1.0f, 0.0f, 0.2f};
-    m_colors["border"] = {0.0f, 1.0f, 0.0f, 1.0f};
-
-    m_styles["font_family"] = "Consolas";
-    m_styles["font_size"] = "14";
-    m_styles["border_width"] = "0";
-    m_styles["corner_radius"] = "4";
-    m_styles["graph_glow"] = "true";
-
-    m_currentTheme = "default";
+bool ThemeManager::isValidThemeName(const std::string& themeName) {
+    return !themeName.empty() && themeName.find("..") == std::string::npos &&
+           themeName.find('/') == std::string::npos && themeName.find('\\') == std::string::npos;
 }
 
 } // namespace fps_monitor
@@ -1,7 +1,7 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
-#include <map>
 
 namespace fps_monitor {
 
@@ -10,6 +10,13 @@ namespace fps_monitor {
  * 
  * Parses JSON theme files and provides color values.
  * Supports theme switching without restart.
+ * 
+ * A theme is compiled once at load into a flat Palette indexed by
+ * ColorRole, so drawing code reads colours by array index instead of
+ * looking names up every frame. The file is scanned in a single pass;
+ * keys it does not know are ignored and missing keys keep the default
+ * (Matrix Green) value. A file that fails to parse (e.g. one an editor is
+ * still writing) leaves the current palette untouched.
  */
 class ThemeManager {
 public:
@@ -23,6 +30,46 @@ public:
         float a; ///< Alpha (0.0-1.0)
     };
 
+    /**
+     * @brief Colours a theme defines (index into Palette::colors)
+     */
+    enum class ColorRole : size_t {
+        Background,
+        GraphLine,
+        GraphFill,
+        TextPrimary,
+        TextSecondary,
+        TextShadow,
+        DropMarker,
+        GridLine,
+        Border,
+        Count
+    };
+
+    static constexpr size_t COLOR_COUNT = static_cast<size_t>(ColorRole::Count);   ///< Palette colours
+    static constexpr size_t FONT_FAMILY_CHARS = 64;     ///< Longest font family (with terminator)
+    static constexpr const char* THEME_DIRECTORY = "resources/themes";  ///< Theme files (<name>.json)
+
+    /**
+     * @brief A compiled theme
+     */
+    struct Palette {
+        Color colors[COLOR_COUNT];                  ///< Colours by ColorRole
+        wchar_t fontFamily[FONT_FAMILY_CHARS];      ///< Font family name
+        float fontSize;                             ///< Font size
+        float borderWidth;                          ///< Border width in pixels
+        float cornerRadius;                         ///< Corner radius in pixels
+        bool graphGlow;                             ///< Glow under the graph line
+
+        /**
+         * @brief Get a colour
+         * 
+         * @param role Colour role
+         * @return const Color& Colour value
+         */
+        const Color& operator[](ColorRole role) const { return colors[static_cast<size_t>(role)]; }
+    };
+
     /**
      * @brief Construct a new Theme Manager
      */
@@ -38,25 +85,45 @@ public:
      * 
      * @param themeName Theme name (without .json extension)
      * @return true if loaded successfully
-     * @return false otherwise
+     * @return false otherwise (the default theme is used)
      */
     bool loadTheme(const std::string& themeName);
 
     /**
-     * @brief Get a color by name
+     * @brief Compile the current theme's file again
+     * 
+     * The palette is replaced only if the file parses; otherwise the
+     * current one stays in use.
      * 
-     * @param colorName Color name (e.g., "graph_line")
-     * @return Color The color value (black if not found)
+     * @return true if the palette was replaced
+     * @return false otherwise
      */
-    Color getColor(const std::string& colorName) const;
+    bool reloadTheme();
 
     /**
-     * @brief Get a style property
+     * @brief Get the compiled palette
      * 
-     * @param propertyName Property name (e.g., "font_size")
-     * @return std::string Property value (empty if not found)
+     * @return const Palette& Current palette
      */
-    std::string getStyleProperty(const std::string& propertyName) const;
+    const Palette& getPalette() const { return m_palette; }
+
+    /**
+     * @brief Get a color by role
+     * 
+     * @param role Colour role
+     * @return const Color& The color value
+     */
+    const Color& getColor(ColorRole role) const { return m_palette[role]; }
+
+    /**
+     * @brief Get the theme file key of a colour
+     * 
+     * Also used as the brush key in ResourceCache.
+     * 
+     * @param role Colour role
+     * @return const char* Key (e.g. "graph_line")
+     */
+    static const char* getColorName(ColorRole role);
 
     /**
      * @brief Get current theme name
@@ -65,32 +132,78 @@ public:
      */
     std::string getCurrentTheme() const;
 
+    /**
+     * @brief Get the file name (without directory) of the current theme
+     * 
+     * @return std::string File name, or empty for the built-in default
+     */
+    std::string getCurrentThemeFile() const;
+
 private:
+    /**
+     * @brief Read and compile a theme file
+     * 
+     * @param themeName Theme name (validated)
+     * @param palette Output palette (starts from the defaults)
+     * @return true if the file was read and parsed
+     * @return false otherwise (palette contents undefined)
+     */
+    static bool compileTheme(const std::string& themeName, Palette& palette);
+
+    /**
+     * @brief Parse theme JSON into a palette in one pass
+     * 
+     * Every "key": value pair at any depth is handed to applyValue().
+     * 
+     * @param json Theme file contents
+     * @param palette Palette to update
+     * @return true if the document is complete (balanced, terminated strings)
+     * @return false otherwise
+     */
+    static bool parseTheme(const std::string& json, Palette& palette);
+
+    /**
+     * @brief Store one parsed value in the palette
+     * 
+     * @param key Key characters
+     * @param keyLength Key length
+     * @param value Value characters (without quotes)
+     * @param valueLength Value length
+     * @param palette Palette to update
+     */
+    static void applyValue(const char* key, size_t keyLength, const char* value, size_t valueLength,
+                           Palette& palette);
+
     /**
      * @brief Parse hex color string (#RRGGBB or #RRGGBBAA)
      * 
-     * @param hexColor Hex color string
-     * @return Color Parsed color
+     * @param hexColor Hex color characters
+     * @param length Number of characters
+     * @param color Output colour
+     * @return true if parsed
+     * @return false otherwise (color unchanged)
      */
-    Color parseHexColor(const std::string& hexColor) const;
+    static bool parseHexColor(const char* hexColor, size_t length, Color& color);
 
     /**
-     * @brief Simple JSON value parser
+     * @brief Get the default (Matrix Green) palette
      * 
-     * @param json JSON string
-     * @param key Key to find
-     * @return std::string Value (empty if not found)
+     * @return Palette Default palette
      */
-    std::string parseJsonValue(const std::string& json, const std::string& key) const;
+    static Palette defaultPalette();
 
     /**
-     * @brief Load default theme colors
+     * @brief Check a theme name for path components
+     * 
+     * @param themeName Theme name
+     * @return true if it names a file inside THEME_DIRECTORY
+     * @return false otherwise
      */
-    void loadDefaultTheme();
+    static bool isValidThemeName(const std::string& themeName);
 
-    std::map<std::string, Color> m_colors;          ///< Color map
-    std::map<std::string, std::string> m_styles;    ///< Style properties
-    std::string m_currentTheme;                     ///< Current theme name
+    Palette m_palette;              ///< Compiled current theme
+    std::string m_currentTheme;     ///< Current theme name
+    bool m_fromFile;                ///< m_palette was compiled from a file
 };
 
 } // namespace fps_monitor
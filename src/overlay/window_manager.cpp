@@ -20,11 +20,13 @@ WindowManager::WindowManager()
 WindowManager::~WindowManager() {
     unregisterHotkey();
     if (m_hwnd) {
+        // Detach first so destroying the window from here does not post WM_QUIT
+        SetWindowLongPtr(m_hwnd, GWLP_USERDATA, 0);
         DestroyWindow(m_hwnd);
     }
 }
 
-bool WindowManager::create(int width, int height, int x, int y) {
+bool WindowManager::create(int width, int height, int x, int y, bool noRedirection) {
     m_width = width;
     m_height = height;
     m_x = x;
@@ -35,8 +37,13 @@ bool WindowManager::create(int width, int height, int x, int y) {
     }
 
     // Create layered, topmost, transparent window
+    DWORD exStyle = WS_EX_LAYERED | WS_EX_TOPMOST | WS_EX_TRANSPARENT | WS_EX_TOOLWINDOW;
+    if (noRedirection) {
+        exStyle |= WS_EX_NOREDIRECTIONBITMAP;
+    }
+
     m_hwnd = CreateWindowExW(
-        WS_EX_LAYERED | WS_EX_TOPMOST | WS_EX_TRANSPARENT | WS_EX_TOOLWINDOW,
+        exStyle,
         WINDOW_CLASS_NAME,
         L"FPS Monitor Overlay",
         WS_POPUP,
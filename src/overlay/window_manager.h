@@ -36,10 +36,13 @@ public:
      * @param height Window height
      * @param x X position
      * @param y Y position
+     * @param noRedirection Create without a GDI redirection surface
+     *                      (WS_EX_NOREDIRECTIONBITMAP), for content presented
+     *                      through DirectComposition
      * @return true if created successfully
      * @return false otherwise
      */
-    bool create(int width, int height, int x, int y);
+    bool create(int width, int height, int x, int y, bool noRedirection = false);
 
     /**
      * @brief Show the overlay window
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace fps_monitor {
+namespace recording {
+
+/**
+ * @brief .fpsr session recording format
+ * 
+ * A fixed FileHeader followed by a stream of variable-length records.
+ * Every record starts with an unsigned LEB128 varint "head":
+ * 
+ * - Frame (head bit 0 clear): head >> 1 is the zigzag-encoded difference
+ *   between this frame time and the previous one, in ticks. A steady frame
+ *   rate therefore costs one or two bytes per frame.
+ * - Event (head bit 0 set): head >> 1 is the EventType, followed by its
+ *   payload (varints unless noted):
+ *   - Target: time (ticks since FileHeader::startQpc), process ID, name
+ *     length, name bytes (UTF-8). Starts a new segment; the frame time
+ *     predictor restarts at 0.
+ *   - Drop: current FPS x 100, average FPS x 100 (at the preceding frame).
+ * 
+ * All integers are little-endian. Frame times within a segment accumulate
+ * from the segment's start time.
+ */
+
+constexpr uint32_t MAGIC = 0x52535046;          ///< "FPSR"
+constexpr uint16_t VERSION = 1;                 ///< Current format version
+constexpr size_t MAX_NAME_BYTES = 255;          ///< Longest target name stored
+constexpr size_t MAX_VARINT_BYTES = 10;         ///< Longest encoded uint64_t
+
+/**
+ * @brief File header (32 bytes, at offset 0)
+ */
+struct FileHeader {
+    uint32_t magic;             ///< MAGIC
+    uint16_t version;           ///< VERSION
+    uint16_t headerSize;        ///< sizeof(FileHeader); records start here
+    int64_t tickFrequency;      ///< Ticks per second of all times
+    int64_t startQpc;           ///< QPC timestamp the recording started at
+    uint64_t startFileTime;     ///< Wall clock at startQpc (FILETIME, UTC)
+};
+
+static_assert(sizeof(FileHeader) == 32, "FileHeader layout is part of the format");
+
+/**
+ * @brief Event record types
+ */
+enum class EventType : uint8_t {
+    Target = 0,     ///< Capture target changed
+    Drop = 1        ///< FPS drop detected
+};
+
+/**
+ * @brief Encode a signed difference so small magnitudes stay small
+ * 
+ * @param value Signed value
+ * @return uint64_t Zigzag encoding (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...)
+ */
+inline uint64_t zigzagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/**
+ * @brief Decode a zigzag-encoded value
+ * 
+ * @param value Zigzag encoding
+ * @return int64_t Signed value
+ */
+inline int64_t zigzagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * @brief Write an unsigned LEB128 varint
+ * 
+ * @param value Value to encode
+ * @param out Destination with room for MAX_VARINT_BYTES
+ * @return size_t Bytes written
+ */
+inline size_t writeVarint(uint64_t value, uint8_t* out) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<uint8_t>(value);
+    return length;
+}
+
+/**
+ * @brief Read an unsigned LEB128 varint
+ * 
+ * @param data Encoded bytes
+ * @param size Bytes available
+ * @param value Decoded value
+ * @return size_t Bytes consumed (0 if truncated or overlong)
+ */
+inline size_t readVarint(const uint8_t* data, size_t size, uint64_t& value) {
+    value = 0;
+    for (size_t i = 0; i < size && i < MAX_VARINT_BYTES; ++i) {
+        value |= static_cast<uint64_t>(data[i] & 0x7F) << (7 * i);
+        if ((data[i] & 0x80) == 0) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+} // namespace recording
+} // namespace fps_monitor
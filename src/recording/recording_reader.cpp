@@ -0,0 +1,164 @@
+#include "recording_reader.h"
+#include <cstring>
+
+namespace fps_monitor {
+
+RecordingReader::RecordingReader()
+    : m_data(nullptr)
+    , m_size(0)
+    , m_offset(0)
+    , m_header()
+    , m_time(0)
+    , m_lastTicks(0)
+    , m_processId(0)
+    , m_truncated(false)
+{
+}
+
+bool RecordingReader::open(const uint8_t* data, size_t size) {
+    m_data = nullptr;
+    m_size = 0;
+
+    if (!data || size < sizeof(recording::FileHeader)) {
+        return false;
+    }
+
+    std::memcpy(&m_header, data, sizeof(m_header));
+    if (m_header.magic != recording::MAGIC || m_header.version != recording::VERSION
+        || m_header.headerSize < sizeof(recording::FileHeader) || m_header.headerSize > size
+        || m_header.tickFrequency <= 0) {
+        return false;
+    }
+
+    m_data = data;
+    m_size = size;
+    rewind();
+    return true;
+}
+
+const recording::FileHeader& RecordingReader::getHeader() const {
+    return m_header;
+}
+
+void RecordingReader::rewind() {
+    m_offset = m_data ? m_header.headerSize : 0;
+    m_time = 0;
+    m_lastTicks = 0;
+    m_processId = 0;
+    m_name = std::string_view();
+    m_truncated = false;
+}
+
+RecordingReader::Position RecordingReader::tell() const {
+    Position position;
+    position.offset = m_offset;
+    position.time = m_time;
+    position.lastTicks = m_lastTicks;
+    position.processId = m_processId;
+    position.name = m_name;
+    return position;
+}
+
+void RecordingReader::seek(const Position& position) {
+    m_offset = position.offset;
+    m_time = position.time;
+    m_lastTicks = position.lastTicks;
+    m_processId = position.processId;
+    m_name = position.name;
+    m_truncated = false;
+}
+
+bool RecordingReader::isTruncated() const {
+    return m_truncated;
+}
+
+bool RecordingReader::read(uint64_t& value) {
+    size_t length = recording::readVarint(m_data + m_offset, m_size - m_offset, value);
+    if (length == 0) {
+        m_truncated = true;
+        return false;
+    }
+    m_offset += length;
+    return true;
+}
+
+bool RecordingReader::next(Record& record) {
+    if (!m_data || m_truncated || m_offset >= m_size) {
+        return false;
+    }
+
+    // Rolled back if the record turns out incomplete
+    size_t start = m_offset;
+    uint64_t head = 0;
+    if (!read(head)) {
+        return false;
+    }
+
+    record.processId = m_processId;
+    record.name = m_name;
+
+    if ((head & 1) == 0) {
+        int64_t ticks = static_cast<int64_t>(m_lastTicks) + recording::zigzagDecode(head >> 1);
+        if (ticks < 0 || ticks > UINT32_MAX) {
+            m_truncated = true;
+            m_offset = start;
+            return false;
+        }
+
+        m_lastTicks = static_cast<uint32_t>(ticks);
+        m_time += m_lastTicks;
+        record.type = Record::Type::Frame;
+        record.ticks = m_lastTicks;
+        record.time = m_time;
+        return true;
+    }
+
+    record.ticks = 0;
+    switch (static_cast<recording::EventType>(head >> 1)) {
+        case recording::EventType::Target: {
+            uint64_t time = 0;
+            uint64_t processId = 0;
+            uint64_t nameLength = 0;
+            if (!read(time) || !read(processId) || !read(nameLength)
+                || nameLength > recording::MAX_NAME_BYTES || nameLength > m_size - m_offset) {
+                m_truncated = true;
+                m_offset = start;
+                return false;
+            }
+
+            m_name = std::string_view(reinterpret_cast<const char*>(m_data + m_offset), static_cast<size_t>(nameLength));
+            m_offset += static_cast<size_t>(nameLength);
+            m_processId = static_cast<uint32_t>(processId);
+            m_time = time;
+            m_lastTicks = 0;
+
+            record.type = Record::Type::Target;
+            record.time = m_time;
+            record.processId = m_processId;
+            record.name = m_name;
+            return true;
+        }
+
+        case recording::EventType::Drop: {
+            uint64_t currentFPS = 0;
+            uint64_t averageFPS = 0;
+            if (!read(currentFPS) || !read(averageFPS)) {
+                m_offset = start;
+                return false;
+            }
+
+            record.type = Record::Type::Drop;
+            record.time = m_time;
+            record.currentFPS = static_cast<double>(currentFPS) / 100.0;
+            record.averageFPS = static_cast<double>(averageFPS) / 100.0;
+            return true;
+        }
+    }
+
+    // Unknown event: its payload length is unknown, so nothing after it can be read
+    m_truncated = true;
+    m_offset = start;
+    return false;
+}
+
+} // namespace fps_monitor
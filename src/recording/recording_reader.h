@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "recording_format.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Decodes a .fpsr recording held in memory
+ * 
+ * Records are decoded in order with next(); nothing is allocated and the
+ * target names point into the recording. Portable (no Windows APIs), so
+ * offline tools can use it too.
+ */
+class RecordingReader {
+public:
+    /**
+     * @brief One decoded record
+     */
+    struct Record {
+        enum class Type {
+            Frame,      ///< A frame time
+            Target,     ///< Capture target changed
+            Drop        ///< FPS drop detected
+        };
+
+        Type type;                  ///< Record type
+        uint64_t time;              ///< Ticks since the recording started (end of the frame for Frame)
+        uint32_t ticks;             ///< Frame time in ticks (Frame)
+        uint32_t processId;         ///< Target process (Target; current target otherwise)
+        std::string_view name;      ///< Target name (Target; current target otherwise)
+        double currentFPS;          ///< FPS during the drop (Drop)
+        double averageFPS;          ///< Average FPS before the drop (Drop)
+    };
+
+    /**
+     * @brief Decoder state between two records (for seeking)
+     */
+    struct Position {
+        size_t offset = 0;              ///< Byte offset of the next record
+        uint64_t time = 0;              ///< Current time in ticks
+        uint32_t lastTicks = 0;         ///< Frame time predictor
+        uint32_t processId = 0;         ///< Current target
+        std::string_view name;          ///< Current target name
+    };
+
+    /**
+     * @brief Construct a new Recording Reader (no data)
+     */
+    RecordingReader();
+
+    /**
+     * @brief Attach to a recording and validate its header
+     * 
+     * @param data Recording bytes (must outlive the reader)
+     * @param size Number of bytes
+     * @return true if the header is valid
+     * @return false if the data is not a supported recording
+     */
+    bool open(const uint8_t* data, size_t size);
+
+    /**
+     * @brief Get the file header
+     * 
+     * @return const recording::FileHeader& Header (valid after open())
+     */
+    const recording::FileHeader& getHeader() const;
+
+    /**
+     * @brief Decode the next record
+     * 
+     * @param record Decoded record
+     * @return true if a record was decoded
+     * @return false at the end of the data (see isTruncated())
+     */
+    bool next(Record& record);
+
+    /**
+     * @brief Restart from the first record
+     */
+    void rewind();
+
+    /**
+     * @brief Get the current decoder state
+     * 
+     * @return Position State to pass to seek() to resume from here
+     */
+    Position tell() const;
+
+    /**
+     * @brief Resume decoding from a state returned by tell()
+     * 
+     * @param position Saved state (from the same recording)
+     */
+    void seek(const Position& position);
+
+    /**
+     * @brief Check if decoding stopped at an incomplete or invalid record
+     * 
+     * A recording cut short (crash, full disk) ends with a partial record;
+     * everything before it is still valid.
+     * 
+     * @return true if the data ended mid-record
+     * @return false otherwise
+     */
+    bool isTruncated() const;
+
+private:
+    /**
+     * @brief Read a varint at the current position
+     * 
+     * @param value Decoded value
+     * @return true if read
+     * @return false if the data ended mid-varint (marks the reader truncated)
+     */
+    bool read(uint64_t& value);
+
+    const uint8_t* m_data;              ///< Recording bytes
+    size_t m_size;                      ///< Number of bytes
+    size_t m_offset;                    ///< Read position
+    recording::FileHeader m_header;     ///< Copy of the header
+    uint64_t m_time;                    ///< Current time in ticks
+    uint32_t m_lastTicks;               ///< Frame time predictor
+    uint32_t m_processId;               ///< Current target
+    std::string_view m_name;            ///< Current target name
+    bool m_truncated;                   ///< Stopped at a bad record
+};
+
+} // namespace fps_monitor
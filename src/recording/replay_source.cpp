@@ -0,0 +1,121 @@
+#include "replay_source.h"
+#include <algorithm>
+#include <cmath>
+
+namespace fps_monitor {
+
+ReplaySource::ReplaySource()
+    : m_next()
+    , m_hasNext(false)
+    , m_duration(0)
+    , m_frameCount(0)
+    , m_recordedDrops(0)
+    , m_truncated(false)
+{
+}
+
+bool ReplaySource::open(const std::string& path) {
+    m_index.clear();
+    m_hasNext = false;
+
+    if (!m_file.open(path) || !m_reader.open(m_file.data(), m_file.size())) {
+        m_file.close();
+        return false;
+    }
+
+    buildIndex();
+    return true;
+}
+
+int64_t ReplaySource::getTickFrequency() const {
+    return m_reader.getHeader().tickFrequency;
+}
+
+uint64_t ReplaySource::getDuration() const {
+    return m_duration;
+}
+
+uint64_t ReplaySource::getFrameCount() const {
+    return m_frameCount;
+}
+
+uint64_t ReplaySource::getRecordedDropCount() const {
+    return m_recordedDrops;
+}
+
+bool ReplaySource::isTruncated() const {
+    return m_truncated;
+}
+
+void ReplaySource::buildIndex() {
+    uint64_t interval = static_cast<uint64_t>(std::llround(INDEX_INTERVAL_SECONDS
+                                                           * static_cast<double>(getTickFrequency())));
+    interval = std::max<uint64_t>(interval, 1);
+
+    m_duration = 0;
+    m_frameCount = 0;
+    m_recordedDrops = 0;
+
+    // First checkpoint is the start of the records
+    m_reader.rewind();
+    m_index.push_back({0, m_reader.tell()});
+    uint64_t nextCheckpoint = interval;
+
+    RecordingReader::Position before = m_reader.tell();
+    RecordingReader::Record record;
+    while (m_reader.next(record)) {
+        // Index the state before the first record of each interval; a
+        // record's time can only go backwards at a target change, which
+        // restarts the checkpoint grid
+        if (record.time >= nextCheckpoint || record.time < m_index.back().time) {
+            m_index.push_back({record.time, before});
+            nextCheckpoint = (record.time / interval + 1) * interval;
+        }
+
+        if (record.type == RecordingReader::Record::Type::Frame) {
+            ++m_frameCount;
+        } else if (record.type == RecordingReader::Record::Type::Drop) {
+            ++m_recordedDrops;
+        }
+
+        m_duration = std::max(m_duration, record.time);
+        before = m_reader.tell();
+    }
+    m_truncated = m_reader.isTruncated();
+
+    m_reader.rewind();
+}
+
+void ReplaySource::seek(uint64_t time) {
+    // Checkpoint times only ascend within a segment; take the last one at
+    // or before the time
+    size_t best = 0;
+    for (size_t i = 0; i < m_index.size(); ++i) {
+        if (m_index[i].time <= time) {
+            best = i;
+        }
+    }
+
+    m_reader.seek(m_index[best].position);
+    m_hasNext = false;
+
+    while (const RecordingReader::Record* record = peek()) {
+        if (record->time >= time) {
+            break;
+        }
+        pop();
+    }
+}
+
+const RecordingReader::Record* ReplaySource::peek() {
+    if (!m_hasNext) {
+        m_hasNext = m_reader.next(m_next);
+    }
+    return m_hasNext ? &m_next : nullptr;
+}
+
+void ReplaySource::pop() {
+    m_hasNext = false;
+}
+
+} // namespace fps_monitor
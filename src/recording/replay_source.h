@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "recording_reader.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Random-access playback of a memory-mapped .fpsr recording
+ * 
+ * Opening maps the file and decodes it once to build a seek index: a
+ * reader checkpoint every INDEX_INTERVAL_SECONDS of recording time. A
+ * seek restores the checkpoint before the requested time and decodes at
+ * most one interval forward, so jumping anywhere in an hour-long capture
+ * is instant and nothing but the index is held in memory.
+ */
+class ReplaySource {
+public:
+    static constexpr double INDEX_INTERVAL_SECONDS = 5.0;   ///< Recording time between checkpoints
+
+    /**
+     * @brief Construct a new Replay Source (nothing open)
+     */
+    ReplaySource();
+
+    /**
+     * @brief Map a recording and build its seek index
+     * 
+     * @param path Recording file
+     * @return true if the recording can be replayed
+     * @return false if it could not be mapped or is not a recording
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Get the tick rate of the recording
+     * 
+     * @return int64_t Ticks per second
+     */
+    int64_t getTickFrequency() const;
+
+    /**
+     * @brief Get the time of the last record
+     * 
+     * @return uint64_t Duration in ticks
+     */
+    uint64_t getDuration() const;
+
+    /**
+     * @brief Get the number of frames in the recording
+     * 
+     * @return uint64_t Frame count
+     */
+    uint64_t getFrameCount() const;
+
+    /**
+     * @brief Get the number of drops detected while recording
+     * 
+     * @return uint64_t Recorded drop count
+     */
+    uint64_t getRecordedDropCount() const;
+
+    /**
+     * @brief Check if the recording ends with an incomplete record
+     * 
+     * @return true if truncated (everything before it replays normally)
+     * @return false otherwise
+     */
+    bool isTruncated() const;
+
+    /**
+     * @brief Position playback at a time
+     * 
+     * The next record is the first one at or after the time. The target
+     * state (process, name) of the skipped part is kept.
+     * 
+     * @param time Ticks since the recording started
+     */
+    void seek(uint64_t time);
+
+    /**
+     * @brief Look at the next record without consuming it
+     * 
+     * @return const RecordingReader::Record* Next record, or nullptr at the end
+     */
+    const RecordingReader::Record* peek();
+
+    /**
+     * @brief Consume the record returned by peek()
+     */
+    void pop();
+
+private:
+    /**
+     * @brief Reader state at a point in the recording
+     */
+    struct Checkpoint {
+        uint64_t time;                          ///< Time of the next record
+        RecordingReader::Position position;     ///< Reader state before it
+    };
+
+    /**
+     * @brief Decode the whole recording once to fill the index and totals
+     */
+    void buildIndex();
+
+    MappedFile m_file;                      ///< Mapped recording
+    RecordingReader m_reader;               ///< Playback decoder
+    std::vector<Checkpoint> m_index;        ///< Seek checkpoints (ascending time)
+    RecordingReader::Record m_next;         ///< Record returned by peek()
+    bool m_hasNext;                         ///< m_next holds an unconsumed record
+    uint64_t m_duration;                    ///< Time of the last record
+    uint64_t m_frameCount;                  ///< Frames in the recording
+    uint64_t m_recordedDrops;               ///< Drop events in the recording
+    bool m_truncated;                       ///< Recording ends mid-record
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,205 @@
+#include "session_recorder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace fps_monitor {
+
+SessionRecorder::SessionRecorder()
+    : m_file(INVALID_HANDLE_VALUE)
+    , m_block(nullptr)
+    , m_used(0)
+    , m_startQpc(0)
+    , m_lastTicks(0)
+    , m_frameCount(0)
+    , m_pendingBlock(nullptr)
+    , m_pendingSize(0)
+    , m_stopRequested(false)
+    , m_bytesWritten(0)
+    , m_failed(false)
+{
+}
+
+SessionRecorder::~SessionRecorder() {
+    close();
+}
+
+bool SessionRecorder::open(const std::string& path, int64_t tickFrequency) {
+    if (isOpen()) {
+        return false;
+    }
+
+    m_file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                         FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    if (!m_storage) {
+        m_storage = std::make_unique<uint8_t[]>(2 * BLOCK_SIZE);
+    }
+    m_block = m_storage.get();
+    m_used = 0;
+    m_lastTicks = 0;
+    m_frameCount = 0;
+    m_pendingBlock = nullptr;
+    m_pendingSize = 0;
+    m_stopRequested = false;
+    m_bytesWritten = 0;
+    m_failed = false;
+
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    FILETIME wallClock;
+    GetSystemTimeAsFileTime(&wallClock);
+    m_startQpc = now.QuadPart;
+
+    // The header goes out with the first block
+    recording::FileHeader header = {};
+    header.magic = recording::MAGIC;
+    header.version = recording::VERSION;
+    header.headerSize = static_cast<uint16_t>(sizeof(recording::FileHeader));
+    header.tickFrequency = tickFrequency;
+    header.startQpc = m_startQpc;
+    header.startFileTime = (static_cast<uint64_t>(wallClock.dwHighDateTime) << 32) | wallClock.dwLowDateTime;
+    std::memcpy(m_block, &header, sizeof(header));
+    m_used = sizeof(header);
+
+    m_thread = std::thread(&SessionRecorder::writerThread, this);
+    return true;
+}
+
+void SessionRecorder::close() {
+    if (!isOpen()) {
+        return;
+    }
+
+    if (m_used > 0) {
+        submitBlock();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopRequested = true;
+    }
+    m_condition.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+
+    CloseHandle(m_file);
+    m_file = INVALID_HANDLE_VALUE;
+}
+
+bool SessionRecorder::isOpen() const {
+    return m_file != INVALID_HANDLE_VALUE;
+}
+
+void SessionRecorder::recordFrame(uint32_t ticks) {
+    if (!isOpen()) {
+        return;
+    }
+
+    reserve(recording::MAX_VARINT_BYTES);
+    int64_t difference = static_cast<int64_t>(ticks) - static_cast<int64_t>(m_lastTicks);
+    putVarint(recording::zigzagEncode(difference) << 1);
+    m_lastTicks = ticks;
+    ++m_frameCount;
+}
+
+void SessionRecorder::recordTarget(uint32_t processId, const std::string& name, int64_t qpcTimestamp) {
+    if (!isOpen()) {
+        return;
+    }
+
+    size_t nameLength = std::min(name.size(), recording::MAX_NAME_BYTES);
+    uint64_t time = qpcTimestamp > m_startQpc ? static_cast<uint64_t>(qpcTimestamp - m_startQpc) : 0;
+
+    reserve(MAX_EVENT_BYTES);
+    putVarint((static_cast<uint64_t>(recording::EventType::Target) << 1) | 1);
+    putVarint(time);
+    putVarint(processId);
+    putVarint(nameLength);
+    std::memcpy(m_block + m_used, name.data(), nameLength);
+    m_used += nameLength;
+
+    // Frame times of the new segment are predicted from scratch
+    m_lastTicks = 0;
+}
+
+void SessionRecorder::recordDrop(double currentFPS, double averageFPS) {
+    if (!isOpen()) {
+        return;
+    }
+
+    reserve(MAX_EVENT_BYTES);
+    putVarint((static_cast<uint64_t>(recording::EventType::Drop) << 1) | 1);
+    putVarint(static_cast<uint64_t>(std::llround(std::max(0.0, currentFPS) * 100.0)));
+    putVarint(static_cast<uint64_t>(std::llround(std::max(0.0, averageFPS) * 100.0)));
+}
+
+uint64_t SessionRecorder::getFrameCount() const {
+    return m_frameCount;
+}
+
+uint64_t SessionRecorder::getBytesWritten() const {
+    return m_bytesWritten;
+}
+
+bool SessionRecorder::hasFailed() const {
+    return m_failed;
+}
+
+void SessionRecorder::reserve(size_t bytes) {
+    if (m_used + bytes > BLOCK_SIZE) {
+        submitBlock();
+    }
+}
+
+void SessionRecorder::putVarint(uint64_t value) {
+    m_used += recording::writeVarint(value, m_block + m_used);
+}
+
+void SessionRecorder::submitBlock() {
+    {
+        // The other block must be written out before it is reused; at a few
+        // bytes per frame this only waits if the disk stalls for minutes
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_pendingBlock == nullptr; });
+        m_pendingBlock = m_block;
+        m_pendingSize = m_used;
+    }
+    m_condition.notify_all();
+    m_bytesWritten += m_used;
+
+    uint8_t* first = m_storage.get();
+    m_block = (m_block == first) ? first + BLOCK_SIZE : first;
+    m_used = 0;
+}
+
+void SessionRecorder::writerThread() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;) {
+        m_condition.wait(lock, [this]() { return m_pendingBlock != nullptr || m_stopRequested; });
+        if (!m_pendingBlock) {
+            return;
+        }
+
+        const uint8_t* block = m_pendingBlock;
+        DWORD size = static_cast<DWORD>(m_pendingSize);
+        lock.unlock();
+
+        DWORD written = 0;
+        if (!m_failed && (!WriteFile(m_file, block, size, &written, nullptr) || written != size)) {
+            m_failed = true;
+        }
+
+        lock.lock();
+        m_pendingBlock = nullptr;
+        m_condition.notify_all();
+    }
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <windows.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "recording_format.h"
+
+namespace fps_monitor {
+
+/**
+ * @brief Streams frame times and events to a .fpsr file
+ * 
+ * Records are encoded into one of two 64 KB blocks. When the active block
+ * fills up it is handed to a writer thread, which stores it with a single
+ * WriteFile, while encoding continues in the other block. Encoding a
+ * frame costs a few instructions and no allocation; the producer only
+ * synchronizes once per block.
+ * 
+ * The record*() functions must all be called from one thread (the
+ * analysis thread).
+ */
+class SessionRecorder {
+public:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;     ///< Bytes per write
+
+    /**
+     * @brief Construct a new Session Recorder (closed)
+     */
+    SessionRecorder();
+
+    /**
+     * @brief Destroy the Session Recorder (flushes and closes)
+     */
+    ~SessionRecorder();
+
+    // Prevent copying
+    SessionRecorder(const SessionRecorder&) = delete;
+    SessionRecorder& operator=(const SessionRecorder&) = delete;
+
+    /**
+     * @brief Create the file, write the header and start the writer thread
+     * 
+     * @param path Output file (replaced if it exists)
+     * @param tickFrequency Ticks per second of the recorded frame times
+     * @return true if recording
+     * @return false if the file could not be created
+     */
+    bool open(const std::string& path, int64_t tickFrequency);
+
+    /**
+     * @brief Flush the partial block, stop the writer thread and close the file
+     */
+    void close();
+
+    /**
+     * @brief Check if a file is open
+     * 
+     * @return true if recording
+     * @return false otherwise
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Record one frame time
+     * 
+     * @param ticks Frame time in ticks
+     */
+    void recordFrame(uint32_t ticks);
+
+    /**
+     * @brief Record a change of capture target (starts a segment)
+     * 
+     * @param processId Target process (0 for overlay timing)
+     * @param name Target name (truncated to MAX_NAME_BYTES)
+     * @param qpcTimestamp QPC timestamp of the change
+     */
+    void recordTarget(uint32_t processId, const std::string& name, int64_t qpcTimestamp);
+
+    /**
+     * @brief Record an FPS drop (at the last recorded frame)
+     * 
+     * @param currentFPS FPS during the drop
+     * @param averageFPS Average FPS before the drop
+     */
+    void recordDrop(double currentFPS, double averageFPS);
+
+    /**
+     * @brief Get the number of frames recorded
+     * 
+     * @return uint64_t Frame count
+     */
+    uint64_t getFrameCount() const;
+
+    /**
+     * @brief Get the number of bytes handed to the writer so far
+     * 
+     * @return uint64_t Byte count (excluding the active block)
+     */
+    uint64_t getBytesWritten() const;
+
+    /**
+     * @brief Check if a write failed (the rest of the session is discarded)
+     * 
+     * @return true if the file is incomplete
+     * @return false otherwise
+     */
+    bool hasFailed() const;
+
+private:
+    /**
+     * @brief Make room for a record in the active block
+     * 
+     * @param bytes Largest size the record can encode to
+     */
+    void reserve(size_t bytes);
+
+    /**
+     * @brief Append a varint to the active block (after reserve())
+     * 
+     * @param value Value to encode
+     */
+    void putVarint(uint64_t value);
+
+    /**
+     * @brief Hand the active block to the writer and switch blocks
+     */
+    void submitBlock();
+
+    /**
+     * @brief Writer thread body
+     */
+    void writerThread();
+
+    static constexpr size_t MAX_EVENT_BYTES = 4 * recording::MAX_VARINT_BYTES + recording::MAX_NAME_BYTES;
+
+    HANDLE m_file;                          ///< Output file
+    std::unique_ptr<uint8_t[]> m_storage;   ///< Both blocks (2 x BLOCK_SIZE)
+    uint8_t* m_block;                       ///< Active block
+    size_t m_used;                          ///< Bytes used in the active block
+    int64_t m_startQpc;                     ///< Header start timestamp
+    uint32_t m_lastTicks;                   ///< Frame time predictor
+    uint64_t m_frameCount;                  ///< Frames recorded
+
+    std::thread m_thread;                   ///< Writer thread
+    std::mutex m_mutex;                     ///< Guards the hand-off below
+    std::condition_variable m_condition;    ///< Signals hand-off changes
+    const uint8_t* m_pendingBlock;          ///< Block waiting to be written (nullptr if none)
+    size_t m_pendingSize;                   ///< Bytes in the pending block
+    bool m_stopRequested;                   ///< Writer should exit once idle
+    std::atomic<uint64_t> m_bytesWritten;   ///< Bytes handed to the writer
+    std::atomic<bool> m_failed;             ///< A write failed
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,288 @@
+#include "system_sampler.h"
+#include "thread_config.h"
+#include <pdhmsg.h>
+#include <algorithm>
+#include <cwchar>
+
+#pragma comment(lib, "pdh.lib")
+
+namespace fps_monitor {
+
+namespace {
+
+// English names, so the counters resolve on localized systems too
+constexpr const wchar_t* CORE_COUNTER = L"\\Processor Information(*)\\% Processor Time";
+constexpr const wchar_t* TOTAL_COUNTER = L"\\Processor Information(_Total)\\% Processor Time";
+constexpr const wchar_t* FREQUENCY_COUNTER = L"\\Processor Information(_Total)\\Processor Frequency";
+constexpr const wchar_t* PERFORMANCE_COUNTER = L"\\Processor Information(_Total)\\% Processor Performance";
+constexpr const wchar_t* GPU_COUNTER = L"\\GPU Engine(*engtype_3D)\\Utilization Percentage";
+
+// Per-group totals ("0,_Total") are not cores
+bool isTotalInstance(const wchar_t* name) {
+    return std::wcsstr(name, L"_Total") != nullptr;
+}
+
+// "pid_1234_luid_..._engtype_3D": the engine is everything from "luid_"
+const wchar_t* engineKey(const wchar_t* name) {
+    const wchar_t* key = std::wcsstr(name, L"luid_");
+    return key ? key : name;
+}
+
+} // namespace
+
+SystemSampler::SystemSampler()
+    : m_query(nullptr)
+    , m_coreCounter(nullptr)
+    , m_totalCounter(nullptr)
+    , m_frequencyCounter(nullptr)
+    , m_performanceCounter(nullptr)
+    , m_gpuCounter(nullptr)
+    , m_engines{}
+    , m_intervalMs(500)
+    , m_stopEvent(CreateEventW(nullptr, TRUE, FALSE, nullptr))
+    , m_history{}
+    , m_head(0)
+    , m_count(0)
+{
+}
+
+SystemSampler::~SystemSampler() {
+    stop();
+
+    if (m_stopEvent) {
+        CloseHandle(m_stopEvent);
+    }
+}
+
+bool SystemSampler::start(int intervalMs) {
+    if (m_thread.joinable()) {
+        return true;
+    }
+    if (!m_stopEvent || PdhOpenQueryW(nullptr, 0, &m_query) != ERROR_SUCCESS) {
+        m_query = nullptr;
+        return false;
+    }
+
+    // CPU load is required; the clock and GPU counters depend on the OS and driver
+    if (PdhAddEnglishCounterW(m_query, CORE_COUNTER, 0, &m_coreCounter) != ERROR_SUCCESS ||
+        PdhAddEnglishCounterW(m_query, TOTAL_COUNTER, 0, &m_totalCounter) != ERROR_SUCCESS) {
+        closeQuery();
+        return false;
+    }
+    if (PdhAddEnglishCounterW(m_query, FREQUENCY_COUNTER, 0, &m_frequencyCounter) != ERROR_SUCCESS ||
+        PdhAddEnglishCounterW(m_query, PERFORMANCE_COUNTER, 0, &m_performanceCounter) != ERROR_SUCCESS) {
+        m_frequencyCounter = nullptr;
+        m_performanceCounter = nullptr;
+    }
+    if (PdhAddEnglishCounterW(m_query, GPU_COUNTER, 0, &m_gpuCounter) != ERROR_SUCCESS) {
+        m_gpuCounter = nullptr;
+    }
+
+    // Rate counters need a first collection as their baseline
+    PdhCollectQueryData(m_query);
+
+    m_intervalMs = static_cast<DWORD>(std::max(100, std::min(intervalMs, 5000)));
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_head = 0;
+        m_count = 0;
+    }
+    ResetEvent(m_stopEvent);
+    m_thread = std::thread(&SystemSampler::threadMain, this);
+    return true;
+}
+
+void SystemSampler::stop() {
+    if (m_thread.joinable()) {
+        SetEvent(m_stopEvent);
+        m_thread.join();
+    }
+    closeQuery();
+}
+
+bool SystemSampler::getLatest(Sample& sample) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_count == 0) {
+        return false;
+    }
+
+    sample = m_history[(m_head + HISTORY_CAPACITY - 1) % HISTORY_CAPACITY];
+    return true;
+}
+
+bool SystemSampler::findSample(int64_t qpcTime, Sample& sample) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_count == 0) {
+        return false;
+    }
+
+    // Timestamps only grow: binary search for the first one at or after qpcTime
+    size_t oldest = (m_head + HISTORY_CAPACITY - m_count) % HISTORY_CAPACITY;
+    size_t low = 0;
+    size_t high = m_count;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (m_history[(oldest + middle) % HISTORY_CAPACITY].qpcTime < qpcTime) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    sample = m_history[(oldest + std::min(low, m_count - 1)) % HISTORY_CAPACITY];
+    return true;
+}
+
+SystemSampler::Bound SystemSampler::classify(const Sample& sample) {
+    if (sample.gpuPercent >= BOUND_PERCENT) {
+        return Bound::Gpu;
+    }
+    if (sample.busiestCorePercent >= BOUND_PERCENT) {
+        return Bound::Cpu;
+    }
+    return Bound::Unknown;
+}
+
+const char* SystemSampler::getBoundName(Bound bound) {
+    switch (bound) {
+        case Bound::Gpu: return "GPU-bound";
+        case Bound::Cpu: return "CPU-bound";
+        default: return "unbound";
+    }
+}
+
+void SystemSampler::threadMain() {
+    ThreadConfig samplerThread;
+    samplerThread.priority = THREAD_PRIORITY_BELOW_NORMAL;
+    applyThreadConfig(samplerThread);
+
+    while (WaitForSingleObject(m_stopEvent, m_intervalMs) == WAIT_TIMEOUT) {
+        Sample sample;
+        if (!collect(sample)) {
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_history[m_head] = sample;
+        m_head = (m_head + 1) % HISTORY_CAPACITY;
+        m_count = std::min(m_count + 1, HISTORY_CAPACITY);
+    }
+}
+
+bool SystemSampler::collect(Sample& sample) {
+    // One collection for every counter, stamped on the present clock
+    if (PdhCollectQueryData(m_query) != ERROR_SUCCESS) {
+        return false;
+    }
+    LARGE_INTEGER now;
+    QueryPerformanceCounter(&now);
+    sample.qpcTime = now.QuadPart;
+
+    double total = 0.0;
+    DWORD count = 0;
+    if (!readValue(m_totalCounter, total) || !readArray(m_coreCounter, count)) {
+        return false;
+    }
+    // Values are read uncapped (processor performance exceeds 100 under
+    // boost); loads are capped here
+    sample.cpuPercent = static_cast<float>(std::min(total, 100.0));
+
+    const auto* items = reinterpret_cast<const PDH_FMT_COUNTERVALUE_ITEM_W*>(m_items.data());
+    sample.coreCount = 0;
+    sample.busiestCorePercent = 0.0f;
+    for (DWORD i = 0; i < count; ++i) {
+        if (isTotalInstance(items[i].szName) || items[i].FmtValue.CStatus != ERROR_SUCCESS) {
+            continue;
+        }
+        float load = static_cast<float>(std::min(items[i].FmtValue.doubleValue, 100.0));
+        sample.busiestCorePercent = std::max(sample.busiestCorePercent, load);
+        if (sample.coreCount < MAX_CORES) {
+            sample.coreLoad[sample.coreCount++] = load;
+        }
+    }
+
+    // Effective clock: nominal frequency scaled by the performance counter
+    double frequency = 0.0;
+    double performance = 0.0;
+    sample.cpuMHz = (readValue(m_frequencyCounter, frequency) && readValue(m_performanceCounter, performance))
+        ? static_cast<float>(frequency * performance / 100.0)
+        : -1.0f;
+
+    // GPU: instances are per process and engine; sum per engine, keep the busiest
+    sample.gpuPercent = -1.0f;
+    if (m_gpuCounter && readArray(m_gpuCounter, count)) {
+        items = reinterpret_cast<const PDH_FMT_COUNTERVALUE_ITEM_W*>(m_items.data());
+        size_t engines = 0;
+        for (DWORD i = 0; i < count; ++i) {
+            if (items[i].FmtValue.CStatus != ERROR_SUCCESS) {
+                continue;
+            }
+            const wchar_t* key = engineKey(items[i].szName);
+            size_t e = 0;
+            while (e < engines && std::wcsncmp(m_engines[e].key, key, _countof(m_engines[e].key) - 1) != 0) {
+                ++e;
+            }
+            if (e == engines) {
+                if (engines == MAX_ENGINES) {
+                    continue;
+                }
+                wcsncpy_s(m_engines[e].key, key, _TRUNCATE);
+                m_engines[e].percent = 0.0;
+                ++engines;
+            }
+            m_engines[e].percent += items[i].FmtValue.doubleValue;
+        }
+
+        double busiest = 0.0;
+        for (size_t e = 0; e < engines; ++e) {
+            busiest = std::max(busiest, m_engines[e].percent);
+        }
+        sample.gpuPercent = static_cast<float>(std::min(busiest, 100.0));
+    }
+
+    return true;
+}
+
+bool SystemSampler::readArray(PDH_HCOUNTER counter, DWORD& count) {
+    // Grows only when the instance count (or a name) gets larger
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        DWORD bytes = static_cast<DWORD>(m_items.size());
+        count = 0;
+        PDH_STATUS status = PdhGetFormattedCounterArrayW(
+            counter, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, &bytes, &count,
+            m_items.empty() ? nullptr : reinterpret_cast<PDH_FMT_COUNTERVALUE_ITEM_W*>(m_items.data()));
+        if (status == ERROR_SUCCESS) {
+            return true;
+        }
+        if (status != static_cast<PDH_STATUS>(PDH_MORE_DATA)) {
+            return false;
+        }
+        m_items.resize(bytes);
+    }
+    return false;
+}
+
+bool SystemSampler::readValue(PDH_HCOUNTER counter, double& value) {
+    PDH_FMT_COUNTERVALUE formatted;
+    if (!counter ||
+        PdhGetFormattedCounterValue(counter, PDH_FMT_DOUBLE | PDH_FMT_NOCAP100, nullptr, &formatted) != ERROR_SUCCESS ||
+        formatted.CStatus != ERROR_SUCCESS) {
+        return false;
+    }
+    value = formatted.doubleValue;
+    return true;
+}
+
+void SystemSampler::closeQuery() {
+    if (m_query) {
+        PdhCloseQuery(m_query);
+    }
+    m_query = nullptr;
+    m_coreCounter = nullptr;
+    m_totalCounter = nullptr;
+    m_frequencyCounter = nullptr;
+    m_performanceCounter = nullptr;
+    m_gpuCounter = nullptr;
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <windows.h>
+#include <pdh.h>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fps_monitor {
+
+/**
+ * @brief Background sampler of system CPU and GPU load
+ *
+ * Polls Performance Data Helper counters on a below-normal priority
+ * thread at a fixed interval:
+ * - Per-logical-processor and total CPU time (\Processor Information)
+ * - Effective CPU clock (processor frequency x % processor performance)
+ * - GPU 3D engine utilisation (\GPU Engine, WDDM 2.0+), summed over the
+ *   processes using each engine; the busiest engine is reported
+ *
+ * The query and its counters are opened once in start(); every interval
+ * costs a single PdhCollectQueryData() plus reads of the formatted values
+ * into buffers that only grow when the instance count does (e.g. a new
+ * process starts using the GPU).
+ *
+ * Samples are stamped with QueryPerformanceCounter at collection, the
+ * clock of the captured presents, and kept in a fixed ring. A sample's
+ * values describe the interval that ends at its timestamp, so findSample()
+ * lets drop and stutter events be attributed to CPU or GPU load from any
+ * thread.
+ */
+class SystemSampler {
+public:
+    static constexpr size_t MAX_CORES = 64;             ///< Logical processors reported per sample
+    static constexpr size_t HISTORY_CAPACITY = 256;     ///< Samples kept
+    static constexpr size_t MAX_ENGINES = 16;           ///< GPU 3D engines tracked
+    static constexpr double BOUND_PERCENT = 90.0;       ///< Load treated as the bottleneck
+
+    /**
+     * @brief One collection of the counters
+     */
+    struct Sample {
+        int64_t qpcTime;                ///< QPC time of the collection (end of the interval)
+        float cpuPercent;               ///< All logical processors (0 - 100)
+        float busiestCorePercent;       ///< Highest single logical processor
+        float gpuPercent;               ///< Busiest 3D engine (-1 = unavailable)
+        float cpuMHz;                   ///< Effective CPU clock (-1 = unavailable)
+        uint32_t coreCount;             ///< Entries in coreLoad
+        float coreLoad[MAX_CORES];      ///< Per logical processor (0 - 100)
+    };
+
+    /**
+     * @brief Likely limiting resource of an interval
+     */
+    enum class Bound {
+        Unknown,    ///< Neither CPU nor GPU saturated
+        Cpu,        ///< A core (typically the game's main thread) saturated
+        Gpu         ///< A GPU 3D engine saturated
+    };
+
+    /**
+     * @brief Construct an idle System Sampler
+     */
+    SystemSampler();
+
+    /**
+     * @brief Destroy the System Sampler (stops it)
+     */
+    ~SystemSampler();
+
+    // Prevent copying
+    SystemSampler(const SystemSampler&) = delete;
+    SystemSampler& operator=(const SystemSampler&) = delete;
+
+    /**
+     * @brief Open the counters and start the sampler thread
+     *
+     * CPU counters are required; the GPU and clock counters are optional
+     * and reported as unavailable when missing.
+     *
+     * @param intervalMs Milliseconds between collections (100 - 5000)
+     * @return true if the sampler thread is running
+     * @return false otherwise
+     */
+    bool start(int intervalMs);
+
+    /**
+     * @brief Stop and join the sampler thread and close the counters
+     */
+    void stop();
+
+    /**
+     * @brief Check if the sampler is running
+     *
+     * @return true if started
+     * @return false otherwise
+     */
+    bool isRunning() const { return m_thread.joinable(); }
+
+    /**
+     * @brief Get the newest sample
+     *
+     * @param sample Output sample
+     * @return true if a sample was collected
+     * @return false otherwise
+     */
+    bool getLatest(Sample& sample) const;
+
+    /**
+     * @brief Get the sample covering a point in time
+     *
+     * The first sample collected at or after qpcTime; if the interval is
+     * still open, the newest sample (the interval just before).
+     *
+     * @param qpcTime QPC time of the event
+     * @param sample Output sample
+     * @return true if a sample was found
+     * @return false if none is kept
+     */
+    bool findSample(int64_t qpcTime, Sample& sample) const;
+
+    /**
+     * @brief Classify a sample's limiting resource
+     *
+     * @param sample Sample to classify
+     * @return Bound Gpu if a 3D engine is saturated, else Cpu if a core is
+     */
+    static Bound classify(const Sample& sample);
+
+    /**
+     * @brief Get a printable name of a bound
+     *
+     * @param bound Bound
+     * @return const char* "GPU-bound", "CPU-bound" or "unbound"
+     */
+    static const char* getBoundName(Bound bound);
+
+private:
+    /**
+     * @brief GPU engine utilisation summed over processes
+     */
+    struct Engine {
+        wchar_t key[96];    ///< Instance name without the process prefix
+        double percent;     ///< Sum for this collection
+    };
+
+    /**
+     * @brief Sampler thread body
+     */
+    void threadMain();
+
+    /**
+     * @brief Collect the counters into a sample
+     *
+     * @param sample Output sample
+     * @return true if the CPU counters were read
+     * @return false otherwise
+     */
+    bool collect(Sample& sample);
+
+    /**
+     * @brief Read a wildcard counter's instances into m_items
+     *
+     * @param counter Counter handle
+     * @param count Output instance count
+     * @return true if read
+     * @return false otherwise
+     */
+    bool readArray(PDH_HCOUNTER counter, DWORD& count);
+
+    /**
+     * @brief Read a single-instance counter
+     *
+     * @param counter Counter handle (may be null)
+     * @param value Output value
+     * @return true if read
+     * @return false otherwise
+     */
+    static bool readValue(PDH_HCOUNTER counter, double& value);
+
+    /**
+     * @brief Close the query and its counters
+     */
+    void closeQuery();
+
+    PDH_HQUERY m_query;                 ///< Query holding every counter
+    PDH_HCOUNTER m_coreCounter;         ///< \Processor Information(*)\% Processor Time
+    PDH_HCOUNTER m_totalCounter;        ///< \Processor Information(_Total)\% Processor Time
+    PDH_HCOUNTER m_frequencyCounter;    ///< \Processor Information(_Total)\Processor Frequency
+    PDH_HCOUNTER m_performanceCounter;  ///< \Processor Information(_Total)\% Processor Performance
+    PDH_HCOUNTER m_gpuCounter;          ///< \GPU Engine(*engtype_3D)\Utilization Percentage
+    std::vector<unsigned char> m_items; ///< Formatted counter array (sampler thread)
+    Engine m_engines[MAX_ENGINES];      ///< Per-engine sums (sampler thread)
+    DWORD m_intervalMs;                 ///< Collection interval
+    std::thread m_thread;               ///< Sampler thread
+    HANDLE m_stopEvent;                 ///< Wakes the thread to exit
+
+    mutable std::mutex m_mutex;         ///< Guards the history
+    Sample m_history[HISTORY_CAPACITY]; ///< Samples (ring, oldest at m_head when full)
+    size_t m_head;                      ///< Next history slot
+    size_t m_count;                     ///< Samples kept
+};
+
+} // namespace fps_monitor
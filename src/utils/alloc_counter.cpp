@@ -0,0 +1,53 @@
+#include "alloc_counter.h"
+#include <cstdlib>
+#include <new>
+
+namespace fps_monitor {
+
+#ifdef _DEBUG
+
+namespace {
+thread_local uint64_t t_allocationCount = 0;
+} // namespace
+
+uint64_t AllocationCounter::getThreadCount() {
+    return t_allocationCount;
+}
+
+} // namespace fps_monitor
+
+// Replacement global allocation functions (debug only). The array and
+// nothrow forms forward to these by default, so only these are replaced.
+void* operator new(std::size_t size) {
+    ++fps_monitor::t_allocationCount;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++fps_monitor::t_allocationCount;
+    if (void* ptr = _aligned_malloc(size ? size : 1, static_cast<std::size_t>(alignment))) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    _aligned_free(ptr);
+}
+
+#else
+
+uint64_t AllocationCounter::getThreadCount() {
+    return 0;
+}
+
+} // namespace fps_monitor
+
+#endif
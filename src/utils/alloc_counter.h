@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+
+namespace fps_monitor {
+
+/**
+ * @brief Heap allocation counter for the steady-state render loop
+ * 
+ * In debug builds the global operator new is replaced (alloc_counter.cpp)
+ * to count allocations made by the calling thread. ScopedAllocationCheck
+ * asserts that a region performed no allocations, which guards the
+ * "no heap allocation per frame" property of the sample pipeline.
+ * 
+ * In release builds nothing is replaced and the count is always 0.
+ */
+class AllocationCounter {
+public:
+    /**
+     * @brief Get the number of allocations made by the calling thread
+     * 
+     * @return uint64_t Allocation count (always 0 in release builds)
+     */
+    static uint64_t getThreadCount();
+};
+
+/**
+ * @brief Asserts that no heap allocation happens during its lifetime
+ * 
+ * Only checks in debug builds; compiles to nothing useful otherwise.
+ */
+class ScopedAllocationCheck {
+public:
+    /**
+     * @brief Begin an allocation-free region
+     * 
+     * @param enabled Whether to check (e.g. false during warm-up frames)
+     */
+    explicit ScopedAllocationCheck(bool enabled = true)
+        : m_enabled(enabled)
+        , m_start(AllocationCounter::getThreadCount())
+    {
+    }
+
+    /**
+     * @brief End the region, asserting no allocations occurred
+     */
+    ~ScopedAllocationCheck() {
+        assert(!m_enabled || AllocationCounter::getThreadCount() == m_start);
+    }
+
+    // Prevent copying
+    ScopedAllocationCheck(const ScopedAllocationCheck&) = delete;
+    ScopedAllocationCheck& operator=(const ScopedAllocationCheck&) = delete;
+
+private:
+    bool m_enabled;     ///< Check active
+    uint64_t m_start;   ///< Count at region start
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,127 @@
+#include "directory_watcher.h"
+
+namespace fps_monitor {
+
+namespace {
+
+/// Saves, new files and editors' write-to-temp-then-rename all show up as one of these
+constexpr DWORD NOTIFY_FILTER = FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME;
+
+} // namespace
+
+DirectoryWatcher::DirectoryWatcher()
+    : m_directory(INVALID_HANDLE_VALUE)
+    , m_event(nullptr)
+    , m_overlapped{}
+    , m_pending(false)
+    , m_buffer{}
+{
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+    stop();
+}
+
+bool DirectoryWatcher::start(const std::string& directory) {
+    stop();
+
+    m_directory = CreateFileA(
+        directory.c_str(),
+        FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+        nullptr
+    );
+    if (m_directory == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    m_event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!m_event || !arm()) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+void DirectoryWatcher::stop() {
+    if (m_pending) {
+        // The read writes into m_buffer until it is cancelled
+        CancelIoEx(m_directory, &m_overlapped);
+        DWORD transferred = 0;
+        GetOverlappedResult(m_directory, &m_overlapped, &transferred, TRUE);
+        m_pending = false;
+    }
+    if (m_directory != INVALID_HANDLE_VALUE) {
+        CloseHandle(m_directory);
+        m_directory = INVALID_HANDLE_VALUE;
+    }
+    if (m_event) {
+        CloseHandle(m_event);
+        m_event = nullptr;
+    }
+}
+
+bool DirectoryWatcher::poll(const std::string& fileName) {
+    if (!m_pending) {
+        return false;
+    }
+
+    DWORD transferred = 0;
+    if (!GetOverlappedResult(m_directory, &m_overlapped, &transferred, FALSE)) {
+        if (GetLastError() == ERROR_IO_INCOMPLETE) {
+            return false;
+        }
+        // Read failed (directory removed?): try again, give up if that fails too
+        m_pending = false;
+        arm();
+        return false;
+    }
+    m_pending = false;
+
+    wchar_t wideName[MAX_PATH];
+    int wideLength = MultiByteToWideChar(CP_UTF8, 0, fileName.c_str(), static_cast<int>(fileName.size()),
+                                         wideName, MAX_PATH);
+
+    // Zero bytes: the buffer overflowed and the changes are unknown, so assume ours
+    bool changed = (transferred == 0);
+    size_t offset = 0;
+    while (!changed && wideLength > 0 && transferred > 0 && offset < transferred) {
+        const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(m_buffer + offset);
+        bool written = info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME;
+        int length = static_cast<int>(info->FileNameLength / sizeof(WCHAR));
+        if (written && CompareStringOrdinal(info->FileName, length, wideName, wideLength, TRUE) == CSTR_EQUAL) {
+            changed = true;
+        }
+
+        if (info->NextEntryOffset == 0) {
+            break;
+        }
+        offset += info->NextEntryOffset;
+    }
+
+    arm();
+    return changed;
+}
+
+bool DirectoryWatcher::arm() {
+    ResetEvent(m_event);
+    m_overlapped = {};
+    m_overlapped.hEvent = m_event;
+
+    m_pending = ReadDirectoryChangesW(
+        m_directory,
+        m_buffer,
+        static_cast<DWORD>(BUFFER_SIZE),
+        FALSE,
+        NOTIFY_FILTER,
+        nullptr,
+        &m_overlapped,
+        nullptr
+    ) != FALSE;
+    return m_pending;
+}
+
+} // namespace fps_monitor
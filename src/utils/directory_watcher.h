@@ -0,0 +1,85 @@
+#pragma once
+
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fps_monitor {
+
+/**
+ * @brief Change notification for one file in a directory
+ *
+ * Keeps one overlapped ReadDirectoryChangesW pending on the directory.
+ * Its completion event can be added to a FrameScheduler (or any wait), so
+ * an edit wakes the thread like any other input; the thread then calls
+ * poll(), which never blocks, to learn whether the file it cares about
+ * (the current theme, config.ini) was written.
+ */
+class DirectoryWatcher {
+public:
+    /**
+     * @brief Construct an idle Directory Watcher
+     */
+    DirectoryWatcher();
+
+    /**
+     * @brief Destroy the Directory Watcher (stops watching)
+     */
+    ~DirectoryWatcher();
+
+    // Prevent copying (owns the directory handle and pending I/O)
+    DirectoryWatcher(const DirectoryWatcher&) = delete;
+    DirectoryWatcher& operator=(const DirectoryWatcher&) = delete;
+
+    /**
+     * @brief Start watching a directory
+     *
+     * @param directory Directory to watch
+     * @return true if the first read is pending
+     * @return false otherwise (the watcher stays idle)
+     */
+    bool start(const std::string& directory);
+
+    /**
+     * @brief Cancel the pending read and close the directory
+     */
+    void stop();
+
+    /**
+     * @brief Get the event signalled when changes are available
+     *
+     * Manual-reset; poll() resets it by issuing the next read.
+     *
+     * @return HANDLE Event, or nullptr while idle
+     */
+    HANDLE getEvent() const { return m_event; }
+
+    /**
+     * @brief Collect completed notifications and re-arm the read
+     *
+     * @param fileName File to look for (compared case-insensitively)
+     * @return true if that file was written, created or renamed into place
+     * @return false if not, or nothing completed yet
+     */
+    bool poll(const std::string& fileName);
+
+private:
+    static constexpr size_t BUFFER_SIZE = 4096;    ///< Notification buffer (bytes)
+
+    /**
+     * @brief Issue the next overlapped read
+     *
+     * @return true if pending
+     * @return false otherwise
+     */
+    bool arm();
+
+    HANDLE m_directory;                 ///< Directory opened for overlapped I/O
+    HANDLE m_event;                     ///< Completion event (in m_overlapped)
+    OVERLAPPED m_overlapped;            ///< Pending read
+    bool m_pending;                     ///< A read is outstanding
+    alignas(DWORD) uint8_t m_buffer[BUFFER_SIZE];   ///< FILE_NOTIFY_INFORMATION records
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,179 @@
+#include "frame_scheduler.h"
+
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+namespace fps_monitor {
+
+namespace {
+
+int64_t queryCounter() {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+} // namespace
+
+FrameScheduler::FrameScheduler()
+    : m_timer(nullptr)
+    , m_highResolution(false)
+    , m_frameEnabled(false)
+    , m_periodMs(1)
+    , m_frequency(1)
+    , m_periodTicks(1)
+    , m_nextFrame(0)
+    , m_handleCount(0)
+    , m_signalled(INVALID_HANDLE_ID)
+{
+    for (size_t i = 0; i < MAX_HANDLES; ++i) {
+        m_handles[i] = nullptr;
+        m_enabled[i] = false;
+    }
+}
+
+FrameScheduler::~FrameScheduler() {
+    if (m_timer) {
+        CloseHandle(m_timer);
+    }
+}
+
+bool FrameScheduler::initialize(int periodMs) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    m_frequency = frequency.QuadPart;
+    m_periodMs = static_cast<DWORD>(periodMs > 0 ? periodMs : 1);
+    m_periodTicks = m_frequency * m_periodMs / 1000;
+
+    // High-resolution timers are not tied to the 15.6 ms scheduler tick
+    m_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    m_highResolution = (m_timer != nullptr);
+
+    if (!m_timer) {
+        m_timer = CreateWaitableTimerExW(nullptr, nullptr, 0, TIMER_ALL_ACCESS);
+    }
+
+    return m_timer != nullptr;
+}
+
+void FrameScheduler::setPeriod(int periodMs) {
+    m_periodMs = static_cast<DWORD>(periodMs > 0 ? periodMs : 1);
+    m_periodTicks = m_frequency * m_periodMs / 1000;
+
+    if (m_frameEnabled && m_timer) {
+        m_nextFrame = queryCounter() + m_periodTicks;
+        armTimer();
+    }
+}
+
+bool FrameScheduler::isHighResolution() const {
+    return m_highResolution;
+}
+
+void FrameScheduler::setFrameEnabled(bool enabled) {
+    if (enabled == m_frameEnabled) {
+        return;
+    }
+
+    m_frameEnabled = enabled;
+    if (!m_timer) {
+        return;
+    }
+
+    if (enabled) {
+        m_nextFrame = queryCounter() + m_periodTicks;
+        armTimer();
+    } else {
+        CancelWaitableTimer(m_timer);
+    }
+}
+
+size_t FrameScheduler::addHandle(HANDLE handle) {
+    if (!handle || m_handleCount >= MAX_HANDLES) {
+        return INVALID_HANDLE_ID;
+    }
+
+    m_handles[m_handleCount] = handle;
+    m_enabled[m_handleCount] = true;
+    return m_handleCount++;
+}
+
+void FrameScheduler::setHandleEnabled(size_t id, bool enabled) {
+    if (id < m_handleCount) {
+        m_enabled[id] = enabled;
+    }
+}
+
+FrameScheduler::WakeReason FrameScheduler::wait(DWORD timeoutMs) {
+    // Timer first, then the enabled handles in registration order
+    HANDLE handles[MAX_HANDLES + 1];
+    size_t ids[MAX_HANDLES + 1];
+    DWORD count = 0;
+
+    if (m_frameEnabled && m_timer) {
+        handles[count] = m_timer;
+        ids[count] = INVALID_HANDLE_ID;
+        ++count;
+    }
+
+    // No timer: time out once per period instead
+    bool frameByTimeout = m_frameEnabled && !m_timer;
+    if (frameByTimeout && timeoutMs > m_periodMs) {
+        timeoutMs = m_periodMs;
+    }
+    for (size_t i = 0; i < m_handleCount; ++i) {
+        if (m_enabled[i]) {
+            handles[count] = m_handles[i];
+            ids[count] = i;
+            ++count;
+        }
+    }
+
+    // MWMO_INPUTAVAILABLE: also wake for messages already queued but not yet seen
+    DWORD result = MsgWaitForMultipleObjectsEx(count, handles, timeoutMs, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+
+    if (result == WAIT_OBJECT_0 + count) {
+        return WakeReason::Message;
+    }
+    if (result == WAIT_TIMEOUT) {
+        return frameByTimeout ? WakeReason::Frame : WakeReason::Timeout;
+    }
+    if (result >= WAIT_OBJECT_0 + count) {
+        return WakeReason::Failed;
+    }
+
+    size_t index = result - WAIT_OBJECT_0;
+    if (ids[index] != INVALID_HANDLE_ID) {
+        m_signalled = ids[index];
+        return WakeReason::Handle;
+    }
+
+    // Next deadline; frames missed while busy are dropped, not queued
+    int64_t now = queryCounter();
+    m_nextFrame += m_periodTicks;
+    if (m_nextFrame <= now) {
+        m_nextFrame = now + m_periodTicks;
+    }
+    armTimer();
+
+    return WakeReason::Frame;
+}
+
+size_t FrameScheduler::getSignalledHandle() const {
+    return m_signalled;
+}
+
+void FrameScheduler::armTimer() {
+    // Negative due time: relative, in 100 ns units
+    int64_t remaining = m_nextFrame - queryCounter();
+    LARGE_INTEGER dueTime;
+    dueTime.QuadPart = remaining > 0 ? -(remaining * 10000000 / m_frequency) : -1;
+    if (dueTime.QuadPart == 0) {
+        dueTime.QuadPart = -1;
+    }
+
+    SetWaitableTimer(m_timer, &dueTime, 0, nullptr, nullptr, FALSE);
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace fps_monitor {
+
+/**
+ * @brief Event-driven wait for the UI thread
+ * 
+ * Blocks in MsgWaitForMultipleObjectsEx on a frame timer, a small set of
+ * registered wait handles (e.g. the capture thread's data event) and the
+ * thread's message queue, so the thread wakes only when a frame is due,
+ * data arrived or a window message (hotkey, etc.) is pending.
+ * 
+ * The frame timer is a high-resolution waitable timer
+ * (CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, Windows 10 1803+; a regular
+ * waitable timer otherwise). It is re-armed for every frame against an
+ * absolute QPC deadline, so frames do not drift and missed frames are
+ * skipped rather than queued.
+ */
+class FrameScheduler {
+public:
+    static constexpr size_t MAX_HANDLES = 8;                ///< Registered handles
+    static constexpr size_t INVALID_HANDLE_ID = SIZE_MAX;   ///< addHandle() failure
+
+    /**
+     * @brief Why wait() returned
+     */
+    enum class WakeReason {
+        Frame,      ///< Frame timer fired
+        Handle,     ///< A registered handle was signalled (see getSignalledHandle())
+        Message,    ///< Window messages are pending
+        Timeout,    ///< Timeout elapsed
+        Failed      ///< Wait failed
+    };
+
+    /**
+     * @brief Construct a new Frame Scheduler
+     */
+    FrameScheduler();
+
+    /**
+     * @brief Destroy the Frame Scheduler
+     */
+    ~FrameScheduler();
+
+    // Prevent copying
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+    /**
+     * @brief Create the frame timer
+     * 
+     * If no timer can be created, wait() falls back to timing out once per
+     * period while the frame is enabled.
+     * 
+     * @param periodMs Frame period in milliseconds
+     * @return true if the timer was created
+     * @return false otherwise
+     */
+    bool initialize(int periodMs);
+
+    /**
+     * @brief Change the frame period
+     * 
+     * An enabled frame timer is rescheduled one new period from now.
+     * 
+     * @param periodMs Frame period in milliseconds
+     */
+    void setPeriod(int periodMs);
+
+    /**
+     * @brief Check if the frame timer is high resolution
+     * 
+     * @return true if created with CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+     * @return false if a regular (scheduler-tick) timer is used
+     */
+    bool isHighResolution() const;
+
+    /**
+     * @brief Include or exclude the frame timer from wait()
+     * 
+     * Enabling it schedules the next frame one period from now.
+     * 
+     * @param enabled Frame timer enabled state
+     */
+    void setFrameEnabled(bool enabled);
+
+    /**
+     * @brief Register a handle to wait on
+     * 
+     * @param handle Waitable handle (auto-reset events recommended)
+     * @return size_t Id for setHandleEnabled(), or INVALID_HANDLE_ID if full
+     */
+    size_t addHandle(HANDLE handle);
+
+    /**
+     * @brief Include or exclude a registered handle from wait()
+     * 
+     * @param id Id returned by addHandle()
+     * @param enabled Handle enabled state
+     */
+    void setHandleEnabled(size_t id, bool enabled);
+
+    /**
+     * @brief Block until the frame is due, a handle is signalled or messages arrive
+     * 
+     * Messages already in the queue make this return immediately.
+     * 
+     * @param timeoutMs Longest wait in milliseconds (INFINITE for none)
+     * @return WakeReason What woke the thread
+     */
+    WakeReason wait(DWORD timeoutMs = INFINITE);
+
+    /**
+     * @brief Get the handle that ended the last wait()
+     * 
+     * @return size_t Id of the signalled handle (valid after WakeReason::Handle)
+     */
+    size_t getSignalledHandle() const;
+
+private:
+    /**
+     * @brief Arm the timer for the current deadline
+     */
+    void armTimer();
+
+    HANDLE m_timer;                       ///< Frame timer
+    bool m_highResolution;                ///< Timer created high resolution
+    bool m_frameEnabled;                  ///< Frame timer part of the wait
+    DWORD m_periodMs;                     ///< Frame period in milliseconds
+    int64_t m_frequency;                  ///< QPC frequency
+    int64_t m_periodTicks;                ///< Frame period in QPC ticks
+    int64_t m_nextFrame;                  ///< QPC deadline of the next frame
+    HANDLE m_handles[MAX_HANDLES];        ///< Registered handles
+    bool m_enabled[MAX_HANDLES];          ///< Registered handle enabled
+    size_t m_handleCount;                 ///< Registered handle count
+    size_t m_signalled;                   ///< Handle that ended the last wait
+};
+
+} // namespace fps_monitor
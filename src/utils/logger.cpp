@@ -1,11 +1,26 @@
 #include "logger.h"
-#include <windows.h>
-#include <sstream>
-#include <iomanip>
-#include <chrono>
+#include "thread_config.h"
+#include <algorithm>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
 
 namespace fps_monitor {
 
+Logger::Logger()
+    : m_wakeEvent(nullptr)
+    , m_running(false)
+    , m_stopRequested(false)
+    , m_writerSleeping(false)
+    , m_dropped(0)
+    , m_file(INVALID_HANDLE_VALUE)
+    , m_fileSize(0)
+    , m_batchSize(0)
+    , m_cachedSecond(0)
+    , m_cachedDate{}
+{
+}
+
 Logger::~Logger() {
     shutdown();
 }
@@ -16,47 +31,89 @@ Logger& Logger::getInstance() {
 }
 
 bool Logger::initialize(const std::string& filename) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-
-    if (m_initialized) {
+    if (m_running) {
         return true;
     }
 
     m_filename = filename;
-    m_file.open(m_filename, std::ios::out | std::ios::app);
-    
-    if (!m_file.is_open()) {
+    if (!openFile()) {
         return false;
     }
 
-    m_initialized = true;
+    m_wakeEvent = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+    if (!m_wakeEvent) {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+        return false;
+    }
+
+    m_stopRequested = false;
+    m_running = true;
+    m_writer = std::thread(&Logger::writerMain, this);
+
     log(Level::Info, "Logger initialized");
-    
     return true;
 }
 
 void Logger::shutdown() {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running.exchange(false)) {
+        return;
+    }
 
-    if (m_initialized && m_file.is_open()) {
-        // Write shutdown message before closing
-        m_file << getTimestamp() << " [INFO ] Logger shutting down" << std::endl;
-        m_file.close();
-        m_initialized = false;
+    // Write shutdown message before closing; log() already refuses new
+    // messages, so enqueue it directly. The writer drains the queue first.
+    static const char SHUTDOWN_MESSAGE[] = "Logger shutting down";
+    Record record;
+    record.time = now();
+    record.level = Level::Info;
+    record.length = static_cast<uint32_t>(sizeof(SHUTDOWN_MESSAGE) - 1);
+    std::memcpy(record.text, SHUTDOWN_MESSAGE, record.length);
+    enqueue(record);
+
+    m_stopRequested = true;
+    SetEvent(m_wakeEvent);
+    if (m_writer.joinable()) {
+        m_writer.join();
     }
+
+    CloseHandle(m_wakeEvent);
+    m_wakeEvent = nullptr;
+    CloseHandle(m_file);
+    m_file = INVALID_HANDLE_VALUE;
 }
 
 void Logger::log(Level level, const std::string& message) {
-    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+        return;
+    }
 
-    if (!m_initialized) {
+    Record record;
+    record.time = now();
+    record.level = level;
+    record.length = static_cast<uint32_t>(std::min(message.size(), MESSAGE_CAPACITY));
+    std::memcpy(record.text, message.data(), record.length);
+    enqueue(record);
+}
+
+void Logger::logf(Level level, const char* format, ...) {
+    if (!m_running) {
         return;
     }
 
-    checkRotation();
+    Record record;
+    record.time = now();
+    record.level = level;
 
-    m_file << getTimestamp() << " [" << levelToString(level) << "] " << message << std::endl;
-    m_file.flush();
+    // vsnprintf always terminates; one byte of text is lost to it at most
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(record.text, MESSAGE_CAPACITY, format, args);
+    va_end(args);
+    if (length < 0) {
+        return;
+    }
+    record.length = static_cast<uint32_t>(std::min<size_t>(static_cast<size_t>(length), MESSAGE_CAPACITY - 1));
+    enqueue(record);
 }
 
 void Logger::debug(const std::string& message) {
@@ -77,57 +134,161 @@ void Logger::error(const std::string& message) {
     log(Level::Error, message);
 }
 
-std::string Logger::getTimestamp() const {
-    auto now = std::chrono::system_clock::now();
-    auto nowTime = std::chrono::system_clock::to_time_t(now);
-    auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+void Logger::enqueue(const Record& record) {
+    if (!m_queue.push(record)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Only the first record after the writer went to sleep pays for SetEvent
+    if (m_writerSleeping.exchange(false)) {
+        SetEvent(m_wakeEvent);
+    }
+}
+
+void Logger::writerMain() {
+    ThreadConfig writerThread;
+    writerThread.priority = THREAD_PRIORITY_BELOW_NORMAL;
+    applyThreadConfig(writerThread);
+
+    Record record;
+    for (;;) {
+        while (m_queue.pop(record)) {
+            append(record);
+        }
 
-    std::tm tm;
-    localtime_s(&tm, &nowTime);
+        uint64_t dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+        if (dropped > 0) {
+            record.time = now();
+            record.level = Level::Warning;
+            int length = std::snprintf(record.text, MESSAGE_CAPACITY, "%llu log messages dropped (queue full)",
+                                       static_cast<unsigned long long>(dropped));
+            record.length = static_cast<uint32_t>(std::max(length, 0));
+            append(record);
+        }
+
+        if (m_stopRequested && m_queue.isEmpty()) {
+            break;
+        }
+
+        // Batch whatever arrives within the flush interval, then write it;
+        // with nothing pending sleep until the next record
+        bool pending = m_batchSize > 0;
+        if (!pending) {
+            m_writerSleeping = true;
+            if (!m_queue.isEmpty() || m_stopRequested) {
+                m_writerSleeping = false;
+                continue;
+            }
+        }
 
-    std::ostringstream oss;
-    oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-    oss << '.' << std::setfill('0') << std::setw(3) << nowMs.count();
+        if (WaitForSingleObject(m_wakeEvent, pending ? FLUSH_INTERVAL_MS : INFINITE) == WAIT_TIMEOUT) {
+            flush();
+        }
+        m_writerSleeping = false;
+    }
 
-    return oss.str();
+    flush();
 }
 
-std::string Logger::levelToString(Level level) const {
-    switch (level) {
-        case Level::Debug:   return "DEBUG";
-        case Level::Info:    return "INFO ";
-        case Level::Warning: return "WARN ";
-        case Level::Error:   return "ERROR";
-        default:             return "?????";
+void Logger::append(const Record& record) {
+    // Longest line: timestamp (23) + level (8) + message + newline
+    if (BATCH_SIZE - m_batchSize < MESSAGE_CAPACITY + 40) {
+        flush();
     }
+
+    // The date part changes once per second; format it only then
+    uint64_t second = record.time / 10000000;
+    if (second != m_cachedSecond) {
+        FILETIME utc;
+        utc.dwLowDateTime = static_cast<DWORD>(second * 10000000);
+        utc.dwHighDateTime = static_cast<DWORD>((second * 10000000) >> 32);
+        FILETIME local;
+        SYSTEMTIME time = {};
+        FileTimeToLocalFileTime(&utc, &local);
+        FileTimeToSystemTime(&local, &time);
+        std::snprintf(m_cachedDate, sizeof(m_cachedDate), "%04u-%02u-%02u %02u:%02u:%02u",
+                      time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond);
+        m_cachedSecond = second;
+    }
+
+    unsigned milliseconds = static_cast<unsigned>((record.time / 10000) % 1000);
+    char* out = m_batch + m_batchSize;
+    int prefix = std::snprintf(out, BATCH_SIZE - m_batchSize, "%s.%03u [%s] ",
+                               m_cachedDate, milliseconds, levelToString(record.level));
+    if (prefix < 0) {
+        return;
+    }
+    out += prefix;
+    std::memcpy(out, record.text, record.length);
+    out += record.length;
+    *out++ = '\n';
+    m_batchSize = static_cast<size_t>(out - m_batch);
 }
 
-void Logger::checkRotation() {
-    if (!m_file.is_open()) {
+void Logger::flush() {
+    if (m_batchSize == 0 || m_file == INVALID_HANDLE_VALUE) {
+        m_batchSize = 0;
         return;
     }
 
-    // Check file size
-    m_file.seekp(0, std::ios::end);
-    size_t fileSize = static_cast<size_t>(m_file.tellp());
+    if (m_fileSize >= MAX_FILE_SIZE) {
+        rotate();
+    }
 
-    if (fileSize >= MAX_FILE_SIZE) {
-        // Rotate log file
-        m_file.close();
+    DWORD written = 0;
+    if (m_file != INVALID_HANDLE_VALUE
+        && WriteFile(m_file, m_batch, static_cast<DWORD>(m_batchSize), &written, nullptr)) {
+        m_fileSize += written;
+    }
+    m_batchSize = 0;
+}
 
-        // Rename old log with error handling
-        std::string backupName = m_filename + ".old";
-        DeleteFileA(backupName.c_str()); // Remove old backup if exists
-        
-        if (!MoveFileA(m_filename.c_str(), backupName.c_str())) {
-            // If move fails, try to delete and create new
-            DeleteFileA(m_filename.c_str());
-        }
+bool Logger::openFile() {
+    m_file = CreateFileA(m_filename.c_str(), FILE_APPEND_DATA, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                         nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
 
-        // Open new log
-        m_file.open(m_filename, std::ios::out | std::ios::app);
+    // Size queried once; every write adds to it
+    LARGE_INTEGER size = {};
+    GetFileSizeEx(m_file, &size);
+    m_fileSize = static_cast<uint64_t>(size.QuadPart);
+    return true;
+}
+
+void Logger::rotate() {
+    CloseHandle(m_file);
+    m_file = INVALID_HANDLE_VALUE;
+
+    // Rename old log with error handling
+    std::string backupName = m_filename + ".old";
+    DeleteFileA(backupName.c_str()); // Remove old backup if exists
+
+    if (!MoveFileA(m_filename.c_str(), backupName.c_str())) {
+        // If move fails, try to delete and create new
+        DeleteFileA(m_filename.c_str());
+    }
+
+    // Open new log
+    openFile();
+}
+
+const char* Logger::levelToString(Level level) {
+    switch (level) {
+        case Level::Debug:   return "DEBUG";
+        case Level::Info:    return "INFO ";
+        case Level::Warning: return "WARN ";
+        case Level::Error:   return "ERROR";
+        default:             return "?????";
     }
 }
 
+uint64_t Logger::now() {
+    FILETIME time;
+    GetSystemTimeAsFileTime(&time);
+    return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+}
+
 } // namespace fps_monitor
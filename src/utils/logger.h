@@ -1,8 +1,12 @@
 #pragma once
 
+#include <windows.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include <fstream>
-#include <mutex>
+#include <thread>
+#include "mpsc_ring_buffer.h"
 
 namespace fps_monitor {
 
@@ -11,6 +15,15 @@ namespace fps_monitor {
  * 
  * Provides thread-safe logging with timestamps and log levels.
  * Only active in debug builds.
+ * 
+ * Logging never touches the disk on the caller's thread: a call stamps
+ * the time, copies the message into a fixed-size record and pushes it to
+ * a lock-free queue (no lock, no allocation). A background writer formats
+ * the records into one buffer per batch and writes it with a single
+ * WriteFile, tracks the file size for rotation in memory, and formats the
+ * date part of the timestamp once per second. Messages are truncated to
+ * MESSAGE_CAPACITY bytes; if the queue is full they are dropped and the
+ * number dropped is logged once there is room again.
  */
 class Logger {
 public:
@@ -53,6 +66,16 @@ public:
      */
     void log(Level level, const std::string& message);
 
+    /**
+     * @brief Log a printf-style message, formatted straight into the record
+     * 
+     * Allocation-free alternative to building a std::string.
+     * 
+     * @param level Log level
+     * @param format printf format string
+     */
+    void logf(Level level, const char* format, ...);
+
     /**
      * @brief Log a debug message
      * 
@@ -83,8 +106,20 @@ public:
      */
     void error(const std::string& message);
 
+    static constexpr size_t MESSAGE_CAPACITY = 240;     ///< Longest message kept (bytes)
+
 private:
-    Logger() = default;
+    /**
+     * @brief One queued log line
+     */
+    struct Record {
+        uint64_t time;                      ///< GetSystemTimeAsFileTime() at the call
+        Level level;                        ///< Log level
+        uint32_t length;                    ///< Message bytes used
+        char text[MESSAGE_CAPACITY];        ///< Message (not terminated)
+    };
+
+    Logger();
     ~Logger();
 
     // Prevent copying
@@ -92,30 +127,78 @@ private:
     Logger& operator=(const Logger&) = delete;
 
     /**
-     * @brief Get current timestamp string
+     * @brief Queue a record and wake the writer if it sleeps
+     * 
+     * @param record Filled record
+     */
+    void enqueue(const Record& record);
+
+    /**
+     * @brief Writer thread body
+     */
+    void writerMain();
+
+    /**
+     * @brief Format a record into the batch buffer, flushing it when full
+     * 
+     * @param record Record to format
+     */
+    void append(const Record& record);
+
+    /**
+     * @brief Write the batch buffer to the file (rotating first if needed)
+     */
+    void flush();
+
+    /**
+     * @brief Open (or reopen) the log file for appending
      * 
-     * @return std::string Formatted timestamp
+     * @return true if open
+     * @return false otherwise
+     */
+    bool openFile();
+
+    /**
+     * @brief Move the full log to <name>.old and start a new one
      */
-    std::string getTimestamp() const;
+    void rotate();
 
     /**
      * @brief Convert log level to string
      * 
      * @param level Log level
-     * @return std::string Level string
+     * @return const char* Level string (5 characters)
      */
-    std::string levelToString(Level level) const;
+    static const char* levelToString(Level level);
 
     /**
-     * @brief Check if log file needs rotation
+     * @brief Get the current time for a record
+     * 
+     * @return uint64_t FILETIME in 100 ns units
      */
-    void checkRotation();
-
-    std::ofstream m_file;           ///< Log file stream
-    std::string m_filename;         ///< Current log file path
-    std::mutex m_mutex;             ///< Thread safety mutex
-    bool m_initialized;             ///< Initialization flag
-    static constexpr size_t MAX_FILE_SIZE = 5 * 1024 * 1024; ///< 5MB max log size
+    static uint64_t now();
+
+    static constexpr size_t QUEUE_CAPACITY = 1024;                  ///< Queued records
+    static constexpr size_t BATCH_SIZE = 64 * 1024;                 ///< Bytes per WriteFile
+    static constexpr DWORD FLUSH_INTERVAL_MS = 200;                 ///< Longest a line waits for a batch
+    static constexpr uint64_t MAX_FILE_SIZE = 5 * 1024 * 1024;      ///< 5MB max log size
+
+    MpscRingBuffer<Record, QUEUE_CAPACITY> m_queue;  ///< Callers -> writer
+    std::thread m_writer;                       ///< Background writer
+    HANDLE m_wakeEvent;                         ///< Wakes the writer
+    std::atomic<bool> m_running;                ///< Accepting records
+    std::atomic<bool> m_stopRequested;          ///< Writer should drain and exit
+    std::atomic<bool> m_writerSleeping;         ///< Writer waits for m_wakeEvent
+    std::atomic<uint64_t> m_dropped;            ///< Records lost to a full queue
+
+    // Writer thread state
+    HANDLE m_file;                              ///< Log file
+    std::string m_filename;                     ///< Current log file path
+    uint64_t m_fileSize;                        ///< Bytes in the file (tracked, not queried)
+    char m_batch[BATCH_SIZE];                   ///< Formatted lines awaiting WriteFile
+    size_t m_batchSize;                         ///< Bytes used in m_batch
+    uint64_t m_cachedSecond;                    ///< Second m_cachedDate was formatted for
+    char m_cachedDate[20];                      ///< "YYYY-MM-DD HH:MM:SS" of m_cachedSecond
 };
 
 // Convenience macros
@@ -124,11 +207,15 @@ private:
     #define LOG_INFO(msg) fps_monitor::Logger::getInstance().info(msg)
     #define LOG_WARNING(msg) fps_monitor::Logger::getInstance().warning(msg)
     #define LOG_ERROR(msg) fps_monitor::Logger::getInstance().error(msg)
+    #define LOG_INFOF(...) fps_monitor::Logger::getInstance().logf(fps_monitor::Logger::Level::Info, __VA_ARGS__)
+    #define LOG_WARNINGF(...) fps_monitor::Logger::getInstance().logf(fps_monitor::Logger::Level::Warning, __VA_ARGS__)
 #else
     #define LOG_DEBUG(msg)
     #define LOG_INFO(msg)
     #define LOG_WARNING(msg)
     #define LOG_ERROR(msg)
+    #define LOG_INFOF(...)
+    #define LOG_WARNINGF(...)
 #endif
 
 } // namespace fps_monitor
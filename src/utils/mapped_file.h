@@ -0,0 +1,67 @@
+#pragma once
+
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fps_monitor {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ * 
+ * Pages are loaded on first access, so opening a multi-hour recording
+ * costs nothing up front and only the parts that are read use memory.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Construct a new Mapped File (nothing mapped)
+     */
+    MappedFile();
+
+    /**
+     * @brief Destroy the Mapped File (unmaps it)
+     */
+    ~MappedFile();
+
+    // Prevent copying (owns the mapping)
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file for reading
+     * 
+     * @param path File to map
+     * @return true if mapped (an empty file maps to no data)
+     * @return false if the file could not be opened or mapped
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmap the file
+     */
+    void close();
+
+    /**
+     * @brief Get the mapped bytes
+     * 
+     * @return const uint8_t* File contents (nullptr if nothing is mapped)
+     */
+    const uint8_t* data() const { return m_data; }
+
+    /**
+     * @brief Get the file size
+     * 
+     * @return size_t Bytes mapped
+     */
+    size_t size() const { return m_size; }
+
+private:
+    HANDLE m_file;          ///< File handle
+    HANDLE m_mapping;       ///< File mapping object
+    const uint8_t* m_data;  ///< Mapped view
+    size_t m_size;          ///< View size
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,67 @@
+#include "process_usage.h"
+#include <psapi.h>
+#include <algorithm>
+
+namespace fps_monitor {
+
+namespace {
+
+uint64_t toUInt64(const FILETIME& time) {
+    return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+}
+
+} // namespace
+
+ProcessUsage::ProcessUsage()
+    : m_lastCpuTime(0)
+    , m_lastWallTime(0)
+    , m_processors(1)
+    , m_cpuPercent(0.0)
+    , m_workingSet(0)
+    , m_privateBytes(0)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    m_processors = std::max<unsigned>(1, info.dwNumberOfProcessors);
+    readTimes(m_lastCpuTime, m_lastWallTime);
+}
+
+bool ProcessUsage::sample() {
+    uint64_t cpuTime = 0;
+    uint64_t wallTime = 0;
+    if (!readTimes(cpuTime, wallTime)) {
+        return false;
+    }
+
+    if (wallTime > m_lastWallTime) {
+        double busy = static_cast<double>(cpuTime - m_lastCpuTime);
+        double elapsed = static_cast<double>(wallTime - m_lastWallTime) * m_processors;
+        m_cpuPercent = 100.0 * busy / elapsed;
+    }
+    m_lastCpuTime = cpuTime;
+    m_lastWallTime = wallTime;
+
+    PROCESS_MEMORY_COUNTERS_EX memory = {};
+    memory.cb = sizeof(memory);
+    if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&memory),
+                             sizeof(memory))) {
+        m_workingSet = memory.WorkingSetSize;
+        m_privateBytes = memory.PrivateUsage;
+    }
+    return true;
+}
+
+bool ProcessUsage::readTimes(uint64_t& cpuTime, uint64_t& wallTime) {
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return false;
+    }
+
+    FILETIME now;
+    GetSystemTimeAsFileTime(&now);
+    cpuTime = toUInt64(kernel) + toUInt64(user);
+    wallTime = toUInt64(now);
+    return true;
+}
+
+} // namespace fps_monitor
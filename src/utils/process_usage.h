@@ -0,0 +1,73 @@
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+
+namespace fps_monitor {
+
+/**
+ * @brief The overlay's own CPU time and memory
+ *
+ * CPU usage is the process's user + kernel time (GetProcessTimes) between
+ * two sample() calls, relative to the wall time in between and the number
+ * of logical processors, i.e. the share of the whole machine (what Task
+ * Manager shows). Memory comes from GetProcessMemoryInfo.
+ */
+class ProcessUsage {
+public:
+    /**
+     * @brief Construct a new Process Usage sampler
+     *
+     * Takes the baseline for the first interval.
+     */
+    ProcessUsage();
+
+    /**
+     * @brief Measure the interval since the previous call (or construction)
+     *
+     * @return true if the values were updated
+     * @return false if the process times could not be read
+     */
+    bool sample();
+
+    /**
+     * @brief Get the CPU usage of the last interval
+     *
+     * @return double Percent of all logical processors (0 - 100)
+     */
+    double getCpuPercent() const { return m_cpuPercent; }
+
+    /**
+     * @brief Get the working set at the last sample
+     *
+     * @return uint64_t Resident bytes
+     */
+    uint64_t getWorkingSetBytes() const { return m_workingSet; }
+
+    /**
+     * @brief Get the private (committed) bytes at the last sample
+     *
+     * @return uint64_t Private bytes
+     */
+    uint64_t getPrivateBytes() const { return m_privateBytes; }
+
+private:
+    /**
+     * @brief Read the process CPU time and the wall clock
+     *
+     * @param cpuTime User + kernel time in 100 ns units
+     * @param wallTime Current time in 100 ns units
+     * @return true if read
+     * @return false otherwise
+     */
+    static bool readTimes(uint64_t& cpuTime, uint64_t& wallTime);
+
+    uint64_t m_lastCpuTime;     ///< Process CPU time at the previous sample
+    uint64_t m_lastWallTime;    ///< Wall time at the previous sample
+    unsigned m_processors;      ///< Logical processors
+    double m_cpuPercent;        ///< Last interval's usage
+    uint64_t m_workingSet;      ///< Last working set
+    uint64_t m_privateBytes;    ///< Last private bytes
+};
+
+} // namespace fps_monitor
@@ -0,0 +1,79 @@
+#include "stage_profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace fps_monitor {
+
+StageProfiler::StageProfiler()
+    : m_stages{}
+    , m_stageCount(0)
+    , m_scratch{}
+{
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    m_microsecondsPerTick = 1000000.0 / static_cast<double>(frequency.QuadPart);
+}
+
+size_t StageProfiler::addStage(const char* name) {
+    if (m_stageCount >= MAX_STAGES) {
+        return MAX_STAGES;
+    }
+
+    Stage& stage = m_stages[m_stageCount];
+    stage.name = name;
+    stage.next = 0;
+    stage.count = 0;
+    return m_stageCount++;
+}
+
+void StageProfiler::record(size_t stage, int64_t ticks) {
+    if (stage >= m_stageCount) {
+        return;
+    }
+
+    Stage& target = m_stages[stage];
+    int64_t clamped = std::min<int64_t>(std::max<int64_t>(ticks, 0), std::numeric_limits<uint32_t>::max());
+    target.ticks[target.next] = static_cast<uint32_t>(clamped);
+    target.next = (target.next + 1) % WINDOW;
+    target.count = std::min(target.count + 1, WINDOW);
+}
+
+void StageProfiler::summarize(Summary& out) {
+    out.stageCount = m_stageCount;
+
+    for (size_t i = 0; i < m_stageCount; ++i) {
+        const Stage& stage = m_stages[i];
+        StageStats& stats = out.stages[i];
+        stats.name = stage.name;
+        stats.runs = static_cast<uint32_t>(stage.count);
+        stats.p50Us = 0.0;
+        stats.p99Us = 0.0;
+        stats.maxUs = 0.0;
+
+        if (stage.count == 0) {
+            continue;
+        }
+
+        // Select in place on a copy; the window is small and fixed
+        std::copy(stage.ticks, stage.ticks + stage.count, m_scratch);
+        uint32_t* end = m_scratch + stage.count;
+        auto select = [&](double fraction) {
+            size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(stage.count))) - 1;
+            std::nth_element(m_scratch, m_scratch + rank, end);
+            return static_cast<double>(m_scratch[rank]) * m_microsecondsPerTick;
+        };
+
+        stats.p50Us = select(0.50);
+        stats.p99Us = select(0.99);
+        stats.maxUs = static_cast<double>(*std::max_element(m_scratch, end)) * m_microsecondsPerTick;
+    }
+}
+
+int64_t StageProfiler::now() {
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return counter.QuadPart;
+}
+
+} // namespace fps_monitor
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <windows.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace fps_monitor {
+
+/**
+ * @brief Per-stage timing of one thread's loop
+ *
+ * Each stage keeps the durations of its last WINDOW runs (QPC ticks) in a
+ * fixed ring, and summarize() reduces them to p50/p99/max. Recording is a
+ * QPC read and a store, with no allocation, so the scopes can stay in the
+ * steady-state loop of release builds.
+ *
+ * Not thread-safe: every thread owns its own profiler and hands out
+ * summaries (plain values) instead.
+ */
+class StageProfiler {
+public:
+    static constexpr size_t MAX_STAGES = 8;     ///< Stages per profiler
+    static constexpr size_t WINDOW = 256;       ///< Runs kept per stage
+
+    /**
+     * @brief Timing of one stage over its window
+     */
+    struct StageStats {
+        const char* name;   ///< Stage name (string literal given to addStage())
+        double p50Us;       ///< Median duration in microseconds
+        double p99Us;       ///< 99th percentile duration in microseconds
+        double maxUs;       ///< Longest duration in microseconds
+        uint32_t runs;      ///< Runs in the window
+    };
+
+    /**
+     * @brief Timing of every stage, oldest stage first
+     */
+    struct Summary {
+        StageStats stages[MAX_STAGES];  ///< Per-stage results
+        size_t stageCount;              ///< Valid entries in stages
+    };
+
+    /**
+     * @brief Times a stage from construction to destruction
+     */
+    class Scope {
+    public:
+        Scope(StageProfiler& profiler, size_t stage)
+            : m_profiler(profiler)
+            , m_stage(stage)
+            , m_start(now())
+        {
+        }
+
+        ~Scope() {
+            m_profiler.record(m_stage, now() - m_start);
+        }
+
+        // Prevent copying
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        StageProfiler& m_profiler;  ///< Receives the duration
+        size_t m_stage;             ///< Stage index
+        int64_t m_start;            ///< QPC at construction
+    };
+
+    /**
+     * @brief Construct a new Stage Profiler with no stages
+     */
+    StageProfiler();
+
+    /**
+     * @brief Register a stage (setup only)
+     *
+     * @param name Stage name; must outlive the profiler (a string literal)
+     * @return size_t Stage index for record()/Scope, or MAX_STAGES when full
+     *         (recording to it is ignored)
+     */
+    size_t addStage(const char* name);
+
+    /**
+     * @brief Record one run of a stage
+     *
+     * @param stage Stage index from addStage()
+     * @param ticks Duration in QPC ticks
+     */
+    void record(size_t stage, int64_t ticks);
+
+    /**
+     * @brief Reduce every stage's window to percentiles
+     *
+     * @param out Receives one entry per stage
+     */
+    void summarize(Summary& out);
+
+    /**
+     * @brief Get the current QPC value
+     *
+     * @return int64_t QueryPerformanceCounter ticks
+     */
+    static int64_t now();
+
+private:
+    /**
+     * @brief Ring of recent durations of one stage
+     */
+    struct Stage {
+        const char* name;           ///< Stage name
+        uint32_t ticks[WINDOW];     ///< Recent durations (QPC ticks, saturated)
+        size_t next;                ///< Next slot to write
+        size_t count;               ///< Valid slots
+    };
+
+    Stage m_stages[MAX_STAGES];     ///< Registered stages
+    size_t m_stageCount;            ///< Stages in use
+    uint32_t m_scratch[WINDOW];     ///< Selection scratch for summarize()
+    double m_microsecondsPerTick;   ///< 1e6 / QueryPerformanceFrequency
+};
+
+} // namespace fps_monitor
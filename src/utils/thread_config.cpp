@@ -0,0 +1,53 @@
+#include "thread_config.h"
+
+namespace fps_monitor {
+
+namespace {
+
+struct PriorityName {
+    const char* name;
+    int priority;
+};
+
+const PriorityName PRIORITY_NAMES[] = {
+    {"idle", THREAD_PRIORITY_IDLE},
+    {"lowest", THREAD_PRIORITY_LOWEST},
+    {"below_normal", THREAD_PRIORITY_BELOW_NORMAL},
+    {"normal", THREAD_PRIORITY_NORMAL},
+    {"above_normal", THREAD_PRIORITY_ABOVE_NORMAL},
+    {"highest", THREAD_PRIORITY_HIGHEST},
+    {"time_critical", THREAD_PRIORITY_TIME_CRITICAL},
+};
+
+} // namespace
+
+int parseThreadPriority(const std::string& name) {
+    for (const PriorityName& entry : PRIORITY_NAMES) {
+        if (name == entry.name) {
+            return entry.priority;
+        }
+    }
+    return THREAD_PRIORITY_NORMAL;
+}
+
+std::string threadPriorityToString(int priority) {
+    for (const PriorityName& entry : PRIORITY_NAMES) {
+        if (priority == entry.priority) {
+            return entry.name;
+        }
+    }
+    return "normal";
+}
+
+bool applyThreadConfig(const ThreadConfig& config) {
+    HANDLE thread = GetCurrentThread();
+    bool applied = SetThreadPriority(thread, config.priority) != 0;
+
+    if (config.affinityMask != 0) {
+        applied = SetThreadAffinityMask(thread, static_cast<DWORD_PTR>(config.affinityMask)) != 0 && applied;
+    }
+
+    return applied;
+}
+
+} // namespace fps_monitor
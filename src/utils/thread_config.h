@@ -0,0 +1,45 @@
+#pragma once
+
+#include <windows.h>
+#include <cstdint>
+#include <string>
+
+namespace fps_monitor {
+
+/**
+ * @brief Scheduling settings for one of the overlay's threads
+ * 
+ * Applied by the thread itself once it starts, so the overlay's threads can
+ * be kept off the cores the game is busiest on.
+ */
+struct ThreadConfig {
+    int priority = THREAD_PRIORITY_NORMAL;  ///< THREAD_PRIORITY_* value
+    uint64_t affinityMask = 0;              ///< Logical processor mask (0 = any)
+};
+
+/**
+ * @brief Convert a priority name to a THREAD_PRIORITY_* value
+ * 
+ * @param name idle, lowest, below_normal, normal, above_normal, highest or time_critical
+ * @return int Priority value (THREAD_PRIORITY_NORMAL for unknown names)
+ */
+int parseThreadPriority(const std::string& name);
+
+/**
+ * @brief Convert a THREAD_PRIORITY_* value to its name
+ * 
+ * @param priority Priority value
+ * @return std::string Priority name (as accepted by parseThreadPriority())
+ */
+std::string threadPriorityToString(int priority);
+
+/**
+ * @brief Apply priority and affinity to the calling thread
+ * 
+ * @param config Settings to apply
+ * @return true if every setting was applied
+ * @return false if the priority or affinity was rejected
+ */
+bool applyThreadConfig(const ThreadConfig& config);
+
+} // namespace fps_monitor
@@ -0,0 +1,118 @@
+#include "recording_reader.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace fps_monitor;
+
+namespace {
+
+/**
+ * @brief Read a whole file
+ *
+ * @return true if read
+ * @return false otherwise
+ */
+bool readFile(const char* path, std::vector<uint8_t>& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+/**
+ * @brief Print a target name as a CSV field (names never contain commas or quotes in practice)
+ */
+void printName(std::FILE* out, std::string_view name) {
+    if (name.empty()) {
+        std::fputs("overlay", out);
+        return;
+    }
+    for (char c : name) {
+        std::fputc((c == ',' || c == '"' || c == '\n') ? '_' : c, out);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Convert a .fpsr recording to PresentMon-style CSV
+ *
+ * usage: fpsr-export <recording.fpsr> <frames.csv> [--drops=<drops.csv>]
+ */
+int main(int argc, char** argv) {
+    const char* dropsPath = nullptr;
+    if (argc == 4 && std::strncmp(argv[3], "--drops=", 8) == 0) {
+        dropsPath = argv[3] + 8;
+    } else if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <recording.fpsr> <frames.csv> [--drops=<drops.csv>]\n", argv[0]);
+        return 1;
+    }
+
+    std::vector<uint8_t> data;
+    if (!readFile(argv[1], data)) {
+        std::fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+
+    RecordingReader reader;
+    if (!reader.open(data.data(), data.size())) {
+        std::fprintf(stderr, "%s is not a supported recording\n", argv[1]);
+        return 1;
+    }
+
+    std::FILE* frames = std::fopen(argv[2], "w");
+    if (!frames) {
+        std::fprintf(stderr, "cannot write %s\n", argv[2]);
+        return 1;
+    }
+
+    std::FILE* drops = nullptr;
+    if (dropsPath) {
+        drops = std::fopen(dropsPath, "w");
+        if (!drops) {
+            std::fprintf(stderr, "cannot write %s\n", dropsPath);
+            std::fclose(frames);
+            return 1;
+        }
+        std::fputs("Application,ProcessID,TimeInSeconds,CurrentFPS,AverageFPS\n", drops);
+    }
+
+    // Column names follow PresentMon so existing frame-time tools can load the file
+    std::fputs("Application,ProcessID,TimeInSeconds,msBetweenPresents\n", frames);
+
+    double frequency = static_cast<double>(reader.getHeader().tickFrequency);
+    uint64_t frameCount = 0;
+    RecordingReader::Record record;
+
+    while (reader.next(record)) {
+        double seconds = static_cast<double>(record.time) / frequency;
+
+        if (record.type == RecordingReader::Record::Type::Frame) {
+            printName(frames, record.name);
+            std::fprintf(frames, ",%u,%.6f,%.4f\n", record.processId, seconds,
+                         static_cast<double>(record.ticks) * 1000.0 / frequency);
+            ++frameCount;
+        } else if (record.type == RecordingReader::Record::Type::Drop && drops) {
+            printName(drops, record.name);
+            std::fprintf(drops, ",%u,%.6f,%.2f,%.2f\n", record.processId, seconds,
+                         record.currentFPS, record.averageFPS);
+        }
+    }
+
+    std::fclose(frames);
+    if (drops) {
+        std::fclose(drops);
+    }
+
+    if (reader.isTruncated()) {
+        std::fprintf(stderr, "warning: recording ends with an incomplete record\n");
+    }
+    std::printf("%llu frames exported\n", static_cast<unsigned long long>(frameCount));
+    return 0;
+}